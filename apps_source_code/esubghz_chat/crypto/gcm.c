@@ -68,30 +68,21 @@
  * Bellcore: "On Fast and Provably Secure MessageAuthentication Based on
  * Universal Hashing."  See: http://www.shoup.net/papers/macs.pdf
  * See, also section 4.1 of the "gcm-revised-spec" cited above.
+ *
+ * Chat messages are short but every one of them is hashed, so we go one step
+ * up from the 4-bit tables: a 256-entry (4 KB) key table halves the number of
+ * shift-and-reduce steps per block. The table and the running hash are kept
+ * as 32-bit words, since the targets we run on are 32-bit and the hash stays
+ * in words from block to block instead of being packed into bytes each time.
  */
 
 /*
- *  This 16-entry table of pre-computed constants is used by the
- *  GHASH multiplier to improve over a strictly table-free but
- *  significantly slower 128x128 bit multiple within GF(2^128).
+ *  This 256-entry table of pre-computed constants is used by the
+ *  GHASH multiplier to reduce the byte shifted out of the product
+ *  back into GF(2^128). Like the AES tables it is filled in once
+ *  by gcm_initialize.
  */
-static const uint64_t last4[16] = {
-    0x0000,
-    0x1c20,
-    0x3840,
-    0x2460,
-    0x7080,
-    0x6ca0,
-    0x48c0,
-    0x54e0,
-    0xe100,
-    0xfd20,
-    0xd940,
-    0xc560,
-    0x9180,
-    0x8da0,
-    0xa9c0,
-    0xb5e0};
+static uint16_t last8[256];
 
 /*
  * Platform Endianness Neutralizing Load and Store Macro definitions
@@ -124,56 +115,90 @@ static const uint64_t last4[16] = {
  *
  ******************************************************************************/
 int gcm_initialize(void) {
+    int i, k;
+
     aes_init_keygen_tables();
+
+    // each bit shifted out folds back in as x^128 = x^7 + x^2 + x + 1
+    for(i = 0; i < 256; i++) {
+        last8[i] = 0;
+        for(k = 0; k < 8; k++)
+            if(i & (1 << k)) last8[i] ^= (uint16_t)(0x1c2 << k);
+    }
     return (0);
 }
 
+/******************************************************************************
+ *
+ *  GCM_SHIFT8
+ *
+ *  Shifts the 128-bit 'z' right by one byte, reduces the bits shifted out
+ *  and then adds in the HTable entry 'h'.
+ *
+ ******************************************************************************/
+static inline void gcm_shift8(uint32_t z[4], const uint32_t h[4]) {
+    uint32_t rem = z[3] & 0xff;
+
+    z[3] = ((z[2] << 24) | (z[3] >> 8)) ^ h[3];
+    z[2] = ((z[1] << 24) | (z[2] >> 8)) ^ h[2];
+    z[1] = ((z[0] << 24) | (z[1] >> 8)) ^ h[1];
+    z[0] = ((z[0] >> 8) ^ ((uint32_t)last8[rem] << 16)) ^ h[0];
+}
+
 /******************************************************************************
  *
  *  GCM_MULT
  *
- *  Performs a GHASH operation on the 128-bit input vector 'x', setting
- *  the 128-bit output vector to 'x' times H using our precomputed tables.
- *  'x' and 'output' are seen as elements of GCM's GF(2^128) Galois field.
+ *  Performs a GHASH operation on the 128-bit vector 'x' in place, setting
+ *  it to 'x' times H using our precomputed tables. 'x' is held as four
+ *  big-endian 32-bit words and seen as an element of GCM's GF(2^128) field.
  *
  ******************************************************************************/
 static void gcm_mult(
     gcm_context* ctx, // pointer to established context
-    const uchar x[16], // pointer to 128-bit input vector
-    uchar output[16]) // pointer to 128-bit output vector
+    uint32_t x[4]) // 128-bit input and output vector
+{
+    int i, j;
+    uint32_t word;
+    uint32_t z[4] = {0, 0, 0, 0};
+
+    // walk the bytes from last to first. The first step only shifts
+    // zeros, which leaves z equal to the last byte's table entry
+    for(i = 3; i >= 0; i--) {
+        word = x[i];
+        for(j = 0; j < 4; j++, word >>= 8)
+            gcm_shift8(z, ctx->HT[word & 0xff]);
+    }
+    memcpy(x, z, sizeof(z));
+}
+
+/******************************************************************************
+ *
+ *  GCM_GHASH
+ *
+ *  Mixes up to 16 bytes of 'input' into the GHASH accumulator 'x' and runs
+ *  the GHASH multiplication over it. Short blocks are zero padded.
+ *
+ ******************************************************************************/
+static void gcm_ghash(
+    gcm_context* ctx, // pointer to established context
+    uint32_t x[4], // GHASH accumulator
+    const uchar* input, // pointer to up to 16 bytes of data
+    size_t length) // byte count to mix in
 {
-    int i;
-    uchar lo, hi, rem;
-    uint64_t zh, zl;
-
-    lo = (uchar)(x[15] & 0x0f);
-    hi = (uchar)(x[15] >> 4);
-    zh = ctx->HH[lo];
-    zl = ctx->HL[lo];
-
-    for(i = 15; i >= 0; i--) {
-        lo = (uchar)(x[i] & 0x0f);
-        hi = (uchar)(x[i] >> 4);
-
-        if(i != 15) {
-            rem = (uchar)(zl & 0x0f);
-            zl = (zh << 60) | (zl >> 4);
-            zh = (zh >> 4);
-            zh ^= (uint64_t)last4[rem] << 48;
-            zh ^= ctx->HH[lo];
-            zl ^= ctx->HL[lo];
+    uint32_t word;
+    size_t i;
+
+    if(length == 16) {
+        for(i = 0; i < 4; i++) {
+            GET_UINT32_BE(word, input, i * 4);
+            x[i] ^= word;
         }
-        rem = (uchar)(zl & 0x0f);
-        zl = (zh << 60) | (zl >> 4);
-        zh = (zh >> 4);
-        zh ^= (uint64_t)last4[rem] << 48;
-        zh ^= ctx->HH[hi];
-        zl ^= ctx->HL[hi];
+    } else {
+        for(i = 0; i < length; i++)
+            x[i >> 2] ^= (uint32_t)input[i] << (24 - 8 * (i & 3));
     }
-    PUT_UINT32_BE(zh >> 32, output, 0);
-    PUT_UINT32_BE(zh, output, 4);
-    PUT_UINT32_BE(zl >> 32, output, 8);
-    PUT_UINT32_BE(zl, output, 12);
+    gcm_mult(ctx, x);
 }
 
 /******************************************************************************
@@ -190,9 +215,7 @@ int gcm_setkey(
     const uint keysize) // size in bytes (must be 16, 24, 32 for
 // 128, 192 or 256-bit keys respectively)
 {
-    int ret, i, j;
-    uint64_t hi, lo;
-    uint64_t vl, vh;
+    int ret, i, j, k;
     unsigned char h[16];
 
     memset(ctx, 0, sizeof(gcm_context)); // zero caller-provided GCM context
@@ -203,33 +226,27 @@ int gcm_setkey(
     if((ret = aes_setkey(&ctx->aes_ctx, ENCRYPT, key, keysize)) != 0) return (ret);
     if((ret = aes_cipher(&ctx->aes_ctx, h, h)) != 0) return (ret);
 
-    GET_UINT32_BE(hi, h, 0); // pack h as two 64-bit ints, big-endian
-    GET_UINT32_BE(lo, h, 4);
-    vh = (uint64_t)hi << 32 | lo;
-
-    GET_UINT32_BE(hi, h, 8);
-    GET_UINT32_BE(lo, h, 12);
-    vl = (uint64_t)hi << 32 | lo;
-
-    ctx->HL[8] = vl; // 8 = 1000 corresponds to 1 in GF(2^128)
-    ctx->HH[8] = vh;
-    ctx->HH[0] = 0; // 0 corresponds to 0 in GF(2^128)
-    ctx->HL[0] = 0;
-
-    for(i = 4; i > 0; i >>= 1) {
-        uint32_t T = (uint32_t)(vl & 1) * 0xe1000000U;
-        vl = (vh << 63) | (vl >> 1);
-        vh = (vh >> 1) ^ ((uint64_t)T << 32);
-        ctx->HL[i] = vl;
-        ctx->HH[i] = vh;
+    // 128 = 10000000 corresponds to 1 in GF(2^128), 0 stays zeroed
+    GET_UINT32_BE(ctx->HT[128][0], h, 0); // pack h as big-endian words
+    GET_UINT32_BE(ctx->HT[128][1], h, 4);
+    GET_UINT32_BE(ctx->HT[128][2], h, 8);
+    GET_UINT32_BE(ctx->HT[128][3], h, 12);
+    memset(h, 0, sizeof(h));
+
+    // single bit entries are H times successive powers of x
+    for(i = 64; i > 0; i >>= 1) {
+        const uint32_t* v = ctx->HT[i << 1];
+        uint32_t T = (v[3] & 1) * 0xe1000000U;
+        ctx->HT[i][3] = (v[2] << 31) | (v[3] >> 1);
+        ctx->HT[i][2] = (v[1] << 31) | (v[2] >> 1);
+        ctx->HT[i][1] = (v[0] << 31) | (v[1] >> 1);
+        ctx->HT[i][0] = (v[0] >> 1) ^ T;
     }
-    for(i = 2; i < 16; i <<= 1) {
-        uint64_t *HiL = ctx->HL + i, *HiH = ctx->HH + i;
-        vh = *HiH;
-        vl = *HiL;
+    // and the rest are sums of those
+    for(i = 2; i < 256; i <<= 1) {
         for(j = 1; j < i; j++) {
-            HiH[j] = vh ^ ctx->HH[j];
-            HiL[j] = vl ^ ctx->HL[j];
+            for(k = 0; k < 4; k++)
+                ctx->HT[i + j][k] = ctx->HT[i][k] ^ ctx->HT[j][k];
         }
     }
     return (0);
@@ -266,9 +283,9 @@ int gcm_start(
 {
     int ret; // our error return if the AES encrypt fails
     uchar work_buf[16]; // XOR source built from provided IV if len != 16
+    uint32_t y[4]; // GHASH of the IV if len != 12
     const uchar* p; // general purpose array pointer
     size_t use_len; // byte count to process, up to 16 bytes
-    size_t i; // local loop iterator
 
     // since the context might be reused under the same key
     // we zero the working buffers for this next new process
@@ -287,29 +304,30 @@ int gcm_start(
     {
         memset(work_buf, 0x00, 16); // clear the working buffer
         PUT_UINT32_BE(iv_len * 8, work_buf, 12); // place the IV into buffer
+        memset(y, 0x00, sizeof(y));
 
         p = iv;
         while(iv_len > 0) {
             use_len = (iv_len < 16) ? iv_len : 16;
-            for(i = 0; i < use_len; i++)
-                ctx->y[i] ^= p[i];
-            gcm_mult(ctx, ctx->y, ctx->y);
+            gcm_ghash(ctx, y, p, use_len);
             iv_len -= use_len;
             p += use_len;
         }
-        for(i = 0; i < 16; i++)
-            ctx->y[i] ^= work_buf[i];
-        gcm_mult(ctx, ctx->y, ctx->y);
+        gcm_ghash(ctx, y, work_buf, 16);
+
+        PUT_UINT32_BE(y[0], ctx->y, 0);
+        PUT_UINT32_BE(y[1], ctx->y, 4);
+        PUT_UINT32_BE(y[2], ctx->y, 8);
+        PUT_UINT32_BE(y[3], ctx->y, 12);
     }
+    GET_UINT32_BE(ctx->ctr, ctx->y, 12);
     if((ret = aes_cipher(&ctx->aes_ctx, ctx->y, ctx->base_ectr)) != 0) return (ret);
 
     ctx->add_len = add_len;
     p = add;
     while(add_len > 0) {
         use_len = (add_len < 16) ? add_len : 16;
-        for(i = 0; i < use_len; i++)
-            ctx->buf[i] ^= p[i];
-        gcm_mult(ctx, ctx->buf, ctx->buf);
+        gcm_ghash(ctx, ctx->buf, p, use_len);
         add_len -= use_len;
         p += use_len;
     }
@@ -344,38 +362,34 @@ int gcm_update(
         // clamp the length to process at 16 bytes
         use_len = (length < 16) ? length : 16;
 
-        // increment the context's 128-bit IV||Counter 'y' vector
-        for(i = 16; i > 12; i--)
-            if(++ctx->y[i - 1] != 0) break;
+        // increment the counter half of the context's 'y' vector
+        ctx->ctr++;
+        PUT_UINT32_BE(ctx->ctr, ctx->y, 12);
 
         // encrypt the context's 'y' vector under the established key
         if((ret = aes_cipher(&ctx->aes_ctx, ctx->y, ectr)) != 0) return (ret);
 
         // encrypt or decrypt the input to the output
         if(ctx->mode == ENCRYPT) {
-            for(i = 0; i < use_len; i++) {
-                // XOR the cipher's ouptut vector (ectr) with our input
+            // XOR the cipher's ouptut vector (ectr) with our input
+            for(i = 0; i < use_len; i++)
                 output[i] = (uchar)(ectr[i] ^ input[i]);
-                // now we mix in our data into the authentication hash.
-                // if we're ENcrypting we XOR in the post-XOR (output)
-                // results, but if we're DEcrypting we XOR in the input
-                // data
-                ctx->buf[i] ^= output[i];
-            }
+            // now we mix in our data into the authentication hash.
+            // if we're ENcrypting we XOR in the post-XOR (output)
+            // results, but if we're DEcrypting we XOR in the input
+            // data
+            gcm_ghash(ctx, ctx->buf, output, use_len);
         } else {
-            for(i = 0; i < use_len; i++) {
-                // but if we're DEcrypting we XOR in the input data first,
-                // i.e. before saving to ouput data, otherwise if the input
-                // and output buffer are the same (inplace decryption) we
-                // would not get the correct auth tag
+            // but if we're DEcrypting we hash the input data first,
+            // i.e. before saving to ouput data, otherwise if the input
+            // and output buffer are the same (inplace decryption) we
+            // would not get the correct auth tag
+            gcm_ghash(ctx, ctx->buf, input, use_len);
 
-                ctx->buf[i] ^= input[i];
-
-                // XOR the cipher's ouptut vector (ectr) with our input
+            // XOR the cipher's ouptut vector (ectr) with our input
+            for(i = 0; i < use_len; i++)
                 output[i] = (uchar)(ectr[i] ^ input[i]);
-            }
         }
-        gcm_mult(ctx, ctx->buf, ctx->buf); // perform a GHASH operation
 
         length -= use_len; // drop the remaining byte count to process
         input += use_len; // bump our input pointer forward
@@ -405,18 +419,18 @@ int gcm_finish(
     if(tag_len != 0) memcpy(tag, ctx->base_ectr, tag_len);
 
     if(orig_len || orig_add_len) {
-        memset(work_buf, 0x00, 16);
-
-        PUT_UINT32_BE((orig_add_len >> 32), work_buf, 0);
-        PUT_UINT32_BE((orig_add_len), work_buf, 4);
-        PUT_UINT32_BE((orig_len >> 32), work_buf, 8);
-        PUT_UINT32_BE((orig_len), work_buf, 12);
-
-        for(i = 0; i < 16; i++)
-            ctx->buf[i] ^= work_buf[i];
-        gcm_mult(ctx, ctx->buf, ctx->buf);
+        ctx->buf[0] ^= (uint32_t)(orig_add_len >> 32);
+        ctx->buf[1] ^= (uint32_t)orig_add_len;
+        ctx->buf[2] ^= (uint32_t)(orig_len >> 32);
+        ctx->buf[3] ^= (uint32_t)orig_len;
+        gcm_mult(ctx, ctx->buf);
+
+        PUT_UINT32_BE(ctx->buf[0], work_buf, 0);
+        PUT_UINT32_BE(ctx->buf[1], work_buf, 4);
+        PUT_UINT32_BE(ctx->buf[2], work_buf, 8);
+        PUT_UINT32_BE(ctx->buf[3], work_buf, 12);
         for(i = 0; i < tag_len; i++)
-            tag[i] ^= ctx->buf[i];
+            tag[i] ^= work_buf[i];
     }
     return (0);
 }
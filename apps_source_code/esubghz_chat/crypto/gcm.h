@@ -44,11 +44,11 @@ typedef struct {
     int mode; // cipher direction: encrypt/decrypt
     uint64_t len; // cipher data length processed so far
     uint64_t add_len; // total add data length
-    uint64_t HL[16]; // precalculated lo-half HTable
-    uint64_t HH[16]; // precalculated hi-half HTable
+    uint32_t HT[256][4]; // precalculated HTable, big-endian 32-bit words
     uchar base_ectr[16]; // first counter-mode cipher output for tag
     uchar y[16]; // the current cipher-input IV|Counter value
-    uchar buf[16]; // buf working value
+    uint32_t ctr; // counter half of 'y' in native byte order
+    uint32_t buf[4]; // GHASH accumulator, big-endian 32-bit words
     aes_context aes_ctx; // cipher context used
 } gcm_context;
 
@@ -0,0 +1,164 @@
+// Host check and benchmark for the AES-GCM fallback, see test/Makefile. Not part of the FAP.
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "../gcm.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define GCM_TEST_HAVE_TSC 1
+#endif
+
+// The chat sends messages of a few dozen bytes, bulk data shows the GHASH throughput
+#define GCM_BENCH_SHORT 64
+#define GCM_BENCH_LONG 16384
+#define GCM_BENCH_BYTES (64 * 1024 * 1024)
+
+typedef struct {
+    const char* name;
+    const char* key;
+    const char* plain;
+    const char* add;
+    const char* iv;
+    const char* cipher;
+    const char* tag;
+} GcmVector;
+
+// Test cases from the GCM specification (McGrew & Viega), as used in NIST's validation
+static const GcmVector gcm_vectors[] = {
+    {"TC13",
+     "0000000000000000000000000000000000000000000000000000000000000000",
+     "",
+     "",
+     "000000000000000000000000",
+     "",
+     "530f8afbc74536b9a963b4f1c4cb738b"},
+    {"TC14",
+     "0000000000000000000000000000000000000000000000000000000000000000",
+     "00000000000000000000000000000000",
+     "",
+     "000000000000000000000000",
+     "cea7403d4d606b6e074ec5d3baf39d18",
+     "d0d1c8a799996bf0265b98b5d48ab919"},
+    {"TC16",
+     "feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308",
+     "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+     "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+     "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+     "cafebabefacedbaddecaf888",
+     "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa"
+     "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662",
+     "76fc6ece0f4e1768cddf8853bb2d551b"},
+    {"TC18",
+     "feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308",
+     "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+     "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+     "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+     "9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728"
+     "c3c0c95156809539fcf0e2429a6b525416aedbf5a0de6a57a637b39b",
+     "5a8def2f0c9e53f1f75d7853659e2a20eeb2b22aafde6419a058ab4f6f746bf4"
+     "0fc0c3b780f244452da3ebf1c5d82cdea2418997200ef82e44ae7e3f",
+     "a44a8266ee1c8eb0c8b5d4cf5ae9f19a"},
+};
+
+static size_t gcm_test_hex(const char* hex, uchar* out) {
+    size_t len = strlen(hex) / 2;
+    for(size_t i = 0; i < len; i++) {
+        sscanf(&hex[i * 2], "%2hhx", &out[i]);
+    }
+    return len;
+}
+
+static int gcm_test_vector(const GcmVector* vector) {
+    uchar key[32], plain[64], add[32], iv[64], cipher[64], tag[16];
+    uchar out[64], out_tag[16];
+    gcm_context ctx;
+
+    size_t key_len = gcm_test_hex(vector->key, key);
+    size_t plain_len = gcm_test_hex(vector->plain, plain);
+    size_t add_len = gcm_test_hex(vector->add, add);
+    size_t iv_len = gcm_test_hex(vector->iv, iv);
+    gcm_test_hex(vector->cipher, cipher);
+    gcm_test_hex(vector->tag, tag);
+
+    gcm_setkey(&ctx, key, key_len);
+    gcm_crypt_and_tag(
+        &ctx, ENCRYPT, iv, iv_len, add, add_len, plain, out, plain_len, out_tag, sizeof(tag));
+    int ok = memcmp(out, cipher, plain_len) == 0 && memcmp(out_tag, tag, sizeof(tag)) == 0;
+
+    // decrypting in place must give the plain text back and accept the tag
+    ok &= gcm_auth_decrypt(&ctx, iv, iv_len, add, add_len, out, out, plain_len, tag, sizeof(tag)) ==
+          0;
+    ok &= memcmp(out, plain, plain_len) == 0;
+
+    // a flipped bit must be rejected
+    out[0] ^= 1;
+    gcm_crypt_and_tag(
+        &ctx, ENCRYPT, iv, iv_len, add, add_len, out, out, plain_len, out_tag, sizeof(tag));
+    if(plain_len > 0) {
+        ok &= gcm_auth_decrypt(
+                  &ctx, iv, iv_len, add, add_len, out, out, plain_len, tag, sizeof(tag)) != 0;
+    }
+
+    gcm_zero_ctx(&ctx);
+
+    printf("%s: %s\n", vector->name, ok ? "ok" : "FAIL");
+    return !ok;
+}
+
+static double gcm_test_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void gcm_test_bench(size_t message_len) {
+    static uchar buf[GCM_BENCH_LONG];
+    uchar key[32] = {1};
+    uchar iv[12] = {2};
+    uchar add[12] = {3};
+    uchar tag[16];
+    gcm_context ctx;
+
+    gcm_setkey(&ctx, key, sizeof(key));
+    size_t rounds = GCM_BENCH_BYTES / message_len;
+
+    double start = gcm_test_seconds();
+#ifdef GCM_TEST_HAVE_TSC
+    unsigned long long cycles = __rdtsc();
+#endif
+    for(size_t i = 0; i < rounds; i++) {
+        gcm_crypt_and_tag(
+            &ctx, ENCRYPT, iv, sizeof(iv), add, sizeof(add), buf, buf, message_len, tag, 16);
+    }
+#ifdef GCM_TEST_HAVE_TSC
+    cycles = __rdtsc() - cycles;
+#endif
+    double elapsed = gcm_test_seconds() - start;
+    double bytes = (double)rounds * message_len;
+
+    printf("%5zu byte messages: %.1f MB/s", message_len, bytes / 1e6 / elapsed);
+#ifdef GCM_TEST_HAVE_TSC
+    printf(", %.1f cycles/byte", cycles / bytes);
+#endif
+    printf("\n");
+
+    gcm_zero_ctx(&ctx);
+}
+
+int main(void) {
+    int failed = 0;
+
+    gcm_initialize();
+
+    for(size_t i = 0; i < sizeof(gcm_vectors) / sizeof(gcm_vectors[0]); i++) {
+        failed |= gcm_test_vector(&gcm_vectors[i]);
+    }
+
+    gcm_test_bench(GCM_BENCH_SHORT);
+    gcm_test_bench(GCM_BENCH_LONG);
+
+    return failed;
+}
@@ -1,5 +1,4 @@
 #include <furi_hal.h>
-#include <lib/mlib/m-dict.h>
 #include <mbedtls/sha256.h>
 #include <machine/endian.h>
 
@@ -9,14 +8,41 @@
 
 #include "crypto_wrapper.h"
 
-DICT_DEF2(ESubGhzChatReplayDict, uint64_t, uint32_t)
+/* Number of senders we keep replay state for, the least recently heard one
+ * is evicted when a new sender shows up. */
+#define REPLAY_SENDERS 32
+
+/* Counters older than this many messages behind the newest one are
+ * rejected. */
+#define REPLAY_WINDOW_BITS 64
+
+/* Replay state of one sender. Bit n of window is set if the message with
+ * counter (counter - n) has been seen, so reordered and repeated
+ * transmissions within the window can be told apart. */
+typedef struct {
+    uint64_t run_id;
+    uint64_t window;
+    uint32_t counter;
+    uint32_t last_used;
+} ESubGhzChatReplayEntry;
+
+/* Dump format of one sender, same layout as the NFC key share entry. The
+ * missing field holds window bits 1 to 32 inverted, so dumps from older
+ * versions, which have it zeroed, count as all seen. */
+struct ESubGhzChatReplayRecord {
+    uint64_t run_id;
+    uint32_t counter;
+    uint32_t missing;
+} __attribute__((packed));
 
 struct ESugGhzChatCryptoCtx {
     uint8_t key[KEY_BITS / 8];
 #ifndef FURI_HAL_CRYPTO_ADVANCED_AVAIL
     gcm_context gcm_ctx;
 #endif /* FURI_HAL_CRYPTO_ADVANCED_AVAIL */
-    ESubGhzChatReplayDict_t replay_dict;
+    ESubGhzChatReplayEntry replay[REPLAY_SENDERS];
+    size_t replay_count;
+    uint32_t replay_use_counter;
     uint64_t run_id;
     uint32_t counter;
 };
@@ -46,7 +72,6 @@ ESubGhzChatCryptoCtx* crypto_ctx_alloc(void) {
 
     if(ret != NULL) {
         memset(ret, 0, sizeof(ESubGhzChatCryptoCtx));
-        ESubGhzChatReplayDict_init(ret->replay_dict);
         ret->run_id = 0;
         ret->counter = 1;
     }
@@ -56,7 +81,6 @@ ESubGhzChatCryptoCtx* crypto_ctx_alloc(void) {
 
 void crypto_ctx_free(ESubGhzChatCryptoCtx* ctx) {
     crypto_ctx_clear(ctx);
-    ESubGhzChatReplayDict_clear(ctx->replay_dict);
     free(ctx);
 }
 
@@ -65,11 +89,79 @@ void crypto_ctx_clear(ESubGhzChatCryptoCtx* ctx) {
 #ifndef FURI_HAL_CRYPTO_ADVANCED_AVAIL
     crypto_explicit_bzero(&(ctx->gcm_ctx), sizeof(ctx->gcm_ctx));
 #endif /* FURI_HAL_CRYPTO_ADVANCED_AVAIL */
-    ESubGhzChatReplayDict_reset(ctx->replay_dict);
+    memset(ctx->replay, 0, sizeof(ctx->replay));
+    ctx->replay_count = 0;
+    ctx->replay_use_counter = 0;
     ctx->run_id = 0;
     ctx->counter = 1;
 }
 
+static ESubGhzChatReplayEntry* replay_find(ESubGhzChatCryptoCtx* ctx, uint64_t run_id) {
+    for(size_t i = 0; i < ctx->replay_count; i++) {
+        if(ctx->replay[i].run_id == run_id) {
+            return &ctx->replay[i];
+        }
+    }
+    return NULL;
+}
+
+/* Returns the entry for run_id, creating it in a free or the least recently
+ * used slot if needed. New entries have an empty window. */
+static ESubGhzChatReplayEntry* replay_get(ESubGhzChatCryptoCtx* ctx, uint64_t run_id) {
+    ESubGhzChatReplayEntry* entry = replay_find(ctx, run_id);
+
+    if(entry == NULL) {
+        if(ctx->replay_count < REPLAY_SENDERS) {
+            entry = &ctx->replay[ctx->replay_count++];
+        } else {
+            entry = &ctx->replay[0];
+            for(size_t i = 1; i < REPLAY_SENDERS; i++) {
+                if(ctx->replay[i].last_used < entry->last_used) {
+                    entry = &ctx->replay[i];
+                }
+            }
+        }
+
+        entry->run_id = run_id;
+        entry->window = 0;
+        entry->counter = 0;
+    }
+
+    entry->last_used = ++ctx->replay_use_counter;
+    return entry;
+}
+
+/* Checks whether a message with the given counter was seen already or is too
+ * old to tell. */
+static bool replay_is_stale(ESubGhzChatCryptoCtx* ctx, uint64_t run_id, uint32_t counter) {
+    ESubGhzChatReplayEntry* entry = replay_find(ctx, run_id);
+    if(entry == NULL || entry->window == 0 || counter > entry->counter) {
+        return false;
+    }
+
+    uint32_t age = entry->counter - counter;
+    if(age >= REPLAY_WINDOW_BITS) {
+        return true;
+    }
+
+    return (entry->window >> age) & 1;
+}
+
+/* Marks the messages in window, relative to counter, as seen. */
+static void replay_mark(ESubGhzChatReplayEntry* entry, uint32_t counter, uint64_t window) {
+    if(entry->window == 0 || counter > entry->counter) {
+        uint32_t shift = (entry->window == 0) ? REPLAY_WINDOW_BITS : counter - entry->counter;
+        entry->window = (shift >= REPLAY_WINDOW_BITS) ? 0 : entry->window << shift;
+        entry->window |= window;
+        entry->counter = counter;
+    } else {
+        uint32_t age = entry->counter - counter;
+        if(age < REPLAY_WINDOW_BITS) {
+            entry->window |= window << age;
+        }
+    }
+}
+
 static uint64_t crypto_calc_run_id(FuriString* flipper_name, uint32_t tick) {
     const char* fn = furi_string_get_cstr(flipper_name);
     size_t fn_len = strlen(fn);
@@ -115,11 +207,8 @@ bool crypto_ctx_decrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* in, size_t in_len, u
     struct ESubGhzChatCryptoMsg* msg = (struct ESubGhzChatCryptoMsg*)in;
 
     // check if message is stale, if yes, discard
-    uint32_t* counter = ESubGhzChatReplayDict_get(ctx->replay_dict, msg->run_id);
-    if(counter != NULL) {
-        if(*counter >= __ntohl(msg->counter)) {
-            return false;
-        }
+    if(replay_is_stale(ctx, msg->run_id, __ntohl(msg->counter))) {
+        return false;
     }
 
     // decrypt and auth message
@@ -149,9 +238,9 @@ bool crypto_ctx_decrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* in, size_t in_len, u
              TAG_BYTES) == 0);
 #endif /* FURI_HAL_CRYPTO_ADVANCED_AVAIL */
 
-    // if auth was successful update replay dict
+    // if auth was successful update replay window
     if(ret) {
-        ESubGhzChatReplayDict_set_at(ctx->replay_dict, msg->run_id, __ntohl(msg->counter));
+        replay_mark(replay_get(ctx, msg->run_id), __ntohl(msg->counter), 1);
     }
 
     return ret;
@@ -193,45 +282,56 @@ bool crypto_ctx_encrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* in, size_t in_len, u
              TAG_BYTES) == 0);
 #endif /* FURI_HAL_CRYPTO_ADVANCED_AVAIL */
 
-    // update replay dict and increase internal counter
+    // update replay window and increase internal counter
     if(ret) {
-        ESubGhzChatReplayDict_set_at(ctx->replay_dict, ctx->run_id, ctx->counter);
+        replay_mark(replay_get(ctx, ctx->run_id), ctx->counter, 1);
         ctx->counter++;
     }
 
     return ret;
 }
 
-size_t crypto_ctx_dump_replay_dict(
-    ESubGhzChatCryptoCtx* ctx,
-    CryptoCtxReplayDictWriter writer,
-    void* writer_ctx) {
+size_t crypto_ctx_dump_replay_dict(ESubGhzChatCryptoCtx* ctx, uint8_t* buf, size_t size) {
     size_t ret = 0;
-    ESubGhzChatReplayDict_it_t i;
-
-    for(ESubGhzChatReplayDict_it(i, ctx->replay_dict); !ESubGhzChatReplayDict_end_p(i);
-        ESubGhzChatReplayDict_next(i), ret++) {
-        ESubGhzChatReplayDict_itref_t* ref = ESubGhzChatReplayDict_ref(i);
-        if(!writer(ref->key, ref->value, writer_ctx)) {
+    uint32_t below = UINT32_MAX;
+
+    // most recently heard senders first, so a short buffer keeps the active ones
+    while(ret + sizeof(struct ESubGhzChatReplayRecord) <= size) {
+        ESubGhzChatReplayEntry* entry = NULL;
+        for(size_t i = 0; i < ctx->replay_count; i++) {
+            if(ctx->replay[i].last_used < below &&
+               (entry == NULL || ctx->replay[i].last_used > entry->last_used)) {
+                entry = &ctx->replay[i];
+            }
+        }
+        if(entry == NULL) {
             break;
         }
+        below = entry->last_used;
+
+        struct ESubGhzChatReplayRecord record = {
+            .run_id = entry->run_id,
+            .counter = __htonl(entry->counter),
+            .missing = __htonl(~(uint32_t)(entry->window >> 1))};
+        memcpy(buf + ret, &record, sizeof(record));
+        ret += sizeof(record);
     }
 
     return ret;
 }
 
-size_t crypto_ctx_read_replay_dict(
-    ESubGhzChatCryptoCtx* ctx,
-    CryptoCtxReplayDictReader reader,
-    void* reader_ctx) {
+size_t crypto_ctx_read_replay_dict(ESubGhzChatCryptoCtx* ctx, const uint8_t* buf, size_t size) {
     size_t ret = 0;
 
-    uint64_t run_id;
-    uint32_t counter;
+    // read in reverse, so the first record ends up the most recently used
+    for(size_t n = size / sizeof(struct ESubGhzChatReplayRecord); n > 0; n--, ret++) {
+        struct ESubGhzChatReplayRecord record;
+        memcpy(&record, buf + (n - 1) * sizeof(record), sizeof(record));
 
-    while(reader(&run_id, &counter, reader_ctx)) {
-        ESubGhzChatReplayDict_set_at(ctx->replay_dict, run_id, counter);
-        ret++;
+        // counters older than the dumped window count as seen
+        uint64_t window = 1 | ((uint64_t)(uint32_t)~__ntohl(record.missing) << 1) |
+                          (UINT64_MAX << 33);
+        replay_mark(replay_get(ctx, record.run_id), __ntohl(record.counter), window);
     }
 
     return ret;
@@ -34,17 +34,13 @@ void crypto_ctx_get_key(ESubGhzChatCryptoCtx* ctx, uint8_t* key);
 bool crypto_ctx_decrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* in, size_t in_len, uint8_t* out);
 bool crypto_ctx_encrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* in, size_t in_len, uint8_t* out);
 
-typedef bool (*CryptoCtxReplayDictWriter)(uint64_t run_id, uint32_t counter, void* context);
-typedef bool (*CryptoCtxReplayDictReader)(uint64_t* run_id, uint32_t* counter, void* context);
+/* Writes the replay state of as many senders as fit into buf, most recently
+ * heard first. Returns the number of bytes written. */
+size_t crypto_ctx_dump_replay_dict(ESubGhzChatCryptoCtx* ctx, uint8_t* buf, size_t size);
 
-size_t crypto_ctx_dump_replay_dict(
-    ESubGhzChatCryptoCtx* ctx,
-    CryptoCtxReplayDictWriter writer,
-    void* writer_ctx);
-size_t crypto_ctx_read_replay_dict(
-    ESubGhzChatCryptoCtx* ctx,
-    CryptoCtxReplayDictReader reader,
-    void* reader_ctx);
+/* Merges a dump written by crypto_ctx_dump_replay_dict() into the replay
+ * state. Returns the number of senders read. */
+size_t crypto_ctx_read_replay_dict(ESubGhzChatCryptoCtx* ctx, const uint8_t* buf, size_t size);
 
 #ifdef __cplusplus
 }
@@ -17,7 +17,7 @@ struct FreqNfcEntry {
 struct ReplayDictNfcEntry {
     uint64_t run_id;
     uint32_t counter;
-    uint32_t unused;
+    uint32_t missing; /* inverted replay window below counter, 0 if unknown */
 } __attribute__((packed));
 
 #ifdef __cplusplus
@@ -28,10 +28,22 @@ typedef struct {
     InputEvent input;
 } PluginEvent;
 
+typedef enum {
+    SamWorkerEvtStop = (1 << 0),
+    SamWorkerEvtSay = (1 << 1),
+} SamWorkerEvtFlags;
+
+#define SAM_WORKER_EVT_ALL (SamWorkerEvtStop | SamWorkerEvtSay)
+
 typedef struct {
     ViewDispatcher* view_dispatcher;
     TextInput* text_input;
     char input[TEXT_BUFFER_SIZE];
+
+    // Speech is rendered on its own thread so the text input stays responsive
+    FuriThread* worker;
+    FuriMutex* say_mutex;
+    char say_buffer[TEXT_BUFFER_SIZE];
 } AppState;
 
 AppState* app_state;
@@ -44,6 +56,26 @@ static void say_something(char* something) {
     }
 }
 
+static int32_t sam_worker(void* ctx) {
+    AppState* app_state = (AppState*)ctx;
+    char text[TEXT_BUFFER_SIZE];
+
+    while(true) {
+        uint32_t flags =
+            furi_thread_flags_wait(SAM_WORKER_EVT_ALL, FuriFlagWaitAny, FuriWaitForever);
+        furi_check((flags & FuriFlagError) == 0);
+        if(flags & SamWorkerEvtStop) break;
+
+        furi_check(furi_mutex_acquire(app_state->say_mutex, FuriWaitForever) == FuriStatusOk);
+        strlcpy(text, app_state->say_buffer, sizeof(text));
+        furi_mutex_release(app_state->say_mutex);
+
+        say_something(text);
+    }
+
+    return 0;
+}
+
 static void text_input_callback(void* ctx) {
     AppState* app_state = (AppState*)ctx;
     //FURI_LOG_D(TAG, "Input text: %s", app_state->input);
@@ -55,7 +87,10 @@ static void text_input_callback(void* ctx) {
         }
     }
 
-    say_something(app_state->input);
+    furi_check(furi_mutex_acquire(app_state->say_mutex, FuriWaitForever) == FuriStatusOk);
+    strlcpy(app_state->say_buffer, app_state->input, sizeof(app_state->say_buffer));
+    furi_mutex_release(app_state->say_mutex);
+    furi_thread_flags_set(furi_thread_get_id(app_state->worker), SamWorkerEvtSay);
 }
 
 static bool back_event_callback(void* ctx) {
@@ -67,9 +102,20 @@ static bool back_event_callback(void* ctx) {
 static void sam_state_init(AppState* const app_state) {
     app_state->view_dispatcher = view_dispatcher_alloc();
     app_state->text_input = text_input_alloc();
+
+    app_state->say_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    app_state->worker = furi_thread_alloc_ex("SamWorker", 4096, sam_worker, app_state);
+    furi_thread_start(app_state->worker);
 }
 
 static void sam_state_free(AppState* const app_state) {
+    // Keep the worker from taking another text, cut off the one playing and wait for it
+    furi_thread_flags_set(furi_thread_get_id(app_state->worker), SamWorkerEvtStop);
+    voice.stop();
+    furi_thread_join(app_state->worker);
+    furi_thread_free(app_state->worker);
+    furi_mutex_free(app_state->say_mutex);
+
     text_input_free(app_state->text_input);
     view_dispatcher_remove_view(app_state->view_dispatcher, 0);
     view_dispatcher_free(app_state->view_dispatcher);
@@ -2435,8 +2435,7 @@ void STM32SAM::Output8BitAry(int index, unsigned char ary[5]) {
         // while(micros() < f) {
         // };
         f = sample_uS / (_STM32SAM_SPEED + 1);
-        furi_delay_us(f);
-        SetAUDIO(ary[k]);
+        PutSample(ary[k], f);
         //  delayMicroseconds(sample_uS / 5 );
     }
 
@@ -3551,7 +3550,9 @@ int STM32SAM::SAMMain() {
 
     //mem[40158] = 255;
 
+    PlaybackStart();
     PrepareOutput();
+    PlaybackStop();
 
     return 1;
 }
@@ -5259,6 +5260,9 @@ STM32SAM::STM32SAM(uint32_t STM32SAM_SPEED /* = 5 */) {
     mem59 = 0;
 
     oldtimetableindex = 0;
+
+    sample_time = 0;
+    stopping = false;
 }
 
 STM32SAM::STM32SAM() {
@@ -5280,6 +5284,9 @@ STM32SAM::STM32SAM() {
     mem59 = 0;
 
     oldtimetableindex = 0;
+
+    sample_time = 0;
+    stopping = false;
 }
 
 /*
@@ -5330,6 +5337,9 @@ void STM32SAM::sam(
     unsigned char _speed,
     unsigned char _mouth,
     unsigned char _throat) {
+    // a new utterance, stop() from here on cuts it off even before playback starts
+    stopping = false;
+
     phonetic = _phonetic;
     singmode = _singmode;
     pitch = _pitch;
@@ -5381,6 +5391,9 @@ void STM32SAM::sam(
     unsigned char _speed,
     unsigned char _mouth,
     unsigned char _throat) {
+    // a new utterance, stop() from here on cuts it off even before playback starts
+    stopping = false;
+
     phonetic = _phonetic;
     singmode = _singmode;
     pitch = _pitch;
@@ -5625,12 +5638,111 @@ void STM32SAM::setThroat(unsigned char _throat /* = 128 */) {
 //
 // Set PA8 pin as PWM, at 256 timer ticks overflow (8bit resolution)
 
+// Samples are not written to the timer directly while rendering. Render() fills a ring
+// buffer at its own pace, DMA moves samples from a double buffer into the PWM compare
+// register at a fixed rate, and the DMA interrupt refills the half just played from the
+// ring. Rendering only waits when the ring is full, so pitch no longer depends on how
+// long rendering takes.
+
 #include <math.h>
+
+#define SAM_SAMPLE_RATE 44100
+#define SAM_STAGE_SAMPLES 64
+#define SAM_PWM_IDLE 127
+
+static uint8_t sam_pwm_curve[256]; // SAM output level to PWM compare value
+static uint8_t sam_stage[SAM_STAGE_SAMPLES];
+static size_t sam_stage_len;
+
+static void sam_pwm_curve_init(void) {
+    // soft clipping used to be computed for every sample, now it is looked up
+    for(int i = 0; i < 256; i++) {
+        float data = i;
+        data /= 255.0f;
+        data -= 0.5f;
+        data *= 4.0f;
+        data = tanhf(data);
+
+        data += 0.5f;
+        data *= 255.0f;
+
+        if(data < 0) {
+            data = 0;
+        } else if(data > 255) {
+            data = 255;
+        }
+        sam_pwm_curve[i] = (uint8_t)data;
+    }
+}
+
+#ifdef SAM_HOST
+
+// Host build (see test/) hands the fixed rate output to the caller instead of the speaker
+extern void sam_host_write(const uint8_t* samples, size_t len);
+
+void STM32SAM::begin(void) {
+    sam_pwm_curve_init();
+}
+
+void STM32SAM::stop(void) {
+    stopping = true;
+}
+
+void STM32SAM::PlaybackStart() {
+    sample_time = 0;
+    sam_stage_len = 0;
+}
+
+void STM32SAM::PlaybackStop() {
+    FlushSamples();
+}
+
+void STM32SAM::FlushSamples() {
+    if(sam_stage_len > 0 && !stopping) {
+        sam_host_write(sam_stage, sam_stage_len);
+    }
+    sam_stage_len = 0;
+}
+
+#else
+
+#include <furi_hal.h>
 #include <stm32wbxx_ll_tim.h>
+#include <stm32wbxx_ll_dma.h>
 
 #define FURI_HAL_SPEAKER_TIMER TIM16
 #define FURI_HAL_SPEAKER_CHANNEL LL_TIM_CHANNEL_CH1
 
+#define SAM_SAMPLE_RATE_TIMER TIM2
+#define SAM_DMA_INSTANCE DMA1, LL_DMA_CHANNEL_1
+#define SAM_DMA_SAMPLES 512 // two halves, each refilled while the other one plays
+#define SAM_RING_SAMPLES 4096 // how far rendering may run ahead of playback
+
+static uint8_t sam_dma_buffer[SAM_DMA_SAMPLES];
+static FuriStreamBuffer* sam_ring;
+
+static void sam_dma_fill(uint8_t* half) {
+    size_t len = furi_stream_buffer_receive(sam_ring, half, SAM_DMA_SAMPLES / 2, 0);
+    if(len < SAM_DMA_SAMPLES / 2) {
+        // underrun or end of utterance, hold the speaker at rest
+        memset(half + len, SAM_PWM_IDLE, SAM_DMA_SAMPLES / 2 - len);
+    }
+}
+
+static void sam_dma_isr(void* ctx) {
+    UNUSED(ctx);
+
+    if(LL_DMA_IsActiveFlag_HT1(DMA1)) {
+        LL_DMA_ClearFlag_HT1(DMA1);
+        sam_dma_fill(sam_dma_buffer);
+    }
+
+    if(LL_DMA_IsActiveFlag_TC1(DMA1)) {
+        LL_DMA_ClearFlag_TC1(DMA1);
+        sam_dma_fill(sam_dma_buffer + SAM_DMA_SAMPLES / 2);
+    }
+}
+
 void STM32SAM::begin(void) {
 #ifdef USE_ROGER_CORE
 
@@ -5667,37 +5779,94 @@ void STM32SAM::begin(void) {
 
     LL_TIM_EnableAllOutputs(FURI_HAL_SPEAKER_TIMER);
     LL_TIM_EnableCounter(FURI_HAL_SPEAKER_TIMER);
+
+    sam_pwm_curve_init();
+
+    if(sam_ring == NULL) {
+        sam_ring = furi_stream_buffer_alloc(SAM_RING_SAMPLES, SAM_STAGE_SAMPLES);
+    }
 } // begin
 
-inline void STM32SAM::SetAUDIO(unsigned char main_volume) {
-#ifdef USE_ROGER_CORE
-    Timer1.setCompare(TIMER_CH1, main_volume);
-#endif
+void STM32SAM::stop(void) {
+    stopping = true;
+}
 
-#ifdef USE_STM32duino_CORE
-    PWM->setCaptureCompare(1, main_volume, TICK_COMPARE_FORMAT);
-#endif
+void STM32SAM::PlaybackStart() {
+    sample_time = 0;
+    sam_stage_len = 0;
+    furi_stream_buffer_reset(sam_ring);
+    memset(sam_dma_buffer, SAM_PWM_IDLE, sizeof(sam_dma_buffer));
+
+    furi_hal_bus_enable(FuriHalBusTIM2);
 
-    // if(main_volume > 64) {
-    //     LL_TIM_OC_SetCompareCH1(FURI_HAL_SPEAKER_TIMER, 127);
-    // } else {
-    //     LL_TIM_OC_SetCompareCH1(FURI_HAL_SPEAKER_TIMER, main_volume);
-    // }
-
-    float data = main_volume;
-    data /= 255.0f;
-    data -= 0.5f;
-    data *= 4.0f;
-    data = tanhf(data);
-
-    data += 0.5f;
-    data *= 255.0f;
-
-    if(data < 0) {
-        data = 0;
-    } else if(data > 255) {
-        data = 255;
+    LL_TIM_InitTypeDef TIM_InitStruct;
+    memset(&TIM_InitStruct, 0, sizeof(LL_TIM_InitTypeDef));
+    TIM_InitStruct.Prescaler = 0;
+    TIM_InitStruct.Autoreload = SystemCoreClock / SAM_SAMPLE_RATE - 1;
+    LL_TIM_Init(SAM_SAMPLE_RATE_TIMER, &TIM_InitStruct);
+
+    uint32_t dma_dst = (uint32_t) & (FURI_HAL_SPEAKER_TIMER->CCR1);
+    LL_DMA_ConfigAddresses(
+        SAM_DMA_INSTANCE, (uint32_t)sam_dma_buffer, dma_dst, LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+    LL_DMA_SetDataLength(SAM_DMA_INSTANCE, SAM_DMA_SAMPLES);
+    LL_DMA_SetPeriphRequest(SAM_DMA_INSTANCE, LL_DMAMUX_REQ_TIM2_UP);
+    LL_DMA_SetDataTransferDirection(SAM_DMA_INSTANCE, LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+    LL_DMA_SetChannelPriorityLevel(SAM_DMA_INSTANCE, LL_DMA_PRIORITY_VERYHIGH);
+    LL_DMA_SetMode(SAM_DMA_INSTANCE, LL_DMA_MODE_CIRCULAR);
+    LL_DMA_SetPeriphIncMode(SAM_DMA_INSTANCE, LL_DMA_PERIPH_NOINCREMENT);
+    LL_DMA_SetMemoryIncMode(SAM_DMA_INSTANCE, LL_DMA_MEMORY_INCREMENT);
+    LL_DMA_SetPeriphSize(SAM_DMA_INSTANCE, LL_DMA_PDATAALIGN_HALFWORD);
+    LL_DMA_SetMemorySize(SAM_DMA_INSTANCE, LL_DMA_MDATAALIGN_BYTE);
+    LL_DMA_EnableIT_TC(SAM_DMA_INSTANCE);
+    LL_DMA_EnableIT_HT(SAM_DMA_INSTANCE);
+
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdDma1Ch1, sam_dma_isr, NULL);
+
+    LL_DMA_EnableChannel(SAM_DMA_INSTANCE);
+    LL_TIM_EnableDMAReq_UPDATE(SAM_SAMPLE_RATE_TIMER);
+    LL_TIM_EnableCounter(SAM_SAMPLE_RATE_TIMER);
+}
+
+void STM32SAM::PlaybackStop() {
+    FlushSamples();
+
+    // let the ring and both DMA halves play out
+    while(!stopping && !furi_stream_buffer_is_empty(sam_ring)) {
+        furi_delay_ms(1);
+    }
+    if(!stopping) {
+        furi_delay_ms(SAM_DMA_SAMPLES * 1000 / SAM_SAMPLE_RATE + 1);
     }
 
-    LL_TIM_OC_SetCompareCH1(FURI_HAL_SPEAKER_TIMER, data);
-}
\ No newline at end of file
+    LL_TIM_DisableCounter(SAM_SAMPLE_RATE_TIMER);
+    LL_TIM_DisableDMAReq_UPDATE(SAM_SAMPLE_RATE_TIMER);
+    LL_DMA_DisableChannel(SAM_DMA_INSTANCE);
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdDma1Ch1, NULL, NULL);
+    furi_hal_bus_disable(FuriHalBusTIM2);
+
+    LL_TIM_OC_SetCompareCH1(FURI_HAL_SPEAKER_TIMER, SAM_PWM_IDLE);
+}
+
+void STM32SAM::FlushSamples() {
+    if(sam_stage_len > 0 && !stopping) {
+        furi_stream_buffer_send(sam_ring, sam_stage, sam_stage_len, FuriWaitForever);
+    }
+    sam_stage_len = 0;
+}
+
+#endif // SAM_HOST
+
+// Holds the level for duration_us at the fixed output rate. Whole output samples
+// are emitted, the remainder carries over so the average timing stays exact.
+void STM32SAM::PutSample(unsigned char main_volume, uint32_t duration_us) {
+    uint8_t level = sam_pwm_curve[main_volume];
+
+    sample_time += duration_us * SAM_SAMPLE_RATE;
+    while(sample_time >= 1000000) {
+        sample_time -= 1000000;
+        sam_stage[sam_stage_len++] = level;
+        if(sam_stage_len == SAM_STAGE_SAMPLES) {
+            FlushSamples();
+        }
+    }
+}
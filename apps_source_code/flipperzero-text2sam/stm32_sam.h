@@ -47,8 +47,14 @@ public:
     void setMouth(unsigned char _mouth = 128);
     void setThroat(unsigned char _throat = 128);
 
+    // Cuts the utterance being spoken short, safe to call from another thread
+    void stop(void);
+
 private:
-    void SetAUDIO(unsigned char main_volume);
+    void PutSample(unsigned char main_volume, uint32_t duration_us);
+    void FlushSamples();
+    void PlaybackStart();
+    void PlaybackStop();
 
     void Output8BitAry(int index, unsigned char ary[5]);
     void Output8Bit(int index, unsigned char A);
@@ -83,6 +89,9 @@ private:
 
     uint32_t _STM32SAM_SPEED;
 
+    uint32_t sample_time; // output sample time owed, in us * SAM_SAMPLE_RATE
+    volatile bool stopping;
+
     unsigned char speed;
     unsigned char pitch;
     unsigned char mouth;
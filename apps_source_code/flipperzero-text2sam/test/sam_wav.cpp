@@ -0,0 +1,81 @@
+// Host render of an utterance to a .wav file, see test/Makefile. Not part of the FAP.
+//
+// stm32_sam.cpp is built with SAM_HOST, so Render() goes through the same fixed rate
+// PutSample() as on the Flipper and the samples that would reach the PWM compare register
+// are written out as 8 bit unsigned mono PCM.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../stm32_sam.h"
+
+#define SAM_WAV_RATE 44100
+
+static FILE* wav_file;
+static uint32_t wav_samples;
+
+void sam_host_write(const uint8_t* samples, size_t len) {
+    fwrite(samples, 1, len, wav_file);
+    wav_samples += len;
+}
+
+static void wav_put32(uint8_t* p, uint32_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+static void wav_header(uint8_t* h, uint32_t samples) {
+    memcpy(h, "RIFF\0\0\0\0WAVEfmt ", 16);
+    wav_put32(h + 4, 36 + samples);
+    wav_put32(h + 16, 16); // fmt chunk size
+    wav_put32(h + 20, 1 | (1 << 16)); // PCM, mono
+    wav_put32(h + 24, SAM_WAV_RATE);
+    wav_put32(h + 28, SAM_WAV_RATE); // byte rate
+    wav_put32(h + 32, 1 | (8 << 16)); // block align, bits per sample
+    memcpy(h + 36, "data", 4);
+    wav_put32(h + 40, samples);
+}
+
+int main(int argc, char** argv) {
+    if(argc < 3) {
+        fprintf(stderr, "usage: %s \"text\" out.wav [pitch speed mouth throat]\n", argv[0]);
+        return 2;
+    }
+
+    wav_file = fopen(argv[2], "wb");
+    if(!wav_file) {
+        perror(argv[2]);
+        return 1;
+    }
+
+    uint8_t header[44] = {0};
+    fwrite(header, 1, sizeof(header), wav_file);
+
+    static STM32SAM voice;
+    voice.begin();
+    if(argc >= 7) {
+        voice.setVoice(atoi(argv[3]), atoi(argv[4]), atoi(argv[5]), atoi(argv[6]));
+    }
+
+    clock_t start = clock();
+    voice.say(argv[1]);
+    double render_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    wav_header(header, wav_samples);
+    fseek(wav_file, 0, SEEK_SET);
+    fwrite(header, 1, sizeof(header), wav_file);
+    fclose(wav_file);
+
+    double audio_s = (double)wav_samples / SAM_WAV_RATE;
+    printf(
+        "%s: %u samples, %.2f s of audio rendered in %.3f s\n",
+        argv[2],
+        (unsigned)wav_samples,
+        audio_s,
+        render_s);
+
+    return wav_samples > 0 ? 0 : 1;
+}
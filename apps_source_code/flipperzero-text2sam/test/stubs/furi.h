@@ -0,0 +1,10 @@
+#pragma once
+
+// Just enough of furi.h for the renderer, the host build replaces the speaker output
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNUSED(x) (void)(x)
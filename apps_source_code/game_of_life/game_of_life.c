@@ -3,10 +3,19 @@
 
 #include <input/input.h>
 #include <stdlib.h>
+#include <stdio.h>
 
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
-#define TOTAL_PIXELS SCREEN_WIDTH* SCREEN_HEIGHT
+
+#define FRAME_ROW_BYTES (SCREEN_WIDTH / 8)
+#define WORD_BITS 32
+#define PAN_STEP 8
+#define TICK_MS 25
+#define REVIVE_PERCENT 1
+// Generation with fewer changed cells than cells / REVIVE_ACTIVITY is considered stagnant
+#define REVIVE_ACTIVITY 128
+#define ROW_NONE -1
 
 typedef enum {
     EventTypeTick,
@@ -18,73 +27,239 @@ typedef struct {
     InputEvent input;
 } AppEvent;
 
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    bool wrap; // Toroidal world, otherwise cells beyond the edges are dead
+} WorldSize;
+
+static const WorldSize world_sizes[] = {
+    {SCREEN_WIDTH, SCREEN_HEIGHT, false},
+    {256, 128, true},
+    {512, 256, true},
+};
+
+#define WORLD_SIZES_COUNT (sizeof(world_sizes) / sizeof(world_sizes[0]))
+
+// Board is 1 bit per cell, row after row of 32-bit words. Bit n of a word is cell n of the
+// word, so on little endian the row bytes are already in XBM order.
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint16_t words; // Words per row
+    bool wrap;
+    uint32_t* cells[2];
+    int current;
+    // dirty[y] is set when row y of the current generation may differ from the previous one
+    uint8_t* dirty;
+    uint8_t* next_dirty;
+} World;
+
 typedef struct {
     bool revive;
-    int evo;
+    int evo; // Cells changed by the last generation
     FuriMutex* mutex;
+
+    World world;
+    size_t world_size;
+    uint16_t view_x;
+    uint16_t view_y;
+
+    bool benchmark;
+    uint32_t generations;
+    uint32_t bench_generations;
+    uint32_t bench_tick;
+    uint32_t gens_per_sec;
+
+    uint8_t frame[FRAME_ROW_BYTES * SCREEN_HEIGHT];
 } State;
 
-unsigned char new[TOTAL_PIXELS] = {};
-unsigned char old[TOTAL_PIXELS] = {};
-unsigned char* fields[] = {new, old};
+static uint32_t* world_row(const World* world, int index, int y) {
+    return &world->cells[index][y * world->words];
+}
+
+static int world_row_above(const World* world, int y) {
+    if(y > 0) return y - 1;
+    return world->wrap ? world->height - 1 : ROW_NONE;
+}
+
+static int world_row_below(const World* world, int y) {
+    if(y + 1 < world->height) return y + 1;
+    return world->wrap ? 0 : ROW_NONE;
+}
 
-int current = 0;
-int next = 1;
+static void world_free(World* world) {
+    free(world->cells[0]);
+    free(world->cells[1]);
+    free(world->dirty);
+    free(world->next_dirty);
+    memset(world, 0, sizeof(World));
+}
 
-unsigned char get_cell(int x, int y) {
-    if(x <= 0 || x >= SCREEN_WIDTH) return 0;
-    if(y <= 0 || y >= SCREEN_HEIGHT) return 0;
+static bool world_alloc(World* world, const WorldSize* size) {
+    size_t board_size = size->width / 8 * size->height;
+    // furi malloc does not return on failure, so check that both boards fit first
+    if(board_size * 2 + size->height * 2 > memmgr_heap_get_max_free_block()) {
+        return false;
+    }
 
-    int pix = (y * SCREEN_WIDTH) + x;
-    return fields[current][pix];
+    world->width = size->width;
+    world->height = size->height;
+    world->words = size->width / WORD_BITS;
+    world->wrap = size->wrap;
+    world->cells[0] = malloc(board_size);
+    world->cells[1] = malloc(board_size);
+    memset(world->cells[0], 0, board_size);
+    memset(world->cells[1], 0, board_size);
+    world->current = 0;
+    world->dirty = malloc(world->height);
+    world->next_dirty = malloc(world->height);
+    memset(world->dirty, 0, world->height);
+    memset(world->next_dirty, 0, world->height);
+    return true;
 }
 
-int count_neightbors(int x, int y) {
-    return get_cell(x + 1, y - 1) + get_cell(x - 1, y - 1) + get_cell(x - 1, y + 1) +
-           get_cell(x + 1, y + 1) + get_cell(x + 1, y) + get_cell(x - 1, y) + get_cell(x, y - 1) +
-           get_cell(x, y + 1);
+static void world_set_cell(World* world, int x, int y) {
+    world_row(world, world->current, y)[x / WORD_BITS] |= 1UL << (x % WORD_BITS);
+    // Previous generation row is stale now, make sure the row gets recomputed
+    world->dirty[y] = true;
 }
 
-static void update_field(State* state) {
-    if(state->revive) {
-        for(int i = 0; i < TOTAL_PIXELS; ++i) {
-            if((random() % 100) == 1) {
-                fields[current][i] = 1;
-            }
-            state->revive = false;
-        }
+static void world_seed(World* world) {
+    uint32_t cells = (uint32_t)world->width * world->height;
+    for(uint32_t i = 0; i < cells * REVIVE_PERCENT / 100; i++) {
+        world_set_cell(world, random() % world->width, random() % world->height);
+    }
+}
+
+// Left, center and right neighbours of the cells in word i of a row, aligned to their cells
+static inline void world_row_neighbours(
+    const World* world,
+    const uint32_t* row,
+    int i,
+    uint32_t* left,
+    uint32_t* center,
+    uint32_t* right) {
+    if(!row) {
+        *left = *center = *right = 0;
+        return;
+    }
+
+    uint32_t prev = 0;
+    uint32_t next = 0;
+    if(i > 0) {
+        prev = row[i - 1];
+    } else if(world->wrap) {
+        prev = row[world->words - 1];
     }
+    if(i + 1 < world->words) {
+        next = row[i + 1];
+    } else if(world->wrap) {
+        next = row[0];
+    }
+
+    *center = row[i];
+    *left = (row[i] << 1) | (prev >> (WORD_BITS - 1));
+    *right = (row[i] >> 1) | (next << (WORD_BITS - 1));
+}
+
+// Adds one neighbour bit plane to the bit sliced counters, s2 sticks once count reaches 4
+static inline void life_add(uint32_t plane, uint32_t* s0, uint32_t* s1, uint32_t* s2) {
+    uint32_t carry0 = *s0 & plane;
+    *s0 ^= plane;
+    uint32_t carry1 = *s1 & carry0;
+    *s1 ^= carry0;
+    *s2 |= carry1;
+}
+
+// Computes next generation 32 cells at a time, returns number of changed cells
+static uint32_t world_step(World* world) {
+    int next = world->current ^ 1;
+    uint32_t changed = 0;
+
+    for(int y = 0; y < world->height; y++) {
+        int above = world_row_above(world, y);
+        int below = world_row_below(world, y);
+        bool dirty = world->dirty[y] || (above != ROW_NONE && world->dirty[above]) ||
+                     (below != ROW_NONE && world->dirty[below]);
+        // Neighbourhood did not change, so the row did not either and the other buffer
+        // already holds the same row from the previous generation
+        if(!dirty) {
+            world->next_dirty[y] = false;
+            continue;
+        }
 
-    for(int i = 0; i < TOTAL_PIXELS; ++i) {
-        int x = i % SCREEN_WIDTH;
-        int y = (int)(i / SCREEN_WIDTH);
-
-        int v = get_cell(x, y);
-        int n = count_neightbors(x, y);
-
-        if(v && n == 3) {
-            ++state->evo;
-        } else if(v && (n < 2 || n > 3)) {
-            ++state->evo;
-            v = 0;
-        } else if(!v && n == 3) {
-            ++state->evo;
-            v = 1;
+        const uint32_t* row_above = above != ROW_NONE ? world_row(world, world->current, above) :
+                                                        NULL;
+        const uint32_t* row_below = below != ROW_NONE ? world_row(world, world->current, below) :
+                                                        NULL;
+        const uint32_t* row = world_row(world, world->current, y);
+        uint32_t* out = world_row(world, next, y);
+        uint32_t row_changed = 0;
+
+        for(int i = 0; i < world->words; i++) {
+            uint32_t left, center, right;
+            uint32_t s0 = 0, s1 = 0, s2 = 0;
+
+            world_row_neighbours(world, row_above, i, &left, &center, &right);
+            life_add(left, &s0, &s1, &s2);
+            life_add(center, &s0, &s1, &s2);
+            life_add(right, &s0, &s1, &s2);
+            world_row_neighbours(world, row_below, i, &left, &center, &right);
+            life_add(left, &s0, &s1, &s2);
+            life_add(center, &s0, &s1, &s2);
+            life_add(right, &s0, &s1, &s2);
+            world_row_neighbours(world, row, i, &left, &center, &right);
+            life_add(left, &s0, &s1, &s2);
+            life_add(right, &s0, &s1, &s2);
+
+            // Alive with 3 neighbours, or with 2 if the cell already was alive
+            uint32_t cell = s1 & ~s2 & (s0 | center);
+            row_changed += __builtin_popcount(cell ^ center);
+            out[i] = cell;
         }
 
-        fields[next][i] = v;
+        world->next_dirty[y] = row_changed > 0;
+        changed += row_changed;
+    }
+
+    uint8_t* dirty = world->dirty;
+    world->dirty = world->next_dirty;
+    world->next_dirty = dirty;
+    world->current = next;
+    return changed;
+}
+
+static void update_field(State* state) {
+    World* world = &state->world;
+
+    if(state->revive) {
+        world_seed(world);
+        state->revive = false;
     }
 
-    next ^= current;
-    current ^= next;
-    next ^= current;
+    state->evo = world_step(world);
+    state->generations++;
 
-    if(state->evo < TOTAL_PIXELS) {
+    if(state->evo < (int)((uint32_t)world->width * world->height / REVIVE_ACTIVITY)) {
         state->revive = true;
-        state->evo = 0;
     }
 }
 
+static void set_world_size(State* state, size_t size) {
+    world_free(&state->world);
+    if(!world_alloc(&state->world, &world_sizes[size])) {
+        FURI_LOG_W("GameOfLife", "Not enough memory for %ux%u world", world_sizes[size].width,
+                   world_sizes[size].height);
+        size = 0;
+        furi_check(world_alloc(&state->world, &world_sizes[size]));
+    }
+    state->world_size = size;
+    state->view_x = 0;
+    state->view_y = 0;
+    state->revive = true;
+}
+
 static void input_callback(InputEvent* input_event, void* ctx) {
     furi_assert(ctx);
     FuriMessageQueue* event_queue = ctx;
@@ -100,22 +275,75 @@ static void render_callback(Canvas* canvas, void* ctx) {
 
     canvas_clear(canvas);
 
-    for(int i = 0; i < TOTAL_PIXELS; ++i) {
-        int x = i % SCREEN_WIDTH;
-        int y = (int)(i / SCREEN_WIDTH);
-        if(fields[current][i] == 1) canvas_draw_dot(canvas, x, y);
+    // Viewport is byte aligned, so every screen row is at most two copies from the board
+    const World* world = &state->world;
+    size_t row_bytes = world->width / 8;
+    size_t view_byte = state->view_x / 8;
+    size_t first = MIN(row_bytes - view_byte, (size_t)FRAME_ROW_BYTES);
+    for(int y = 0; y < SCREEN_HEIGHT; y++) {
+        const uint8_t* row = (const uint8_t*)world_row(
+            world, world->current, (state->view_y + y) % world->height);
+        uint8_t* dst = &state->frame[y * FRAME_ROW_BYTES];
+        memcpy(dst, &row[view_byte], first);
+        memcpy(&dst[first], row, FRAME_ROW_BYTES - first);
+    }
+    canvas_draw_xbm(canvas, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, state->frame);
+
+    if(state->benchmark) {
+        char buffer[24];
+        snprintf(
+            buffer,
+            sizeof(buffer),
+            "%lu gen/s %ux%u",
+            state->gens_per_sec,
+            world->width,
+            world->height);
+        canvas_set_font(canvas, FontSecondary);
+        canvas_set_color(canvas, ColorWhite);
+        canvas_draw_box(canvas, 0, 0, canvas_string_width(canvas, buffer) + 2, 10);
+        canvas_set_color(canvas, ColorBlack);
+        canvas_draw_str(canvas, 1, 8, buffer);
     }
     furi_mutex_release(state->mutex);
 }
 
+static void handle_key(State* state, InputEvent* input) {
+    const World* world = &state->world;
+
+    if(input->key == InputKeyOk && input->type == InputTypeShort) {
+        // Benchmark runs generations back to back and shows the rate
+        state->benchmark = !state->benchmark;
+        state->bench_generations = state->generations;
+        state->bench_tick = furi_get_tick();
+        state->gens_per_sec = 0;
+    } else if(input->key == InputKeyOk && input->type == InputTypeLong) {
+        set_world_size(state, (state->world_size + 1) % WORLD_SIZES_COUNT);
+    } else if(input->type == InputTypePress || input->type == InputTypeRepeat) {
+        // Viewport pans around toroidal worlds larger than the screen, a screen sized
+        // world has hard edges and would be shown wrapped around
+        bool pan_x = world->width > SCREEN_WIDTH;
+        bool pan_y = world->height > SCREEN_HEIGHT;
+        if(input->key == InputKeyLeft && pan_x) {
+            state->view_x = (state->view_x + world->width - PAN_STEP) % world->width;
+        } else if(input->key == InputKeyRight && pan_x) {
+            state->view_x = (state->view_x + PAN_STEP) % world->width;
+        } else if(input->key == InputKeyUp && pan_y) {
+            state->view_y = (state->view_y + world->height - PAN_STEP) % world->height;
+        } else if(input->key == InputKeyDown && pan_y) {
+            state->view_y = (state->view_y + PAN_STEP) % world->height;
+        }
+    }
+}
+
 int32_t game_of_life_app(void* p) {
     UNUSED(p);
     srand(DWT->CYCCNT);
 
-    FuriMessageQueue* event_queue = furi_message_queue_alloc(1, sizeof(AppEvent));
+    FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(AppEvent));
     furi_check(event_queue);
 
     State* _state = malloc(sizeof(State));
+    memset(_state, 0, sizeof(State));
 
     _state->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     if(!_state->mutex) {
@@ -124,6 +352,7 @@ int32_t game_of_life_app(void* p) {
         free(_state);
         return 255;
     }
+    set_world_size(_state, 0);
 
     ViewPort* view_port = view_port_alloc();
     view_port_draw_callback_set(view_port, render_callback, _state);
@@ -134,23 +363,36 @@ int32_t game_of_life_app(void* p) {
 
     AppEvent event;
     for(bool processing = true; processing;) {
-        FuriStatus event_status = furi_message_queue_get(event_queue, &event, 25);
+        FuriStatus event_status =
+            furi_message_queue_get(event_queue, &event, _state->benchmark ? 0 : TICK_MS);
         furi_mutex_acquire(_state->mutex, FuriWaitForever);
 
-        if(event_status == FuriStatusOk && event.type == EventTypeKey &&
-           event.input.type == InputTypePress) {
-            if(event.input.key == InputKeyBack) {
+        if(event_status == FuriStatusOk && event.type == EventTypeKey) {
+            if(event.input.key == InputKeyBack && event.input.type == InputTypePress) {
                 // furiac_exit(NULL);
                 processing = false;
                 furi_mutex_release(_state->mutex);
                 break;
             }
+            handle_key(_state, &event.input);
         }
 
         update_field(_state);
 
+        if(_state->benchmark) {
+            uint32_t elapsed = furi_get_tick() - _state->bench_tick;
+            if(elapsed >= furi_ms_to_ticks(1000)) {
+                _state->gens_per_sec = (_state->generations - _state->bench_generations) *
+                                       furi_ms_to_ticks(1000) / elapsed;
+                _state->bench_generations = _state->generations;
+                _state->bench_tick += elapsed;
+            }
+        }
+
         furi_mutex_release(_state->mutex);
         view_port_update(view_port);
+        // Queue is not waited on in benchmark, let the GUI thread draw in between
+        if(_state->benchmark) furi_thread_yield();
     }
 
     view_port_enabled_set(view_port, false);
@@ -159,7 +401,8 @@ int32_t game_of_life_app(void* p) {
     view_port_free(view_port);
     furi_message_queue_free(event_queue);
     furi_mutex_free(_state->mutex);
+    world_free(&_state->world);
     free(_state);
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,326 @@
+#include "hex_editor_buffer.h"
+
+#define TAG "HexEditorBuffer"
+
+#define HEX_EDITOR_NO_BLOCK UINT32_MAX
+// add_start of pieces that still point to the file itself
+#define HEX_EDITOR_PIECE_FILE UINT32_MAX
+
+// Edits only overwrite bytes, so pieces never move and keep absolute offsets.
+// Pieces are sorted and cover the whole file without gaps.
+typedef struct {
+    uint32_t offset;
+    uint32_t length;
+    uint32_t add_start;
+} HexEditorPiece;
+
+// Pieces [index, index + new_count) replaced old pieces, undo puts those back
+typedef struct {
+    uint32_t offset; // Edited byte
+    uint32_t index;
+    uint32_t add_len;
+    uint8_t old_count;
+    uint8_t new_count;
+    HexEditorPiece old[2];
+} HexEditorUndo;
+
+typedef struct {
+    uint32_t offset; // Block aligned file offset, HEX_EDITOR_NO_BLOCK if empty
+    uint32_t size;
+    uint32_t last_used;
+    uint8_t data[HEX_EDITOR_BLOCK_SIZE];
+} HexEditorBlock;
+
+struct HexEditorBuffer {
+    Stream* stream;
+    uint32_t file_size;
+
+    HexEditorPiece* pieces;
+    uint32_t pieces_count;
+    uint32_t pieces_capacity;
+
+    uint8_t* add;
+    uint32_t add_len;
+    uint32_t add_capacity;
+
+    HexEditorUndo undo[HEX_EDITOR_UNDO_DEPTH];
+    uint32_t undo_head; // Next free slot
+    uint32_t undo_count;
+
+    uint32_t use_counter;
+    HexEditorBlock blocks[HEX_EDITOR_BLOCKS];
+};
+
+static void hex_editor_buffer_reset(HexEditorBuffer* buffer) {
+    buffer->pieces[0].offset = 0;
+    buffer->pieces[0].length = buffer->file_size;
+    buffer->pieces[0].add_start = HEX_EDITOR_PIECE_FILE;
+    buffer->pieces_count = 1;
+    buffer->add_len = 0;
+    buffer->undo_head = 0;
+    buffer->undo_count = 0;
+}
+
+static void hex_editor_buffer_drop_blocks(HexEditorBuffer* buffer) {
+    for(size_t i = 0; i < HEX_EDITOR_BLOCKS; i++) {
+        buffer->blocks[i].offset = HEX_EDITOR_NO_BLOCK;
+        buffer->blocks[i].size = 0;
+        buffer->blocks[i].last_used = 0;
+    }
+}
+
+HexEditorBuffer* hex_editor_buffer_alloc(Stream* stream) {
+    furi_assert(stream);
+
+    HexEditorBuffer* buffer = malloc(sizeof(HexEditorBuffer));
+    buffer->stream = stream;
+    buffer->file_size = stream_size(stream);
+
+    buffer->pieces_capacity = 16;
+    buffer->pieces = malloc(buffer->pieces_capacity * sizeof(HexEditorPiece));
+    buffer->add_capacity = 64;
+    buffer->add = malloc(buffer->add_capacity);
+
+    buffer->use_counter = 0;
+    hex_editor_buffer_drop_blocks(buffer);
+    hex_editor_buffer_reset(buffer);
+
+    return buffer;
+}
+
+void hex_editor_buffer_free(HexEditorBuffer* buffer) {
+    furi_assert(buffer);
+
+    free(buffer->add);
+    free(buffer->pieces);
+    free(buffer);
+}
+
+uint32_t hex_editor_buffer_size(HexEditorBuffer* buffer) {
+    furi_assert(buffer);
+    return buffer->file_size;
+}
+
+static HexEditorBlock* hex_editor_buffer_get_block(HexEditorBuffer* buffer, uint32_t offset) {
+    uint32_t block_offset = offset - (offset % HEX_EDITOR_BLOCK_SIZE);
+
+    HexEditorBlock* block = NULL;
+    HexEditorBlock* victim = &buffer->blocks[0];
+    for(size_t i = 0; i < HEX_EDITOR_BLOCKS; i++) {
+        if(buffer->blocks[i].offset == block_offset) {
+            block = &buffer->blocks[i];
+            break;
+        }
+        if(buffer->blocks[i].last_used < victim->last_used) {
+            victim = &buffer->blocks[i];
+        }
+    }
+
+    if(!block) {
+        block = victim;
+        block->size = 0;
+        if(stream_seek(buffer->stream, block_offset, StreamOffsetFromStart)) {
+            block->size = stream_read(buffer->stream, block->data, HEX_EDITOR_BLOCK_SIZE);
+        } else {
+            FURI_LOG_E(TAG, "Unable to seek stream");
+        }
+        if(block->size == 0) {
+            // Don't cache failed reads, next access retries
+            block->offset = HEX_EDITOR_NO_BLOCK;
+            return NULL;
+        }
+        block->offset = block_offset;
+    }
+    block->last_used = ++buffer->use_counter;
+
+    return block;
+}
+
+// Index of the piece holding offset, offset must be inside the file
+static uint32_t hex_editor_buffer_find(HexEditorBuffer* buffer, uint32_t offset) {
+    uint32_t lo = 0;
+    uint32_t hi = buffer->pieces_count - 1;
+    while(lo < hi) {
+        uint32_t mid = (lo + hi + 1) / 2;
+        if(buffer->pieces[mid].offset <= offset) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+size_t hex_editor_buffer_read(HexEditorBuffer* buffer, uint32_t offset, uint8_t* buf, size_t len) {
+    furi_assert(buffer);
+    furi_assert(buf);
+
+    if(offset >= buffer->file_size) return 0;
+    len = MIN(len, buffer->file_size - offset);
+
+    size_t total = 0;
+    uint32_t index = hex_editor_buffer_find(buffer, offset);
+    while(total < len) {
+        const HexEditorPiece* piece = &buffer->pieces[index];
+        uint32_t piece_pos = offset - piece->offset;
+        size_t chunk = MIN(len - total, piece->length - piece_pos);
+
+        if(piece->add_start != HEX_EDITOR_PIECE_FILE) {
+            memcpy(&buf[total], &buffer->add[piece->add_start + piece_pos], chunk);
+        } else {
+            HexEditorBlock* block = hex_editor_buffer_get_block(buffer, offset);
+            if(!block) break;
+            uint32_t block_pos = offset - block->offset;
+            if(block_pos >= block->size) break;
+            chunk = MIN(chunk, block->size - block_pos);
+            memcpy(&buf[total], &block->data[block_pos], chunk);
+        }
+
+        total += chunk;
+        offset += chunk;
+        if(offset == piece->offset + piece->length) index++;
+    }
+
+    return total;
+}
+
+static HexEditorPiece hex_editor_piece_slice(const HexEditorPiece* piece, uint32_t skip) {
+    HexEditorPiece slice = {
+        .offset = piece->offset + skip,
+        .length = piece->length - skip,
+        .add_start = piece->add_start,
+    };
+    if(slice.add_start != HEX_EDITOR_PIECE_FILE) slice.add_start += skip;
+    return slice;
+}
+
+static void hex_editor_buffer_replace(
+    HexEditorBuffer* buffer,
+    uint32_t index,
+    uint32_t old_count,
+    const HexEditorPiece* pieces,
+    uint32_t new_count) {
+    uint32_t count = buffer->pieces_count - old_count + new_count;
+    if(count > buffer->pieces_capacity) {
+        buffer->pieces_capacity *= 2;
+        buffer->pieces = realloc(buffer->pieces, buffer->pieces_capacity * sizeof(HexEditorPiece));
+    }
+
+    memmove(
+        &buffer->pieces[index + new_count],
+        &buffer->pieces[index + old_count],
+        (buffer->pieces_count - index - old_count) * sizeof(HexEditorPiece));
+    memcpy(&buffer->pieces[index], pieces, new_count * sizeof(HexEditorPiece));
+    buffer->pieces_count = count;
+}
+
+bool hex_editor_buffer_set(HexEditorBuffer* buffer, uint32_t offset, uint8_t value) {
+    furi_assert(buffer);
+    furi_assert(offset < buffer->file_size);
+
+    uint8_t current;
+    if(hex_editor_buffer_read(buffer, offset, &current, 1) != 1 || current == value) {
+        return false;
+    }
+
+    if(buffer->add_len == buffer->add_capacity) {
+        buffer->add_capacity *= 2;
+        buffer->add = realloc(buffer->add, buffer->add_capacity);
+    }
+    uint32_t add_start = buffer->add_len;
+    buffer->add[buffer->add_len++] = value;
+
+    HexEditorUndo* undo = &buffer->undo[buffer->undo_head];
+    undo->offset = offset;
+    undo->add_len = add_start;
+
+    uint32_t index = hex_editor_buffer_find(buffer, offset);
+    const HexEditorPiece* piece = &buffer->pieces[index];
+    HexEditorPiece pieces[3];
+    uint32_t new_count = 0;
+
+    const HexEditorPiece* prev = index > 0 ? &buffer->pieces[index - 1] : NULL;
+    if(offset == piece->offset && prev && prev->add_start != HEX_EDITOR_PIECE_FILE &&
+       prev->add_start + prev->length == add_start) {
+        // Typing forward extends the previous edit instead of adding a piece per byte
+        undo->index = index - 1;
+        undo->old_count = 2;
+        undo->old[0] = *prev;
+        undo->old[1] = *piece;
+        pieces[new_count] = *prev;
+        pieces[new_count++].length++;
+    } else {
+        undo->index = index;
+        undo->old_count = 1;
+        undo->old[0] = *piece;
+        if(offset > piece->offset) {
+            pieces[new_count] = *piece;
+            pieces[new_count++].length = offset - piece->offset;
+        }
+        pieces[new_count].offset = offset;
+        pieces[new_count].length = 1;
+        pieces[new_count++].add_start = add_start;
+    }
+    if(offset + 1 < piece->offset + piece->length) {
+        pieces[new_count++] = hex_editor_piece_slice(piece, offset + 1 - piece->offset);
+    }
+    undo->new_count = new_count;
+
+    hex_editor_buffer_replace(buffer, undo->index, undo->old_count, pieces, new_count);
+
+    // Oldest edit silently falls out of history when it is full
+    buffer->undo_head = (buffer->undo_head + 1) % HEX_EDITOR_UNDO_DEPTH;
+    if(buffer->undo_count < HEX_EDITOR_UNDO_DEPTH) buffer->undo_count++;
+
+    return true;
+}
+
+bool hex_editor_buffer_undo(HexEditorBuffer* buffer, uint32_t* offset) {
+    furi_assert(buffer);
+
+    if(buffer->undo_count == 0) return false;
+
+    buffer->undo_head = (buffer->undo_head + HEX_EDITOR_UNDO_DEPTH - 1) % HEX_EDITOR_UNDO_DEPTH;
+    buffer->undo_count--;
+    const HexEditorUndo* undo = &buffer->undo[buffer->undo_head];
+
+    hex_editor_buffer_replace(buffer, undo->index, undo->new_count, undo->old, undo->old_count);
+    // Edits are undone in reverse order, so everything past add_len is unused now
+    buffer->add_len = undo->add_len;
+
+    if(offset) *offset = undo->offset;
+
+    return true;
+}
+
+bool hex_editor_buffer_is_dirty(HexEditorBuffer* buffer) {
+    furi_assert(buffer);
+    return buffer->pieces_count > 1 || buffer->pieces[0].add_start != HEX_EDITOR_PIECE_FILE;
+}
+
+bool hex_editor_buffer_save(HexEditorBuffer* buffer) {
+    furi_assert(buffer);
+
+    // Pieces keep their file offsets, so only edited ranges have to be written
+    bool success = true;
+    for(uint32_t i = 0; i < buffer->pieces_count && success; i++) {
+        const HexEditorPiece* piece = &buffer->pieces[i];
+        if(piece->add_start == HEX_EDITOR_PIECE_FILE) continue;
+
+        if(!stream_seek(buffer->stream, piece->offset, StreamOffsetFromStart)) {
+            FURI_LOG_E(TAG, "Unable to seek stream");
+            success = false;
+        } else if(
+            stream_write(buffer->stream, &buffer->add[piece->add_start], piece->length) !=
+            piece->length) {
+            FURI_LOG_E(TAG, "Unable to write stream");
+            success = false;
+        }
+    }
+
+    // Cached blocks hold bytes from before the save
+    hex_editor_buffer_drop_blocks(buffer);
+    if(success) hex_editor_buffer_reset(buffer);
+
+    return success;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <furi.h>
+#include <stream/stream.h>
+
+#define HEX_EDITOR_BLOCK_SIZE 512u
+#define HEX_EDITOR_BLOCKS 4u
+#define HEX_EDITOR_UNDO_DEPTH 64u
+
+typedef struct HexEditorBuffer HexEditorBuffer;
+
+// Byte model on top of an opened stream. The file is only read through a small
+// block cache, edits live in memory until hex_editor_buffer_save
+HexEditorBuffer* hex_editor_buffer_alloc(Stream* stream);
+void hex_editor_buffer_free(HexEditorBuffer* buffer);
+
+uint32_t hex_editor_buffer_size(HexEditorBuffer* buffer);
+
+// Reads edited contents, returns less than len only at the end of file
+size_t hex_editor_buffer_read(HexEditorBuffer* buffer, uint32_t offset, uint8_t* buf, size_t len);
+
+// Overwrites one byte, returns false if the value is already there
+bool hex_editor_buffer_set(HexEditorBuffer* buffer, uint32_t offset, uint8_t value);
+
+// Reverts the last edit, returns its offset or false when there is nothing to undo
+bool hex_editor_buffer_undo(HexEditorBuffer* buffer, uint32_t* offset);
+
+bool hex_editor_buffer_is_dirty(HexEditorBuffer* buffer);
+
+// Writes all edited ranges in one pass, clears undo history on success
+bool hex_editor_buffer_save(HexEditorBuffer* buffer);
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <ctype.h>
 #include <furi.h>
 #include <gui/gui.h>
 #include <gui/elements.h>
@@ -8,23 +9,33 @@
 
 #include <storage/storage.h>
 #include <stream/stream.h>
-#include <stream/buffered_file_stream.h>
 #include <toolbox/stream/file_stream.h>
 
 #include <hex_editor_icons.h>
 // #include <assets_icons.h>
 
+#include "helpers/hex_editor_buffer.h"
+
 #define TAG "HexEditor"
 
-#define STEP 6u
+#define HEX_EDITOR_BYTES_PER_LINE 4
+#define HEX_EDITOR_LINES_ON_SCREEN 4
+#define HEX_EDITOR_BYTES_ON_SCREEN (HEX_EDITOR_BYTES_PER_LINE * HEX_EDITOR_LINES_ON_SCREEN)
+
+#define ROW_HEIGHT 10
+#define TOP_OFFSET 8
+#define BYTES_LEFT_OFFSET 40
+#define BYTE_STEP 18
 
 typedef struct {
-    uint32_t file_offset;
+    uint32_t file_offset; // First byte on screen, always line aligned
     uint32_t file_read_bytes;
     uint32_t file_size;
-    uint8_t string_offset;
-    char editable_char;
-    Stream* stream;
+    uint32_t cursor;
+    uint8_t file_bytes[HEX_EDITOR_BYTES_ON_SCREEN];
+    uint8_t editable_char;
+    uint8_t repeat_count;
+    bool dirty;
     bool mode;
 } HexEditorModel;
 
@@ -37,55 +48,68 @@ typedef struct {
     Gui* gui;
     Storage* storage;
 
-    FuriString* buffer;
+    Stream* stream;
+    HexEditorBuffer* buffer;
 } HexEditor;
 
 static void draw_callback(Canvas* canvas, void* ctx) {
     HexEditor* hex_editor = ctx;
+    HexEditorModel* model = hex_editor->model;
 
     canvas_clear(canvas);
-    canvas_set_font(canvas, FontPrimary);
-    canvas_draw_str(canvas, 0, 10, "Line and mode:");
-
-    canvas_set_font(canvas, FontSecondary);
-
-    uint8_t com_str_offset = 0;
-    uint8_t local_offset = MAX(hex_editor->model->string_offset - 5, 0);
-    // TODO UTF ?
-    for(uint8_t i = 0; i < MIN((uint8_t)128 / STEP, furi_string_size(hex_editor->buffer)); i++) {
-        if(i + local_offset >= furi_string_size(hex_editor->buffer)) {
-            break;
+    canvas_set_font(canvas, FontKeyboard);
+
+    char temp_buf[32];
+    for(uint32_t i = 0; i * HEX_EDITOR_BYTES_PER_LINE < model->file_read_bytes; i++) {
+        uint32_t y = TOP_OFFSET + i * ROW_HEIGHT;
+        uint32_t addr = model->file_offset + i * HEX_EDITOR_BYTES_PER_LINE;
+        snprintf(temp_buf, sizeof(temp_buf), "%06lX", addr);
+        canvas_draw_str(canvas, 0, y, temp_buf);
+
+        for(uint32_t j = 0; j < HEX_EDITOR_BYTES_PER_LINE; j++) {
+            uint32_t pos = i * HEX_EDITOR_BYTES_PER_LINE + j;
+            if(pos >= model->file_read_bytes) break;
+
+            uint32_t x = BYTES_LEFT_OFFSET + j * BYTE_STEP;
+            bool selected = model->file_offset + pos == model->cursor;
+            uint8_t value = selected && model->mode ? model->editable_char :
+                                                      model->file_bytes[pos];
+            snprintf(temp_buf, sizeof(temp_buf), "%02X", value);
+            if(selected) {
+                canvas_draw_box(canvas, x - 1, y - ROW_HEIGHT + 2, BYTE_STEP - 4, ROW_HEIGHT);
+                canvas_invert_color(canvas);
+                canvas_draw_str(canvas, x, y, temp_buf);
+                canvas_invert_color(canvas);
+            } else {
+                canvas_draw_str(canvas, x, y, temp_buf);
+            }
         }
-        char a = furi_string_get_char(hex_editor->buffer, i + local_offset);
-        canvas_draw_glyph(
-            canvas, 0 + com_str_offset + (STEP - canvas_glyph_width(canvas, a)) / 2, 20, a);
-
-        com_str_offset += STEP;
     }
 
-    canvas_draw_icon(
-        canvas,
-        0 + MIN(hex_editor->model->string_offset, 5) * STEP - 4 + STEP / 2,
-        21,
-        &I_Pin_arrow_up_7x9);
+    uint32_t cursor_pos = model->cursor - model->file_offset;
+    uint8_t value = model->mode ? model->editable_char : model->file_bytes[cursor_pos];
 
-    if(hex_editor->model->mode) {
-        elements_button_left(canvas, "ASCII -");
-        elements_button_right(canvas, "ASCII +");
-        elements_button_center(canvas, "");
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(canvas, 0, 49, model->mode ? "edit" : "seek");
 
-        canvas_set_font(canvas, FontPrimary);
-        canvas_draw_str(canvas, 0, 45, "edit");
+    canvas_set_font(canvas, FontSecondary);
+    snprintf(
+        temp_buf,
+        sizeof(temp_buf),
+        "'%c' %lu/%lu%s",
+        isprint(value) ? value : '.',
+        model->cursor,
+        model->file_size - 1,
+        model->dirty ? "*" : "");
+    canvas_draw_str(canvas, 30, 49, temp_buf);
+
+    if(model->mode) {
+        elements_button_left(canvas, "-");
+        elements_button_right(canvas, "+");
+        elements_button_center(canvas, "Set");
     } else {
-        elements_button_left(canvas, "");
-        elements_button_right(canvas, "");
-        elements_button_center(canvas, "chmod");
-
-        canvas_set_font(canvas, FontPrimary);
-        canvas_draw_str(canvas, 0, 45, "seek");
+        elements_button_center(canvas, "Edit");
     }
-
-    canvas_draw_glyph(canvas, 30, 45, hex_editor->model->editable_char);
 }
 
 static void input_callback(InputEvent* input_event, void* ctx) {
@@ -102,8 +126,6 @@ static HexEditor* hex_editor_alloc() {
     instance->model = malloc(sizeof(HexEditorModel));
     memset(instance->model, 0x0, sizeof(HexEditorModel));
 
-    instance->model->editable_char = ' ';
-
     instance->input_queue = furi_message_queue_alloc(8, sizeof(InputEvent));
 
     instance->view_port = view_port_alloc();
@@ -115,26 +137,29 @@ static HexEditor* hex_editor_alloc() {
 
     instance->storage = furi_record_open(RECORD_STORAGE);
 
-    instance->buffer = furi_string_alloc();
+    instance->stream = NULL;
+    instance->buffer = NULL;
 
     return instance;
 }
 
 static void hex_editor_free(HexEditor* instance) {
-    furi_record_close(RECORD_STORAGE);
-
     gui_remove_view_port(instance->gui, instance->view_port);
     view_port_free(instance->view_port);
     furi_record_close(RECORD_GUI);
 
     furi_message_queue_free(instance->input_queue);
 
-    if(instance->model->stream) {
-        buffered_file_stream_close(instance->model->stream);
-        stream_free(instance->model->stream);
+    if(instance->buffer) {
+        hex_editor_buffer_free(instance->buffer);
     }
 
-    furi_string_free(instance->buffer);
+    if(instance->stream) {
+        file_stream_close(instance->stream);
+        stream_free(instance->stream);
+    }
+
+    furi_record_close(RECORD_STORAGE);
 
     free(instance->model);
     free(instance);
@@ -144,19 +169,77 @@ static bool hex_editor_open_file(HexEditor* hex_editor, const char* file_path) {
     furi_assert(hex_editor);
     furi_assert(file_path);
 
-    hex_editor->model->stream = buffered_file_stream_alloc(hex_editor->storage);
+    // No stream buffering, the editor buffer caches whole blocks itself
+    hex_editor->stream = file_stream_alloc(hex_editor->storage);
 
-    if(!buffered_file_stream_open(
-           hex_editor->model->stream, file_path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING)) {
+    if(!file_stream_open(hex_editor->stream, file_path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING)) {
         FURI_LOG_E(TAG, "Unable to open stream: %s", file_path);
         return false;
     };
 
-    hex_editor->model->file_size = stream_size(hex_editor->model->stream);
+    hex_editor->buffer = hex_editor_buffer_alloc(hex_editor->stream);
+    hex_editor->model->file_size = hex_editor_buffer_size(hex_editor->buffer);
 
     return true;
 }
 
+// Scrolls so the cursor stays visible and reloads bytes on screen
+static void hex_editor_update(HexEditor* hex_editor) {
+    HexEditorModel* model = hex_editor->model;
+
+    uint32_t cursor_line = model->cursor - model->cursor % HEX_EDITOR_BYTES_PER_LINE;
+    if(cursor_line < model->file_offset) {
+        model->file_offset = cursor_line;
+    } else if(cursor_line >= model->file_offset + HEX_EDITOR_BYTES_ON_SCREEN) {
+        model->file_offset =
+            cursor_line - (HEX_EDITOR_LINES_ON_SCREEN - 1) * HEX_EDITOR_BYTES_PER_LINE;
+    }
+
+    model->file_read_bytes = hex_editor_buffer_read(
+        hex_editor->buffer, model->file_offset, model->file_bytes, HEX_EDITOR_BYTES_ON_SCREEN);
+    model->dirty = hex_editor_buffer_is_dirty(hex_editor->buffer);
+}
+
+// Moves cursor by delta bytes, stops at file edges and wraps around once it is there
+static void hex_editor_move(HexEditorModel* model, int32_t delta) {
+    uint32_t last = model->file_size - 1;
+    if(delta < 0) {
+        uint32_t back = -delta;
+        if(model->cursor == 0) {
+            model->cursor = last;
+        } else {
+            model->cursor = model->cursor > back ? model->cursor - back : 0;
+        }
+    } else {
+        if(model->cursor == last) {
+            model->cursor = 0;
+        } else {
+            model->cursor = MIN(model->cursor + (uint32_t)delta, last);
+        }
+    }
+}
+
+// True if the editor may close: nothing to save, saved, or the user dropped the edits
+static bool hex_editor_save(HexEditor* hex_editor) {
+    if(!hex_editor_buffer_is_dirty(hex_editor->buffer)) return true;
+    if(hex_editor_buffer_save(hex_editor->buffer)) return true;
+
+    FURI_LOG_E(TAG, "Unable to save file");
+
+    // Edits are still in memory, stay in the editor unless they are dropped on purpose
+    DialogsApp* dialogs = furi_record_open(RECORD_DIALOGS);
+    DialogMessage* message = dialog_message_alloc();
+    dialog_message_set_header(message, "Unable to save file", 64, 2, AlignCenter, AlignTop);
+    dialog_message_set_text(
+        message, "Edits are kept.\nBack retries saving.", 64, 32, AlignCenter, AlignCenter);
+    dialog_message_set_buttons(message, "Discard", NULL, "Edit");
+    DialogMessageButton result = dialog_message_show(dialogs, message);
+    dialog_message_free(message);
+    furi_record_close(RECORD_DIALOGS);
+
+    return result == DialogMessageButtonLeft;
+}
+
 int32_t hex_editor_app(void* p) {
     UNUSED(p);
 
@@ -191,13 +274,17 @@ int32_t hex_editor_app(void* p) {
 
         if(!hex_editor_open_file(hex_editor, furi_string_get_cstr(file_path))) break;
 
-        if(!stream_read_line(hex_editor->model->stream, hex_editor->buffer)) {
-            FURI_LOG_T(TAG, "No keys left in dict");
+        HexEditorModel* model = hex_editor->model;
+        if(model->file_size == 0) {
+            FURI_LOG_I(TAG, "File is empty");
             break;
         }
 
+        hex_editor_update(hex_editor);
+        view_port_update(hex_editor->view_port);
+
         InputEvent event;
-        int8_t offset_modifier;
+        int32_t offset_modifier;
         while(1) {
             // Выбираем событие из очереди в переменную event (ждем бесконечно долго, если очередь пуста)
             // и проверяем, что у нас получилось это сделать
@@ -205,141 +292,82 @@ int32_t hex_editor_app(void* p) {
                 furi_message_queue_get(hex_editor->input_queue, &event, FuriWaitForever) ==
                 FuriStatusOk);
 
-            // Если нажата кнопка "назад", то выходим из цикла, а следовательно и из приложения
-            if(event.type == InputTypeShort || event.type == InputTypeRepeat) {
-                if(!hex_editor->model->mode) {
+            if(event.type == InputTypePress) {
+                model->repeat_count = 0;
+            }
+
+            if(event.key == InputKeyBack) {
+                if(model->mode) {
+                    // Drop the value being edited, file stays untouched
+                    if(event.type == InputTypeShort) model->mode = 0;
+                } else if(event.type == InputTypeShort) {
+                    if(hex_editor_save(hex_editor)) break;
+                } else if(event.type == InputTypeLong) {
+                    FURI_LOG_I(TAG, "Leaving without saving");
+                    break;
+                }
+            } else if(!model->mode) {
+                if(event.type == InputTypeShort || event.type == InputTypeRepeat) {
+                    // Scrolling speeds up while a key is held, so any offset is a few seconds away
                     offset_modifier = 1;
                     if(event.type == InputTypeRepeat) {
-                        offset_modifier = 3;
+                        model->repeat_count = MIN(model->repeat_count + 1, 8 * 12);
+                        offset_modifier = 1 << (model->repeat_count / 8);
                     }
                     if(event.key == InputKeyRight) {
-                        hex_editor->model->string_offset += offset_modifier;
-                        if(hex_editor->model->string_offset >=
-                           furi_string_size(hex_editor->buffer)) {
-                            // dengeros
-                            hex_editor->model->string_offset -=
-                                furi_string_size(hex_editor->buffer);
-                        }
+                        hex_editor_move(model, 1);
                     }
                     if(event.key == InputKeyLeft) {
-                        if(hex_editor->model->string_offset - offset_modifier < 0) {
-                            // dengeros
-                            hex_editor->model->string_offset +=
-                                furi_string_size(hex_editor->buffer);
-                        }
-                        hex_editor->model->string_offset -= offset_modifier;
+                        hex_editor_move(model, -1);
                     }
                     if(event.key == InputKeyDown) {
-                        hex_editor->model->string_offset = 0;
-                        if(!stream_read_line(hex_editor->model->stream, hex_editor->buffer)) {
-                            FURI_LOG_T(TAG, "No keys left in dict");
-                        }
+                        hex_editor_move(model, offset_modifier * HEX_EDITOR_BYTES_PER_LINE);
                     }
                     if(event.key == InputKeyUp) {
-                        hex_editor->model->string_offset = 0;
-
-                        if(!stream_seek(hex_editor->model->stream, -1, StreamOffsetFromCurrent)) {
-                            FURI_LOG_E(TAG, "Unable to seek stream");
-                            break;
-                        }
-                        // NOT work on first line
-                        stream_seek_to_char(
-                            hex_editor->model->stream, '\n', StreamDirectionBackward);
-
-                        if(!stream_seek_to_char(
-                               hex_editor->model->stream, '\n', StreamDirectionBackward)) {
-                            stream_rewind(hex_editor->model->stream);
-                        } else {
-                            if(!stream_seek(
-                                   hex_editor->model->stream, 1, StreamOffsetFromCurrent)) {
-                                FURI_LOG_E(TAG, "Unable to seek stream");
-                                break;
-                            }
-                        }
-
-                        if(!stream_read_line(hex_editor->model->stream, hex_editor->buffer)) {
-                            FURI_LOG_T(TAG, "No keys left in dict");
-                            break;
-                        }
+                        hex_editor_move(model, -offset_modifier * HEX_EDITOR_BYTES_PER_LINE);
                     }
+                }
 
-                    if(event.key == InputKeyOk) {
-                        hex_editor->model->editable_char = furi_string_get_char(
-                            hex_editor->buffer, hex_editor->model->string_offset);
-
-                        hex_editor->model->mode = 1;
+                if(event.key == InputKeyOk) {
+                    if(event.type == InputTypeShort) {
+                        uint32_t cursor_pos = model->cursor - model->file_offset;
+                        model->editable_char = model->file_bytes[cursor_pos];
+                        model->mode = 1;
+                    } else if(event.type == InputTypeLong) {
+                        uint32_t offset;
+                        if(hex_editor_buffer_undo(hex_editor->buffer, &offset)) {
+                            model->cursor = offset;
+                        }
                     }
-                } else {
+                }
+            } else {
+                if(event.type == InputTypeShort || event.type == InputTypeRepeat) {
                     offset_modifier = 1;
                     if(event.type == InputTypeRepeat) {
                         offset_modifier = 4;
                     }
                     if(event.key == InputKeyRight) {
-                        hex_editor->model->editable_char += offset_modifier;
+                        model->editable_char += offset_modifier;
                     }
                     if(event.key == InputKeyLeft) {
-                        hex_editor->model->editable_char -= offset_modifier;
+                        model->editable_char -= offset_modifier;
+                    }
+                    if(event.key == InputKeyUp) {
+                        model->editable_char += 0x10;
+                    }
+                    if(event.key == InputKeyDown) {
+                        model->editable_char -= 0x10;
                     }
 
                     if(event.key == InputKeyOk) {
-                        if(!stream_seek(hex_editor->model->stream, -1, StreamOffsetFromCurrent)) {
-                            FURI_LOG_E(TAG, "Unable to seek stream");
-                            break;
-                        }
-                        if(!stream_seek_to_char(
-                               hex_editor->model->stream, '\n', StreamDirectionBackward)) {
-                            FURI_LOG_E(TAG, "Unable to stream_seek_to_char n");
-                            // first line
-                            stream_seek(hex_editor->model->stream, 0, StreamOffsetFromStart);
-                            if(!stream_seek(
-                                   hex_editor->model->stream,
-                                   hex_editor->model->string_offset,
-                                   StreamOffsetFromCurrent)) {
-                                FURI_LOG_E(TAG, "Unable to seek string_offset");
-                            }
-                        } else {
-                            if(!stream_seek(
-                                   hex_editor->model->stream,
-                                   hex_editor->model->string_offset + 1,
-                                   StreamOffsetFromCurrent)) {
-                                FURI_LOG_E(TAG, "Unable to seek string_offset +1");
-                            }
-                        }
-
-                        if(!stream_write_char(
-                               hex_editor->model->stream, hex_editor->model->editable_char)) {
-                            FURI_LOG_E(TAG, "Unable to stream_write_char");
-                            break;
-                        }
-
-                        hex_editor->model->editable_char = ' ';
-
-                        hex_editor->model->mode = 0;
-
-                        if(!stream_seek_to_char(
-                               hex_editor->model->stream, '\n', StreamDirectionBackward)) {
-                            FURI_LOG_E(TAG, "Unable to stream_seek_to_char n 2");
-                            // first line
-                            stream_seek(hex_editor->model->stream, 0, StreamOffsetFromStart);
-                        } else {
-                            if(!stream_seek(
-                                   hex_editor->model->stream, 1, StreamOffsetFromCurrent)) {
-                                FURI_LOG_E(TAG, "Unable to seek stream");
-                                break;
-                            }
-                        }
-
-                        if(!stream_read_line(hex_editor->model->stream, hex_editor->buffer)) {
-                            FURI_LOG_T(TAG, "No keys left in dict");
-                            break;
-                        }
+                        hex_editor_buffer_set(
+                            hex_editor->buffer, model->cursor, model->editable_char);
+                        model->mode = 0;
                     }
                 }
             }
-            if(event.key == InputKeyBack) {
-                break;
-            }
-            // ?
+
+            hex_editor_update(hex_editor);
             view_port_update(hex_editor->view_port);
         }
     } while(false);
@@ -348,4 +376,4 @@ int32_t hex_editor_app(void* p) {
     hex_editor_free(hex_editor);
 
     return 0;
-}
\ No newline at end of file
+}
@@ -4,6 +4,19 @@
 #include <input/input.h>
 #include <stdlib.h>
 
+#define SCREEN_WIDTH 128
+#define SCREEN_HEIGHT 64
+#define FRAME_STRIDE (SCREEN_WIDTH / 8)
+#define FRAME_SIZE (FRAME_STRIDE * SCREEN_HEIGHT)
+
+#define MAX_ITERATION 50
+#define PAN_STEP 8 // pixels, whole pixels keep the rendered part reusable
+#define COARSE_STEP 8 // block size of the first progressive pass
+
+// Q5.26 fixed point, |z| stays below 32 until the bailout check
+#define FIX_FRAC 26
+#define FIX(v) ((int32_t)((v) * (float)(1 << FIX_FRAC)))
+
 typedef enum {
     EventTypeTick,
     EventTypeKey,
@@ -14,6 +27,13 @@ typedef struct {
     InputEvent input;
 } PluginEvent;
 
+typedef enum {
+    WorkerEvtStop = (1 << 0),
+    WorkerEvtRender = (1 << 1),
+} WorkerEvtFlags;
+
+#define WORKER_EVT_ALL (WorkerEvtStop | WorkerEvtRender)
+
 typedef struct {
     FuriMutex* mutex;
     float xZoom;
@@ -21,35 +41,173 @@ typedef struct {
     float xOffset;
     float yOffset;
     float zoom;
+
+    // pending changes for the worker, it shifts or drops its cached pixels accordingly
+    int shift_x;
+    int shift_y;
+    bool reset;
+    volatile uint32_t generation; // bumped on every view change, aborts the running render
+
+    ViewPort* view_port;
+    FuriThread* worker;
+    uint8_t frame[FRAME_SIZE]; // what the draw callback blits, 1 bit per pixel
 } PluginState;
 
-bool mandelbrot_pixel(int x, int y, float xZoom, float yZoom, float xOffset, float yOffset) {
-    float ratio = 128.0 / 64.0;
-    //x0 := scaled x coordinate of pixel (scaled to lie in the Mandelbrot X scale (-2.00, 0.47))
-    float x0 = (((x / 128.0) * ratio * xZoom)) - xOffset;
-    //y0 := scaled y coordinate of pixel (scaled to lie in the Mandelbrot Y scale (-1.12, 1.12))
-    float y0 = ((y / 64.0) * yZoom) - yOffset;
-    float x1 = 0.0;
-    float y1 = 0.0;
-    float x2 = 0.0;
-    float y2 = 0.0;
-
-    int iteration = 0;
-    int max_iteration = 50;
-
-    while(x2 + y2 <= 4.0 && iteration < max_iteration) {
-        y1 = 2.0 * x1 * y1 + y0;
-        x1 = x2 - y2 + x0;
-        x2 = x1 * x1;
-        y2 = y1 * y1;
-        iteration++;
+static inline bool buffer_get(const uint8_t* buffer, int x, int y) {
+    return buffer[y * FRAME_STRIDE + x / 8] & (1 << (x % 8));
+}
+
+static inline void buffer_set(uint8_t* buffer, int x, int y, bool value) {
+    if(value) {
+        buffer[y * FRAME_STRIDE + x / 8] |= 1 << (x % 8);
+    } else {
+        buffer[y * FRAME_STRIDE + x / 8] &= ~(1 << (x % 8));
+    }
+}
+
+// Moves the content by dx, dy pixels in place, uncovered pixels are cleared
+static void buffer_shift(uint8_t* buffer, int dx, int dy) {
+    // iterate so that every source pixel is read before it gets overwritten
+    for(int i = 0; i < SCREEN_HEIGHT; i++) {
+        int y = dy > 0 ? SCREEN_HEIGHT - 1 - i : i;
+        int sy = y - dy;
+        for(int j = 0; j < SCREEN_WIDTH; j++) {
+            int x = dx > 0 ? SCREEN_WIDTH - 1 - j : j;
+            int sx = x - dx;
+            bool inside = sx >= 0 && sx < SCREEN_WIDTH && sy >= 0 && sy < SCREEN_HEIGHT;
+            buffer_set(buffer, x, y, inside && buffer_get(buffer, sx, sy));
+        }
     }
+}
 
-    if(iteration > 49) {
+bool mandelbrot_pixel(int32_t x0, int32_t y0) {
+    int64_t y0_2 = ((int64_t)y0 * y0) >> FIX_FRAC;
+
+    // main cardioid and period-2 bulb are inside, no need to iterate
+    int32_t xq = x0 - FIX(0.25f);
+    int64_t q = (((int64_t)xq * xq) >> FIX_FRAC) + y0_2;
+    if(((q * (q + xq)) >> FIX_FRAC) <= y0_2 / 4) {
         return true;
     }
+    int32_t xb = x0 + FIX(1.0f);
+    if((((int64_t)xb * xb) >> FIX_FRAC) + y0_2 <= FIX(0.0625f)) {
+        return true;
+    }
+
+    int32_t x1 = 0;
+    int32_t y1 = 0;
+    // periodicity check: a point revisiting an earlier orbit point never escapes
+    int32_t x_saved = 0;
+    int32_t y_saved = 0;
+    int period = 0;
+    int period_length = 4;
+
+    for(int iteration = 0; iteration < MAX_ITERATION; iteration++) {
+        int64_t x2 = ((int64_t)x1 * x1) >> FIX_FRAC;
+        int64_t y2 = ((int64_t)y1 * y1) >> FIX_FRAC;
+        if(x2 + y2 > FIX(4.0f)) {
+            return false;
+        }
+
+        y1 = (int32_t)((((int64_t)x1 * y1) >> (FIX_FRAC - 1)) + y0);
+        x1 = (int32_t)(x2 - y2 + x0);
+
+        if(x1 == x_saved && y1 == y_saved) {
+            return true;
+        }
+        if(++period == period_length) {
+            period = 0;
+            period_length *= 2;
+            x_saved = x1;
+            y_saved = y1;
+        }
+    }
+
+    return true;
+}
 
-    return false;
+static void mandelbrot_publish(PluginState* plugin_state, const uint8_t* work) {
+    furi_mutex_acquire(plugin_state->mutex, FuriWaitForever);
+    memcpy(plugin_state->frame, work, FRAME_SIZE);
+    furi_mutex_release(plugin_state->mutex);
+    view_port_update(plugin_state->view_port);
+}
+
+static void mandelbrot_render(PluginState* plugin_state, uint8_t* work, uint8_t* valid) {
+    furi_mutex_acquire(plugin_state->mutex, FuriWaitForever);
+    uint32_t generation = plugin_state->generation;
+    int32_t x_step = FIX(plugin_state->xZoom * 2.0f / SCREEN_WIDTH);
+    int32_t y_step = FIX(plugin_state->yZoom / SCREEN_HEIGHT);
+    int32_t x_offset = FIX(plugin_state->xOffset);
+    int32_t y_offset = FIX(plugin_state->yOffset);
+    int shift_x = plugin_state->shift_x;
+    int shift_y = plugin_state->shift_y;
+    bool reset = plugin_state->reset;
+    plugin_state->shift_x = 0;
+    plugin_state->shift_y = 0;
+    plugin_state->reset = false;
+    furi_mutex_release(plugin_state->mutex);
+
+    if(reset) {
+        memset(valid, 0, FRAME_SIZE);
+    } else if(shift_x != 0 || shift_y != 0) {
+        // pixels still on screen after a pan are kept, only the uncovered strip is computed
+        buffer_shift(work, shift_x, shift_y);
+        buffer_shift(valid, shift_x, shift_y);
+        mandelbrot_publish(plugin_state, work);
+    }
+
+    // coarse to fine: every pass computes one pixel per block and fills the block with it,
+    // pixels computed exactly are marked valid and never touched again
+    for(int step = COARSE_STEP; step > 0; step /= 2) {
+        for(int y = 0; y < SCREEN_HEIGHT; y += step) {
+            if(plugin_state->generation != generation) {
+                return;
+            }
+
+            int32_t y0 = y * y_step - y_offset;
+            for(int x = 0; x < SCREEN_WIDTH; x += step) {
+                if(buffer_get(valid, x, y)) {
+                    continue;
+                }
+
+                bool inside = mandelbrot_pixel(x * x_step - x_offset, y0);
+                buffer_set(valid, x, y, true);
+
+                for(int by = y; by < y + step; by++) {
+                    for(int bx = x; bx < x + step; bx++) {
+                        if(!buffer_get(valid, bx, by)) {
+                            buffer_set(work, bx, by, inside);
+                        }
+                    }
+                }
+                buffer_set(work, x, y, inside);
+            }
+        }
+
+        mandelbrot_publish(plugin_state, work);
+    }
+}
+
+static int32_t mandelbrot_worker(void* ctx) {
+    PluginState* plugin_state = ctx;
+    uint8_t* work = malloc(FRAME_SIZE);
+    uint8_t* valid = malloc(FRAME_SIZE);
+    memset(work, 0, FRAME_SIZE);
+    memset(valid, 0, FRAME_SIZE);
+
+    while(true) {
+        uint32_t flags = furi_thread_flags_wait(WORKER_EVT_ALL, FuriFlagWaitAny, FuriWaitForever);
+        furi_check((flags & FuriFlagError) == 0);
+        if(flags & WorkerEvtStop) break;
+
+        mandelbrot_render(plugin_state, work, valid);
+    }
+
+    free(valid);
+    free(work);
+
+    return 0;
 }
 
 static void render_callback(Canvas* const canvas, void* ctx) {
@@ -59,21 +217,8 @@ static void render_callback(Canvas* const canvas, void* ctx) {
     // border around the edge of the screen
     canvas_draw_frame(canvas, 0, 0, 128, 64);
 
-    for(int y = 0; y < 64; y++) {
-        for(int x = 0; x < 128; x++) {
-            // did you know if you just pass the indivdiual bits of plugin_state instead of plugin_state
-            // you dont get any compiler warnings :)
-            if(mandelbrot_pixel(
-                   x,
-                   y,
-                   plugin_state->xZoom,
-                   plugin_state->yZoom,
-                   plugin_state->xOffset,
-                   plugin_state->yOffset)) {
-                canvas_draw_dot(canvas, x, y);
-            }
-        }
-    }
+    // the worker keeps the frame up to date, drawing is just a blit
+    canvas_draw_xbm(canvas, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, plugin_state->frame);
 
     furi_mutex_release(plugin_state->mutex);
 }
@@ -87,11 +232,16 @@ static void input_callback(InputEvent* input_event, void* ctx) {
 }
 
 static void mandelbrot_state_init(PluginState* const plugin_state) {
-    plugin_state->xOffset = 3.0;
-    plugin_state->yOffset = 1.12;
-    plugin_state->xZoom = 2.47;
-    plugin_state->yZoom = 2.24;
+    plugin_state->xOffset = 3.0f;
+    plugin_state->yOffset = 1.12f;
+    plugin_state->xZoom = 2.47f;
+    plugin_state->yZoom = 2.24f;
     plugin_state->zoom = 1; // this controls the camera when
+    plugin_state->shift_x = 0;
+    plugin_state->shift_y = 0;
+    plugin_state->reset = true;
+    plugin_state->generation = 0;
+    memset(plugin_state->frame, 0, FRAME_SIZE);
 }
 
 int32_t mandelbrot_app(void* p) {
@@ -113,54 +263,82 @@ int32_t mandelbrot_app(void* p) {
     ViewPort* view_port = view_port_alloc();
     view_port_draw_callback_set(view_port, render_callback, plugin_state);
     view_port_input_callback_set(view_port, input_callback, event_queue);
+    plugin_state->view_port = view_port;
 
     // Open GUI and register view_port
     Gui* gui = furi_record_open(RECORD_GUI);
     gui_add_view_port(gui, view_port, GuiLayerFullscreen);
 
+    plugin_state->worker =
+        furi_thread_alloc_ex("MandelbrotWorker", 1024, mandelbrot_worker, plugin_state);
+    furi_thread_start(plugin_state->worker);
+    furi_thread_flags_set(furi_thread_get_id(plugin_state->worker), WorkerEvtRender);
+
     PluginEvent event;
     for(bool processing = true; processing;) {
         FuriStatus event_status = furi_message_queue_get(event_queue, &event, 100);
         furi_mutex_acquire(plugin_state->mutex, FuriWaitForever);
 
+        bool changed = false;
         if(event_status == FuriStatusOk) {
             // press events
             if(event.type == EventTypeKey) {
-                if(event.input.type == InputTypePress) {
+                if(event.input.type == InputTypePress || event.input.type == InputTypeRepeat) {
+                    // pan by whole pixels, so the worker can reuse what it has already rendered
+                    float x_pan = PAN_STEP * plugin_state->xZoom * 2.0f / SCREEN_WIDTH;
+                    float y_pan = PAN_STEP * plugin_state->yZoom / SCREEN_HEIGHT;
+                    changed = true;
                     switch(event.input.key) {
                     case InputKeyUp:
-                        plugin_state->yOffset += 0.1 / plugin_state->zoom;
+                        plugin_state->yOffset += y_pan;
+                        plugin_state->shift_y += PAN_STEP;
                         break;
                     case InputKeyDown:
-                        plugin_state->yOffset += -0.1 / plugin_state->zoom;
+                        plugin_state->yOffset -= y_pan;
+                        plugin_state->shift_y -= PAN_STEP;
                         break;
                     case InputKeyRight:
-                        plugin_state->xOffset += -0.1 / plugin_state->zoom;
+                        plugin_state->xOffset -= x_pan;
+                        plugin_state->shift_x -= PAN_STEP;
                         break;
                     case InputKeyLeft:
-                        plugin_state->xOffset += 0.1 / plugin_state->zoom;
+                        plugin_state->xOffset += x_pan;
+                        plugin_state->shift_x += PAN_STEP;
                         break;
                     case InputKeyOk:
-                        plugin_state->xZoom -= (2.47 / 10) / plugin_state->zoom;
-                        plugin_state->yZoom -= (2.24 / 10) / plugin_state->zoom;
+                        plugin_state->xZoom -= (2.47f / 10) / plugin_state->zoom;
+                        plugin_state->yZoom -= (2.24f / 10) / plugin_state->zoom;
                         // used to make camera control finer the more zoomed you are
                         // this needs to be some sort of curve
-                        plugin_state->zoom += 0.15;
+                        plugin_state->zoom += 0.15f;
+                        plugin_state->reset = true;
                         break;
                     case InputKeyBack:
                         processing = false;
+                        changed = false;
                         break;
                     default:
+                        changed = false;
                         break;
                     }
                 }
             }
         }
 
+        if(changed) {
+            plugin_state->generation++;
+        }
         furi_mutex_release(plugin_state->mutex);
-        view_port_update(view_port);
+
+        if(changed) {
+            furi_thread_flags_set(furi_thread_get_id(plugin_state->worker), WorkerEvtRender);
+        }
     }
 
+    furi_thread_flags_set(furi_thread_get_id(plugin_state->worker), WorkerEvtStop);
+    furi_thread_join(plugin_state->worker);
+    furi_thread_free(plugin_state->worker);
+
     view_port_enabled_set(view_port, false);
     gui_remove_view_port(gui, view_port);
     furi_record_close(RECORD_GUI);
@@ -170,4 +348,4 @@ int32_t mandelbrot_app(void* p) {
     free(plugin_state);
 
     return 0;
-}
\ No newline at end of file
+}
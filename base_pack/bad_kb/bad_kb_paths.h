@@ -6,4 +6,5 @@
 #define BAD_USB_APP_BASE_FOLDER EXT_PATH("badusb")
 #define BAD_KB_KEYS_PATH BAD_KB_APP_BASE_FOLDER "/.bad_kb.keys"
 #define BAD_KB_SETTINGS_PATH BAD_KB_APP_BASE_FOLDER "/.bad_kb.settings"
+#define BAD_KB_APP_CACHE_FOLDER BAD_KB_APP_BASE_FOLDER "/.cache"
 #define BAD_KB_APP_PATH_LAYOUT_FOLDER BAD_USB_APP_BASE_FOLDER "/assets/layouts"
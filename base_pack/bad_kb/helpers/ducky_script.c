@@ -15,9 +15,6 @@
 #define TAG "BadKb"
 #define WORKER_TAG TAG "Worker"
 
-#define BADKB_ASCII_TO_KEY(script, x) \
-    (((uint8_t)x < 128) ? (script->layout[(uint8_t)x]) : HID_KEYBOARD_NONE)
-
 // Delays for waiting between HID key press and key release
 const uint8_t bt_hid_delays[LevelRssiNum] = {
     60, // LevelRssi122_100
@@ -195,110 +192,158 @@ int32_t ducky_error(BadKbScript* bad_kb, const char* text, ...) {
     return SCRIPT_STATE_ERROR;
 }
 
-bool ducky_string(BadKbScript* bad_kb, const char* param) {
-    uint32_t i = 0;
+static void ducky_key_click(BadKbScript* bad_kb, uint16_t keycode) {
+    if(bad_kb->bt) {
+        ble_profile_hid_kb_press(bad_kb->app->ble_hid, keycode);
+        furi_delay_ms(bt_timeout);
+        ble_profile_hid_kb_release(bad_kb->app->ble_hid, keycode);
+    } else {
+        furi_hal_hid_kb_press(keycode);
+        furi_hal_hid_kb_release(keycode);
+    }
+}
 
-    while(param[i] != '\0') {
-        if(param[i] != '\n') {
-            uint16_t keycode = BADKB_ASCII_TO_KEY(bad_kb, param[i]);
-            if(keycode != HID_KEYBOARD_NONE) {
-                if(bad_kb->bt) {
-                    ble_profile_hid_kb_press(bad_kb->app->ble_hid, keycode);
-                    furi_delay_ms(bt_timeout);
-                    ble_profile_hid_kb_release(bad_kb->app->ble_hid, keycode);
-                } else {
-                    furi_hal_hid_kb_press(keycode);
-                    furi_hal_hid_kb_release(keycode);
-                }
-            }
-        } else {
-            if(bad_kb->bt) {
-                ble_profile_hid_kb_press(bad_kb->app->ble_hid, HID_KEYBOARD_RETURN);
-                furi_delay_ms(bt_timeout);
-                ble_profile_hid_kb_release(bad_kb->app->ble_hid, HID_KEYBOARD_RETURN);
-            } else {
-                furi_hal_hid_kb_press(HID_KEYBOARD_RETURN);
-                furi_hal_hid_kb_release(HID_KEYBOARD_RETURN);
-            }
+static uint16_t ducky_op_get_u16(BadKbScript* bad_kb, size_t index) {
+    uint16_t value = 0;
+    memcpy(&value, &bad_kb->op_payload[index * sizeof(value)], sizeof(value));
+    return value;
+}
+
+static uint32_t ducky_op_get_u32(BadKbScript* bad_kb) {
+    uint32_t value = 0;
+    memcpy(&value, bad_kb->op_payload, sizeof(value));
+    return value;
+}
+
+static bool ducky_string(BadKbScript* bad_kb) {
+    while(true) {
+        for(size_t i = 0; i < bad_kb->op.payload_len / sizeof(uint16_t); i++) {
+            ducky_key_click(bad_kb, ducky_op_get_u16(bad_kb, i));
         }
-        i++;
+        if(!(bad_kb->op.flags & DuckyOpFlagStringMore)) break;
+        if(!ducky_bytecode_read_op(bad_kb)) return false;
     }
     bad_kb->stringdelay = 0;
     return true;
 }
 
 static bool ducky_string_next(BadKbScript* bad_kb) {
-    if(bad_kb->string_print_pos >= furi_string_size(bad_kb->string_print)) {
-        return true;
+    if(bad_kb->string_print_pos >= bad_kb->op.payload_len / sizeof(uint16_t)) {
+        // Long strings are split into several ops
+        if(!(bad_kb->op.flags & DuckyOpFlagStringMore) || !ducky_bytecode_read_op(bad_kb)) {
+            return true;
+        }
+        bad_kb->string_print_pos = 0;
+        return false;
     }
 
-    char print_char = furi_string_get_char(bad_kb->string_print, bad_kb->string_print_pos);
+    ducky_key_click(bad_kb, ducky_op_get_u16(bad_kb, bad_kb->string_print_pos));
 
-    if(print_char != '\n') {
-        uint16_t keycode = BADKB_ASCII_TO_KEY(bad_kb, print_char);
-        if(keycode != HID_KEYBOARD_NONE) {
-            if(bad_kb->bt) {
-                ble_profile_hid_kb_press(bad_kb->app->ble_hid, keycode);
-                furi_delay_ms(bt_timeout);
-                ble_profile_hid_kb_release(bad_kb->app->ble_hid, keycode);
-            } else {
-                furi_hal_hid_kb_press(keycode);
-                furi_hal_hid_kb_release(keycode);
+    bad_kb->string_print_pos++;
+
+    return false;
+}
+
+static int32_t ducky_execute_op(BadKbScript* bad_kb) {
+    uint16_t key;
+
+    switch(bad_kb->op.opcode) {
+    case DuckyOpNop:
+        break;
+    case DuckyOpKey:
+        ducky_key_click(bad_kb, ducky_op_get_u16(bad_kb, 0));
+        break;
+    case DuckyOpString:
+        if(bad_kb->stringdelay == 0 &&
+           bad_kb->defstringdelay == 0) { // stringdelay not set - run command immediately
+            if(!ducky_string(bad_kb)) {
+                return ducky_error(bad_kb, "Bytecode read error");
             }
+        } else { // stringdelay is set - run command in thread to keep handling external events
+            return SCRIPT_STATE_STRING_START;
         }
-    } else {
+        break;
+    case DuckyOpDelay:
+        return (int32_t)ducky_op_get_u32(bad_kb);
+    case DuckyOpDefDelay:
+        bad_kb->defdelay = ducky_op_get_u32(bad_kb);
+        break;
+    case DuckyOpStringDelay:
+        bad_kb->stringdelay = ducky_op_get_u32(bad_kb);
+        break;
+    case DuckyOpDefStringDelay:
+        bad_kb->defstringdelay = ducky_op_get_u32(bad_kb);
+        break;
+    case DuckyOpSysrq:
+        key = ducky_op_get_u16(bad_kb, 0);
         if(bad_kb->bt) {
-            ble_profile_hid_kb_press(bad_kb->app->ble_hid, HID_KEYBOARD_RETURN);
+            ble_profile_hid_kb_press(
+                bad_kb->app->ble_hid, KEY_MOD_LEFT_ALT | HID_KEYBOARD_PRINT_SCREEN);
+            ble_profile_hid_kb_press(bad_kb->app->ble_hid, key);
             furi_delay_ms(bt_timeout);
-            ble_profile_hid_kb_release(bad_kb->app->ble_hid, HID_KEYBOARD_RETURN);
+            ble_profile_hid_kb_release_all(bad_kb->app->ble_hid);
         } else {
-            furi_hal_hid_kb_press(HID_KEYBOARD_RETURN);
-            furi_hal_hid_kb_release(HID_KEYBOARD_RETURN);
+            furi_hal_hid_kb_press(KEY_MOD_LEFT_ALT | HID_KEYBOARD_PRINT_SCREEN);
+            furi_hal_hid_kb_press(key);
+            furi_hal_hid_kb_release_all();
         }
-    }
-
-    bad_kb->string_print_pos++;
-
-    return false;
-}
-
-static int32_t ducky_parse_line(BadKbScript* bad_kb, FuriString* line) {
-    uint32_t line_len = furi_string_size(line);
-    const char* line_tmp = furi_string_get_cstr(line);
-
-    if(line_len == 0) {
-        return SCRIPT_STATE_NEXT_LINE; // Skip empty lines
-    }
-    FURI_LOG_D(WORKER_TAG, "line:%s", line_tmp);
-
-    // Ducky Lang Functions
-    int32_t cmd_result = ducky_execute_cmd(bad_kb, line_tmp);
-    if(cmd_result != SCRIPT_STATE_CMD_UNKNOWN) {
-        return cmd_result;
-    }
-
-    // Special keys + modifiers
-    uint16_t key = ducky_get_keycode(bad_kb, line_tmp, false);
-    if(key == HID_KEYBOARD_NONE) {
-        return ducky_error(bad_kb, "No keycode defined for %s", line_tmp);
-    }
-    if((key & 0xFF00) != 0) {
-        // It's a modifier key
-        uint32_t offset = ducky_get_command_len(line_tmp) + 1;
-        // ducky_get_command_len() returns 0 without space, so check for != 1
-        if(offset != 1 && line_len > offset) {
-            // It's also a key combination
-            key |= ducky_get_keycode(bad_kb, line_tmp + offset, true);
+        break;
+    case DuckyOpAltChar:
+        ducky_numlock_on(bad_kb);
+        ducky_altchar(bad_kb, (const char*)bad_kb->op_payload);
+        break;
+    case DuckyOpAltString:
+        ducky_numlock_on(bad_kb);
+        ducky_altstring(bad_kb, (const char*)bad_kb->op_payload);
+        break;
+    case DuckyOpHold:
+        key = ducky_op_get_u16(bad_kb, 0);
+        if(bad_kb->bt) {
+            ble_profile_hid_kb_press(bad_kb->app->ble_hid, key);
+        } else {
+            furi_hal_hid_kb_press(key);
         }
+        break;
+    case DuckyOpRelease:
+        key = ducky_op_get_u16(bad_kb, 0);
+        if(bad_kb->bt) {
+            ble_profile_hid_kb_release(bad_kb->app->ble_hid, key);
+        } else {
+            furi_hal_hid_kb_release(key);
+        }
+        break;
+    case DuckyOpMedia:
+        key = ducky_op_get_u16(bad_kb, 0);
+        if(bad_kb->bt) {
+            ble_profile_hid_kb_press(bad_kb->app->ble_hid, key);
+            furi_delay_ms(bt_timeout);
+            ble_profile_hid_kb_release(bad_kb->app->ble_hid, key);
+        } else {
+            furi_hal_hid_kb_press(key);
+            furi_hal_hid_kb_release(key);
+        }
+        break;
+    case DuckyOpGlobe:
+        key = ducky_op_get_u16(bad_kb, 0);
+        if(bad_kb->bt) {
+            ble_profile_hid_consumer_key_press(bad_kb->app->ble_hid, HID_CONSUMER_FN_GLOBE);
+            ble_profile_hid_kb_press(bad_kb->app->ble_hid, key);
+            furi_delay_ms(bt_timeout);
+            ble_profile_hid_kb_release(bad_kb->app->ble_hid, key);
+            ble_profile_hid_consumer_key_release(bad_kb->app->ble_hid, HID_CONSUMER_FN_GLOBE);
+        } else {
+            furi_hal_hid_consumer_key_press(HID_CONSUMER_FN_GLOBE);
+            furi_hal_hid_kb_press(key);
+            furi_hal_hid_kb_release(key);
+            furi_hal_hid_consumer_key_release(HID_CONSUMER_FN_GLOBE);
+        }
+        break;
+    case DuckyOpWaitForButton:
+        return SCRIPT_STATE_WAIT_FOR_BTN;
+    default:
+        return ducky_error(bad_kb, "Unknown opcode %u", bad_kb->op.opcode);
     }
-    if(bad_kb->bt) {
-        ble_profile_hid_kb_press(bad_kb->app->ble_hid, key);
-        furi_delay_ms(bt_timeout);
-        ble_profile_hid_kb_release(bad_kb->app->ble_hid, key);
-    } else {
-        furi_hal_hid_kb_press(key);
-        furi_hal_hid_kb_release(key);
-    }
+
     return 0;
 }
 
@@ -353,14 +398,16 @@ static bool ducky_set_bt_id(BadKbScript* bad_kb, const char* line) {
 
 static void ducky_script_preload(BadKbScript* bad_kb, File* script_file) {
     BadKbApp* app = bad_kb->app;
-    uint8_t ret = 0;
+    size_t ret = 0;
     uint32_t line_len = 0;
 
     furi_string_reset(bad_kb->line);
+    bad_kb->script_hash = 0;
 
     do {
         ret = storage_file_read(script_file, bad_kb->file_buf, FILE_BUFFER_LEN);
-        for(uint16_t i = 0; i < ret; i++) {
+        bad_kb->script_hash = ducky_hash_update(bad_kb->script_hash, bad_kb->file_buf, ret);
+        for(size_t i = 0; i < ret; i++) {
             if(bad_kb->file_buf[i] == '\n' && line_len > 0) {
                 bad_kb->st.line_nb++;
                 line_len = 0;
@@ -399,73 +446,53 @@ static void ducky_script_preload(BadKbScript* bad_kb, File* script_file) {
     furi_string_reset(bad_kb->line);
 }
 
-static int32_t ducky_script_execute_next(BadKbScript* bad_kb, File* script_file) {
+static int32_t ducky_script_execute_next(BadKbScript* bad_kb) {
     int32_t delay_val = 0;
 
-    if(bad_kb->repeat_cnt > 0) {
-        bad_kb->repeat_cnt--;
-        delay_val = ducky_parse_line(bad_kb, bad_kb->line_prev);
-        if(delay_val == SCRIPT_STATE_NEXT_LINE) { // Empty line
-            return 0;
-        } else if(delay_val == SCRIPT_STATE_STRING_START) { // Print string with delays
-            return delay_val;
-        } else if(delay_val == SCRIPT_STATE_WAIT_FOR_BTN) { // wait for button
-            return delay_val;
-        } else if(delay_val < 0) { // Script error
-            bad_kb->st.error_line = bad_kb->st.line_cur - 1;
-            FURI_LOG_E(WORKER_TAG, "Unknown command at line %zu", bad_kb->st.line_cur - 1U);
-            return SCRIPT_STATE_ERROR;
-        } else {
-            return (delay_val + bad_kb->defdelay);
+    if(!ducky_bytecode_read_op(bad_kb)) {
+        if(bad_kb->bytecode_end) {
+            return SCRIPT_STATE_END;
         }
+        bad_kb->st.error_line = bad_kb->st.line_cur;
+        FURI_LOG_E(WORKER_TAG, "Bytecode read error after line %zu", bad_kb->st.line_cur);
+        ducky_error(bad_kb, "Bytecode read error");
+        return SCRIPT_STATE_ERROR;
     }
 
-    furi_string_set(bad_kb->line_prev, bad_kb->line);
-    furi_string_reset(bad_kb->line);
+    bad_kb->st.line_cur = bad_kb->op.line;
+    delay_val = ducky_execute_op(bad_kb);
+    if(delay_val == SCRIPT_STATE_STRING_START) { // Print string with delays
+        return delay_val;
+    } else if(delay_val == SCRIPT_STATE_WAIT_FOR_BTN) { // wait for button
+        return delay_val;
+    } else if(delay_val < 0) { // Script error
+        bad_kb->st.error_line = bad_kb->st.line_cur;
+        FURI_LOG_E(WORKER_TAG, "Execution error at line %zu", bad_kb->st.line_cur);
+        return SCRIPT_STATE_ERROR;
+    }
 
-    while(1) {
-        if(bad_kb->buf_len == 0) {
-            bad_kb->buf_len = storage_file_read(script_file, bad_kb->file_buf, FILE_BUFFER_LEN);
-            if(storage_file_eof(script_file)) {
-                if((bad_kb->buf_len < FILE_BUFFER_LEN) && (bad_kb->file_end == false)) {
-                    bad_kb->file_buf[bad_kb->buf_len] = '\n';
-                    bad_kb->buf_len++;
-                    bad_kb->file_end = true;
-                }
-            }
+    return (delay_val + bad_kb->defdelay);
+}
 
-            bad_kb->buf_start = 0;
-            if(bad_kb->buf_len == 0) return SCRIPT_STATE_END;
-        }
-        for(uint8_t i = bad_kb->buf_start; i < (bad_kb->buf_start + bad_kb->buf_len); i++) {
-            if(bad_kb->file_buf[i] == '\n' && furi_string_size(bad_kb->line) > 0) {
-                bad_kb->st.line_cur++;
-                bad_kb->buf_len = bad_kb->buf_len + bad_kb->buf_start - (i + 1);
-                bad_kb->buf_start = i + 1;
-                furi_string_trim(bad_kb->line);
-                delay_val = ducky_parse_line(bad_kb, bad_kb->line);
-                if(delay_val == SCRIPT_STATE_NEXT_LINE) { // Empty line
-                    return 0;
-                } else if(delay_val == SCRIPT_STATE_STRING_START) { // Print string with delays
-                    return delay_val;
-                } else if(delay_val == SCRIPT_STATE_WAIT_FOR_BTN) { // wait for button
-                    return delay_val;
-                } else if(delay_val < 0) {
-                    bad_kb->st.error_line = bad_kb->st.line_cur;
-                    FURI_LOG_E(WORKER_TAG, "Unknown command at line %zu", bad_kb->st.line_cur);
-                    return SCRIPT_STATE_ERROR;
-                } else {
-                    return (delay_val + bad_kb->defdelay);
-                }
-            } else {
-                furi_string_push_back(bad_kb->line, bad_kb->file_buf[i]);
-            }
-        }
-        bad_kb->buf_len = 0;
-        if(bad_kb->file_end) return SCRIPT_STATE_END;
+static BadKbWorkerState ducky_script_prepare_run(BadKbScript* bad_kb, File* script_file) {
+    bad_kb->st.line_cur = 0;
+    bad_kb->defdelay = 0;
+    bad_kb->stringdelay = 0;
+    bad_kb->defstringdelay = 0;
+    bad_kb->repeat_cnt = 0;
+    bad_kb->key_hold_nb = 0;
+    bad_kb_script_set_keyboard_layout(bad_kb, bad_kb->keyboard_layout);
+
+    // Keycodes depend on layout, so bytecode is validated against it before each run
+    ducky_bytecode_close(bad_kb);
+    int32_t result = ducky_script_compile(bad_kb, script_file);
+    if(result == SCRIPT_STATE_ERROR) {
+        return BadKbStateScriptError;
+    } else if((result < 0) || !ducky_bytecode_open(bad_kb)) {
+        return BadKbStateFileError;
     }
 
-    return 0;
+    return BadKbStateRunning;
 }
 
 void bad_kb_bt_hid_state_callback(BtStatus status, void* context) {
@@ -517,9 +544,9 @@ static int32_t bad_kb_worker(void* context) {
 
     FURI_LOG_I(WORKER_TAG, "Init");
     File* script_file = storage_file_alloc(furi_record_open(RECORD_STORAGE));
+    bad_kb->bytecode_file = storage_file_alloc(furi_record_open(RECORD_STORAGE));
+    bad_kb->file_buf = malloc(FILE_BUFFER_LEN + 1);
     bad_kb->line = furi_string_alloc();
-    bad_kb->line_prev = furi_string_alloc();
-    bad_kb->string_print = furi_string_alloc();
     bad_kb->st.elapsed = 0;
 
     while(1) {
@@ -533,11 +560,18 @@ static int32_t bad_kb_worker(void* context) {
                    FSAM_READ,
                    FSOM_OPEN_EXISTING)) {
                 ducky_script_preload(bad_kb, script_file);
+                int32_t compile_result = SCRIPT_STATE_ERROR;
                 if(bad_kb->st.line_nb > 0) {
+                    // Validate whole script before run, errors are reported right away
+                    compile_result = ducky_script_compile(bad_kb, script_file);
+                }
+                if(compile_result == 0) {
                     bad_kb_config_refresh(bad_kb->app);
                     worker_state = BadKbStateNotConnected; // Refresh will set connected flag
+                } else if(compile_result == SCRIPT_STATE_FILE_ERROR) {
+                    worker_state = BadKbStateFileError; // Bytecode cache write error
                 } else {
-                    worker_state = BadKbStateScriptError; // Script preload error
+                    worker_state = BadKbStateScriptError; // Script preload or compile error
                 }
             } else {
                 FURI_LOG_E(WORKER_TAG, "File open error");
@@ -576,17 +610,7 @@ static int32_t bad_kb_worker(void* context) {
             } else if(flags & WorkerEvtStartStop) { // Start executing script
                 //dolphin_deed(DolphinDeedBadKbPlayScript);
                 delay_val = 0;
-                bad_kb->buf_len = 0;
-                bad_kb->st.line_cur = 0;
-                bad_kb->defdelay = 0;
-                bad_kb->stringdelay = 0;
-                bad_kb->defstringdelay = 0;
-                bad_kb->repeat_cnt = 0;
-                bad_kb->key_hold_nb = 0;
-                bad_kb->file_end = false;
-                storage_file_seek(script_file, 0, true);
-                bad_kb_script_set_keyboard_layout(bad_kb, bad_kb->keyboard_layout);
-                worker_state = BadKbStateRunning;
+                worker_state = ducky_script_prepare_run(bad_kb, script_file);
                 bad_kb->st.elapsed = 0;
             } else if(flags & WorkerEvtDisconnect) {
                 worker_state = BadKbStateNotConnected; // Disconnected
@@ -606,14 +630,6 @@ static int32_t bad_kb_worker(void* context) {
             } else if(flags & WorkerEvtConnect) { // Start executing script
                 //dolphin_deed(DolphinDeedBadKbPlayScript);
                 delay_val = 0;
-                bad_kb->buf_len = 0;
-                bad_kb->st.line_cur = 0;
-                bad_kb->defdelay = 0;
-                bad_kb->stringdelay = 0;
-                bad_kb->defstringdelay = 0;
-                bad_kb->repeat_cnt = 0;
-                bad_kb->file_end = false;
-                storage_file_seek(script_file, 0, true);
                 // extra time for PC to recognize Flipper as keyboard
                 flags = furi_thread_flags_wait(
                     WorkerEvtEnd | WorkerEvtDisconnect | WorkerEvtStartStop,
@@ -621,7 +637,7 @@ static int32_t bad_kb_worker(void* context) {
                     bad_kb->bt ? 3000 : 1500);
                 if(flags == (unsigned)FuriFlagErrorTimeout) {
                     // If nothing happened - start script execution
-                    worker_state = BadKbStateRunning;
+                    worker_state = ducky_script_prepare_run(bad_kb, script_file);
                     bad_kb->st.elapsed = 0;
                 } else if(flags & WorkerEvtStartStop) {
                     worker_state = BadKbStateIdle;
@@ -630,7 +646,6 @@ static int32_t bad_kb_worker(void* context) {
                 if(bad_kb->bt) {
                     update_bt_timeout(bad_kb->bt);
                 }
-                bad_kb_script_set_keyboard_layout(bad_kb, bad_kb->keyboard_layout);
             } else if(flags & WorkerEvtStartStop) { // Cancel scheduled execution
                 worker_state = BadKbStateNotConnected;
             }
@@ -680,7 +695,7 @@ static int32_t bad_kb_worker(void* context) {
                     continue;
                 }
                 bad_kb->st.state = BadKbStateRunning;
-                delay_val = ducky_script_execute_next(bad_kb, script_file);
+                delay_val = ducky_script_execute_next(bad_kb);
                 if(delay_val == SCRIPT_STATE_ERROR) { // Script error
                     delay_val = 0;
                     worker_state = BadKbStateScriptError;
@@ -855,9 +870,11 @@ static int32_t bad_kb_worker(void* context) {
 
     storage_file_close(script_file);
     storage_file_free(script_file);
+    ducky_bytecode_close(bad_kb);
+    storage_file_free(bad_kb->bytecode_file);
+    furi_record_close(RECORD_STORAGE);
+    free(bad_kb->file_buf);
     furi_string_free(bad_kb->line);
-    furi_string_free(bad_kb->line_prev);
-    furi_string_free(bad_kb->string_print);
 
     FURI_LOG_I(WORKER_TAG, "End");
 
@@ -879,6 +896,7 @@ BadKbScript* bad_kb_script_open(FuriString* file_path, Bt* bt, BadKbApp* app) {
     bad_kb->file_path = furi_string_alloc();
     furi_string_set(bad_kb->file_path, file_path);
     bad_kb->keyboard_layout = furi_string_alloc();
+    bad_kb->layout_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     bad_kb_script_set_default_keyboard_layout(bad_kb);
 
     bad_kb->st.state = BadKbStateInit;
@@ -887,6 +905,9 @@ BadKbScript* bad_kb_script_open(FuriString* file_path, Bt* bt, BadKbApp* app) {
 
     bad_kb->bt = bt;
 
+    // Worker compiles the script right away, so selected layout must be there before it starts
+    bad_kb_script_set_keyboard_layout(bad_kb, app->keyboard_layout);
+
     bad_kb->thread = furi_thread_alloc_ex("BadKbWorker", 2048, bad_kb_worker, bad_kb);
     furi_thread_start(bad_kb->thread);
     return bad_kb;
@@ -900,6 +921,7 @@ void bad_kb_script_close(BadKbScript* bad_kb) {
     furi_thread_free(bad_kb->thread);
     furi_string_free(bad_kb->file_path);
     furi_string_free(bad_kb->keyboard_layout);
+    furi_mutex_free(bad_kb->layout_mutex);
     free(bad_kb);
 }
 
@@ -911,6 +933,7 @@ void bad_kb_script_set_keyboard_layout(BadKbScript* bad_kb, FuriString* layout_p
         return;
     }
 
+    furi_mutex_acquire(bad_kb->layout_mutex, FuriWaitForever);
     File* layout_file = storage_file_alloc(furi_record_open(RECORD_STORAGE));
     if(!furi_string_empty(layout_path)) { //-V1051
         furi_string_set(bad_kb->keyboard_layout, layout_path);
@@ -926,6 +949,7 @@ void bad_kb_script_set_keyboard_layout(BadKbScript* bad_kb, FuriString* layout_p
         bad_kb_script_set_default_keyboard_layout(bad_kb);
     }
     storage_file_free(layout_file);
+    furi_mutex_release(bad_kb->layout_mutex);
 }
 
 void bad_kb_script_start_stop(BadKbScript* bad_kb) {
@@ -1,7 +1,6 @@
 #include "../bad_kb_app_i.h"
 #include <furi_hal.h>
 #include <furi_hal_usb_hid.h>
-#include "ble_hid.h"
 #include "ducky_script.h"
 #include "ducky_script_i.h"
 
@@ -13,69 +12,65 @@ typedef struct {
     int32_t param;
 } DuckyCmd;
 
-static int32_t ducky_fnc_delay(BadKbScript* bad_kb, const char* line, int32_t param) {
+static int32_t ducky_fnc_nop(BadKbScript* bad_kb, const char* line, int32_t param) {
+    UNUSED(line);
     UNUSED(param);
 
+    ducky_emit_op(bad_kb, DuckyOpNop, DuckyOpFlagNone, NULL, 0);
+    return 0;
+}
+
+static int32_t ducky_fnc_delay(BadKbScript* bad_kb, const char* line, int32_t param) {
     line = &line[ducky_get_command_len(line) + 1];
     uint32_t delay_val = 0;
     bool state = ducky_get_number(line, &delay_val);
     if((state) && (delay_val > 0)) {
-        return (int32_t)delay_val;
+        ducky_emit_op(bad_kb, (DuckyOpCode)param, DuckyOpFlagNone, &delay_val, sizeof(delay_val));
+        return 0;
     }
 
     return ducky_error(bad_kb, "Invalid number %s", line);
 }
 
-static int32_t ducky_fnc_defdelay(BadKbScript* bad_kb, const char* line, int32_t param) {
-    UNUSED(param);
-
-    line = &line[ducky_get_command_len(line) + 1];
-    bool state = ducky_get_number(line, &bad_kb->defdelay);
-    if(!state) {
-        return ducky_error(bad_kb, "Invalid number %s", line);
-    }
-    return 0;
-}
-
-static int32_t ducky_fnc_strdelay(BadKbScript* bad_kb, const char* line, int32_t param) {
-    UNUSED(param);
-
-    line = &line[ducky_get_command_len(line) + 1];
-    bool state = ducky_get_number(line, &bad_kb->stringdelay);
-    if(!state) {
-        return ducky_error(bad_kb, "Invalid number %s", line);
-    }
-    return 0;
-}
-
-static int32_t ducky_fnc_defstrdelay(BadKbScript* bad_kb, const char* line, int32_t param) {
-    UNUSED(param);
-
+static int32_t ducky_fnc_set_delay(BadKbScript* bad_kb, const char* line, int32_t param) {
     line = &line[ducky_get_command_len(line) + 1];
-    bool state = ducky_get_number(line, &bad_kb->defstringdelay);
+    uint32_t delay_val = 0;
+    bool state = ducky_get_number(line, &delay_val);
     if(!state) {
         return ducky_error(bad_kb, "Invalid number %s", line);
     }
+    ducky_emit_op(bad_kb, (DuckyOpCode)param, DuckyOpFlagNone, &delay_val, sizeof(delay_val));
     return 0;
 }
 
 static int32_t ducky_fnc_string(BadKbScript* bad_kb, const char* line, int32_t param) {
     line = &line[ducky_get_command_len(line) + 1];
-    furi_string_set_str(bad_kb->string_print, line);
-    if(param == 1) {
-        furi_string_cat(bad_kb->string_print, "\n");
-    }
 
-    if(bad_kb->stringdelay == 0 &&
-       bad_kb->defstringdelay == 0) { // stringdelay not set - run command immediately
-        bool state = ducky_string(bad_kb, furi_string_get_cstr(bad_kb->string_print));
-        if(!state) {
-            return ducky_error(bad_kb, "Invalid string %s", line);
+    // Resolve keycodes with selected layout, long strings are split into several ops
+    uint8_t* keys = bad_kb->op_payload;
+    size_t keys_len = 0;
+    size_t line_len = strlen(line);
+    for(size_t i = 0; i <= line_len; i++) {
+        uint16_t keycode;
+        if(i == line_len) {
+            if(param != 1) break;
+            keycode = HID_KEYBOARD_RETURN; // STRINGLN
+        } else if(line[i] == '\n') {
+            keycode = HID_KEYBOARD_RETURN;
+        } else {
+            keycode = BADKB_ASCII_TO_KEY(bad_kb, line[i]);
+        }
+
+        if(keycode == HID_KEYBOARD_NONE) continue;
+        if(keys_len + sizeof(keycode) > DUCKY_OP_PAYLOAD_MAX) {
+            ducky_emit_op(bad_kb, DuckyOpString, DuckyOpFlagStringMore, keys, keys_len);
+            keys_len = 0;
         }
-    } else { // stringdelay is set - run command in thread to keep handling external events
-        return SCRIPT_STATE_STRING_START;
+        memcpy(&keys[keys_len], &keycode, sizeof(keycode));
+        keys_len += sizeof(keycode);
     }
 
+    ducky_emit_op(bad_kb, DuckyOpString, DuckyOpFlagNone, keys, keys_len);
     return 0;
 }
 
@@ -95,17 +90,7 @@ static int32_t ducky_fnc_sysrq(BadKbScript* bad_kb, const char* line, int32_t pa
 
     line = &line[ducky_get_command_len(line) + 1];
     uint16_t key = ducky_get_keycode(bad_kb, line, true);
-    if(bad_kb->bt) {
-        ble_profile_hid_kb_press(
-            bad_kb->app->ble_hid, KEY_MOD_LEFT_ALT | HID_KEYBOARD_PRINT_SCREEN);
-        ble_profile_hid_kb_press(bad_kb->app->ble_hid, key);
-        furi_delay_ms(bt_timeout);
-        ble_profile_hid_kb_release_all(bad_kb->app->ble_hid);
-    } else {
-        furi_hal_hid_kb_press(KEY_MOD_LEFT_ALT | HID_KEYBOARD_PRINT_SCREEN);
-        furi_hal_hid_kb_press(key);
-        furi_hal_hid_kb_release_all();
-    }
+    ducky_emit_op(bad_kb, DuckyOpSysrq, DuckyOpFlagNone, &key, sizeof(key));
     return 0;
 }
 
@@ -113,11 +98,15 @@ static int32_t ducky_fnc_altchar(BadKbScript* bad_kb, const char* line, int32_t
     UNUSED(param);
 
     line = &line[ducky_get_command_len(line) + 1];
-    ducky_numlock_on(bad_kb);
-    bool state = ducky_altchar(bad_kb, line);
-    if(!state) {
+    size_t len = 0;
+    while(!ducky_is_line_end(line[len])) {
+        if((line[len] < '0') || (line[len] > '9') || (len == DUCKY_OP_PAYLOAD_MAX)) break;
+        len++;
+    }
+    if((len == 0) || !ducky_is_line_end(line[len])) {
         return ducky_error(bad_kb, "Invalid altchar %s", line);
     }
+    ducky_emit_op(bad_kb, DuckyOpAltChar, DuckyOpFlagNone, line, len);
     return 0;
 }
 
@@ -125,11 +114,24 @@ static int32_t ducky_fnc_altstring(BadKbScript* bad_kb, const char* line, int32_
     UNUSED(param);
 
     line = &line[ducky_get_command_len(line) + 1];
-    ducky_numlock_on(bad_kb);
-    bool state = ducky_altstring(bad_kb, line);
-    if(!state) {
+    bool has_printable = false;
+    for(size_t i = 0; line[i] != '\0'; i++) {
+        if((line[i] >= ' ') && (line[i] <= '~')) {
+            has_printable = true;
+            break;
+        }
+    }
+    if(!has_printable) {
         return ducky_error(bad_kb, "Invalid altstring %s", line);
     }
+
+    size_t len = strlen(line);
+    do {
+        size_t chunk_len = MIN(len, (size_t)DUCKY_OP_PAYLOAD_MAX);
+        ducky_emit_op(bad_kb, DuckyOpAltString, DuckyOpFlagNone, line, chunk_len);
+        line += chunk_len;
+        len -= chunk_len;
+    } while(len > 0);
     return 0;
 }
 
@@ -145,11 +147,7 @@ static int32_t ducky_fnc_hold(BadKbScript* bad_kb, const char* line, int32_t par
     if(bad_kb->key_hold_nb > (HID_KB_MAX_KEYS - 1)) {
         return ducky_error(bad_kb, "Too many keys are hold");
     }
-    if(bad_kb->bt) {
-        ble_profile_hid_kb_press(bad_kb->app->ble_hid, key);
-    } else {
-        furi_hal_hid_kb_press(key);
-    }
+    ducky_emit_op(bad_kb, DuckyOpHold, DuckyOpFlagNone, &key, sizeof(key));
     return 0;
 }
 
@@ -165,11 +163,7 @@ static int32_t ducky_fnc_release(BadKbScript* bad_kb, const char* line, int32_t
         return ducky_error(bad_kb, "No keys are hold");
     }
     bad_kb->key_hold_nb--;
-    if(bad_kb->bt) {
-        ble_profile_hid_kb_release(bad_kb->app->ble_hid, key);
-    } else {
-        furi_hal_hid_kb_release(key);
-    }
+    ducky_emit_op(bad_kb, DuckyOpRelease, DuckyOpFlagNone, &key, sizeof(key));
     return 0;
 }
 
@@ -181,14 +175,7 @@ static int32_t ducky_fnc_media(BadKbScript* bad_kb, const char* line, int32_t pa
     if(key == HID_CONSUMER_UNASSIGNED) {
         return ducky_error(bad_kb, "No keycode defined for %s", line);
     }
-    if(bad_kb->bt) {
-        ble_profile_hid_kb_press(bad_kb->app->ble_hid, key);
-        furi_delay_ms(bt_timeout);
-        ble_profile_hid_kb_release(bad_kb->app->ble_hid, key);
-    } else {
-        furi_hal_hid_kb_press(key);
-        furi_hal_hid_kb_release(key);
-    }
+    ducky_emit_op(bad_kb, DuckyOpMedia, DuckyOpFlagNone, &key, sizeof(key));
     return 0;
 }
 
@@ -200,43 +187,31 @@ static int32_t ducky_fnc_globe(BadKbScript* bad_kb, const char* line, int32_t pa
     if(key == HID_KEYBOARD_NONE) {
         return ducky_error(bad_kb, "No keycode defined for %s", line);
     }
-
-    if(bad_kb->bt) {
-        ble_profile_hid_consumer_key_press(bad_kb->app->ble_hid, HID_CONSUMER_FN_GLOBE);
-        ble_profile_hid_kb_press(bad_kb->app->ble_hid, key);
-        furi_delay_ms(bt_timeout);
-        ble_profile_hid_kb_release(bad_kb->app->ble_hid, key);
-        ble_profile_hid_consumer_key_release(bad_kb->app->ble_hid, HID_CONSUMER_FN_GLOBE);
-    } else {
-        furi_hal_hid_consumer_key_press(HID_CONSUMER_FN_GLOBE);
-        furi_hal_hid_kb_press(key);
-        furi_hal_hid_kb_release(key);
-        furi_hal_hid_consumer_key_release(HID_CONSUMER_FN_GLOBE);
-    }
+    ducky_emit_op(bad_kb, DuckyOpGlobe, DuckyOpFlagNone, &key, sizeof(key));
     return 0;
 }
 
 static int32_t ducky_fnc_waitforbutton(BadKbScript* bad_kb, const char* line, int32_t param) {
     UNUSED(param);
-    UNUSED(bad_kb);
     UNUSED(line);
 
-    return SCRIPT_STATE_WAIT_FOR_BTN;
+    ducky_emit_op(bad_kb, DuckyOpWaitForButton, DuckyOpFlagNone, NULL, 0);
+    return 0;
 }
 
 static const DuckyCmd ducky_commands[] = {
-    {"REM", NULL, -1},
-    {"ID", NULL, -1},
-    {"BT_ID", NULL, -1},
-    {"DELAY", ducky_fnc_delay, -1},
+    {"REM", ducky_fnc_nop, -1},
+    {"ID", ducky_fnc_nop, -1},
+    {"BT_ID", ducky_fnc_nop, -1},
+    {"DELAY", ducky_fnc_delay, DuckyOpDelay},
     {"STRING", ducky_fnc_string, 0},
     {"STRINGLN", ducky_fnc_string, 1},
-    {"DEFAULT_DELAY", ducky_fnc_defdelay, -1},
-    {"DEFAULTDELAY", ducky_fnc_defdelay, -1},
-    {"STRINGDELAY", ducky_fnc_strdelay, -1},
-    {"STRING_DELAY", ducky_fnc_strdelay, -1},
-    {"DEFAULT_STRING_DELAY", ducky_fnc_defstrdelay, -1},
-    {"DEFAULTSTRINGDELAY", ducky_fnc_defstrdelay, -1},
+    {"DEFAULT_DELAY", ducky_fnc_set_delay, DuckyOpDefDelay},
+    {"DEFAULTDELAY", ducky_fnc_set_delay, DuckyOpDefDelay},
+    {"STRINGDELAY", ducky_fnc_set_delay, DuckyOpStringDelay},
+    {"STRING_DELAY", ducky_fnc_set_delay, DuckyOpStringDelay},
+    {"DEFAULT_STRING_DELAY", ducky_fnc_set_delay, DuckyOpDefStringDelay},
+    {"DEFAULTSTRINGDELAY", ducky_fnc_set_delay, DuckyOpDefStringDelay},
     {"REPEAT", ducky_fnc_repeat, -1},
     {"SYSRQ", ducky_fnc_sysrq, -1},
     {"ALTCHAR", ducky_fnc_altchar, -1},
@@ -252,7 +227,7 @@ static const DuckyCmd ducky_commands[] = {
 #define TAG "BadKb"
 #define WORKER_TAG TAG "Worker"
 
-int32_t ducky_execute_cmd(BadKbScript* bad_kb, const char* line) {
+int32_t ducky_compile_cmd(BadKbScript* bad_kb, const char* line) {
     size_t cmd_word_len = strcspn(line, " ");
     for(size_t i = 0; i < COUNT_OF(ducky_commands); i++) {
         size_t cmd_compare_len = strlen(ducky_commands[i].name);
@@ -262,11 +237,7 @@ int32_t ducky_execute_cmd(BadKbScript* bad_kb, const char* line) {
         }
 
         if(strncmp(line, ducky_commands[i].name, cmd_compare_len) == 0) {
-            if(ducky_commands[i].callback == NULL) {
-                return 0;
-            } else {
-                return ((ducky_commands[i].callback)(bad_kb, line, ducky_commands[i].param));
-            }
+            return ((ducky_commands[i].callback)(bad_kb, line, ducky_commands[i].param));
         }
     }
 
@@ -0,0 +1,483 @@
+#include "../bad_kb_app_i.h"
+#include <furi.h>
+#include <furi_hal.h>
+#include <storage/storage.h>
+#include "ducky_script.h"
+#include "ducky_script_i.h"
+
+#define TAG "BadKb"
+#define COMPILER_TAG TAG "Compiler"
+
+#define BYTECODE_MAGIC (0x43424B42UL) // "BKBC"
+#define BYTECODE_VERSION (3)
+#define BYTECODE_EXTENSION ".bkc"
+#define BYTECODE_WRITE_BUFFER_LEN 512
+#define BYTECODE_SOURCE_PATH_LEN 256
+// Stale cache files are collected and then removed in batches, dir can't change while it's read
+#define BYTECODE_PRUNE_BATCH 8
+
+#define FNV1A_OFFSET_BASIS (2166136261UL)
+#define FNV1A_PRIME (16777619UL)
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t reserved[3];
+    uint32_t source_hash;
+    uint32_t line_nb;
+    // Script the cache was built from, cache is removed once the script is gone
+    char source_path[BYTECODE_SOURCE_PATH_LEN];
+} DuckyBytecodeHeader;
+
+struct DuckyCompiler {
+    // Copy of the selected layout, so layout lock isn't held while the script is compiled
+    uint16_t layout[128];
+    File* file;
+    uint32_t line;
+    uint32_t offset;
+    // Ops of the last line that is not REPEAT, used as REPEAT target
+    uint32_t prev_start;
+    uint32_t prev_len;
+    int8_t prev_hold_delta;
+    bool write_error;
+    size_t buf_len;
+    uint8_t buf[BYTECODE_WRITE_BUFFER_LEN];
+};
+
+uint32_t ducky_hash_update(uint32_t hash, const void* data, size_t len) {
+    const uint8_t* bytes = data;
+    if(hash == 0) hash = FNV1A_OFFSET_BASIS;
+    for(size_t i = 0; i < len; i++) {
+        hash ^= bytes[i];
+        hash *= FNV1A_PRIME;
+    }
+    return hash;
+}
+
+const uint16_t* ducky_compiler_get_layout(BadKbScript* bad_kb) {
+    furi_assert(bad_kb->compiler);
+    return bad_kb->compiler->layout;
+}
+
+static void ducky_bytecode_get_path(BadKbScript* bad_kb, FuriString* path) {
+    // One cache file per script path, its content is validated by source hash
+    uint32_t path_hash = ducky_hash_update(
+        0, furi_string_get_cstr(bad_kb->file_path), furi_string_size(bad_kb->file_path));
+    furi_string_printf(
+        path, "%s/%08lX%s", BAD_KB_APP_CACHE_FOLDER, path_hash, BYTECODE_EXTENSION);
+}
+
+static uint32_t ducky_bytecode_source_hash(BadKbScript* bad_kb, const uint16_t* layout) {
+    // Keycodes are resolved at compile time, so layout is a part of the source
+    uint32_t hash = ducky_hash_update(bad_kb->script_hash, layout, sizeof(bad_kb->layout));
+    uint8_t version = BYTECODE_VERSION;
+    return ducky_hash_update(hash, &version, sizeof(version));
+}
+
+static bool ducky_bytecode_is_stale(Storage* storage, File* file, const char* path) {
+    DuckyBytecodeHeader header;
+    if(!storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) return false;
+    bool stale = (storage_file_read(file, &header, sizeof(header)) != sizeof(header)) ||
+                 (header.magic != BYTECODE_MAGIC) || (header.version != BYTECODE_VERSION);
+    storage_file_close(file);
+    if(!stale) {
+        header.source_path[BYTECODE_SOURCE_PATH_LEN - 1] = '\0';
+        stale = !storage_file_exists(storage, header.source_path);
+    }
+    return stale;
+}
+
+static void ducky_bytecode_prune(Storage* storage, const char* keep_path) {
+    // Removes caches of deleted or renamed scripts and caches left by older versions
+    File* dir = storage_file_alloc(storage);
+    File* file = storage_file_alloc(storage);
+    FuriString* path = furi_string_alloc();
+    FuriString* stale[BYTECODE_PRUNE_BATCH];
+    for(size_t i = 0; i < BYTECODE_PRUNE_BATCH; i++) {
+        stale[i] = furi_string_alloc();
+    }
+    char name[64];
+    size_t stale_nb;
+
+    do {
+        stale_nb = 0;
+        if(!storage_dir_open(dir, BAD_KB_APP_CACHE_FOLDER)) {
+            storage_dir_close(dir);
+            break;
+        }
+        FileInfo info;
+        while((stale_nb < BYTECODE_PRUNE_BATCH) &&
+              storage_dir_read(dir, &info, name, sizeof(name))) {
+            if(info.flags & FSF_DIRECTORY) continue;
+            furi_string_printf(path, "%s/%s", BAD_KB_APP_CACHE_FOLDER, name);
+            if(!furi_string_end_with_str(path, BYTECODE_EXTENSION) ||
+               furi_string_equal_str(path, keep_path)) {
+                continue;
+            }
+            if(ducky_bytecode_is_stale(storage, file, furi_string_get_cstr(path))) {
+                furi_string_set(stale[stale_nb++], path);
+            }
+        }
+        storage_dir_close(dir);
+
+        for(size_t i = 0; i < stale_nb; i++) {
+            FURI_LOG_D(COMPILER_TAG, "Remove stale %s", furi_string_get_cstr(stale[i]));
+            storage_simply_remove(storage, furi_string_get_cstr(stale[i]));
+        }
+    } while(stale_nb == BYTECODE_PRUNE_BATCH);
+
+    for(size_t i = 0; i < BYTECODE_PRUNE_BATCH; i++) {
+        furi_string_free(stale[i]);
+    }
+    furi_string_free(path);
+    storage_file_free(file);
+    storage_file_free(dir);
+}
+
+static void ducky_compiler_write(DuckyCompiler* compiler, const void* data, size_t len) {
+    const uint8_t* bytes = data;
+    compiler->offset += len;
+    while(len > 0) {
+        if(compiler->buf_len == BYTECODE_WRITE_BUFFER_LEN) {
+            if(storage_file_write(compiler->file, compiler->buf, compiler->buf_len) !=
+               compiler->buf_len) {
+                compiler->write_error = true;
+            }
+            compiler->buf_len = 0;
+        }
+        size_t chunk_len = MIN(len, BYTECODE_WRITE_BUFFER_LEN - compiler->buf_len);
+        memcpy(&compiler->buf[compiler->buf_len], bytes, chunk_len);
+        compiler->buf_len += chunk_len;
+        bytes += chunk_len;
+        len -= chunk_len;
+    }
+}
+
+static void ducky_compiler_flush(DuckyCompiler* compiler) {
+    if(compiler->buf_len > 0) {
+        if(storage_file_write(compiler->file, compiler->buf, compiler->buf_len) !=
+           compiler->buf_len) {
+            compiler->write_error = true;
+        }
+        compiler->buf_len = 0;
+    }
+}
+
+void ducky_emit_op(
+    BadKbScript* bad_kb,
+    DuckyOpCode opcode,
+    uint8_t flags,
+    const void* payload,
+    size_t payload_len) {
+    DuckyCompiler* compiler = bad_kb->compiler;
+    furi_assert(compiler);
+    furi_check(payload_len <= DUCKY_OP_PAYLOAD_MAX);
+
+    DuckyOpHeader op = {
+        .opcode = opcode,
+        .flags = flags,
+        .payload_len = payload_len,
+        .line = compiler->line,
+    };
+    ducky_compiler_write(compiler, &op, sizeof(op));
+    if(payload_len > 0) {
+        ducky_compiler_write(compiler, payload, payload_len);
+    }
+}
+
+static int32_t ducky_compile_line(BadKbScript* bad_kb, FuriString* line) {
+    uint32_t line_len = furi_string_size(line);
+    const char* line_tmp = furi_string_get_cstr(line);
+
+    if(line_len == 0) {
+        return SCRIPT_STATE_NEXT_LINE; // Skip empty lines
+    }
+
+    // Ducky Lang Functions
+    int32_t cmd_result = ducky_compile_cmd(bad_kb, line_tmp);
+    if(cmd_result != SCRIPT_STATE_CMD_UNKNOWN) {
+        return cmd_result;
+    }
+
+    // Special keys + modifiers
+    uint16_t key = ducky_get_keycode(bad_kb, line_tmp, false);
+    if(key == HID_KEYBOARD_NONE) {
+        return ducky_error(bad_kb, "No keycode defined for %s", line_tmp);
+    }
+    if((key & 0xFF00) != 0) {
+        // It's a modifier key
+        uint32_t offset = ducky_get_command_len(line_tmp) + 1;
+        // ducky_get_command_len() returns 0 without space, so check for != 1
+        if(offset != 1 && line_len > offset) {
+            // It's also a key combination
+            key |= ducky_get_keycode(bad_kb, line_tmp + offset, true);
+        }
+    }
+    ducky_emit_op(bad_kb, DuckyOpKey, DuckyOpFlagNone, &key, sizeof(key));
+    return 0;
+}
+
+static int32_t ducky_compile_next_line(BadKbScript* bad_kb) {
+    DuckyCompiler* compiler = bad_kb->compiler;
+    furi_string_trim(bad_kb->line);
+
+    uint32_t line_start = compiler->offset;
+    uint8_t key_hold_nb = bad_kb->key_hold_nb;
+    bad_kb->repeat_cnt = 0;
+    int32_t result = ducky_compile_line(bad_kb, bad_kb->line);
+    if(result < 0 && result != SCRIPT_STATE_NEXT_LINE) {
+        return result;
+    }
+
+    if(bad_kb->repeat_cnt > 0) {
+        // Previous line is replayed by executor, HOLD/RELEASE balance is checked for all runs
+        uint64_t repeat_cnt = bad_kb->repeat_cnt;
+        bad_kb->repeat_cnt = 0;
+        if(compiler->prev_hold_delta > 0) {
+            if(bad_kb->key_hold_nb + repeat_cnt > (HID_KB_MAX_KEYS - 1)) {
+                return ducky_error(bad_kb, "Too many keys are hold");
+            }
+            bad_kb->key_hold_nb += repeat_cnt;
+        } else if(compiler->prev_hold_delta < 0) {
+            if(bad_kb->key_hold_nb < repeat_cnt) {
+                return ducky_error(bad_kb, "No keys are hold");
+            }
+            bad_kb->key_hold_nb -= repeat_cnt;
+        }
+        if(compiler->prev_len > 0) {
+            DuckyOpRepeatPayload repeat = {
+                .start = compiler->prev_start,
+                .len = compiler->prev_len,
+                .count = repeat_cnt,
+            };
+            ducky_emit_op(bad_kb, DuckyOpRepeat, DuckyOpFlagNone, &repeat, sizeof(repeat));
+        }
+    } else {
+        compiler->prev_start = line_start;
+        compiler->prev_len = compiler->offset - line_start;
+        compiler->prev_hold_delta = (int8_t)(bad_kb->key_hold_nb - key_hold_nb);
+    }
+
+    return 0;
+}
+
+static int32_t ducky_compile_script(BadKbScript* bad_kb, File* script_file) {
+    DuckyCompiler* compiler = bad_kb->compiler;
+    size_t line_len = 0;
+    size_t ret = 0;
+
+    furi_string_reset(bad_kb->line);
+    bad_kb->key_hold_nb = 0;
+    storage_file_seek(script_file, 0, true);
+
+    do {
+        ret = storage_file_read(script_file, bad_kb->file_buf, FILE_BUFFER_LEN);
+        bool file_end = (ret == 0) || storage_file_eof(script_file);
+        for(size_t i = 0; i <= ret; i++) {
+            if(i < ret && bad_kb->file_buf[i] != '\n') {
+                furi_string_push_back(bad_kb->line, bad_kb->file_buf[i]);
+                line_len++;
+                continue;
+            }
+            // Line is terminated by new line char or by end of file
+            if((i == ret && !file_end) || line_len == 0) continue;
+
+            compiler->line++;
+            int32_t result = ducky_compile_next_line(bad_kb);
+            if(result < 0) {
+                bad_kb->st.error_line = compiler->line;
+                FURI_LOG_E(COMPILER_TAG, "Error at line %lu", compiler->line);
+                return result;
+            }
+            furi_string_reset(bad_kb->line);
+            line_len = 0;
+        }
+        if(file_end) break;
+    } while(!compiler->write_error);
+
+    return 0;
+}
+
+int32_t ducky_script_compile(BadKbScript* bad_kb, File* script_file) {
+    // Layout is a part of the cache key and of the bytecode, compiler works on a copy of it
+    // so it can't change halfway and layout selection doesn't wait for a long script
+    DuckyCompiler* compiler = malloc(sizeof(DuckyCompiler));
+    furi_mutex_acquire(bad_kb->layout_mutex, FuriWaitForever);
+    memcpy(compiler->layout, bad_kb->layout, sizeof(compiler->layout));
+    furi_mutex_release(bad_kb->layout_mutex);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FuriString* path = furi_string_alloc();
+    ducky_bytecode_get_path(bad_kb, path);
+
+    uint32_t source_hash = ducky_bytecode_source_hash(bad_kb, compiler->layout);
+    int32_t result = 0;
+
+    File* file = storage_file_alloc(storage);
+    do {
+        DuckyBytecodeHeader header;
+        if(storage_file_open(file, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+            bool cached =
+                (storage_file_read(file, &header, sizeof(header)) == sizeof(header)) &&
+                (header.magic == BYTECODE_MAGIC) && (header.version == BYTECODE_VERSION) &&
+                (header.source_hash == source_hash);
+            storage_file_close(file);
+            if(cached) {
+                FURI_LOG_D(COMPILER_TAG, "Cache hit: %s", furi_string_get_cstr(path));
+                bad_kb->st.line_nb = header.line_nb;
+                break;
+            }
+        }
+
+        storage_simply_mkdir(storage, BAD_KB_APP_CACHE_FOLDER);
+        // Script or layout has changed, it's a good time to drop caches nobody will use again
+        ducky_bytecode_prune(storage, furi_string_get_cstr(path));
+        if(!storage_file_open(file, furi_string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            FURI_LOG_E(COMPILER_TAG, "Can't create %s", furi_string_get_cstr(path));
+            result = SCRIPT_STATE_FILE_ERROR;
+            break;
+        }
+
+        // Header stays invalid until compilation is finished
+        memset(&header, 0, sizeof(header));
+        compiler->file = file;
+        compiler->line = 0;
+        compiler->offset = 0;
+        compiler->prev_start = 0;
+        compiler->prev_len = 0;
+        compiler->prev_hold_delta = 0;
+        compiler->write_error = false;
+        compiler->buf_len = 0;
+        bad_kb->compiler = compiler;
+
+        ducky_compiler_write(compiler, &header, sizeof(header));
+        result = ducky_compile_script(bad_kb, script_file);
+        ducky_compiler_flush(compiler);
+
+        if(result == 0 && !compiler->write_error) {
+            header.magic = BYTECODE_MAGIC;
+            header.version = BYTECODE_VERSION;
+            header.source_hash = source_hash;
+            header.line_nb = compiler->line;
+            strlcpy(
+                header.source_path,
+                furi_string_get_cstr(bad_kb->file_path),
+                sizeof(header.source_path));
+            if(!storage_file_seek(file, 0, true) ||
+               storage_file_write(file, &header, sizeof(header)) != sizeof(header)) {
+                compiler->write_error = true;
+            }
+            bad_kb->st.line_nb = header.line_nb;
+        }
+
+        if(compiler->write_error) {
+            FURI_LOG_E(COMPILER_TAG, "Write error: %s", furi_string_get_cstr(path));
+            result = SCRIPT_STATE_FILE_ERROR;
+        }
+
+        bad_kb->compiler = NULL;
+        storage_file_close(file);
+        FURI_LOG_D(COMPILER_TAG, "Compiled %lu lines", header.line_nb);
+    } while(false);
+
+    storage_file_free(file);
+    furi_string_free(path);
+    furi_record_close(RECORD_STORAGE);
+    free(compiler);
+
+    return result;
+}
+
+static bool ducky_bytecode_seek(BadKbScript* bad_kb, uint32_t pos) {
+    bad_kb->buf_start = 0;
+    bad_kb->buf_len = 0;
+    bad_kb->bytecode_pos = pos;
+    return storage_file_seek(bad_kb->bytecode_file, pos, true);
+}
+
+bool ducky_bytecode_open(BadKbScript* bad_kb) {
+    FuriString* path = furi_string_alloc();
+    ducky_bytecode_get_path(bad_kb, path);
+
+    bool result = false;
+    if(storage_file_open(
+           bad_kb->bytecode_file, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+        result = ducky_bytecode_seek(bad_kb, sizeof(DuckyBytecodeHeader));
+    }
+
+    bad_kb->bytecode_end = false;
+    bad_kb->repeat_left = 0;
+    furi_string_free(path);
+    return result;
+}
+
+static bool ducky_bytecode_read(BadKbScript* bad_kb, void* data, size_t len) {
+    uint8_t* bytes = data;
+    while(len > 0) {
+        if(bad_kb->buf_len == 0) {
+            bad_kb->buf_start = 0;
+            bad_kb->buf_len =
+                storage_file_read(bad_kb->bytecode_file, bad_kb->file_buf, FILE_BUFFER_LEN);
+            if(bad_kb->buf_len == 0) return false;
+        }
+        size_t chunk_len = MIN(len, bad_kb->buf_len);
+        memcpy(bytes, &bad_kb->file_buf[bad_kb->buf_start], chunk_len);
+        bad_kb->buf_start += chunk_len;
+        bad_kb->buf_len -= chunk_len;
+        bad_kb->bytecode_pos += chunk_len;
+        bytes += chunk_len;
+        len -= chunk_len;
+    }
+    return true;
+}
+
+bool ducky_bytecode_read_op(BadKbScript* bad_kb) {
+    while(true) {
+        if((bad_kb->repeat_left > 0) && (bad_kb->bytecode_pos == bad_kb->repeat_end)) {
+            // End of repeated ops: run them again or continue after REPEAT
+            bad_kb->repeat_left--;
+            uint32_t pos = (bad_kb->repeat_left > 0) ? bad_kb->repeat_start :
+                                                       bad_kb->repeat_return;
+            if(!ducky_bytecode_seek(bad_kb, pos)) return false;
+        }
+
+        if((bad_kb->buf_len == 0) && storage_file_eof(bad_kb->bytecode_file)) {
+            bad_kb->bytecode_end = true;
+            return false;
+        }
+
+        if(!ducky_bytecode_read(bad_kb, &bad_kb->op, sizeof(bad_kb->op))) {
+            return false;
+        }
+
+        if((bad_kb->op.payload_len > DUCKY_OP_PAYLOAD_MAX) ||
+           !ducky_bytecode_read(bad_kb, bad_kb->op_payload, bad_kb->op.payload_len)) {
+            return false;
+        }
+        bad_kb->op_payload[bad_kb->op.payload_len] = '\0';
+
+        if(bad_kb->op.opcode != DuckyOpRepeat) {
+            return true;
+        }
+
+        DuckyOpRepeatPayload repeat;
+        if(bad_kb->op.payload_len != sizeof(repeat)) return false;
+        memcpy(&repeat, bad_kb->op_payload, sizeof(repeat));
+        // Repeated ops always belong to a line before REPEAT, so REPEATs can't nest
+        if((repeat.count == 0) || (repeat.len == 0) ||
+           (repeat.start + repeat.len > bad_kb->bytecode_pos) || (bad_kb->repeat_left > 0)) {
+            return false;
+        }
+        bad_kb->repeat_start = repeat.start;
+        bad_kb->repeat_end = repeat.start + repeat.len;
+        bad_kb->repeat_return = bad_kb->bytecode_pos;
+        bad_kb->repeat_left = repeat.count;
+        if(!ducky_bytecode_seek(bad_kb, repeat.start)) return false;
+    }
+}
+
+void ducky_bytecode_close(BadKbScript* bad_kb) {
+    if(storage_file_is_open(bad_kb->bytecode_file)) {
+        storage_file_close(bad_kb->bytecode_file);
+    }
+}
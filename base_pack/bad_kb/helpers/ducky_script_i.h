@@ -6,6 +6,7 @@ extern "C" {
 
 #include <furi.h>
 #include <furi_hal.h>
+#include <storage/storage.h>
 #include "ducky_script.h"
 
 #define SCRIPT_STATE_ERROR (-1)
@@ -14,8 +15,55 @@ extern "C" {
 #define SCRIPT_STATE_CMD_UNKNOWN (-4)
 #define SCRIPT_STATE_STRING_START (-5)
 #define SCRIPT_STATE_WAIT_FOR_BTN (-6)
-
-#define FILE_BUFFER_LEN 16
+#define SCRIPT_STATE_FILE_ERROR (-7)
+
+#define FILE_BUFFER_LEN 512
+
+// Keycodes are resolved by compiler only, from its copy of the layout
+#define BADKB_ASCII_TO_KEY(script, x) \
+    (((uint8_t)x < 128) ? (ducky_compiler_get_layout(script)[(uint8_t)x]) : HID_KEYBOARD_NONE)
+
+// Max op payload, long STRING/ALTSTRING lines are split into several ops
+#define DUCKY_OP_PAYLOAD_MAX 512
+
+typedef enum {
+    DuckyOpNop, // REM, ID, BT_ID: only default delay is applied
+    DuckyOpKey, // uint16_t key (with modifiers)
+    DuckyOpString, // uint16_t keycodes[], resolved with selected layout
+    DuckyOpDelay, // uint32_t delay
+    DuckyOpDefDelay, // uint32_t delay
+    DuckyOpStringDelay, // uint32_t delay
+    DuckyOpDefStringDelay, // uint32_t delay
+    DuckyOpSysrq, // uint16_t key
+    DuckyOpAltChar, // char digits[]
+    DuckyOpAltString, // char string[]
+    DuckyOpHold, // uint16_t key
+    DuckyOpRelease, // uint16_t key
+    DuckyOpMedia, // uint16_t key
+    DuckyOpGlobe, // uint16_t key
+    DuckyOpWaitForButton,
+    DuckyOpRepeat, // DuckyOpRepeatPayload, replays ops of a previous line
+} DuckyOpCode;
+
+typedef enum {
+    DuckyOpFlagNone = 0,
+    DuckyOpFlagStringMore = (1 << 0), // Next op continues this STRING
+} DuckyOpFlags;
+
+typedef struct {
+    uint8_t opcode;
+    uint8_t flags;
+    uint16_t payload_len;
+    uint32_t line;
+} DuckyOpHeader;
+
+typedef struct {
+    uint32_t start; // Bytecode offset of the repeated ops
+    uint32_t len;
+    uint32_t count;
+} DuckyOpRepeatPayload;
+
+typedef struct DuckyCompiler DuckyCompiler;
 
 struct BadKbScript {
     FuriThread* thread;
@@ -23,22 +71,31 @@ struct BadKbScript {
 
     FuriString* file_path;
     FuriString* keyboard_layout;
-    uint8_t file_buf[FILE_BUFFER_LEN + 1];
-    uint8_t buf_start;
-    uint8_t buf_len;
-    bool file_end;
+    uint8_t* file_buf;
+    size_t buf_start;
+    size_t buf_len;
+    uint32_t script_hash;
 
     uint32_t defdelay;
     uint32_t stringdelay;
     uint32_t defstringdelay;
     uint16_t layout[128];
+    FuriMutex* layout_mutex;
 
     FuriString* line;
-    FuriString* line_prev;
     uint32_t repeat_cnt;
     uint8_t key_hold_nb;
-
-    FuriString* string_print;
+    DuckyCompiler* compiler;
+
+    File* bytecode_file;
+    bool bytecode_end;
+    uint32_t bytecode_pos;
+    uint32_t repeat_left;
+    uint32_t repeat_start;
+    uint32_t repeat_end;
+    uint32_t repeat_return;
+    DuckyOpHeader op;
+    uint8_t op_payload[DUCKY_OP_PAYLOAD_MAX + 1];
     size_t string_print_pos;
 
     Bt* bt;
@@ -65,12 +122,29 @@ bool ducky_altchar(BadKbScript* bad_kb, const char* charcode);
 
 bool ducky_altstring(BadKbScript* bad_kb, const char* param);
 
-bool ducky_string(BadKbScript* bad_kb, const char* param);
-
-int32_t ducky_execute_cmd(BadKbScript* bad_kb, const char* line);
+int32_t ducky_compile_cmd(BadKbScript* bad_kb, const char* line);
 
 int32_t ducky_error(BadKbScript* bad_kb, const char* text, ...);
 
+uint32_t ducky_hash_update(uint32_t hash, const void* data, size_t len);
+
+const uint16_t* ducky_compiler_get_layout(BadKbScript* bad_kb);
+
+void ducky_emit_op(
+    BadKbScript* bad_kb,
+    DuckyOpCode opcode,
+    uint8_t flags,
+    const void* payload,
+    size_t payload_len);
+
+int32_t ducky_script_compile(BadKbScript* bad_kb, File* script_file);
+
+bool ducky_bytecode_open(BadKbScript* bad_kb);
+
+bool ducky_bytecode_read_op(BadKbScript* bad_kb);
+
+void ducky_bytecode_close(BadKbScript* bad_kb);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,6 +4,7 @@
 #include <furi.h>
 #include <furi_hal_power.h>
 #include <gui/gui.h>
+#include <gui/elements.h>
 #include <string.h>
 #include <expansion/expansion.h>
 
@@ -17,6 +18,62 @@ typedef struct {
     InputEvent input;
 } PluginEvent;
 
+static void render_track(Canvas* const canvas, GpsUart* gps_uart) {
+    char buffer[64];
+    GpsTrackStats stats;
+    gps_track_get_stats(gps_uart->track, &stats);
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(canvas, 0, 8, AlignLeft, AlignBottom, "Track");
+    if(gps_track_is_recording(gps_uart->track)) {
+        canvas_draw_str_aligned(canvas, 127, 8, AlignRight, AlignBottom, "REC");
+    }
+
+    canvas_set_font(canvas, FontSecondary);
+    if(stats.dropped > 0) {
+        snprintf(buffer, 64, "Points: %lu (%lu lost)", stats.points, stats.dropped);
+    } else {
+        snprintf(buffer, 64, "Points: %lu", stats.points);
+    }
+    canvas_draw_str_aligned(canvas, 0, 20, AlignLeft, AlignBottom, buffer);
+    snprintf(buffer, 64, "Distance: %.2f km", (double)(stats.distance / 1000));
+    canvas_draw_str_aligned(canvas, 0, 30, AlignLeft, AlignBottom, buffer);
+    uint32_t duration = stats.last_time - stats.start_time;
+    snprintf(
+        buffer,
+        64,
+        "Time: %02lu:%02lu:%02lu",
+        duration / 3600,
+        duration / 60 % 60,
+        duration % 60);
+    canvas_draw_str_aligned(canvas, 0, 40, AlignLeft, AlignBottom, buffer);
+
+    switch(gps_uart->speed_units) {
+    case KPH:
+        snprintf(buffer, 64, "Max speed: %.1f km/h", (double)(stats.max_speed * KNOTS_TO_KPH));
+        break;
+    case MPH:
+        snprintf(buffer, 64, "Max speed: %.1f mi/h", (double)(stats.max_speed * KNOTS_TO_MPH));
+        break;
+    case KNOTS:
+    default:
+        snprintf(buffer, 64, "Max speed: %.1f kn", (double)stats.max_speed);
+        break;
+    }
+    canvas_draw_str_aligned(canvas, 0, 50, AlignLeft, AlignBottom, buffer);
+
+    FuriString* name = furi_string_alloc();
+    gps_track_get_name(gps_uart->track, name);
+    canvas_draw_str_aligned(
+        canvas,
+        0,
+        62,
+        AlignLeft,
+        AlignBottom,
+        furi_string_empty(name) ? "Hold OK to record" : furi_string_get_cstr(name));
+    furi_string_free(name);
+}
+
 static void render_callback(Canvas* const canvas, void* context) {
     furi_assert(context);
     GpsUart* gps_uart = context;
@@ -67,8 +124,46 @@ static void render_callback(Canvas* const canvas, void* context) {
             break;
         }
         break;
+    case CHANGE_RECORDING:
+        canvas_set_font(canvas, FontPrimary);
+        if(!gps_uart->track_result) {
+            canvas_draw_str_aligned(
+                canvas, 64, 32, AlignCenter, AlignBottom, "Cannot create track");
+        } else {
+            canvas_draw_str_aligned(
+                canvas,
+                64,
+                32,
+                AlignCenter,
+                AlignBottom,
+                gps_track_is_recording(gps_uart->track) ? "Recording started" :
+                                                          "Recording stopped");
+        }
+        break;
+    case EXPORT_GPX:
+        canvas_set_font(canvas, FontPrimary);
+        canvas_draw_str_aligned(
+            canvas,
+            64,
+            32,
+            AlignCenter,
+            AlignBottom,
+            gps_uart->track_result ? "GPX saved" : "GPX export failed");
+        break;
+    case EXPORTING_GPX: {
+        uint8_t progress = gps_track_export_progress(gps_uart->track);
+        canvas_set_font(canvas, FontPrimary);
+        canvas_draw_str_aligned(canvas, 64, 24, AlignCenter, AlignBottom, "Exporting GPX");
+        elements_progress_bar(canvas, 14, 30, 100, progress / 100.0f);
+        canvas_set_font(canvas, FontSecondary);
+        canvas_draw_str_aligned(canvas, 64, 58, AlignCenter, AlignBottom, "Back to cancel");
+    } break;
     case NORMAL:
     default:
+        if(gps_uart->track_view) {
+            render_track(canvas, gps_uart);
+            break;
+        }
         canvas_set_font(canvas, FontPrimary);
         canvas_draw_str_aligned(canvas, 32, 8, AlignCenter, AlignBottom, "Latitude");
         canvas_draw_str_aligned(canvas, 96, 8, AlignCenter, AlignBottom, "Longitude");
@@ -170,6 +265,7 @@ int32_t gps_app(void* p) {
     gui_add_view_port(gui, view_port, GuiLayerFullscreen);
 
     PluginEvent event;
+    bool export_cancelled = false;
     for(bool processing = true; processing;) {
         FuriStatus event_status = furi_message_queue_get(event_queue, &event, 100);
 
@@ -177,7 +273,13 @@ int32_t gps_app(void* p) {
 
         if(event_status == FuriStatusOk) {
             // press events
-            if(event.type == EventTypeKey) {
+            if(event.type == EventTypeKey && gps_uart->view_state == EXPORTING_GPX) {
+                // the export runs on its own thread, Back cancels it and other keys wait
+                if(event.input.type == InputTypeShort && event.input.key == InputKeyBack) {
+                    gps_track_export_cancel(gps_uart->track);
+                    export_cancelled = true;
+                }
+            } else if(event.type == EventTypeKey) {
                 if(event.input.type == InputTypeShort) {
                     switch(event.input.key) {
                     case InputKeyBack:
@@ -202,6 +304,9 @@ int32_t gps_app(void* p) {
                         furi_delay_ms(1000);
                         gps_uart->view_state = NORMAL;
                         break;
+                    case InputKeyLeft:
+                        gps_uart->track_view = !gps_uart->track_view;
+                        break;
                     default:
                         break;
                     }
@@ -246,6 +351,34 @@ int32_t gps_app(void* p) {
                             (uint8_t*)"$PMTK161,0*28\r\n",
                             strlen("$PMTK161,0*28\r\n"));
 
+                        furi_mutex_release(gps_uart->mutex);
+                        view_port_update(view_port);
+                        furi_delay_ms(1000);
+                        gps_uart->view_state = NORMAL;
+                        break;
+                    case InputKeyOk:
+                        if(gps_track_is_recording(gps_uart->track)) {
+                            gps_track_stop(gps_uart->track);
+                            gps_uart->track_result = true;
+                        } else {
+                            gps_uart->track_result = gps_track_start(gps_uart->track);
+                        }
+
+                        gps_uart->view_state = CHANGE_RECORDING;
+                        furi_mutex_release(gps_uart->mutex);
+                        view_port_update(view_port);
+                        furi_delay_ms(1000);
+                        gps_uart->view_state = NORMAL;
+                        break;
+                    case InputKeyLeft:
+                        if(gps_track_export_start(gps_uart->track)) {
+                            export_cancelled = false;
+                            gps_uart->view_state = EXPORTING_GPX;
+                            break;
+                        }
+                        gps_uart->track_result = false;
+
+                        gps_uart->view_state = EXPORT_GPX;
                         furi_mutex_release(gps_uart->mutex);
                         view_port_update(view_port);
                         furi_delay_ms(1000);
@@ -260,7 +393,20 @@ int32_t gps_app(void* p) {
                 }
             }
         }
-        if(gps_uart->view_state == NORMAL) {
+        bool export_success;
+        if(gps_uart->view_state == EXPORTING_GPX &&
+           gps_track_export_poll(gps_uart->track, &export_success)) {
+            if(!export_cancelled) {
+                gps_uart->track_result = export_success;
+                gps_uart->view_state = EXPORT_GPX;
+                furi_mutex_release(gps_uart->mutex);
+                view_port_update(view_port);
+                furi_delay_ms(1000);
+                furi_mutex_acquire(gps_uart->mutex, FuriWaitForever);
+            }
+            gps_uart->view_state = NORMAL;
+        }
+        if(gps_uart->view_state == NORMAL || gps_uart->view_state == EXPORTING_GPX) {
             furi_mutex_release(gps_uart->mutex);
             view_port_update(view_port);
         }
@@ -0,0 +1,462 @@
+#include "gps_track.h"
+
+#include <math.h>
+#include <furi_hal_rtc.h>
+#include <datetime/datetime.h>
+
+#define TAG "GpsTrack"
+
+#define GPS_TRACK_MAGIC "GTRK"
+#define GPS_TRACK_VERSION 1
+
+#define GPS_TRACK_EARTH_RADIUS_M 6371000.0f
+// GPX text is written to the card in chunks of about this size
+#define GPS_TRACK_GPX_CHUNK 2048
+
+typedef struct {
+    char magic[4];
+    uint8_t version;
+    uint8_t point_size;
+    uint16_t reserved;
+} GpsTrackHeader;
+
+// one recorded fix, the .bin track file is the header followed by these
+typedef struct {
+    // degrees * 1e7
+    int32_t latitude;
+    int32_t longitude;
+    // unix time from RMC date and time
+    uint32_t timestamp;
+    // meters
+    int16_t altitude;
+    // knots * 100
+    uint16_t speed;
+} GpsTrackPoint;
+
+typedef enum {
+    WriterEvtStop = (1 << 0),
+    WriterEvtWrite = (1 << 1),
+} WriterEvtFlags;
+
+struct GpsTrack {
+    Storage* storage;
+    FuriMutex* mutex;
+    FuriThread* writer;
+    File* file;
+    FuriString* name;
+    bool recording;
+
+    // buffers[active] is filled by the UART worker, buffers[pending] is being written
+    GpsTrackPoint buffers[2][GPS_TRACK_BUFFER_POINTS];
+    uint8_t active;
+    uint16_t fill;
+    int8_t pending;
+
+    bool has_last;
+    GpsTrackPoint last;
+    GpsTrackStats stats;
+
+    // GPX export, NULL when not running
+    FuriThread* exporter;
+    volatile bool export_cancel;
+    volatile uint8_t export_progress;
+};
+
+static void gps_track_write(GpsTrack* track, const GpsTrackPoint* points, uint16_t count) {
+    size_t size = count * sizeof(GpsTrackPoint);
+    if(storage_file_write(track->file, points, size) != size) {
+        FURI_LOG_E(TAG, "Failed to write %u points", count);
+        furi_mutex_acquire(track->mutex, FuriWaitForever);
+        track->stats.dropped += count;
+        furi_mutex_release(track->mutex);
+    }
+}
+
+static int32_t gps_track_writer(void* context) {
+    GpsTrack* track = context;
+
+    while(1) {
+        uint32_t events = furi_thread_flags_wait(
+            WriterEvtStop | WriterEvtWrite, FuriFlagWaitAny, FuriWaitForever);
+        furi_check((events & FuriFlagError) == 0);
+
+        if(events & WriterEvtWrite) {
+            furi_mutex_acquire(track->mutex, FuriWaitForever);
+            int8_t pending = track->pending;
+            furi_mutex_release(track->mutex);
+
+            if(pending >= 0) {
+                gps_track_write(track, track->buffers[pending], GPS_TRACK_BUFFER_POINTS);
+
+                furi_mutex_acquire(track->mutex, FuriWaitForever);
+                track->pending = -1;
+                furi_mutex_release(track->mutex);
+            }
+        }
+
+        if(events & WriterEvtStop) {
+            break;
+        }
+    }
+
+    // recording is off by now, so the worker does not touch the buffers anymore
+    if(track->pending >= 0) {
+        gps_track_write(track, track->buffers[track->pending], GPS_TRACK_BUFFER_POINTS);
+        track->pending = -1;
+    }
+    if(track->fill > 0) {
+        gps_track_write(track, track->buffers[track->active], track->fill);
+        track->fill = 0;
+    }
+
+    return 0;
+}
+
+// equirectangular approximation, plenty for points a few meters to a few km apart
+static float gps_track_distance(const GpsTrackPoint* a, const GpsTrackPoint* b) {
+    const float to_rad = (float)M_PI / 180.0f / 1e7f;
+    float latitude = ((float)a->latitude + (float)b->latitude) / 2.0f * to_rad;
+    float dx = (float)((int64_t)b->longitude - a->longitude) * to_rad * cosf(latitude);
+    float dy = (float)((int64_t)b->latitude - a->latitude) * to_rad;
+    return sqrtf(dx * dx + dy * dy) * GPS_TRACK_EARTH_RADIUS_M;
+}
+
+GpsTrack* gps_track_alloc(void) {
+    GpsTrack* track = malloc(sizeof(GpsTrack));
+
+    track->storage = furi_record_open(RECORD_STORAGE);
+    track->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    track->writer = NULL;
+    track->file = storage_file_alloc(track->storage);
+    track->name = furi_string_alloc();
+    track->recording = false;
+    track->active = 0;
+    track->fill = 0;
+    track->pending = -1;
+    track->has_last = false;
+    memset(&track->stats, 0, sizeof(GpsTrackStats));
+    track->exporter = NULL;
+    track->export_cancel = false;
+    track->export_progress = 0;
+
+    return track;
+}
+
+void gps_track_free(GpsTrack* track) {
+    furi_assert(track);
+    gps_track_stop(track);
+    if(track->exporter) {
+        track->export_cancel = true;
+        furi_thread_join(track->exporter);
+        furi_thread_free(track->exporter);
+    }
+
+    furi_string_free(track->name);
+    storage_file_free(track->file);
+    furi_mutex_free(track->mutex);
+    furi_record_close(RECORD_STORAGE);
+
+    free(track);
+}
+
+bool gps_track_start(GpsTrack* track) {
+    furi_assert(track);
+    if(track->recording) return true;
+    // the export reads the last track through the point buffers
+    if(track->exporter) return false;
+
+    DateTime datetime;
+    furi_hal_rtc_get_datetime(&datetime);
+    furi_string_printf(
+        track->name,
+        "track_%04u%02u%02u_%02u%02u%02u",
+        datetime.year,
+        datetime.month,
+        datetime.day,
+        datetime.hour,
+        datetime.minute,
+        datetime.second);
+
+    storage_simply_mkdir(track->storage, GPS_TRACK_FOLDER);
+    FuriString* path = furi_string_alloc_printf(
+        "%s/%s.bin", GPS_TRACK_FOLDER, furi_string_get_cstr(track->name));
+
+    GpsTrackHeader header = {
+        .version = GPS_TRACK_VERSION,
+        .point_size = sizeof(GpsTrackPoint),
+        .reserved = 0,
+    };
+    memcpy(header.magic, GPS_TRACK_MAGIC, sizeof(header.magic));
+
+    bool success = storage_file_open(
+                       track->file, furi_string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+                   storage_file_write(track->file, &header, sizeof(header)) == sizeof(header);
+    furi_string_free(path);
+
+    if(!success) {
+        FURI_LOG_E(TAG, "Failed to create track file");
+        storage_file_close(track->file);
+        furi_string_reset(track->name);
+        return false;
+    }
+
+    furi_mutex_acquire(track->mutex, FuriWaitForever);
+    track->active = 0;
+    track->fill = 0;
+    track->pending = -1;
+    track->has_last = false;
+    memset(&track->stats, 0, sizeof(GpsTrackStats));
+    furi_mutex_release(track->mutex);
+
+    track->writer = furi_thread_alloc_ex("GpsTrackWriter", 1024, gps_track_writer, track);
+    furi_thread_start(track->writer);
+
+    furi_mutex_acquire(track->mutex, FuriWaitForever);
+    track->recording = true;
+    furi_mutex_release(track->mutex);
+
+    return true;
+}
+
+void gps_track_stop(GpsTrack* track) {
+    furi_assert(track);
+    if(!track->recording) return;
+
+    furi_mutex_acquire(track->mutex, FuriWaitForever);
+    track->recording = false;
+    furi_mutex_release(track->mutex);
+
+    furi_thread_flags_set(furi_thread_get_id(track->writer), WriterEvtStop);
+    furi_thread_join(track->writer);
+    furi_thread_free(track->writer);
+    track->writer = NULL;
+
+    storage_file_close(track->file);
+}
+
+bool gps_track_is_recording(GpsTrack* track) {
+    furi_assert(track);
+    return track->recording;
+}
+
+void gps_track_add_fix(
+    GpsTrack* track,
+    float latitude,
+    float longitude,
+    float altitude,
+    float speed,
+    uint32_t timestamp) {
+    furi_assert(track);
+
+    furi_mutex_acquire(track->mutex, FuriWaitForever);
+    if(!track->recording) {
+        furi_mutex_release(track->mutex);
+        return;
+    }
+
+    GpsTrackPoint point = {
+        .latitude = (int32_t)lround((double)latitude * 1e7),
+        .longitude = (int32_t)lround((double)longitude * 1e7),
+        .timestamp = timestamp,
+        .altitude = (int16_t)CLAMP(altitude, (float)INT16_MAX, (float)INT16_MIN),
+        .speed = (uint16_t)CLAMP(speed * 100.0f, (float)UINT16_MAX, 0.0f),
+    };
+
+    if(speed > track->stats.max_speed) track->stats.max_speed = speed;
+
+    // thinning: skip fixes that are close to the last point, unless it is getting old.
+    // A standing receiver still reports positions a few meters apart, so the distance
+    // threshold only applies while it also reports some speed
+    float step = 0.0f;
+    bool moving = speed >= GPS_TRACK_MIN_SPEED_KN;
+    bool record = true;
+    if(track->has_last) {
+        step = gps_track_distance(&track->last, &point);
+        record = (moving && step >= GPS_TRACK_MIN_DISTANCE_M) ||
+                 (int32_t)(timestamp - track->last.timestamp) >= GPS_TRACK_MAX_INTERVAL_S ||
+                 timestamp < track->last.timestamp;
+    } else {
+        track->stats.start_time = timestamp;
+    }
+
+    if(record) {
+        if(moving) track->stats.distance += step;
+        track->stats.points++;
+        track->stats.last_time = timestamp;
+        track->last = point;
+        track->has_last = true;
+
+        track->buffers[track->active][track->fill++] = point;
+        if(track->fill == GPS_TRACK_BUFFER_POINTS) {
+            if(track->pending >= 0) {
+                // the writer is still busy with the other buffer, this one is reused
+                track->stats.dropped += GPS_TRACK_BUFFER_POINTS;
+            } else {
+                track->pending = track->active;
+                track->active ^= 1;
+                furi_thread_flags_set(furi_thread_get_id(track->writer), WriterEvtWrite);
+            }
+            track->fill = 0;
+        }
+    }
+
+    furi_mutex_release(track->mutex);
+}
+
+void gps_track_get_stats(GpsTrack* track, GpsTrackStats* stats) {
+    furi_assert(track);
+    furi_mutex_acquire(track->mutex, FuriWaitForever);
+    *stats = track->stats;
+    furi_mutex_release(track->mutex);
+}
+
+void gps_track_get_name(GpsTrack* track, FuriString* name) {
+    furi_assert(track);
+    furi_string_set(name, track->name);
+}
+
+static void gps_track_cat_coordinate(FuriString* text, const char* attribute, int32_t value) {
+    uint32_t abs_value = value < 0 ? (uint32_t)(-(int64_t)value) : (uint32_t)value;
+    furi_string_cat_printf(
+        text,
+        " %s=\"%s%lu.%07lu\"",
+        attribute,
+        value < 0 ? "-" : "",
+        abs_value / 10000000,
+        abs_value % 10000000);
+}
+
+static bool gps_track_write_text(File* file, FuriString* text) {
+    size_t size = furi_string_size(text);
+    bool success = storage_file_write(file, furi_string_get_cstr(text), size) == size;
+    furi_string_reset(text);
+    return success;
+}
+
+static int32_t gps_track_exporter(void* context) {
+    GpsTrack* track = context;
+
+    FuriString* path = furi_string_alloc();
+    FuriString* text = furi_string_alloc();
+    File* input = storage_file_alloc(track->storage);
+    File* output = storage_file_alloc(track->storage);
+    // the point buffers are idle while not recording
+    GpsTrackPoint* points = track->buffers[0];
+    bool success = false;
+    bool output_open = false;
+
+    do {
+        furi_string_printf(
+            path, "%s/%s.bin", GPS_TRACK_FOLDER, furi_string_get_cstr(track->name));
+        if(!storage_file_open(input, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING))
+            break;
+        uint64_t size = storage_file_size(input);
+        uint64_t done = 0;
+
+        GpsTrackHeader header;
+        if(storage_file_read(input, &header, sizeof(header)) != sizeof(header) ||
+           memcmp(header.magic, GPS_TRACK_MAGIC, sizeof(header.magic)) != 0 ||
+           header.version != GPS_TRACK_VERSION || header.point_size != sizeof(GpsTrackPoint))
+            break;
+
+        furi_string_printf(
+            path, "%s/%s.gpx", GPS_TRACK_FOLDER, furi_string_get_cstr(track->name));
+        if(!storage_file_open(
+               output, furi_string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS))
+            break;
+        output_open = true;
+
+        furi_string_printf(
+            text,
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<gpx version=\"1.1\" creator=\"Flipper Zero GPS\" "
+            "xmlns=\"http://www.topografix.com/GPX/1/1\">\n"
+            "<trk><name>%s</name><trkseg>\n",
+            furi_string_get_cstr(track->name));
+
+        success = true;
+        size_t read;
+        while(success && !track->export_cancel &&
+              (read = storage_file_read(
+                   input, points, GPS_TRACK_BUFFER_POINTS * sizeof(GpsTrackPoint))) > 0) {
+            done += read;
+            track->export_progress = done * 100 / size;
+            for(size_t i = 0; i < read / sizeof(GpsTrackPoint); i++) {
+                DateTime datetime;
+                datetime_timestamp_to_datetime(points[i].timestamp, &datetime);
+
+                furi_string_cat_str(text, "<trkpt");
+                gps_track_cat_coordinate(text, "lat", points[i].latitude);
+                gps_track_cat_coordinate(text, "lon", points[i].longitude);
+                furi_string_cat_printf(
+                    text,
+                    "><ele>%d</ele><time>%04u-%02u-%02uT%02u:%02u:%02uZ</time></trkpt>\n",
+                    points[i].altitude,
+                    datetime.year,
+                    datetime.month,
+                    datetime.day,
+                    datetime.hour,
+                    datetime.minute,
+                    datetime.second);
+
+                if(furi_string_size(text) >= GPS_TRACK_GPX_CHUNK) {
+                    success = gps_track_write_text(output, text);
+                    if(!success) break;
+                }
+            }
+        }
+
+        furi_string_cat_str(text, "</trkseg></trk>\n</gpx>\n");
+        success = success && !track->export_cancel && gps_track_write_text(output, text);
+    } while(false);
+
+    if(!success) {
+        FURI_LOG_E(TAG, track->export_cancel ? "GPX export cancelled" : "GPX export failed");
+    }
+
+    storage_file_close(output);
+    // half a GPX file is of no use to anyone
+    if(!success && output_open) {
+        storage_simply_remove(track->storage, furi_string_get_cstr(path));
+    }
+    storage_file_close(input);
+    storage_file_free(output);
+    storage_file_free(input);
+    furi_string_free(text);
+    furi_string_free(path);
+
+    return success ? 1 : 0;
+}
+
+bool gps_track_export_start(GpsTrack* track) {
+    furi_assert(track);
+    if(track->recording || track->exporter || furi_string_empty(track->name)) return false;
+
+    track->export_cancel = false;
+    track->export_progress = 0;
+    track->exporter = furi_thread_alloc_ex("GpsTrackExport", 2048, gps_track_exporter, track);
+    furi_thread_start(track->exporter);
+    return true;
+}
+
+uint8_t gps_track_export_progress(GpsTrack* track) {
+    furi_assert(track);
+    return track->export_progress;
+}
+
+void gps_track_export_cancel(GpsTrack* track) {
+    furi_assert(track);
+    track->export_cancel = true;
+}
+
+bool gps_track_export_poll(GpsTrack* track, bool* success) {
+    furi_assert(track);
+    if(!track->exporter) return false;
+    if(furi_thread_get_state(track->exporter) != FuriThreadStateStopped) return false;
+
+    furi_thread_join(track->exporter);
+    *success = furi_thread_get_return_code(track->exporter) == 1;
+    furi_thread_free(track->exporter);
+    track->exporter = NULL;
+    return true;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+#define GPS_TRACK_FOLDER EXT_PATH("apps_data/gps_nmea")
+
+// points per write buffer, two buffers are used so the writer can flush one while
+// the UART worker fills the other
+#define GPS_TRACK_BUFFER_POINTS 128
+
+// a fix is recorded when it is this far from the last recorded point...
+#define GPS_TRACK_MIN_DISTANCE_M 2.0f
+// ...or when no point was recorded for this long, so stops still show up in the track
+#define GPS_TRACK_MAX_INTERVAL_S 30
+// below this speed (knots) the position only wanders around, such fixes do not count as
+// movement and do not add to the distance
+#define GPS_TRACK_MIN_SPEED_KN 1.0f
+
+typedef struct GpsTrack GpsTrack;
+
+typedef struct {
+    uint32_t points;
+    // points lost because the SD card did not keep up
+    uint32_t dropped;
+    // meters between recorded points
+    float distance;
+    // knots, same as GpsStatus.speed
+    float max_speed;
+    // unix time of the first and the last recorded fix
+    uint32_t start_time;
+    uint32_t last_time;
+} GpsTrackStats;
+
+GpsTrack* gps_track_alloc(void);
+
+// stops recording if needed
+void gps_track_free(GpsTrack* track);
+
+// opens a new track file named after the current RTC time, fails while a GPX export runs
+bool gps_track_start(GpsTrack* track);
+
+// writes the buffered points and closes the track file
+void gps_track_stop(GpsTrack* track);
+
+bool gps_track_is_recording(GpsTrack* track);
+
+// called from the UART worker for every valid fix, never waits for the SD card
+void gps_track_add_fix(
+    GpsTrack* track,
+    float latitude,
+    float longitude,
+    float altitude,
+    float speed,
+    uint32_t timestamp);
+
+void gps_track_get_stats(GpsTrack* track, GpsTrackStats* stats);
+
+// name of the current or last track file without extension, empty if nothing was recorded
+void gps_track_get_name(GpsTrack* track, FuriString* name);
+
+// starts converting the last recorded track to a .gpx file next to it on a worker thread,
+// not available while recording
+bool gps_track_export_start(GpsTrack* track);
+
+// percent of the track converted so far
+uint8_t gps_track_export_progress(GpsTrack* track);
+
+// asks the export to stop, the unfinished .gpx file is removed
+void gps_track_export_cancel(GpsTrack* track);
+
+// true once the export is over, success is false if it failed or was cancelled
+bool gps_track_export_poll(GpsTrack* track, bool* success);
@@ -1,6 +1,7 @@
 #include <string.h>
 
 #include <minmea.h>
+#include <datetime/datetime.h>
 #include "gps_uart.h"
 
 typedef enum {
@@ -10,13 +11,27 @@ typedef enum {
 
 #define WORKER_ALL_RX_EVENTS (WorkerEvtStop | WorkerEvtRxDone)
 
-static void
-    gps_uart_on_irq_cb(FuriHalSerialHandle* handle, FuriHalSerialRxEvent ev, void* context) {
+static void gps_uart_on_irq_cb(
+    FuriHalSerialHandle* handle,
+    FuriHalSerialRxEvent ev,
+    size_t size,
+    void* context) {
     GpsUart* gps_uart = (GpsUart*)context;
 
-    if(ev == FuriHalSerialRxEventData) {
-        uint8_t data = furi_hal_serial_async_rx(handle);
-        furi_stream_buffer_send(gps_uart->rx_stream, &data, 1, 0);
+    // DMA fills the HAL ring buffer, we get here on half/full transfer and on line idle,
+    // so a whole burst of sentences is moved to the stream buffer in a few chunks
+    if(ev & (FuriHalSerialRxEventData | FuriHalSerialRxEventIdle)) {
+        uint8_t data[FURI_HAL_SERIAL_DMA_BUFFER_SIZE];
+        while(size) {
+            size_t len = furi_hal_serial_dma_rx(
+                handle,
+                data,
+                (size > FURI_HAL_SERIAL_DMA_BUFFER_SIZE) ? FURI_HAL_SERIAL_DMA_BUFFER_SIZE : size);
+            if(len == 0) break;
+            size_t sent = furi_stream_buffer_send(gps_uart->rx_stream, data, len, 0);
+            gps_uart->rx_dropped += len - sent;
+            size -= len;
+        }
         furi_thread_flags_set(furi_thread_get_id(gps_uart->thread), WorkerEvtRxDone);
     }
 }
@@ -27,7 +42,7 @@ static void gps_uart_serial_init(GpsUart* gps_uart) {
     gps_uart->serial_handle = furi_hal_serial_control_acquire(UART_CH);
     furi_check(gps_uart->serial_handle);
     furi_hal_serial_init(gps_uart->serial_handle, gps_uart->baudrate);
-    furi_hal_serial_async_rx_start(gps_uart->serial_handle, gps_uart_on_irq_cb, gps_uart, false);
+    furi_hal_serial_dma_rx_start(gps_uart->serial_handle, gps_uart_on_irq_cb, gps_uart, false);
 
     furi_hal_serial_tx(
         gps_uart->serial_handle, (uint8_t*)"wakey wakey\r\n", strlen("wakey wakey\r\n"));
@@ -35,14 +50,38 @@ static void gps_uart_serial_init(GpsUart* gps_uart) {
 
 static void gps_uart_serial_deinit(GpsUart* gps_uart) {
     furi_assert(gps_uart->serial_handle);
-    furi_hal_serial_async_rx_stop(gps_uart->serial_handle);
+    furi_hal_serial_dma_rx_stop(gps_uart->serial_handle);
     furi_hal_serial_deinit(gps_uart->serial_handle);
     furi_hal_serial_control_release(gps_uart->serial_handle);
     gps_uart->serial_handle = NULL;
 }
 
-static void gps_uart_parse_nmea(GpsUart* gps_uart, char* line) {
-    switch(minmea_sentence_id(line, false)) {
+static void gps_uart_blink(GpsUart* gps_uart, const NotificationSequence* sequence) {
+    // at 10 Hz a blocking blink per sentence would stall the worker, so blink at most
+    // once per GPS_BLINK_INTERVAL_MS and don't wait for the LED
+    uint32_t now = furi_get_tick();
+    if(now - gps_uart->last_blink < GPS_BLINK_INTERVAL_MS) return;
+    gps_uart->last_blink = now;
+    notification_message(gps_uart->notifications, sequence);
+}
+
+/**
+ * Cheap sentence type check on the raw line, before checksum and parsing.
+ * Only sentences shown on screen are recognized, everything else (GSV, GSA, VTG, TXT,
+ * proprietary) is dropped here without touching the rest of the line.
+ */
+static enum minmea_sentence_id gps_uart_sentence_id(const char* line, size_t len) {
+    // "$ttSSS," - talker id, then sentence type
+    if(len < 7 || line[0] != '$' || line[6] != ',') return MINMEA_INVALID;
+    const char* type = line + 3;
+    if(!memcmp(type, "RMC", 3)) return MINMEA_SENTENCE_RMC;
+    if(!memcmp(type, "GGA", 3)) return MINMEA_SENTENCE_GGA;
+    if(!memcmp(type, "GLL", 3)) return MINMEA_SENTENCE_GLL;
+    return MINMEA_UNKNOWN;
+}
+
+static void gps_uart_parse_nmea(GpsUart* gps_uart, enum minmea_sentence_id id, char* line) {
+    switch(id) {
     case MINMEA_SENTENCE_RMC: {
         struct minmea_sentence_rmc frame;
         if(minmea_parse_rmc(&frame, line)) {
@@ -55,7 +94,25 @@ static void gps_uart_parse_nmea(GpsUart* gps_uart, char* line) {
             gps_uart->status.time_minutes = frame.time.minutes;
             gps_uart->status.time_seconds = frame.time.seconds;
 
-            notification_message_block(gps_uart->notifications, &sequence_blink_green_10);
+            if(frame.valid && frame.date.year >= 0) {
+                DateTime datetime = {
+                    .year = 2000 + frame.date.year,
+                    .month = frame.date.month,
+                    .day = frame.date.day,
+                    .hour = frame.time.hours,
+                    .minute = frame.time.minutes,
+                    .second = frame.time.seconds,
+                };
+                gps_track_add_fix(
+                    gps_uart->track,
+                    gps_uart->status.latitude,
+                    gps_uart->status.longitude,
+                    gps_uart->status.altitude,
+                    gps_uart->status.speed,
+                    datetime_datetime_to_timestamp(&datetime));
+            }
+
+            gps_uart_blink(gps_uart, &sequence_blink_green_10);
         }
     } break;
 
@@ -72,7 +129,7 @@ static void gps_uart_parse_nmea(GpsUart* gps_uart, char* line) {
             gps_uart->status.time_minutes = frame.time.minutes;
             gps_uart->status.time_seconds = frame.time.seconds;
 
-            notification_message_block(gps_uart->notifications, &sequence_blink_magenta_10);
+            gps_uart_blink(gps_uart, &sequence_blink_magenta_10);
         }
     } break;
 
@@ -85,7 +142,7 @@ static void gps_uart_parse_nmea(GpsUart* gps_uart, char* line) {
             gps_uart->status.time_minutes = frame.time.minutes;
             gps_uart->status.time_seconds = frame.time.seconds;
 
-            notification_message_block(gps_uart->notifications, &sequence_blink_red_10);
+            gps_uart_blink(gps_uart, &sequence_blink_red_10);
         }
     } break;
 
@@ -94,9 +151,32 @@ static void gps_uart_parse_nmea(GpsUart* gps_uart, char* line) {
     }
 }
 
+/**
+ * Handle one received line in place. The line is not NUL-terminated, line[len] is the
+ * '\n' that ended it and gets replaced by the terminator.
+ */
+static void gps_uart_process_line(GpsUart* gps_uart, char* line, size_t len) {
+    // skip noise before the start of the sentence (e.g. after a baudrate change)
+    char* start = memchr(line, '$', len);
+    if(!start) return;
+    len -= start - line;
+    line = start;
+
+    enum minmea_sentence_id id = gps_uart_sentence_id(line, len);
+    if(id == MINMEA_INVALID || id == MINMEA_UNKNOWN) return;
+
+    line[len] = '\0';
+    if(!minmea_check(line, false)) {
+        gps_uart->bad_sentences++;
+        return;
+    }
+    gps_uart_parse_nmea(gps_uart, id, line);
+}
+
 static int32_t gps_uart_worker(void* context) {
     GpsUart* gps_uart = (GpsUart*)context;
 
+    // bytes of an unfinished line kept at the start of rx_buf
     size_t rx_offset = 0;
 
     while(1) {
@@ -110,64 +190,41 @@ static int32_t gps_uart_worker(void* context) {
 
         if(events & WorkerEvtRxDone) {
             size_t len = 0;
-            do {
-                // receive serial bytes into rx_buf, starting at rx_offset from the start of the buffer
-                // the maximum we can receive is RX_BUF_SIZE - 1 - rx_offset
-                len = furi_stream_buffer_receive(
-                    gps_uart->rx_stream,
-                    gps_uart->rx_buf + rx_offset,
-                    RX_BUF_SIZE - 1 - rx_offset,
-                    0);
-                if(len > 0) {
-                    // increase rx_offset by the number of bytes received, and null-terminate rx_buf
-                    rx_offset += len;
-                    gps_uart->rx_buf[rx_offset] = '\0';
-
-                    // look for strings ending in newlines, starting at the start of rx_buf
-                    char* line_current = (char*)gps_uart->rx_buf;
-                    while(1) {
-                        // skip null characters
-                        while(*line_current == '\0' &&
-                              line_current < (char*)gps_uart->rx_buf + rx_offset - 1) {
-                            line_current++;
-                        }
-
-                        // find the next newline
-                        char* newline = strchr(line_current, '\n');
-                        if(newline) // newline found
-                        {
-                            // put a null terminator in place of the newline, to delimit the line string
-                            *newline = '\0';
-
-                            // attempt to parse the line as a NMEA sentence
-                            gps_uart_parse_nmea(gps_uart, line_current);
-
-                            // move the cursor to the character after the newline
-                            line_current = newline + 1;
-                        } else // no more newlines found
-                        {
-                            if(line_current >
-                               (char*)gps_uart->rx_buf) // at least one line was found
-                            {
-                                // clear parsed lines, and move any leftover bytes to the start of rx_buf
-                                rx_offset = 0;
-                                while(
-                                    *line_current) // stop when the original rx_offset terminator is reached
-                                {
-                                    gps_uart->rx_buf[rx_offset++] = *(line_current++);
-                                }
-                            }
-                            break; // go back to receiving bytes from the serial stream
-                        }
-                    }
+            while((len = furi_stream_buffer_receive(
+                       gps_uart->rx_stream,
+                       gps_uart->rx_buf + rx_offset,
+                       RX_BUF_SIZE - rx_offset,
+                       0)) > 0) {
+                uint8_t* line = gps_uart->rx_buf;
+                uint8_t* end = gps_uart->rx_buf + rx_offset + len;
+                // only new bytes can hold a newline, the leftover was already scanned
+                uint8_t* cursor = gps_uart->rx_buf + rx_offset;
+                uint8_t* newline;
+                while((newline = memchr(cursor, '\n', end - cursor)) != NULL) {
+                    gps_uart_process_line(gps_uart, (char*)line, newline - line);
+                    line = cursor = newline + 1;
                 }
-            } while(len > 0);
+
+                rx_offset = end - line;
+                if(rx_offset == RX_BUF_SIZE) {
+                    // no newline in a full buffer, this is not NMEA - drop it and resync
+                    rx_offset = 0;
+                } else if(line != gps_uart->rx_buf && rx_offset > 0) {
+                    memmove(gps_uart->rx_buf, line, rx_offset);
+                }
+            }
         }
     }
 
     gps_uart_serial_deinit(gps_uart);
     furi_stream_buffer_free(gps_uart->rx_stream);
 
+    FURI_LOG_D(
+        "GPS",
+        "rx dropped %lu bytes, %lu bad sentences",
+        gps_uart->rx_dropped,
+        gps_uart->bad_sentences);
+
     return 0;
 }
 
@@ -185,8 +242,11 @@ void gps_uart_init_thread(GpsUart* gps_uart) {
     gps_uart->status.time_hours = 0;
     gps_uart->status.time_minutes = 0;
     gps_uart->status.time_seconds = 0;
+    gps_uart->rx_dropped = 0;
+    gps_uart->bad_sentences = 0;
+    gps_uart->last_blink = 0;
 
-    gps_uart->rx_stream = furi_stream_buffer_alloc(RX_BUF_SIZE * 5, 1);
+    gps_uart->rx_stream = furi_stream_buffer_alloc(RX_STREAM_SIZE, 1);
 
     gps_uart->thread = furi_thread_alloc();
     furi_thread_set_name(gps_uart->thread, "GpsUartWorker");
@@ -216,6 +276,8 @@ GpsUart* gps_uart_enable() {
     gps_uart->speed_units = KNOTS;
     gps_uart->deep_sleep_enabled = false;
     gps_uart->view_state = NORMAL;
+    gps_uart->track_view = false;
+    gps_uart->track = gps_track_alloc();
 
     gps_uart_init_thread(gps_uart);
 
@@ -225,6 +287,7 @@ GpsUart* gps_uart_enable() {
 void gps_uart_disable(GpsUart* gps_uart) {
     furi_assert(gps_uart);
     gps_uart_deinit_thread(gps_uart);
+    gps_track_free(gps_uart->track);
     furi_record_close(RECORD_NOTIFICATION);
 
     free(gps_uart);
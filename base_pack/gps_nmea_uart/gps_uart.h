@@ -3,11 +3,18 @@
 #include <furi_hal.h>
 #include <notification/notification_messages.h>
 
+#include "gps_track.h"
+
 #define UART_CH (FuriHalSerialIdUsart)
 
 #define RX_BUF_SIZE 1024
+// about half a second of data at 115200 baud
+#define RX_STREAM_SIZE (RX_BUF_SIZE * 6)
+
+#define GPS_BLINK_INTERVAL_MS 100
 
-static const int gps_baudrates[6] = {4800, 9600, 19200, 38400, 57600, 115200};
+static const int gps_baudrates[8] =
+    {4800, 9600, 19200, 38400, 57600, 115200, 230400, 460800};
 static int current_gps_baudrate = 1;
 
 typedef struct {
@@ -32,6 +39,9 @@ typedef enum {
     CHANGE_BACKLIGHT,
     CHANGE_DEEPSLEEP,
     CHANGE_SPEEDUNIT,
+    CHANGE_RECORDING,
+    EXPORT_GPX,
+    EXPORTING_GPX,
     NORMAL
 } ViewState;
 
@@ -47,10 +57,19 @@ typedef struct {
     bool deep_sleep_enabled;
     SpeedUnit speed_units;
     ViewState view_state;
+    bool track_view;
+    // result of the last track start or GPX export, shown with CHANGE_RECORDING/EXPORT_GPX
+    bool track_result;
 
     FuriHalSerialHandle* serial_handle;
+    uint32_t last_blink;
+    // bytes lost because the worker did not keep up
+    uint32_t rx_dropped;
+    // sentences of interest that failed checksum
+    uint32_t bad_sentences;
 
     GpsStatus status;
+    GpsTrack* track;
 } GpsUart;
 
 void gps_uart_init_thread(GpsUart* gps_uart);
@@ -0,0 +1,315 @@
+#include "hex_viewer_cache.h"
+
+#define TAG "HexViewerCache"
+
+#define HEX_VIEWER_CACHE_NO_PAGE UINT32_MAX
+
+typedef enum {
+    HexViewerCacheEvtStop = (1 << 0),
+    HexViewerCacheEvtPrefetch = (1 << 1),
+    HexViewerCacheEvtSearch = (1 << 2),
+} HexViewerCacheEvtFlags;
+
+#define HEX_VIEWER_CACHE_EVT_ALL \
+    (HexViewerCacheEvtStop | HexViewerCacheEvtPrefetch | HexViewerCacheEvtSearch)
+
+// Search reads the file in big sequential blocks past the page cache
+#define HEX_VIEWER_CACHE_SEARCH_BLOCK_SIZE 4096u
+
+typedef struct {
+    uint32_t offset; // Page aligned file offset, HEX_VIEWER_CACHE_NO_PAGE if empty
+    uint32_t size; // Valid bytes, less than page size only for the last page
+    uint32_t last_used;
+    uint8_t data[HEX_VIEWER_CACHE_PAGE_SIZE];
+} HexViewerCachePage;
+
+struct HexViewerCache {
+    Stream* stream;
+    uint32_t file_size;
+
+    FuriMutex* pages_mutex; // Guards pages, taken before io_mutex
+    FuriMutex* io_mutex; // Guards stream
+    FuriThread* thread;
+
+    uint32_t use_counter;
+    uint32_t prefetch_offset;
+    HexViewerCachePage pages[HEX_VIEWER_CACHE_PAGES];
+    uint8_t prefetch_buf[HEX_VIEWER_CACHE_PAGE_SIZE];
+
+    // Search runs on the worker, UI polls its state and progress
+    volatile HexViewerCacheSearchState search_state;
+    volatile bool search_cancel;
+    volatile uint32_t search_pos;
+    uint32_t search_from;
+    uint32_t search_found;
+    uint8_t search_pattern[HEX_VIEWER_SEARCH_MAX_LEN];
+    size_t search_pattern_len;
+};
+
+static uint32_t hex_viewer_cache_page_offset(uint32_t offset) {
+    return offset - (offset % HEX_VIEWER_CACHE_PAGE_SIZE);
+}
+
+static uint32_t hex_viewer_cache_load(
+    HexViewerCache* cache,
+    uint32_t offset,
+    uint8_t* buf,
+    size_t len) {
+    uint32_t read = 0;
+    furi_check(furi_mutex_acquire(cache->io_mutex, FuriWaitForever) == FuriStatusOk);
+    if(stream_seek(cache->stream, offset, StreamOffsetFromStart)) {
+        read = stream_read(cache->stream, buf, len);
+    } else {
+        FURI_LOG_E(TAG, "Unable to seek stream");
+    }
+    furi_mutex_release(cache->io_mutex);
+    return read;
+}
+
+// Must be called with pages_mutex taken
+static HexViewerCachePage* hex_viewer_cache_find(HexViewerCache* cache, uint32_t page_offset) {
+    for(size_t i = 0; i < HEX_VIEWER_CACHE_PAGES; i++) {
+        if(cache->pages[i].offset == page_offset) {
+            return &cache->pages[i];
+        }
+    }
+    return NULL;
+}
+
+// Must be called with pages_mutex taken
+static HexViewerCachePage* hex_viewer_cache_victim(HexViewerCache* cache) {
+    HexViewerCachePage* victim = &cache->pages[0];
+    for(size_t i = 0; i < HEX_VIEWER_CACHE_PAGES; i++) {
+        if(cache->pages[i].offset == HEX_VIEWER_CACHE_NO_PAGE) {
+            return &cache->pages[i];
+        }
+        if(cache->pages[i].last_used < victim->last_used) {
+            victim = &cache->pages[i];
+        }
+    }
+    return victim;
+}
+
+// Must be called with pages_mutex taken, returns NULL if the page can't be read
+static HexViewerCachePage* hex_viewer_cache_get_page(HexViewerCache* cache, uint32_t offset) {
+    uint32_t page_offset = hex_viewer_cache_page_offset(offset);
+    HexViewerCachePage* page = hex_viewer_cache_find(cache, page_offset);
+    if(!page) {
+        page = hex_viewer_cache_victim(cache);
+        page->size =
+            hex_viewer_cache_load(cache, page_offset, page->data, HEX_VIEWER_CACHE_PAGE_SIZE);
+        if(page->size == 0) {
+            // Don't cache failed reads, next access retries
+            page->offset = HEX_VIEWER_CACHE_NO_PAGE;
+            return NULL;
+        }
+        page->offset = page_offset;
+    }
+    page->last_used = ++cache->use_counter;
+    return page;
+}
+
+static HexViewerCacheSearchState hex_viewer_cache_search_run(HexViewerCache* cache) {
+    const uint8_t* pattern = cache->search_pattern;
+    size_t pattern_len = cache->search_pattern_len;
+    // Tail of the previous block is kept in front of the next one for matches crossing blocks
+    uint8_t* block = malloc(HEX_VIEWER_CACHE_SEARCH_BLOCK_SIZE + HEX_VIEWER_SEARCH_MAX_LEN - 1);
+    HexViewerCacheSearchState state = HexViewerCacheSearchNotFound;
+    uint32_t read_offset = cache->search_from;
+    size_t kept = 0;
+
+    while(read_offset < cache->file_size) {
+        if(cache->search_cancel) {
+            state = HexViewerCacheSearchCancelled;
+            break;
+        }
+        uint32_t read = hex_viewer_cache_load(
+            cache, read_offset, &block[kept], HEX_VIEWER_CACHE_SEARCH_BLOCK_SIZE);
+        if(read == 0) break;
+
+        size_t avail = kept + read;
+        uint32_t block_offset = read_offset - kept;
+        if(avail >= pattern_len) {
+            const uint8_t* pos = block;
+            const uint8_t* end = &block[avail - pattern_len + 1];
+            while((pos = memchr(pos, pattern[0], end - pos)) != NULL) {
+                if(memcmp(pos, pattern, pattern_len) == 0) {
+                    cache->search_found = block_offset + (pos - block);
+                    state = HexViewerCacheSearchFound;
+                    break;
+                }
+                pos++;
+            }
+            if(state == HexViewerCacheSearchFound) break;
+        }
+
+        read_offset += read;
+        cache->search_pos = read_offset;
+        kept = MIN(pattern_len - 1, avail);
+        memmove(block, &block[avail - kept], kept);
+    }
+
+    free(block);
+    return state;
+}
+
+static int32_t hex_viewer_cache_worker(void* context) {
+    HexViewerCache* cache = context;
+
+    while(true) {
+        uint32_t flags =
+            furi_thread_flags_wait(HEX_VIEWER_CACHE_EVT_ALL, FuriFlagWaitAny, FuriWaitForever);
+        furi_check((flags & FuriFlagError) == 0);
+        if(flags & HexViewerCacheEvtStop) break;
+
+        if(flags & HexViewerCacheEvtSearch) {
+            cache->search_state = hex_viewer_cache_search_run(cache);
+        }
+        if(!(flags & HexViewerCacheEvtPrefetch)) continue;
+
+        furi_check(furi_mutex_acquire(cache->pages_mutex, FuriWaitForever) == FuriStatusOk);
+        uint32_t page_offset = cache->prefetch_offset;
+        bool cached = hex_viewer_cache_find(cache, page_offset) != NULL;
+        furi_mutex_release(cache->pages_mutex);
+        if(cached) continue;
+
+        // Read outside of pages_mutex, so UI keeps reading cached pages meanwhile
+        uint32_t read = hex_viewer_cache_load(
+            cache, page_offset, cache->prefetch_buf, HEX_VIEWER_CACHE_PAGE_SIZE);
+
+        furi_check(furi_mutex_acquire(cache->pages_mutex, FuriWaitForever) == FuriStatusOk);
+        if(read > 0 && !hex_viewer_cache_find(cache, page_offset)) {
+            HexViewerCachePage* page = hex_viewer_cache_victim(cache);
+            page->offset = page_offset;
+            page->size = read;
+            // Prefetched page is the next candidate for eviction until it gets used
+            page->last_used = cache->use_counter > 0 ? cache->use_counter - 1 : 0;
+            memcpy(page->data, cache->prefetch_buf, read);
+        }
+        furi_mutex_release(cache->pages_mutex);
+    }
+
+    return 0;
+}
+
+HexViewerCache* hex_viewer_cache_alloc(Stream* stream, uint32_t file_size) {
+    furi_assert(stream);
+
+    HexViewerCache* cache = malloc(sizeof(HexViewerCache));
+    cache->stream = stream;
+    cache->file_size = file_size;
+    cache->use_counter = 0;
+    cache->prefetch_offset = 0;
+    cache->search_state = HexViewerCacheSearchIdle;
+    cache->search_cancel = false;
+    for(size_t i = 0; i < HEX_VIEWER_CACHE_PAGES; i++) {
+        cache->pages[i].offset = HEX_VIEWER_CACHE_NO_PAGE;
+        cache->pages[i].size = 0;
+        cache->pages[i].last_used = 0;
+    }
+
+    cache->pages_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    cache->io_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    cache->thread = furi_thread_alloc_ex("HexViewerCache", 1024, hex_viewer_cache_worker, cache);
+    furi_thread_start(cache->thread);
+
+    return cache;
+}
+
+void hex_viewer_cache_free(HexViewerCache* cache) {
+    furi_assert(cache);
+
+    cache->search_cancel = true;
+    furi_thread_flags_set(furi_thread_get_id(cache->thread), HexViewerCacheEvtStop);
+    furi_thread_join(cache->thread);
+    furi_thread_free(cache->thread);
+
+    furi_mutex_free(cache->io_mutex);
+    furi_mutex_free(cache->pages_mutex);
+    free(cache);
+}
+
+size_t hex_viewer_cache_read(HexViewerCache* cache, uint32_t offset, uint8_t* buf, size_t len) {
+    furi_assert(cache);
+
+    size_t total = 0;
+    furi_check(furi_mutex_acquire(cache->pages_mutex, FuriWaitForever) == FuriStatusOk);
+    while(total < len && offset < cache->file_size) {
+        HexViewerCachePage* page = hex_viewer_cache_get_page(cache, offset);
+        if(!page) break;
+        uint32_t page_pos = offset - page->offset;
+        if(page_pos >= page->size) break;
+
+        size_t chunk = MIN(len - total, page->size - page_pos);
+        memcpy(&buf[total], &page->data[page_pos], chunk);
+        total += chunk;
+        offset += chunk;
+    }
+    furi_mutex_release(cache->pages_mutex);
+
+    return total;
+}
+
+void hex_viewer_cache_prefetch(
+    HexViewerCache* cache,
+    uint32_t offset,
+    HexViewerCacheDirection direction) {
+    furi_assert(cache);
+
+    uint32_t page_offset = hex_viewer_cache_page_offset(offset);
+    if(direction == HexViewerCacheDirectionForward) {
+        page_offset += HEX_VIEWER_CACHE_PAGE_SIZE;
+        if(page_offset >= cache->file_size) return;
+    } else {
+        if(page_offset == 0) return;
+        page_offset -= HEX_VIEWER_CACHE_PAGE_SIZE;
+    }
+
+    furi_check(furi_mutex_acquire(cache->pages_mutex, FuriWaitForever) == FuriStatusOk);
+    cache->prefetch_offset = page_offset;
+    furi_mutex_release(cache->pages_mutex);
+
+    furi_thread_flags_set(furi_thread_get_id(cache->thread), HexViewerCacheEvtPrefetch);
+}
+
+bool hex_viewer_cache_search_start(
+    HexViewerCache* cache,
+    const uint8_t* pattern,
+    size_t pattern_len,
+    uint32_t from) {
+    furi_assert(cache);
+    furi_assert(pattern);
+    furi_assert(pattern_len > 0 && pattern_len <= HEX_VIEWER_SEARCH_MAX_LEN);
+
+    // Cancelled search may still be finishing its last block
+    if(cache->search_state == HexViewerCacheSearchRunning) return false;
+
+    memcpy(cache->search_pattern, pattern, pattern_len);
+    cache->search_pattern_len = pattern_len;
+    cache->search_from = from;
+    cache->search_pos = from;
+    cache->search_cancel = false;
+    cache->search_state = HexViewerCacheSearchRunning;
+    furi_thread_flags_set(furi_thread_get_id(cache->thread), HexViewerCacheEvtSearch);
+    return true;
+}
+
+void hex_viewer_cache_search_cancel(HexViewerCache* cache) {
+    furi_assert(cache);
+    cache->search_cancel = true;
+}
+
+HexViewerCacheSearchState
+    hex_viewer_cache_search_poll(HexViewerCache* cache, uint32_t* found_offset, uint8_t* percent) {
+    furi_assert(cache);
+
+    HexViewerCacheSearchState state = cache->search_state;
+    if(state == HexViewerCacheSearchRunning) {
+        uint32_t total = cache->file_size - cache->search_from;
+        uint32_t done = cache->search_pos - cache->search_from;
+        *percent = total > 0 ? (uint64_t)done * 100 / total : 100;
+    } else if(state == HexViewerCacheSearchFound) {
+        *found_offset = cache->search_found;
+    }
+    return state;
+}
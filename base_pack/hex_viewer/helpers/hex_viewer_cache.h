@@ -0,0 +1,50 @@
+#pragma once
+
+#include <furi.h>
+#include <stream/stream.h>
+
+#define HEX_VIEWER_CACHE_PAGE_SIZE 1024u
+#define HEX_VIEWER_CACHE_PAGES 4u
+#define HEX_VIEWER_SEARCH_MAX_LEN 16u
+
+typedef struct HexViewerCache HexViewerCache;
+
+typedef enum {
+    HexViewerCacheSearchIdle,
+    HexViewerCacheSearchRunning,
+    HexViewerCacheSearchFound,
+    HexViewerCacheSearchNotFound,
+    HexViewerCacheSearchCancelled,
+} HexViewerCacheSearchState;
+
+typedef enum {
+    HexViewerCacheDirectionForward,
+    HexViewerCacheDirectionBackward,
+} HexViewerCacheDirection;
+
+HexViewerCache* hex_viewer_cache_alloc(Stream* stream, uint32_t file_size);
+void hex_viewer_cache_free(HexViewerCache* cache);
+
+// Reads through the page cache, missing pages are loaded synchronously
+size_t hex_viewer_cache_read(HexViewerCache* cache, uint32_t offset, uint8_t* buf, size_t len);
+
+// Asks background worker to load the page next to offset in scroll direction
+void hex_viewer_cache_prefetch(
+    HexViewerCache* cache,
+    uint32_t offset,
+    HexViewerCacheDirection direction);
+
+// Starts looking for byte pattern from offset on the worker, false if a search is still running.
+// File is read in big blocks past the page cache, so pages on screen stay cached.
+bool hex_viewer_cache_search_start(
+    HexViewerCache* cache,
+    const uint8_t* pattern,
+    size_t pattern_len,
+    uint32_t from);
+
+// Asks the worker to stop searching, it stops after the block being read
+void hex_viewer_cache_search_cancel(HexViewerCache* cache);
+
+// Returns search state, percent done while running and match offset once found
+HexViewerCacheSearchState
+    hex_viewer_cache_search_poll(HexViewerCache* cache, uint32_t* found_offset, uint8_t* percent);
@@ -26,6 +26,8 @@ enum HexViewerCustomEventType {
     HexViewerCustomEventMenuVoid,
     HexViewerCustomEventMenuSelected,
     HexViewerCustomEventMenuPercentEntered,
+    HexViewerCustomEventMenuFindEntered,
+    HexViewerCustomEventMenuFindCancel,
 };
 
 #pragma pack(push, 1)
@@ -117,17 +117,31 @@ void hex_viewer_read_settings(void* context) {
     hex_viewer_close_storage();
 }
 
-bool hex_viewer_open_file(void* context, const char* file_path) {
+void hex_viewer_close_file(void* context) {
     HexViewer* hex_viewer = context;
     furi_assert(hex_viewer);
-    furi_assert(file_path);
 
-    // TODO Separate function?
+    if(hex_viewer->model->cache) {
+        hex_viewer_cache_free(hex_viewer->model->cache);
+        hex_viewer->model->cache = NULL;
+    }
+
     if(hex_viewer->model->stream) {
         buffered_file_stream_close(hex_viewer->model->stream);
         stream_free(hex_viewer->model->stream);
-        hex_viewer->model->file_offset = 0;
+        hex_viewer->model->stream = NULL;
     }
+}
+
+bool hex_viewer_open_file(void* context, const char* file_path) {
+    HexViewer* hex_viewer = context;
+    furi_assert(hex_viewer);
+    furi_assert(file_path);
+
+    hex_viewer_close_file(hex_viewer);
+    hex_viewer->model->file_offset = 0;
+    hex_viewer->model->file_prev_offset = 0;
+    hex_viewer->model->search_offset = HEX_VIEWER_NO_SEARCH_OFFSET;
 
     hex_viewer->model->stream = buffered_file_stream_alloc(hex_viewer->storage);
     bool isOk = true;
@@ -141,6 +155,8 @@ bool hex_viewer_open_file(void* context, const char* file_path) {
         };
 
         hex_viewer->model->file_size = stream_size(hex_viewer->model->stream);
+        hex_viewer->model->cache =
+            hex_viewer_cache_alloc(hex_viewer->model->stream, hex_viewer->model->file_size);
     } while(false);
 
     return isOk;
@@ -149,25 +165,24 @@ bool hex_viewer_open_file(void* context, const char* file_path) {
 bool hex_viewer_read_file(void* context) {
     HexViewer* hex_viewer = context;
     furi_assert(hex_viewer);
-    furi_assert(hex_viewer->model->stream);
+    furi_assert(hex_viewer->model->cache);
     furi_assert(hex_viewer->model->file_offset % HEX_VIEWER_BYTES_PER_LINE == 0);
 
     memset(hex_viewer->model->file_bytes, 0x0, HEX_VIEWER_BUF_SIZE);
-    bool isOk = true;
-
-    do {
-        uint32_t offset = hex_viewer->model->file_offset;
-        if(!stream_seek(hex_viewer->model->stream, offset, true)) {
-            FURI_LOG_E(TAG, "Unable to seek stream");
-            isOk = false;
-            break;
-        }
-
-        hex_viewer->model->file_read_bytes = stream_read(
-            hex_viewer->model->stream,
-            (uint8_t*)hex_viewer->model->file_bytes,
-            HEX_VIEWER_BUF_SIZE);
-    } while(false);
 
-    return isOk;
-}
\ No newline at end of file
+    // Scrolling up moves offset back, anything else is treated as forward move
+    uint32_t offset = hex_viewer->model->file_offset;
+    HexViewerCacheDirection direction = (offset < hex_viewer->model->file_prev_offset) ?
+                                            HexViewerCacheDirectionBackward :
+                                            HexViewerCacheDirectionForward;
+    hex_viewer->model->file_prev_offset = offset;
+
+    hex_viewer->model->file_read_bytes = hex_viewer_cache_read(
+        hex_viewer->model->cache,
+        offset,
+        (uint8_t*)hex_viewer->model->file_bytes,
+        HEX_VIEWER_BUF_SIZE);
+    hex_viewer_cache_prefetch(hex_viewer->model->cache, offset, direction);
+
+    return hex_viewer->model->file_read_bytes > 0 || hex_viewer->model->file_size == 0;
+}
@@ -20,4 +20,5 @@ void hex_viewer_save_settings(void* context);
 void hex_viewer_read_settings(void* context);
 
 bool hex_viewer_open_file(void* context, const char* file_path);
-bool hex_viewer_read_file(void* context);
\ No newline at end of file
+bool hex_viewer_read_file(void* context);
+void hex_viewer_close_file(void* context);
\ No newline at end of file
@@ -24,6 +24,7 @@ HexViewer* hex_viewer_app_alloc() {
 
     app->model = malloc(sizeof(HexViewerModel));
     memset(app->model, 0, sizeof(HexViewerModel));
+    app->model->search_offset = HEX_VIEWER_NO_SEARCH_OFFSET;
 
     app->gui = furi_record_open(RECORD_GUI);
     app->storage = furi_record_open(RECORD_STORAGE);
@@ -72,6 +73,9 @@ HexViewer* hex_viewer_app_alloc() {
     view_dispatcher_add_view(
         app->view_dispatcher, HexViewerViewIdScroll, text_input_get_view(app->text_input));
 
+    app->popup = popup_alloc();
+    view_dispatcher_add_view(app->view_dispatcher, HexViewerViewIdPopup, popup_get_view(app->popup));
+
     app->variable_item_list = variable_item_list_alloc();
     view_dispatcher_add_view(
         app->view_dispatcher,
@@ -86,10 +90,7 @@ HexViewer* hex_viewer_app_alloc() {
 void hex_viewer_app_free(HexViewer* app) {
     furi_assert(app);
 
-    if(app->model->stream) {
-        buffered_file_stream_close(app->model->stream);
-        stream_free(app->model->stream);
-    }
+    hex_viewer_close_file(app);
 
     // Scene manager
     scene_manager_free(app->scene_manager);
@@ -101,6 +102,8 @@ void hex_viewer_app_free(HexViewer* app) {
     hex_viewer_startscreen_free(app->hex_viewer_startscreen);
     view_dispatcher_remove_view(app->view_dispatcher, HexViewerViewIdScroll);
     text_input_free(app->text_input);
+    view_dispatcher_remove_view(app->view_dispatcher, HexViewerViewIdPopup);
+    popup_free(app->popup);
     view_dispatcher_remove_view(app->view_dispatcher, HexViewerViewIdSettings);
     variable_item_list_free(app->variable_item_list);
 
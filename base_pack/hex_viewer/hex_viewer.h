@@ -15,9 +15,11 @@
 #include <gui/modules/variable_item_list.h>
 #include <gui/modules/button_menu.h>
 #include <gui/modules/dialog_ex.h>
+#include <gui/modules/popup.h>
 #include "scenes/hex_viewer_scene.h"
 #include "views/hex_viewer_startscreen.h"
 #include "helpers/hex_viewer_storage.h"
+#include "helpers/hex_viewer_cache.h"
 
 #include <storage/storage.h>
 #include <stream/stream.h>
@@ -29,18 +31,23 @@
 #define HEX_VIEWER_APP_PATH_FOLDER "/any" // TODO ANY_PATH
 #define HEX_VIEWER_APP_EXTENSION "*"
 #define HEX_VIEWER_PERCENT_INPUT 16
+#define HEX_VIEWER_SEARCH_INPUT (HEX_VIEWER_SEARCH_MAX_LEN * 3)
 
 #define HEX_VIEWER_BYTES_PER_LINE 4u
 #define HEX_VIEWER_LINES_ON_SCREEN 4u
+#define HEX_VIEWER_NO_SEARCH_OFFSET UINT32_MAX
 #define HEX_VIEWER_BUF_SIZE (HEX_VIEWER_LINES_ON_SCREEN * HEX_VIEWER_BYTES_PER_LINE)
 
 typedef struct {
     uint8_t file_bytes[HEX_VIEWER_LINES_ON_SCREEN][HEX_VIEWER_BYTES_PER_LINE];
     uint32_t file_offset;
+    uint32_t file_prev_offset;
     uint32_t file_read_bytes;
     uint32_t file_size;
+    uint32_t search_offset;
 
     Stream* stream;
+    HexViewerCache* cache;
 } HexViewerModel;
 
 typedef struct {
@@ -52,6 +59,7 @@ typedef struct {
     ViewDispatcher* view_dispatcher;
     Submenu* submenu;
     TextInput* text_input;
+    Popup* popup;
     SceneManager* scene_manager;
     VariableItemList* variable_item_list;
     HexViewerStartscreen* hex_viewer_startscreen;
@@ -62,6 +70,8 @@ typedef struct {
     uint32_t led;
     uint32_t save_settings;
     char percent_buf[HEX_VIEWER_PERCENT_INPUT];
+    char search_buf[HEX_VIEWER_SEARCH_INPUT];
+    char search_progress[16];
 } HexViewer;
 
 typedef enum {
@@ -69,6 +79,7 @@ typedef enum {
     HexViewerViewIdMenu,
     HexViewerViewIdScroll,
     HexViewerViewIdSettings,
+    HexViewerViewIdPopup,
 } HexViewerViewId;
 
 typedef enum {
@@ -0,0 +1,142 @@
+#include "../hex_viewer.h"
+#include "../helpers/hex_viewer_custom_event.h"
+#include "../helpers/hex_viewer_haptic.h"
+#include <toolbox/hex.h>
+
+void hex_viewer_scene_find_callback(void* context) {
+    HexViewer* app = (HexViewer*)context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, HexViewerCustomEventMenuFindEntered);
+}
+
+// Accepts "deadbeef" as well as "de_ad_be_ef", anything but hex digits is a separator
+static size_t hex_viewer_scene_find_parse(const char* input, uint8_t* pattern) {
+    size_t len = 0;
+    bool high = true;
+    for(; *input && len < HEX_VIEWER_SEARCH_MAX_LEN; input++) {
+        uint8_t nibble;
+        if(!hex_char_to_hex_nibble(*input, &nibble)) {
+            if(!high) len++;
+            high = true;
+            continue;
+        }
+        if(high) {
+            pattern[len] = nibble;
+        } else {
+            pattern[len] = (pattern[len] << 4) | nibble;
+            len++;
+        }
+        high = !high;
+    }
+    if(!high) len++;
+    return len;
+}
+
+void hex_viewer_scene_find_on_enter(void* context) {
+    furi_assert(context);
+    HexViewer* app = context;
+
+    TextInput* text_input = app->text_input;
+
+    text_input_set_header_text(text_input, "Find hex bytes (de_ad_be_ef)");
+    text_input_set_result_callback(
+        text_input,
+        hex_viewer_scene_find_callback,
+        app,
+        app->search_buf,
+        HEX_VIEWER_SEARCH_INPUT,
+        false);
+
+    view_dispatcher_switch_to_view(app->view_dispatcher, HexViewerViewIdScroll);
+}
+
+static void hex_viewer_scene_find_popup_callback(void* context) {
+    HexViewer* app = (HexViewer*)context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, HexViewerCustomEventMenuFindCancel);
+}
+
+static void hex_viewer_scene_find_show_progress(HexViewer* app, uint8_t percent) {
+    snprintf(app->search_progress, sizeof(app->search_progress), "%u%%", percent);
+    popup_set_text(app->popup, app->search_progress, 64, 32, AlignCenter, AlignCenter);
+}
+
+// Whole file search runs on the cache worker, popup shows progress and any key cancels it
+static bool hex_viewer_scene_find_start(HexViewer* app) {
+    uint8_t pattern[HEX_VIEWER_SEARCH_MAX_LEN];
+    size_t pattern_len = hex_viewer_scene_find_parse(app->search_buf, pattern);
+    if(pattern_len == 0 || !app->model->cache) return false;
+
+    // Repeated search continues after the previous match if it is still on screen
+    uint32_t from = app->model->file_offset;
+    uint32_t last = app->model->search_offset;
+    if(last != HEX_VIEWER_NO_SEARCH_OFFSET && last >= from && last < from + HEX_VIEWER_BUF_SIZE) {
+        from = last + 1;
+    }
+    if(!hex_viewer_cache_search_start(app->model->cache, pattern, pattern_len, from)) {
+        return false;
+    }
+
+    popup_reset(app->popup);
+    popup_set_header(app->popup, "Searching...", 64, 16, AlignCenter, AlignCenter);
+    popup_set_callback(app->popup, hex_viewer_scene_find_popup_callback);
+    popup_set_context(app->popup, app);
+    hex_viewer_scene_find_show_progress(app, 0);
+    scene_manager_set_scene_state(app->scene_manager, HexViewerSceneFind, true);
+    view_dispatcher_switch_to_view(app->view_dispatcher, HexViewerViewIdPopup);
+    return true;
+}
+
+static void hex_viewer_scene_find_finish(HexViewer* app) {
+    scene_manager_set_scene_state(app->scene_manager, HexViewerSceneFind, false);
+    scene_manager_search_and_switch_to_previous_scene(
+        app->scene_manager, HexViewerViewIdStartscreen);
+}
+
+bool hex_viewer_scene_find_on_event(void* context, SceneManagerEvent event) {
+    HexViewer* app = (HexViewer*)context;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom) {
+        if(event.event == HexViewerCustomEventMenuFindEntered) {
+            if(!hex_viewer_scene_find_start(app)) {
+                app->model->search_offset = HEX_VIEWER_NO_SEARCH_OFFSET;
+                hex_viewer_play_bad_bump(app);
+                hex_viewer_scene_find_finish(app);
+            }
+            consumed = true;
+        } else if(event.event == HexViewerCustomEventMenuFindCancel) {
+            // Cancelled search leaves position and previous match as they were
+            hex_viewer_scene_find_finish(app);
+            consumed = true;
+        }
+    } else if(
+        event.type == SceneManagerEventTypeTick && app->model->cache &&
+        scene_manager_get_scene_state(app->scene_manager, HexViewerSceneFind)) {
+        uint32_t found;
+        uint8_t percent;
+        HexViewerCacheSearchState state =
+            hex_viewer_cache_search_poll(app->model->cache, &found, &percent);
+        if(state == HexViewerCacheSearchRunning) {
+            hex_viewer_scene_find_show_progress(app, percent);
+        } else if(state == HexViewerCacheSearchFound) {
+            app->model->search_offset = found;
+            app->model->file_offset = found - (found % HEX_VIEWER_BYTES_PER_LINE);
+            hex_viewer_read_file(app);
+            hex_viewer_scene_find_finish(app);
+        } else if(state == HexViewerCacheSearchNotFound) {
+            app->model->search_offset = HEX_VIEWER_NO_SEARCH_OFFSET;
+            hex_viewer_play_bad_bump(app);
+            hex_viewer_scene_find_finish(app);
+        }
+        consumed = true;
+    }
+    return consumed;
+}
+
+void hex_viewer_scene_find_on_exit(void* context) {
+    HexViewer* app = (HexViewer*)context;
+    scene_manager_set_scene_state(app->scene_manager, HexViewerSceneFind, false);
+    if(app->model->cache) {
+        hex_viewer_cache_search_cancel(app->model->cache);
+    }
+    popup_reset(app->popup);
+}
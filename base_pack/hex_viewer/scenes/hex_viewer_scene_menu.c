@@ -4,6 +4,7 @@ enum SubmenuIndex {
     SubmenuIndexScroll = 10,
     SubmenuIndexInfo,
     SubmenuIndexOpen,
+    SubmenuIndexFind,
     // SubmenuIndexSettings,
 };
 
@@ -28,6 +29,12 @@ void hex_viewer_scene_menu_on_enter(void* context) {
         SubmenuIndexScroll,
         hex_viewer_scene_menu_submenu_callback,
         app);
+    submenu_add_item(
+        app->submenu,
+        "Find bytes ...",
+        SubmenuIndexFind,
+        hex_viewer_scene_menu_submenu_callback,
+        app);
     submenu_add_item(
         app->submenu,
         "Show info ...",
@@ -57,6 +64,11 @@ bool hex_viewer_scene_menu_on_event(void* context, SceneManagerEvent event) {
                 app->scene_manager, HexViewerSceneMenu, SubmenuIndexScroll);
             scene_manager_next_scene(app->scene_manager, HexViewerSceneScroll);
             return true;
+        } else if(event.event == SubmenuIndexFind) {
+            scene_manager_set_scene_state(
+                app->scene_manager, HexViewerSceneMenu, SubmenuIndexFind);
+            scene_manager_next_scene(app->scene_manager, HexViewerSceneFind);
+            return true;
         } else if(event.event == SubmenuIndexInfo) {
             scene_manager_set_scene_state(
                 app->scene_manager, HexViewerSceneMenu, SubmenuIndexInfo);
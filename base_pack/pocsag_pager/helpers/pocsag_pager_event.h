@@ -8,6 +8,7 @@ typedef enum {
 
     PCSGCustomEventViewReceiverOK,
     PCSGCustomEventViewReceiverConfig,
+    PCSGCustomEventViewReceiverFilter,
     PCSGCustomEventViewReceiverBack,
     PCSGCustomEventViewReceiverOffDisplay,
     PCSGCustomEventViewReceiverUnlock,
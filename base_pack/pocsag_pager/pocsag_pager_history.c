@@ -2,139 +2,534 @@
 #include <flipper_format/flipper_format_i.h>
 #include <lib/toolbox/stream/stream.h>
 #include <lib/subghz/receiver.h>
+#include <storage/storage.h>
 #include "protocols/pcsg_generic.h"
+#include "protocols/pocsag.h"
 
 #include <furi.h>
 
-#define PCSG_HISTORY_MAX 50
 #define TAG "PCSGHistory"
 
+// List positions are uint16_t
+#define PCSG_HISTORY_MAX UINT16_MAX
+
+#define PCSG_HISTORY_FOLDER EXT_PATH("pocsag")
+#define PCSG_HISTORY_DATA_PATH PCSG_HISTORY_FOLDER "/history.bin"
+#define PCSG_HISTORY_INDEX_PATH PCSG_HISTORY_FOLDER "/history.idx"
+#define PCSG_HISTORY_DATA_OLD_PATH PCSG_HISTORY_FOLDER "/history.bin.old"
+#define PCSG_HISTORY_INDEX_OLD_PATH PCSG_HISTORY_FOLDER "/history.idx.old"
+// Session file is rotated to .old once it grows past this or PCSG_HISTORY_MAX records,
+// listing starts over
+#define PCSG_HISTORY_FILE_MAX (8 * 1024 * 1024)
+
+// Records wait in RAM until one of tail limits is hit or they get old
+#define PCSG_HISTORY_TAIL_SIZE 1024
+#define PCSG_HISTORY_TAIL_ITEMS 32
+#define PCSG_HISTORY_FLUSH_MS 5000
+
+#define PCSG_HISTORY_MSG_MAX 512
+#define PCSG_HISTORY_BODY_MAX ((PCSG_HISTORY_MSG_MAX * 7 + 7) / 8)
+#define PCSG_HISTORY_SCAN_ITEMS 32
+
+// Record header, followed by message packed 7 bits per character
+typedef struct __attribute__((packed)) {
+    uint32_t timestamp;
+    uint32_t ric;
+    uint32_t frequency;
+    uint16_t version;
+    uint16_t msg_len;
+    uint8_t func;
+    uint8_t reserved;
+} PCSGHistoryRecord;
+
+// Fixed size entry per record in the index file, RIC is there to filter without reading records
 typedef struct {
-    FuriString* item_str;
-    FlipperFormat* flipper_string;
-    uint8_t type;
-    SubGhzRadioPreset* preset;
-} PCSGHistoryItem;
-
-ARRAY_DEF(PCSGHistoryItemArray, PCSGHistoryItem, M_POD_OPLIST)
-
-#define M_OPL_PCSGHistoryItemArray_t() ARRAY_OPLIST(PCSGHistoryItemArray, M_POD_OPLIST)
+    uint32_t offset;
+    uint32_t ric;
+} PCSGHistoryIndexEntry;
 
+// Records of one RIC, in record order
 typedef struct {
-    PCSGHistoryItemArray_t data;
-} PCSGHistoryStruct;
+    uint32_t ric;
+    uint16_t* items;
+    uint16_t count;
+    uint32_t capacity; // Doubles past UINT16_MAX
+} PCSGHistoryFilter;
 
 struct PCSGHistory {
     uint32_t last_update_timestamp;
-    uint16_t last_index_write;
     uint8_t code_last_hash_data;
     FuriString* tmp_string;
-    PCSGHistoryStruct* history;
+    FlipperFormat* raw;
+    FuriMutex* mutex;
+
+    Storage* storage;
+    File* data_file;
+    File* index_file;
+    bool files_open;
+    bool sd_error;
+
+    uint32_t data_size; // Bytes already on SD card
+    uint16_t flushed; // Records already on SD card
+    uint16_t count; // All records, including RAM tail
+
+    uint32_t tail_len;
+    uint32_t tail_since;
+    uint8_t tail[PCSG_HISTORY_TAIL_SIZE];
+    PCSGHistoryIndexEntry tail_index[PCSG_HISTORY_TAIL_ITEMS];
+
+    PCSGHistoryFilter filter;
+
+    // New filter is built by a worker and swapped in once the whole index is scanned
+    PCSGHistoryFilter scan;
+    uint16_t scan_pos;
+    FuriThread* scan_thread;
+    volatile bool scan_cancel;
+
+    uint8_t body[PCSG_HISTORY_BODY_MAX];
 };
 
+static uint16_t pcsg_history_pack(const char* text, uint16_t len, uint8_t* body) {
+    uint16_t size = (len * 7 + 7) / 8;
+    memset(body, 0, size);
+    for(uint16_t i = 0; i < len; i++) {
+        uint8_t c = text[i] & 0x7F;
+        uint32_t bit = i * 7;
+        body[bit / 8] |= (uint8_t)(c << (bit % 8));
+        if(bit % 8 > 1) body[bit / 8 + 1] |= c >> (8 - bit % 8);
+    }
+    return size;
+}
+
+static void pcsg_history_unpack(const uint8_t* body, uint16_t len, FuriString* output) {
+    furi_string_reset(output);
+    for(uint16_t i = 0; i < len; i++) {
+        uint32_t bit = i * 7;
+        uint16_t c = body[bit / 8] >> (bit % 8);
+        if(bit % 8 > 1) c |= body[bit / 8 + 1] << (8 - bit % 8);
+        furi_string_push_back(output, c & 0x7F);
+    }
+}
+
+static void pcsg_history_rotate_file(Storage* storage, const char* path, const char* old_path) {
+    if(storage_file_exists(storage, path)) {
+        storage_simply_remove(storage, old_path);
+        storage_common_rename(storage, path, old_path);
+    }
+}
+
+static void pcsg_history_close(PCSGHistory* instance) {
+    if(instance->files_open) {
+        storage_file_close(instance->data_file);
+        storage_file_close(instance->index_file);
+        instance->files_open = false;
+    }
+}
+
+// Must be called with mutex taken
+static bool pcsg_history_open(PCSGHistory* instance) {
+    if(instance->files_open) return true;
+    if(instance->sd_error) return false;
+
+    storage_simply_mkdir(instance->storage, PCSG_HISTORY_FOLDER);
+    // One previous session stays on SD card
+    pcsg_history_rotate_file(
+        instance->storage, PCSG_HISTORY_DATA_PATH, PCSG_HISTORY_DATA_OLD_PATH);
+    pcsg_history_rotate_file(
+        instance->storage, PCSG_HISTORY_INDEX_PATH, PCSG_HISTORY_INDEX_OLD_PATH);
+
+    bool data_open = storage_file_open(
+        instance->data_file, PCSG_HISTORY_DATA_PATH, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS);
+    bool index_open = storage_file_open(
+        instance->index_file, PCSG_HISTORY_INDEX_PATH, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS);
+    if(!data_open || !index_open) {
+        FURI_LOG_E(TAG, "Unable to open history files, keeping records in RAM");
+        storage_file_close(instance->data_file);
+        storage_file_close(instance->index_file);
+        instance->sd_error = true;
+        return false;
+    }
+
+    instance->files_open = true;
+    return true;
+}
+
+// Must be called with mutex taken
+static void pcsg_history_flush(PCSGHistory* instance) {
+    uint16_t pending = instance->count - instance->flushed;
+    if(pending == 0 || !pcsg_history_open(instance)) return;
+
+    size_t index_size = pending * sizeof(PCSGHistoryIndexEntry);
+    if(!storage_file_seek(instance->data_file, instance->data_size, true) ||
+       storage_file_write(instance->data_file, instance->tail, instance->tail_len) !=
+           instance->tail_len ||
+       !storage_file_seek(
+           instance->index_file, instance->flushed * sizeof(PCSGHistoryIndexEntry), true) ||
+       storage_file_write(instance->index_file, instance->tail_index, index_size) !=
+           index_size) {
+        FURI_LOG_E(TAG, "Unable to write history files, keeping records in RAM");
+        pcsg_history_close(instance);
+        instance->sd_error = true;
+        return;
+    }
+
+    instance->data_size += instance->tail_len;
+    instance->flushed = instance->count;
+    instance->tail_len = 0;
+}
+
+// Must be called with mutex taken
+static void pcsg_history_clear(PCSGHistory* instance) {
+    instance->data_size = 0;
+    instance->flushed = 0;
+    instance->count = 0;
+    instance->tail_len = 0;
+    instance->filter.count = 0;
+    instance->scan.count = 0;
+    instance->scan_pos = 0;
+}
+
+static void pcsg_history_filter_push(PCSGHistoryFilter* filter, uint16_t record) {
+    if(filter->count == filter->capacity) {
+        filter->capacity = filter->capacity ? filter->capacity * 2 : 16;
+        filter->items = realloc(filter->items, filter->capacity * sizeof(uint16_t));
+    }
+    filter->items[filter->count++] = record;
+}
+
+// Must be called with mutex taken
+static bool pcsg_history_get_entry(
+    PCSGHistory* instance,
+    uint16_t idx,
+    PCSGHistoryIndexEntry* entry) {
+    uint16_t record = idx;
+    if(instance->filter.ric != PCSG_HISTORY_FILTER_NONE) {
+        if(idx >= instance->filter.count) return false;
+        record = instance->filter.items[idx];
+    }
+    if(record >= instance->count) return false;
+
+    if(record >= instance->flushed) {
+        *entry = instance->tail_index[record - instance->flushed];
+        return true;
+    }
+    return instance->files_open &&
+           storage_file_seek(
+               instance->index_file, record * sizeof(PCSGHistoryIndexEntry), true) &&
+           storage_file_read(instance->index_file, entry, sizeof(PCSGHistoryIndexEntry)) ==
+               sizeof(PCSGHistoryIndexEntry);
+}
+
+// Must be called with mutex taken, message is unpacked only when it is not NULL
+static bool pcsg_history_read(
+    PCSGHistory* instance,
+    uint16_t idx,
+    PCSGHistoryRecord* record,
+    FuriString* message) {
+    PCSGHistoryIndexEntry entry;
+    if(!pcsg_history_get_entry(instance, idx, &entry)) {
+        FURI_LOG_E(TAG, "Missing record %u", idx);
+        return false;
+    }
+
+    const uint8_t* body;
+    if(entry.offset >= instance->data_size) {
+        const uint8_t* src = &instance->tail[entry.offset - instance->data_size];
+        memcpy(record, src, sizeof(PCSGHistoryRecord));
+        body = src + sizeof(PCSGHistoryRecord);
+    } else {
+        if(!instance->files_open ||
+           !storage_file_seek(instance->data_file, entry.offset, true) ||
+           storage_file_read(instance->data_file, record, sizeof(PCSGHistoryRecord)) !=
+               sizeof(PCSGHistoryRecord)) {
+            FURI_LOG_E(TAG, "Unable to read record %u", idx);
+            return false;
+        }
+        if(message) {
+            size_t body_size = (record->msg_len * 7 + 7) / 8;
+            if(storage_file_read(instance->data_file, instance->body, body_size) != body_size) {
+                FURI_LOG_E(TAG, "Unable to read message %u", idx);
+                return false;
+            }
+        }
+        body = instance->body;
+    }
+
+    if(message) pcsg_history_unpack(body, record->msg_len, message);
+    return true;
+}
+
 PCSGHistory* pcsg_history_alloc(void) {
     PCSGHistory* instance = malloc(sizeof(PCSGHistory));
     instance->tmp_string = furi_string_alloc();
-    instance->history = malloc(sizeof(PCSGHistoryStruct));
-    PCSGHistoryItemArray_init(instance->history->data);
+    instance->raw = flipper_format_string_alloc();
+    instance->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+
+    instance->storage = furi_record_open(RECORD_STORAGE);
+    instance->data_file = storage_file_alloc(instance->storage);
+    instance->index_file = storage_file_alloc(instance->storage);
+    instance->files_open = false;
+    instance->sd_error = false;
+
+    instance->filter.ric = PCSG_HISTORY_FILTER_NONE;
+    instance->filter.items = NULL;
+    instance->filter.capacity = 0;
+    instance->scan.items = NULL;
+    instance->scan.capacity = 0;
+    instance->scan_thread = NULL;
+    pcsg_history_clear(instance);
+
+    instance->last_update_timestamp = 0;
+    instance->code_last_hash_data = 0;
     return instance;
 }
 
+// Scan worker takes the mutex itself, so this must be called without it
+static void pcsg_history_scan_stop(PCSGHistory* instance) {
+    if(!instance->scan_thread) return;
+    instance->scan_cancel = true;
+    furi_thread_join(instance->scan_thread);
+    furi_thread_free(instance->scan_thread);
+    instance->scan_thread = NULL;
+}
+
 void pcsg_history_free(PCSGHistory* instance) {
     furi_assert(instance);
+
+    pcsg_history_scan_stop(instance);
+    pcsg_history_flush(instance);
+    pcsg_history_close(instance);
+    storage_file_free(instance->data_file);
+    storage_file_free(instance->index_file);
+    furi_record_close(RECORD_STORAGE);
+
+    free(instance->filter.items);
+    free(instance->scan.items);
+    furi_mutex_free(instance->mutex);
+    flipper_format_free(instance->raw);
     furi_string_free(instance->tmp_string);
-    for
-        M_EACH(item, instance->history->data, PCSGHistoryItemArray_t) {
-            furi_string_free(item->item_str);
-            furi_string_free(item->preset->name);
-            free(item->preset);
-            flipper_format_free(item->flipper_string);
-            item->type = 0;
-        }
-    PCSGHistoryItemArray_clear(instance->history->data);
-    free(instance->history);
     free(instance);
 }
 
-uint32_t pcsg_history_get_frequency(PCSGHistory* instance, uint16_t idx) {
+void pcsg_history_reset(PCSGHistory* instance) {
     furi_assert(instance);
-    PCSGHistoryItem* item = PCSGHistoryItemArray_get(instance->history->data, idx);
-    return item->preset->frequency;
+    pcsg_history_scan_stop(instance);
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+
+    // Finished session becomes .old when the next one writes its first records
+    pcsg_history_flush(instance);
+    pcsg_history_close(instance);
+    instance->sd_error = false;
+    pcsg_history_clear(instance);
+    instance->filter.ric = PCSG_HISTORY_FILTER_NONE;
+    instance->code_last_hash_data = 0;
+
+    furi_mutex_release(instance->mutex);
 }
 
-SubGhzRadioPreset* pcsg_history_get_radio_preset(PCSGHistory* instance, uint16_t idx) {
+void pcsg_history_sync(PCSGHistory* instance) {
     furi_assert(instance);
-    PCSGHistoryItem* item = PCSGHistoryItemArray_get(instance->history->data, idx);
-    return item->preset;
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    if(instance->count > instance->flushed &&
+       furi_get_tick() - instance->tail_since > PCSG_HISTORY_FLUSH_MS) {
+        pcsg_history_flush(instance);
+    }
+    furi_mutex_release(instance->mutex);
 }
 
-const char* pcsg_history_get_preset(PCSGHistory* instance, uint16_t idx) {
+uint32_t pcsg_history_get_frequency(PCSGHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    PCSGHistoryItem* item = PCSGHistoryItemArray_get(instance->history->data, idx);
-    return furi_string_get_cstr(item->preset->name);
+    PCSGHistoryRecord record = {0};
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    pcsg_history_read(instance, idx, &record, NULL);
+    furi_mutex_release(instance->mutex);
+    return record.frequency;
 }
 
-void pcsg_history_reset(PCSGHistory* instance) {
+uint32_t pcsg_history_get_ric(PCSGHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    furi_string_reset(instance->tmp_string);
-    for
-        M_EACH(item, instance->history->data, PCSGHistoryItemArray_t) {
-            furi_string_free(item->item_str);
-            furi_string_free(item->preset->name);
-            free(item->preset);
-            flipper_format_free(item->flipper_string);
-            item->type = 0;
+    PCSGHistoryIndexEntry entry = {.ric = PCSG_HISTORY_FILTER_NONE};
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    pcsg_history_get_entry(instance, idx, &entry);
+    furi_mutex_release(instance->mutex);
+    return entry.ric;
+}
+
+// Index is read in small chunks with the mutex released in between, so receiving and
+// drawing the list go on while a long history is scanned
+static int32_t pcsg_history_scan_worker(void* context) {
+    PCSGHistory* instance = context;
+    PCSGHistoryIndexEntry entries[PCSG_HISTORY_SCAN_ITEMS];
+    bool done = false;
+
+    while(!done && !instance->scan_cancel) {
+        furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+        uint16_t record = instance->scan_pos;
+        if(record >= instance->count) {
+            // Records added from now on are pushed to the new filter right away
+            PCSGHistoryFilter old = instance->filter;
+            instance->filter = instance->scan;
+            instance->scan.items = old.items;
+            instance->scan.capacity = old.capacity;
+            instance->scan.count = 0;
+            done = true;
+        } else if(record < instance->flushed) {
+            uint16_t chunk = MIN(instance->flushed - record, PCSG_HISTORY_SCAN_ITEMS);
+            size_t size = chunk * sizeof(PCSGHistoryIndexEntry);
+            if(instance->files_open &&
+               storage_file_seek(
+                   instance->index_file, record * sizeof(PCSGHistoryIndexEntry), true) &&
+               storage_file_read(instance->index_file, entries, size) == size) {
+                for(uint16_t i = 0; i < chunk; i++) {
+                    if(entries[i].ric == instance->scan.ric) {
+                        pcsg_history_filter_push(&instance->scan, record + i);
+                    }
+                }
+                instance->scan_pos += chunk;
+            } else {
+                // Records that can't be read can't be listed either
+                instance->scan_pos = instance->flushed;
+            }
+        } else {
+            for(; record < instance->count; record++) {
+                if(instance->tail_index[record - instance->flushed].ric == instance->scan.ric) {
+                    pcsg_history_filter_push(&instance->scan, record);
+                }
+            }
+            instance->scan_pos = record;
         }
-    PCSGHistoryItemArray_reset(instance->history->data);
-    instance->last_index_write = 0;
-    instance->code_last_hash_data = 0;
+        furi_mutex_release(instance->mutex);
+
+        if(!done) furi_thread_yield();
+    }
+
+    return 0;
+}
+
+void pcsg_history_set_filter(PCSGHistory* instance, uint32_t ric) {
+    furi_assert(instance);
+    pcsg_history_scan_stop(instance);
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+
+    if(ric == PCSG_HISTORY_FILTER_NONE) {
+        instance->filter.ric = ric;
+        instance->filter.count = 0;
+    } else {
+        instance->scan.ric = ric;
+        instance->scan.count = 0;
+        instance->scan_pos = 0;
+        instance->scan_cancel = false;
+        instance->scan_thread =
+            furi_thread_alloc_ex("PCSGHistoryScan", 1024, pcsg_history_scan_worker, instance);
+        furi_thread_start(instance->scan_thread);
+    }
+
+    furi_mutex_release(instance->mutex);
+}
+
+bool pcsg_history_filter_pending(PCSGHistory* instance) {
+    furi_assert(instance);
+    if(!instance->scan_thread) return false;
+    if(furi_thread_get_state(instance->scan_thread) != FuriThreadStateStopped) return true;
+
+    furi_thread_join(instance->scan_thread);
+    furi_thread_free(instance->scan_thread);
+    instance->scan_thread = NULL;
+    return false;
+}
+
+uint32_t pcsg_history_get_filter(PCSGHistory* instance) {
+    furi_assert(instance);
+    // Filter being scanned counts as set, so toggling it again turns it off
+    return instance->scan_thread ? instance->scan.ric : instance->filter.ric;
 }
 
 uint16_t pcsg_history_get_item(PCSGHistory* instance) {
     furi_assert(instance);
-    return instance->last_index_write;
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    uint16_t count = instance->filter.ric == PCSG_HISTORY_FILTER_NONE ? instance->count :
+                                                                        instance->filter.count;
+    furi_mutex_release(instance->mutex);
+    return count;
 }
 
 uint8_t pcsg_history_get_type_protocol(PCSGHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    PCSGHistoryItem* item = PCSGHistoryItemArray_get(instance->history->data, idx);
-    return item->type;
+    UNUSED(idx);
+    return subghz_protocol_pocsag.type;
 }
 
 const char* pcsg_history_get_protocol_name(PCSGHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    PCSGHistoryItem* item = PCSGHistoryItemArray_get(instance->history->data, idx);
-    flipper_format_rewind(item->flipper_string);
-    if(!flipper_format_read_string(item->flipper_string, "Protocol", instance->tmp_string)) {
-        FURI_LOG_E(TAG, "Missing Protocol");
-        furi_string_reset(instance->tmp_string);
-    }
-    return furi_string_get_cstr(instance->tmp_string);
+    UNUSED(idx);
+    return subghz_protocol_pocsag.name;
 }
 
 FlipperFormat* pcsg_history_get_raw_data(PCSGHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    PCSGHistoryItem* item = PCSGHistoryItemArray_get(instance->history->data, idx);
-    if(item->flipper_string) {
-        return item->flipper_string;
-    } else {
-        return NULL;
-    }
+    FlipperFormat* raw = NULL;
+    PCSGHistoryRecord record;
+    FuriString* ric_str = furi_string_alloc();
+
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    do {
+        if(!pcsg_history_read(instance, idx, &record, instance->tmp_string)) break;
+
+        subghz_protocol_pocsag_format_ric(ric_str, record.version, record.ric, record.func);
+        uint32_t frequency = record.frequency;
+
+        stream_clean(flipper_format_get_raw_stream(instance->raw));
+        if(!flipper_format_write_uint32(instance->raw, "Frequency", &frequency, 1) ||
+           !flipper_format_write_string_cstr(
+               instance->raw, "Protocol", subghz_protocol_pocsag.name) ||
+           !flipper_format_write_string(instance->raw, "Ric", ric_str) ||
+           !flipper_format_write_string(instance->raw, "Message", instance->tmp_string)) {
+            FURI_LOG_E(TAG, "Unable to rebuild record");
+            break;
+        }
+        flipper_format_rewind(instance->raw);
+        raw = instance->raw;
+    } while(false);
+    furi_mutex_release(instance->mutex);
+
+    furi_string_free(ric_str);
+    return raw;
 }
+
 bool pcsg_history_get_text_space_left(PCSGHistory* instance, FuriString* output) {
     furi_assert(instance);
-    if(instance->last_index_write == PCSG_HISTORY_MAX) {
-        if(output != NULL) furi_string_printf(output, "Memory is FULL");
-        return true;
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    // Without SD card only the RAM tail is left
+    bool full = instance->sd_error &&
+                (instance->count - instance->flushed == PCSG_HISTORY_TAIL_ITEMS ||
+                 instance->tail_len + sizeof(PCSGHistoryRecord) + PCSG_HISTORY_BODY_MAX >
+                     PCSG_HISTORY_TAIL_SIZE);
+    if(output != NULL) {
+        if(full) {
+            furi_string_printf(output, "Memory is FULL");
+        } else if(instance->scan_thread) {
+            furi_string_printf(output, "F..");
+        } else if(instance->filter.ric != PCSG_HISTORY_FILTER_NONE) {
+            furi_string_printf(output, "F%u", instance->filter.count);
+        } else {
+            furi_string_printf(output, "%02u", instance->count);
+        }
     }
-    if(output != NULL)
-        furi_string_printf(output, "%02u/%02u", instance->last_index_write, PCSG_HISTORY_MAX);
-    return false;
+    furi_mutex_release(instance->mutex);
+    return full;
 }
 
 void pcsg_history_get_text_item_menu(PCSGHistory* instance, FuriString* output, uint16_t idx) {
-    PCSGHistoryItem* item = PCSGHistoryItemArray_get(instance->history->data, idx);
-    furi_string_set(output, item->item_str);
+    furi_assert(instance);
+    PCSGHistoryRecord record;
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+    if(pcsg_history_read(instance, idx, &record, instance->tmp_string)) {
+        subghz_protocol_pocsag_format_ric(output, record.version, record.ric, record.func);
+        furi_string_cat(output, instance->tmp_string);
+    } else {
+        furi_string_set_str(output, "Unable to read");
+    }
+    furi_mutex_release(instance->mutex);
 }
 
 PCSGHistoryStateAddKey
@@ -142,9 +537,9 @@ PCSGHistoryStateAddKey
     furi_assert(instance);
     furi_assert(context);
 
-    if(instance->last_index_write >= PCSG_HISTORY_MAX) return PCSGHistoryStateAddKeyOverflow;
-
     SubGhzProtocolDecoderBase* decoder_base = context;
+    if(decoder_base->protocol != &subghz_protocol_pocsag) return PCSGHistoryStateAddKeyUnknown;
+
     if((instance->code_last_hash_data ==
         subghz_protocol_decoder_base_get_hash_data(decoder_base)) &&
        ((furi_get_tick() - instance->last_update_timestamp) < 500)) {
@@ -155,69 +550,63 @@ PCSGHistoryStateAddKey
     instance->code_last_hash_data = subghz_protocol_decoder_base_get_hash_data(decoder_base);
     instance->last_update_timestamp = furi_get_tick();
 
-    FlipperFormat* fff = flipper_format_string_alloc();
-    subghz_protocol_decoder_base_serialize(decoder_base, fff, preset);
-
+    PocsagPage page;
+    subghz_protocol_decoder_pocsag_get_page(decoder_base, &page);
+
+    PCSGHistoryRecord record = {
+        .timestamp = furi_hal_rtc_get_timestamp(),
+        .ric = page.ric,
+        .frequency = preset->frequency,
+        .version = page.version,
+        .msg_len = MIN(furi_string_size(page.message), PCSG_HISTORY_MSG_MAX),
+        .func = page.func,
+        .reserved = 0,
+    };
+
+    PCSGHistoryStateAddKey state = PCSGHistoryStateAddKeyNewDada;
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
     do {
-        if(!flipper_format_rewind(fff)) {
-            FURI_LOG_E(TAG, "Rewind error");
-            break;
+        uint16_t body_size =
+            pcsg_history_pack(furi_string_get_cstr(page.message), record.msg_len, instance->body);
+        size_t size = sizeof(PCSGHistoryRecord) + body_size;
+
+        if(instance->count == PCSG_HISTORY_MAX ||
+           instance->data_size + instance->tail_len + size > PCSG_HISTORY_FILE_MAX) {
+            FURI_LOG_I(TAG, "History file is full, rotating");
+            pcsg_history_flush(instance);
+            pcsg_history_close(instance);
+            pcsg_history_clear(instance);
         }
 
-    } while(false);
-    flipper_format_free(fff);
-
-    PCSGHistoryItem* item = PCSGHistoryItemArray_push_raw(instance->history->data);
-    item->preset = malloc(sizeof(SubGhzRadioPreset));
-    item->type = decoder_base->protocol->type;
-    item->preset->frequency = preset->frequency;
-    item->preset->name = furi_string_alloc();
-    furi_string_set(item->preset->name, preset->name);
-    item->preset->data = preset->data;
-    item->preset->data_size = preset->data_size;
-
-    item->item_str = furi_string_alloc();
-    item->flipper_string = flipper_format_string_alloc();
-    subghz_protocol_decoder_base_serialize(decoder_base, item->flipper_string, preset);
-
-    do {
-        if(!flipper_format_rewind(item->flipper_string)) {
-            FURI_LOG_E(TAG, "Rewind error");
-            break;
-        }
-        if(!flipper_format_read_string(item->flipper_string, "Protocol", instance->tmp_string)) {
-            FURI_LOG_E(TAG, "Missing Protocol");
-            break;
+        uint16_t pending = instance->count - instance->flushed;
+        if(instance->tail_len + size > PCSG_HISTORY_TAIL_SIZE ||
+           pending == PCSG_HISTORY_TAIL_ITEMS) {
+            pcsg_history_flush(instance);
+            pending = instance->count - instance->flushed;
         }
-
-        if(!flipper_format_rewind(item->flipper_string)) {
-            FURI_LOG_E(TAG, "Rewind error");
-            break;
-        }
-        FuriString* temp_ric = furi_string_alloc();
-        if(!flipper_format_read_string(item->flipper_string, "Ric", temp_ric)) {
-            FURI_LOG_E(TAG, "Missing Ric");
+        if(instance->tail_len + size > PCSG_HISTORY_TAIL_SIZE ||
+           pending == PCSG_HISTORY_TAIL_ITEMS) {
+            // Tail can't be written out, SD card is gone
+            state = PCSGHistoryStateAddKeyOverflow;
             break;
         }
 
-        FuriString* temp_message = furi_string_alloc();
-        if(!flipper_format_read_string(item->flipper_string, "Message", temp_message)) {
-            FURI_LOG_E(TAG, "Missing Message");
-            break;
-        }
-
-        furi_string_printf(
-            item->item_str,
-            "%s%s",
-            furi_string_get_cstr(temp_ric),
-            furi_string_get_cstr(temp_message));
+        if(pending == 0) instance->tail_since = furi_get_tick();
+        PCSGHistoryIndexEntry* entry = &instance->tail_index[pending];
+        entry->offset = instance->data_size + instance->tail_len;
+        entry->ric = record.ric;
 
-        furi_string_free(temp_message);
-        furi_string_free(temp_ric);
+        uint8_t* dst = &instance->tail[instance->tail_len];
+        memcpy(dst, &record, sizeof(PCSGHistoryRecord));
+        memcpy(dst + sizeof(PCSGHistoryRecord), instance->body, body_size);
+        instance->tail_len += size;
 
+        if(instance->filter.ric == record.ric) {
+            pcsg_history_filter_push(&instance->filter, instance->count);
+        }
+        instance->count++;
     } while(false);
-    instance->last_index_write++;
-    return PCSGHistoryStateAddKeyNewDada;
+    furi_mutex_release(instance->mutex);
 
-    return PCSGHistoryStateAddKeyUnknown;
+    return state;
 }
@@ -1,4 +1,3 @@
-
 #pragma once
 
 #include <math.h>
@@ -9,6 +8,9 @@
 
 typedef struct PCSGHistory PCSGHistory;
 
+/** No RIC filter, every record is listed */
+#define PCSG_HISTORY_FILTER_NONE UINT32_MAX
+
 /** History state add key */
 typedef enum {
     PCSGHistoryStateAddKeyUnknown,
@@ -19,74 +21,106 @@ typedef enum {
 } PCSGHistoryStateAddKey;
 
 /** Allocate PCSGHistory
- * 
- * @return PCSGHistory* 
+ *
+ * Records are kept as packed binary entries: a small tail in RAM, the rest
+ * appended in batches to a file on SD card. Full or previous session file is
+ * kept as history.bin.old.
+ *
+ * @return PCSGHistory*
  */
 PCSGHistory* pcsg_history_alloc(void);
 
-/** Free PCSGHistory
- * 
+/** Free PCSGHistory, pending records are written out
+ *
  * @param instance - PCSGHistory instance
  */
 void pcsg_history_free(PCSGHistory* instance);
 
-/** Clear history
- * 
+/** Clear history and start a new session file
+ *
  * @param instance - PCSGHistory instance
  */
 void pcsg_history_reset(PCSGHistory* instance);
 
+/** Write RAM tail to SD card if it waits there for too long
+ *
+ * @param instance - PCSGHistory instance
+ */
+void pcsg_history_sync(PCSGHistory* instance);
+
 /** Get frequency to history[idx]
- * 
+ *
  * @param instance  - PCSGHistory instance
- * @param idx       - record index  
+ * @param idx       - record index
  * @return frequency - frequency Hz
  */
 uint32_t pcsg_history_get_frequency(PCSGHistory* instance, uint16_t idx);
 
-SubGhzRadioPreset* pcsg_history_get_radio_preset(PCSGHistory* instance, uint16_t idx);
+/** Get RIC to history[idx]
+ *
+ * @param instance  - PCSGHistory instance
+ * @param idx       - record index
+ * @return ric      - receiver identity code
+ */
+uint32_t pcsg_history_get_ric(PCSGHistory* instance, uint16_t idx);
 
-/** Get preset to history[idx]
- * 
+/** Show only records with given RIC, indexes of all other calls follow the filter
+ *
+ * Index is scanned in background, current listing stays until the scan is done.
+ * Removing the filter takes effect right away.
+ *
  * @param instance  - PCSGHistory instance
- * @param idx       - record index  
- * @return preset   - preset name
+ * @param ric       - RIC to keep or PCSG_HISTORY_FILTER_NONE
  */
-const char* pcsg_history_get_preset(PCSGHistory* instance, uint16_t idx);
+void pcsg_history_set_filter(PCSGHistory* instance, uint32_t ric);
 
-/** Get history index write 
- * 
+/** Check whether filter set by pcsg_history_set_filter is still being built
+ *
  * @param instance  - PCSGHistory instance
- * @return idx      - current record index  
+ * @return true while the index scan runs, false once the filter is in effect
+ */
+bool pcsg_history_filter_pending(PCSGHistory* instance);
+
+/** Get active RIC filter
+ *
+ * @param instance  - PCSGHistory instance
+ * @return ric      - RIC or PCSG_HISTORY_FILTER_NONE
+ */
+uint32_t pcsg_history_get_filter(PCSGHistory* instance);
+
+/** Get history index write
+ *
+ * @param instance  - PCSGHistory instance
+ * @return idx      - number of listed records
  */
 uint16_t pcsg_history_get_item(PCSGHistory* instance);
 
 /** Get type protocol to history[idx]
- * 
+ *
  * @param instance  - PCSGHistory instance
- * @param idx       - record index  
- * @return type      - type protocol  
+ * @param idx       - record index
+ * @return type      - type protocol
  */
 uint8_t pcsg_history_get_type_protocol(PCSGHistory* instance, uint16_t idx);
 
 /** Get name protocol to history[idx]
- * 
+ *
  * @param instance  - PCSGHistory instance
- * @param idx       - record index  
- * @return name      - const char* name protocol  
+ * @param idx       - record index
+ * @return name      - const char* name protocol
  */
 const char* pcsg_history_get_protocol_name(PCSGHistory* instance, uint16_t idx);
 
 /** Get string item menu to history[idx]
- * 
+ *
  * @param instance  - PCSGHistory instance
  * @param output    - FuriString* output
  * @param idx       - record index
  */
 void pcsg_history_get_text_item_menu(PCSGHistory* instance, FuriString* output, uint16_t idx);
 
-/** Get string the remaining number of records to history
- * 
+/** Get string the number of records to history
+ *
  * @param instance  - PCSGHistory instance
  * @param output    - FuriString* output
  * @return bool - is FUUL
@@ -94,7 +128,7 @@ void pcsg_history_get_text_item_menu(PCSGHistory* instance, FuriString* output,
 bool pcsg_history_get_text_space_left(PCSGHistory* instance, FuriString* output);
 
 /** Add protocol to history
- * 
+ *
  * @param instance  - PCSGHistory instance
  * @param context    - SubGhzProtocolCommon context
  * @param preset    - SubGhzRadioPreset preset
@@ -103,10 +137,10 @@ bool pcsg_history_get_text_space_left(PCSGHistory* instance, FuriString* output)
 PCSGHistoryStateAddKey
     pcsg_history_add_to_history(PCSGHistory* instance, void* context, SubGhzRadioPreset* preset);
 
-/** Get SubGhzProtocolCommonLoad to load into the protocol decoder bin data
- * 
+/** Get record rebuilt as FlipperFormat, valid until the next call
+ *
  * @param instance  - PCSGHistory instance
  * @param idx       - record index
- * @return SubGhzProtocolCommonLoad*
+ * @return FlipperFormat*
  */
 FlipperFormat* pcsg_history_get_raw_data(PCSGHistory* instance, uint16_t idx);
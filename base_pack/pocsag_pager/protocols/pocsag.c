@@ -1,4 +1,5 @@
 #include "pocsag.h"
+#include "pocsag_bch.h"
 
 #include <inttypes.h>
 #include <lib/flipper_format/flipper_format_i.h>
@@ -6,18 +7,21 @@
 
 #define TAG "POCSAG"
 
+// Logs every corrected codeword, too slow for the decoder callback outside of debugging
+#define POCSAG_DEBUG_BCH 0
+
 static const SubGhzBlockConst pocsag_const = {
     .te_short = 833,
     .te_delta = 100,
 };
 static const SubGhzBlockConst pocsag512_const = {
-    .te_short = 1950,
-    .te_long = 1950,
+    .te_short = 1953,
+    .te_long = 1953,
     .te_delta = 120,
 };
 static const SubGhzBlockConst pocsag2400_const = {
-    .te_short = 410,
-    .te_long = 410,
+    .te_short = 417,
+    .te_long = 417,
     .te_delta = 60,
 };
 
@@ -27,6 +31,9 @@ static const SubGhzBlockConst pocsag2400_const = {
 #define POCSAG_CW_MASK 0xFFFFFFFF
 #define POCSAG_FRAME_SYNC_CODE 0x7CD215D8
 #define POCSAG_IDLE_CODE_WORD 0x7A89C197
+// Bit errors tolerated in frame sync while hunting for it. Preamble and its mix with
+// sync code are at least 11 bits away, so this can't trigger early.
+#define POCSAG_SYNC_MAX_ERRORS 2
 
 #define POCSAG_FUNC_NUM 0
 #define POCSAG_FUNC_ALERT1 1
@@ -36,11 +43,12 @@ static const SubGhzBlockConst pocsag2400_const = {
 static const char* func_msg[] = {"\e#Num:\e# ", "\e#Alert\e#", "\e#Alert:\e# ", "\e#Msg:\e# "};
 static const char* bcd_chars = "*U -)(";
 
-struct SubGhzProtocolDecoderPocsag {
-    SubGhzProtocolDecoderBase base;
+// Bit timing and message state of one baud rate, all rates see every pulse
+typedef struct {
+    const SubGhzBlockConst* timing;
+    uint32_t version;
 
     SubGhzBlockDecoder decoder;
-    PCSGBlockGeneric generic;
 
     uint8_t codeword_idx;
     uint32_t ric;
@@ -53,10 +61,26 @@ struct SubGhzProtocolDecoderPocsag {
     // message being decoded
     FuriString* msg;
 
+    // Done messages of the current transmission
+    FuriString* done_msg;
+    FuriString* result_ric;
+    FuriString* result_msg;
+} PocsagDecoderRate;
+
+#define POCSAG_RATES_COUNT 3
+
+struct SubGhzProtocolDecoderPocsag {
+    SubGhzProtocolDecoderBase base;
+
+    PCSGBlockGeneric generic;
+    PocsagDecoderRate rates[POCSAG_RATES_COUNT];
+
+    uint32_t ric;
+    uint8_t func;
+
     // Done messages, ready to be serialized/deserialized
     FuriString* done_msg;
 
-    SubGhzBlockConst* pocsag_timing;
     uint32_t version;
 };
 
@@ -69,15 +93,29 @@ typedef enum {
     PocsagDecoderStepMessage,
 } PocsagDecoderStep;
 
+static void pocsag_rate_reset(PocsagDecoderRate* rate) {
+    rate->decoder.parser_step = PocsagDecoderStepReset;
+    rate->decoder.decode_data = 0UL;
+    rate->decoder.decode_count_bit = 0;
+    rate->codeword_idx = 0;
+    rate->char_bits = 0;
+    rate->char_data = 0;
+    furi_string_reset(rate->msg);
+    furi_string_reset(rate->done_msg);
+    furi_string_reset(rate->result_msg);
+    furi_string_reset(rate->result_ric);
+}
+
 void* subghz_protocol_decoder_pocsag_alloc(SubGhzEnvironment* environment) {
     UNUSED(environment);
 
+    pocsag_bch_init();
+
     SubGhzProtocolDecoderPocsag* instance = malloc(sizeof(SubGhzProtocolDecoderPocsag));
     instance->base.protocol = &subghz_protocol_pocsag;
     instance->generic.protocol_name = instance->base.protocol->name;
-    instance->msg = furi_string_alloc();
     instance->done_msg = furi_string_alloc();
-    instance->pocsag_timing = NULL; //not synced yet
+    instance->version = 1200;
     if(instance->generic.result_msg == NULL) {
         instance->generic.result_msg = furi_string_alloc();
     }
@@ -85,13 +123,33 @@ void* subghz_protocol_decoder_pocsag_alloc(SubGhzEnvironment* environment) {
         instance->generic.result_ric = furi_string_alloc();
     }
 
+    const SubGhzBlockConst* timings[POCSAG_RATES_COUNT] = {
+        &pocsag512_const, &pocsag_const, &pocsag2400_const};
+    const uint32_t versions[POCSAG_RATES_COUNT] = {512, 1200, 2400};
+    for(size_t i = 0; i < POCSAG_RATES_COUNT; i++) {
+        PocsagDecoderRate* rate = &instance->rates[i];
+        rate->timing = timings[i];
+        rate->version = versions[i];
+        rate->msg = furi_string_alloc();
+        rate->done_msg = furi_string_alloc();
+        rate->result_ric = furi_string_alloc();
+        rate->result_msg = furi_string_alloc();
+        pocsag_rate_reset(rate);
+    }
+
     return instance;
 }
 
 void subghz_protocol_decoder_pocsag_free(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderPocsag* instance = context;
-    furi_string_free(instance->msg);
+    for(size_t i = 0; i < POCSAG_RATES_COUNT; i++) {
+        PocsagDecoderRate* rate = &instance->rates[i];
+        furi_string_free(rate->msg);
+        furi_string_free(rate->done_msg);
+        furi_string_free(rate->result_ric);
+        furi_string_free(rate->result_msg);
+    }
     furi_string_free(instance->done_msg);
     if(instance->generic.result_msg != NULL) {
         furi_string_free(instance->generic.result_msg);
@@ -106,43 +164,39 @@ void subghz_protocol_decoder_pocsag_reset(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderPocsag* instance = context;
 
-    instance->decoder.parser_step = PocsagDecoderStepReset;
-    instance->decoder.decode_data = 0UL;
-    instance->decoder.decode_count_bit = 0;
-    instance->codeword_idx = 0;
-    instance->char_bits = 0;
-    instance->char_data = 0;
-    furi_string_reset(instance->msg);
+    for(size_t i = 0; i < POCSAG_RATES_COUNT; i++) {
+        pocsag_rate_reset(&instance->rates[i]);
+    }
     furi_string_reset(instance->done_msg);
     furi_string_reset(instance->generic.result_msg);
     furi_string_reset(instance->generic.result_ric);
 }
 
-static void pocsag_decode_address_word(SubGhzProtocolDecoderPocsag* instance, uint32_t data) {
-    instance->ric = (data >> 13);
-    instance->ric = (instance->ric << 3) | (instance->codeword_idx >> 1);
-    instance->func = (data >> 11) & 0b11;
+static void pocsag_decode_address_word(PocsagDecoderRate* rate, uint32_t data) {
+    rate->ric = (data >> 13);
+    rate->ric = (rate->ric << 3) | (rate->codeword_idx >> 1);
+    rate->func = (data >> 11) & 0b11;
 }
 
-static bool decode_message_alphanumeric(SubGhzProtocolDecoderPocsag* instance, uint32_t data) {
+static bool decode_message_alphanumeric(PocsagDecoderRate* rate, uint32_t data) {
     for(uint8_t i = 0; i < 20; i++) {
-        instance->char_data >>= 1;
+        rate->char_data >>= 1;
         if(data & (1 << 30)) {
-            instance->char_data |= 1 << 6;
+            rate->char_data |= 1 << 6;
         }
-        instance->char_bits++;
-        if(instance->char_bits == 7) {
-            if(instance->char_data == 0) return false;
-            furi_string_push_back(instance->msg, instance->char_data);
-            instance->char_data = 0;
-            instance->char_bits = 0;
+        rate->char_bits++;
+        if(rate->char_bits == 7) {
+            if(rate->char_data == 0) return false;
+            furi_string_push_back(rate->msg, rate->char_data);
+            rate->char_data = 0;
+            rate->char_bits = 0;
         }
         data <<= 1;
     }
     return true;
 }
 
-static void decode_message_numeric(SubGhzProtocolDecoderPocsag* instance, uint32_t data) {
+static void decode_message_numeric(PocsagDecoderRate* rate, uint32_t data) {
     // 5 groups with 4 bits each
     uint8_t val;
     for(uint8_t i = 0; i < 5; i++) {
@@ -155,186 +209,182 @@ static void decode_message_numeric(SubGhzProtocolDecoderPocsag* instance, uint32
             val += '0';
         else
             val = bcd_chars[val - 10];
-        furi_string_push_back(instance->msg, val);
+        furi_string_push_back(rate->msg, val);
     }
 }
 
-// decode message word, maintaining instance state for partial decoding. Return true if more data
+// decode message word, maintaining rate state for partial decoding. Return true if more data
 // might follow or false if end of message reached.
-static bool pocsag_decode_message_word(SubGhzProtocolDecoderPocsag* instance, uint32_t data) {
-    switch(instance->func) {
+static bool pocsag_decode_message_word(PocsagDecoderRate* rate, uint32_t data) {
+    switch(rate->func) {
     case POCSAG_FUNC_ALERT2:
     case POCSAG_FUNC_ALPHANUM:
-        return decode_message_alphanumeric(instance, data);
+        return decode_message_alphanumeric(rate, data);
 
     case POCSAG_FUNC_NUM:
-        decode_message_numeric(instance, data);
+        decode_message_numeric(rate, data);
         return true;
     }
     return false;
 }
 
+void subghz_protocol_pocsag_format_ric(
+    FuriString* output,
+    uint32_t version,
+    uint32_t ric,
+    uint8_t func) {
+    furi_string_printf(output, "[P%lu]\e#RIC: %" PRIu32 "\e# | ", version, ric);
+    furi_string_cat_str(output, func_msg[func & 0b11]);
+}
+
 // Function called when current message got decoded, but other messages might follow
-static void pocsag_message_done(SubGhzProtocolDecoderPocsag* instance) {
+static void pocsag_message_done(PocsagDecoderRate* rate) {
     // append the message to the long-term storage string
-    furi_string_printf(
-        instance->generic.result_ric,
-        "[P%lu]\e#RIC: %" PRIu32 "\e# | ",
-        instance->version,
-        instance->ric);
-    furi_string_cat_str(instance->generic.result_ric, func_msg[instance->func]);
-    if(instance->func != POCSAG_FUNC_ALERT1) {
-        furi_string_cat(instance->done_msg, instance->msg);
+    subghz_protocol_pocsag_format_ric(rate->result_ric, rate->version, rate->ric, rate->func);
+    if(rate->func != POCSAG_FUNC_ALERT1) {
+        furi_string_cat(rate->done_msg, rate->msg);
     }
 
-    furi_string_cat_str(instance->done_msg, " ");
+    furi_string_cat_str(rate->done_msg, " ");
 
-    furi_string_cat(instance->generic.result_msg, instance->done_msg);
+    furi_string_cat(rate->result_msg, rate->done_msg);
 
     // reset the state
-    instance->char_bits = 0;
-    instance->char_data = 0;
-    furi_string_reset(instance->msg);
+    rate->char_bits = 0;
+    rate->char_data = 0;
+    furi_string_reset(rate->msg);
 }
 
-void subghz_protocol_decoder_pocsag_feed(void* context, bool level, uint32_t duration) {
-    furi_assert(context);
-    SubGhzProtocolDecoderPocsag* instance = context;
+// Transmission at this rate is over, hand its messages out and start hunting again
+static void pocsag_rate_flush(SubGhzProtocolDecoderPocsag* instance, PocsagDecoderRate* rate) {
+    if(furi_string_size(rate->done_msg) > 0) {
+        instance->version = rate->version;
+        instance->ric = rate->ric;
+        instance->func = rate->func;
+        furi_string_set(instance->done_msg, rate->done_msg);
+        furi_string_set(instance->generic.result_ric, rate->result_ric);
+        furi_string_set(instance->generic.result_msg, rate->result_msg);
+        if(instance->base.callback)
+            instance->base.callback(&instance->base, instance->base.context);
+    }
+    pocsag_rate_reset(rate);
+}
 
-    // reset state - waiting for 32 bits of interleaving 1s and 0s
-    if(instance->decoder.parser_step == PocsagDecoderStepReset) {
-        if(DURATION_DIFF(duration, pocsag_const.te_short) < pocsag_const.te_delta) {
-            if(instance->pocsag_timing != &pocsag_const) {
-                //timing changed, so reset before, and override
-                subghz_protocol_decoder_pocsag_reset(context);
-                instance->pocsag_timing = (SubGhzBlockConst*)&pocsag_const;
-                instance->version = 1200;
-            }
-            // POCSAG signals are inverted
-            subghz_protocol_blocks_add_bit(&instance->decoder, !level);
+static void pocsag_rate_codeword(PocsagDecoderRate* rate, uint32_t codeword) {
+    uint8_t errors = pocsag_bch_correct(&codeword);
+#if POCSAG_DEBUG_BCH
+    if(errors == POCSAG_BCH_UNCORRECTABLE) {
+        FURI_LOG_D(TAG, "%lu: uncorrectable codeword %08lX", rate->version, codeword);
+    } else if(errors > 0) {
+        FURI_LOG_D(TAG, "%lu: corrected %u bits", rate->version, errors);
+    }
+#endif
 
-            if(instance->decoder.decode_count_bit == POCSAG_MIN_SYNC_BITS) {
-                instance->decoder.parser_step = PocsagDecoderStepFoundSync;
-            }
-        } else if(DURATION_DIFF(duration, pocsag512_const.te_short) < pocsag512_const.te_delta) {
-            if(instance->pocsag_timing != &pocsag512_const) {
-                //timing changed, so reset before, and override
-                subghz_protocol_decoder_pocsag_reset(context);
-                instance->pocsag_timing = (SubGhzBlockConst*)&pocsag512_const;
-                instance->version = 512;
-            }
-            // POCSAG signals are inverted
-            subghz_protocol_blocks_add_bit(&instance->decoder, !level);
+    if(codeword == POCSAG_FRAME_SYNC_CODE) {
+        rate->codeword_idx = 0;
+        return;
+    }
 
-            if(instance->decoder.decode_count_bit == POCSAG_MIN_SYNC_BITS) {
-                instance->decoder.parser_step = PocsagDecoderStepFoundSync;
-            }
-        } else if(DURATION_DIFF(duration, pocsag2400_const.te_short) < pocsag2400_const.te_delta) {
-            if(instance->pocsag_timing != &pocsag2400_const) {
-                //timing changed, so reset before, and override
-                subghz_protocol_decoder_pocsag_reset(context);
-                instance->pocsag_timing = (SubGhzBlockConst*)&pocsag2400_const;
-                instance->version = 2400;
-            }
+    if(rate->decoder.parser_step == PocsagDecoderStepFoundPreamble) {
+        // Here we expect only address messages, broken one can't be trusted
+        if(codeword != POCSAG_IDLE_CODE_WORD && codeword >> 31 == 0 &&
+           errors != POCSAG_BCH_UNCORRECTABLE) {
+            pocsag_decode_address_word(rate, codeword);
+            rate->decoder.parser_step = PocsagDecoderStepMessage;
+        }
+    } else if(codeword == POCSAG_IDLE_CODE_WORD) {
+        // Idle during the message stops the message
+        rate->decoder.parser_step = PocsagDecoderStepFoundPreamble;
+        pocsag_message_done(rate);
+    } else if(codeword >> 31 == 0) {
+        // In this state, both address and message words can arrive
+        pocsag_message_done(rate);
+        if(errors != POCSAG_BCH_UNCORRECTABLE) {
+            pocsag_decode_address_word(rate, codeword);
+        } else {
+            rate->decoder.parser_step = PocsagDecoderStepFoundPreamble;
+        }
+    } else if(!pocsag_decode_message_word(rate, codeword)) {
+        // Uncorrectable message words are still decoded, a few wrong chars beat a lost page
+        rate->decoder.parser_step = PocsagDecoderStepFoundPreamble;
+        pocsag_message_done(rate);
+    }
+    rate->codeword_idx++;
+}
+
+static void pocsag_rate_feed(
+    SubGhzProtocolDecoderPocsag* instance,
+    PocsagDecoderRate* rate,
+    bool level,
+    uint32_t duration) {
+    const SubGhzBlockConst* timing = rate->timing;
+
+    // reset state - waiting for 24 bits of interleaving 1s and 0s
+    if(rate->decoder.parser_step == PocsagDecoderStepReset) {
+        if(DURATION_DIFF(duration, timing->te_short) < timing->te_delta) {
             // POCSAG signals are inverted
-            subghz_protocol_blocks_add_bit(&instance->decoder, !level);
+            subghz_protocol_blocks_add_bit(&rate->decoder, !level);
 
-            if(instance->decoder.decode_count_bit == POCSAG_MIN_SYNC_BITS) {
-                instance->decoder.parser_step = PocsagDecoderStepFoundSync;
+            if(rate->decoder.decode_count_bit == POCSAG_MIN_SYNC_BITS) {
+                rate->decoder.parser_step = PocsagDecoderStepFoundSync;
             }
-        } else if(instance->decoder.decode_count_bit > 0) {
-            subghz_protocol_decoder_pocsag_reset(context);
+        } else if(rate->decoder.decode_count_bit > 0) {
+            pocsag_rate_reset(rate);
         }
         return;
     }
 
-    int bits_count = duration / instance->pocsag_timing->te_short;
-    uint32_t extra = duration - instance->pocsag_timing->te_short * bits_count;
-
-    if(DURATION_DIFF(extra, instance->pocsag_timing->te_short) < instance->pocsag_timing->te_delta)
-        bits_count++;
-    else if(extra > instance->pocsag_timing->te_delta) {
+    // Round to whole bits, allowed error grows with run length to absorb clock drift.
+    // Runs longer than a codeword mean the carrier is gone.
+    uint32_t bits_count = (duration + timing->te_short / 2) / timing->te_short;
+    uint32_t tolerance = timing->te_delta + timing->te_delta * bits_count / 8;
+    if(bits_count == 0 || bits_count > POCSAG_CW_BITS ||
+       DURATION_DIFF(duration, bits_count * timing->te_short) > tolerance) {
         // in non-reset state we faced the error signal - we reached the end of the packet, flush data
-        if(furi_string_size(instance->done_msg) > 0) {
-            if(instance->base.callback)
-                instance->base.callback(&instance->base, instance->base.context);
-        }
-        subghz_protocol_decoder_pocsag_reset(context);
+        pocsag_rate_flush(instance, rate);
         return;
     }
 
-    uint32_t codeword;
-
     // handle state machine for every incoming bit
     while(bits_count-- > 0) {
-        subghz_protocol_blocks_add_bit(&instance->decoder, !level);
-
-        switch(instance->decoder.parser_step) {
-        case PocsagDecoderStepFoundSync:
-            if((instance->decoder.decode_data & POCSAG_CW_MASK) == POCSAG_FRAME_SYNC_CODE) {
-                instance->decoder.parser_step = PocsagDecoderStepFoundPreamble;
-                instance->decoder.decode_count_bit = 0;
-                instance->decoder.decode_data = 0UL;
+        subghz_protocol_blocks_add_bit(&rate->decoder, !level);
+
+        if(rate->decoder.parser_step == PocsagDecoderStepFoundSync) {
+            uint32_t sync_diff =
+                (uint32_t)(rate->decoder.decode_data & POCSAG_CW_MASK) ^ POCSAG_FRAME_SYNC_CODE;
+            if(__builtin_popcount(sync_diff) <= POCSAG_SYNC_MAX_ERRORS) {
+                rate->decoder.parser_step = PocsagDecoderStepFoundPreamble;
+                rate->decoder.decode_count_bit = 0;
+                rate->decoder.decode_data = 0UL;
             }
-            break;
-        case PocsagDecoderStepFoundPreamble:
-            // handle codewords
-            if(instance->decoder.decode_count_bit == POCSAG_CW_BITS) {
-                codeword = (uint32_t)(instance->decoder.decode_data & POCSAG_CW_MASK);
-                switch(codeword) {
-                case POCSAG_IDLE_CODE_WORD:
-                    instance->codeword_idx++;
-                    break;
-                case POCSAG_FRAME_SYNC_CODE:
-                    instance->codeword_idx = 0;
-                    break;
-                default:
-                    // Here we expect only address messages
-                    if(codeword >> 31 == 0) {
-                        pocsag_decode_address_word(instance, codeword);
-                        instance->decoder.parser_step = PocsagDecoderStepMessage;
-                    }
-                    instance->codeword_idx++;
-                }
-                instance->decoder.decode_count_bit = 0;
-                instance->decoder.decode_data = 0UL;
-            }
-            break;
-
-        case PocsagDecoderStepMessage:
-            if(instance->decoder.decode_count_bit == POCSAG_CW_BITS) {
-                codeword = (uint32_t)(instance->decoder.decode_data & POCSAG_CW_MASK);
-                switch(codeword) {
-                case POCSAG_IDLE_CODE_WORD:
-                    // Idle during the message stops the message
-                    instance->codeword_idx++;
-                    instance->decoder.parser_step = PocsagDecoderStepFoundPreamble;
-                    pocsag_message_done(instance);
-                    break;
-                case POCSAG_FRAME_SYNC_CODE:
-                    instance->codeword_idx = 0;
-                    break;
-                default:
-                    // In this state, both address and message words can arrive
-                    if(codeword >> 31 == 0) {
-                        pocsag_message_done(instance);
-                        pocsag_decode_address_word(instance, codeword);
-                    } else {
-                        if(!pocsag_decode_message_word(instance, codeword)) {
-                            instance->decoder.parser_step = PocsagDecoderStepFoundPreamble;
-                            pocsag_message_done(instance);
-                        }
-                    }
-                    instance->codeword_idx++;
-                }
-                instance->decoder.decode_count_bit = 0;
-                instance->decoder.decode_data = 0UL;
-            }
-            break;
+        } else if(rate->decoder.decode_count_bit == POCSAG_CW_BITS) {
+            pocsag_rate_codeword(rate, (uint32_t)(rate->decoder.decode_data & POCSAG_CW_MASK));
+            rate->decoder.decode_count_bit = 0;
+            rate->decoder.decode_data = 0UL;
         }
     }
 }
 
+void subghz_protocol_decoder_pocsag_feed(void* context, bool level, uint32_t duration) {
+    furi_assert(context);
+    SubGhzProtocolDecoderPocsag* instance = context;
+
+    // Baud rate isn't known upfront, so each rate runs its own state machine on every pulse
+    for(size_t i = 0; i < POCSAG_RATES_COUNT; i++) {
+        pocsag_rate_feed(instance, &instance->rates[i], level, duration);
+    }
+}
+
+void subghz_protocol_decoder_pocsag_get_page(void* context, PocsagPage* page) {
+    furi_assert(context);
+    furi_assert(page);
+    SubGhzProtocolDecoderPocsag* instance = context;
+    page->ric = instance->ric;
+    page->version = instance->version;
+    page->func = instance->func;
+    page->message = instance->done_msg;
+}
+
 uint8_t subghz_protocol_decoder_pocsag_get_hash_data(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderPocsag* instance = context;
@@ -11,3 +11,31 @@
 #define SUBGHZ_PROTOCOL_POCSAG_NAME "POCSAG"
 
 extern const SubGhzProtocol subghz_protocol_pocsag;
+
+/** Plain fields of the last decoded transmission */
+typedef struct {
+    uint32_t ric;
+    uint32_t version;
+    uint8_t func;
+    const FuriString* message;
+} PocsagPage;
+
+/**
+ * Get last decoded transmission without serializing it.
+ * @param context Pointer to a SubGhzProtocolDecoderPocsag instance
+ * @param page Filled with fields, message stays owned by decoder
+ */
+void subghz_protocol_decoder_pocsag_get_page(void* context, PocsagPage* page);
+
+/**
+ * Format RIC header line the way decoder shows it.
+ * @param output Output string
+ * @param version Baud rate
+ * @param ric Receiver identity code
+ * @param func Function bits
+ */
+void subghz_protocol_pocsag_format_ric(
+    FuriString* output,
+    uint32_t version,
+    uint32_t ric,
+    uint8_t func);
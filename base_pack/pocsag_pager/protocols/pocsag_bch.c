@@ -0,0 +1,82 @@
+#include "pocsag_bch.h"
+
+// x^10 + x^9 + x^8 + x^6 + x^5 + x^3 + 1
+#define POCSAG_BCH_POLY 0x769
+#define POCSAG_BCH_CHECK_BITS 10
+#define POCSAG_BCH_CODE_BITS 31
+
+// Syndrome -> positions of up to two flipped bits in the 31 bit code, stored as
+// (pos + 1) in bits 4..0 and 9..5, 0 means syndrome is not correctable.
+// All 31 single and 465 double error syndromes are distinct, so one slot is enough.
+static uint16_t pocsag_bch_table[1 << POCSAG_BCH_CHECK_BITS];
+static bool pocsag_bch_ready = false;
+
+static uint32_t pocsag_bch_syndrome(uint32_t code) {
+    for(int8_t bit = POCSAG_BCH_CODE_BITS - 1; bit >= POCSAG_BCH_CHECK_BITS; bit--) {
+        if(code & (1UL << bit)) {
+            code ^= (uint32_t)POCSAG_BCH_POLY << (bit - POCSAG_BCH_CHECK_BITS);
+        }
+    }
+    return code;
+}
+
+static uint8_t pocsag_bch_parity(uint32_t value) {
+    value ^= value >> 16;
+    value ^= value >> 8;
+    value ^= value >> 4;
+    value ^= value >> 2;
+    value ^= value >> 1;
+    return value & 1;
+}
+
+void pocsag_bch_init(void) {
+    if(pocsag_bch_ready) return;
+
+    uint16_t single[POCSAG_BCH_CODE_BITS];
+    for(uint8_t i = 0; i < POCSAG_BCH_CODE_BITS; i++) {
+        single[i] = pocsag_bch_syndrome(1UL << i);
+        pocsag_bch_table[single[i]] = i + 1;
+    }
+    for(uint8_t i = 0; i < POCSAG_BCH_CODE_BITS; i++) {
+        for(uint8_t j = i + 1; j < POCSAG_BCH_CODE_BITS; j++) {
+            pocsag_bch_table[single[i] ^ single[j]] = (i + 1) | ((j + 1) << 5);
+        }
+    }
+    pocsag_bch_ready = true;
+}
+
+uint8_t pocsag_bch_correct(uint32_t* codeword) {
+    uint32_t code = *codeword >> 1;
+    uint8_t parity_bad = pocsag_bch_parity(*codeword);
+    uint32_t syndrome = pocsag_bch_syndrome(code);
+
+    if(syndrome == 0) {
+        // Only the parity bit itself might be flipped
+        *codeword ^= parity_bad;
+        return parity_bad;
+    }
+
+    uint16_t entry = pocsag_bch_table[syndrome];
+    if(entry == 0) return POCSAG_BCH_UNCORRECTABLE;
+
+    uint8_t errors = 0;
+    uint8_t pos1 = entry & 0x1F;
+    uint8_t pos2 = (entry >> 5) & 0x1F;
+    code ^= 1UL << (pos1 - 1);
+    errors++;
+    if(pos2) {
+        code ^= 1UL << (pos2 - 1);
+        errors++;
+    }
+
+    // Odd number of flips in BCH part changes parity, anything left is the parity bit
+    uint32_t fixed = (code << 1) | (*codeword & 1);
+    if(pocsag_bch_parity(fixed)) {
+        if(errors == 2) return POCSAG_BCH_UNCORRECTABLE;
+        fixed ^= 1;
+        errors++;
+    }
+
+    *codeword = fixed;
+    return errors;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POCSAG_BCH_UNCORRECTABLE 0xFF
+
+/**
+ * Build syndrome table, cheap to call more than once.
+ */
+void pocsag_bch_init(void);
+
+/**
+ * Correct POCSAG codeword: BCH(31,21) over bits 31..1 and even parity in bit 0.
+ * @param codeword Codeword, fixed in place
+ * @return Number of flipped bits (0..2) or POCSAG_BCH_UNCORRECTABLE
+ */
+uint8_t pocsag_bch_correct(uint32_t* codeword);
+
+#ifdef __cplusplus
+}
+#endif
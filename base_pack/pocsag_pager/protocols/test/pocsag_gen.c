@@ -0,0 +1,222 @@
+// Writes the pulse files in pulses/ that pocsag_test replays. They are committed, so the
+// decoder is checked against fixed captures, run `make pulses` only to add new ones.
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define POCSAG_PREAMBLE_BITS 576
+#define POCSAG_FRAME_SYNC_CODE 0x7CD215D8
+#define POCSAG_IDLE_CODE_WORD 0x7A89C197
+#define POCSAG_BCH_POLY 0x769
+#define POCSAG_BATCH_WORDS 16
+
+#define GEN_MAX_WORDS 256
+#define GEN_MAX_ERRORS 8
+#define GEN_RAW_PER_LINE 512
+
+typedef struct {
+    uint8_t word; // 0 is the address word, then message words
+    uint32_t mask; // Bits to flip
+} GenError;
+
+typedef struct {
+    const char* file;
+    uint32_t baud;
+    uint32_t ric;
+    uint8_t func;
+    const char* message;
+    GenError errors[GEN_MAX_ERRORS];
+} GenPage;
+
+static const GenPage pages[] = {
+    {"pocsag512_numeric.sub", 512, 1234567, 0, "0123456789-12", {{0}}},
+    {"pocsag1200_alpha.sub", 1200, 2000000, 3, "Hello, DAPNET! 73 de Flipper", {{0}}},
+    {"pocsag2400_alpha.sub", 2400, 8, 3, "Short", {{0}}},
+    {"pocsag1200_bch.sub",
+     1200,
+     424242,
+     3,
+     "Weak signal, still readable",
+     {{0, 1u << 20}, {1, 1u << 3}, {2, (1u << 30) | (1u << 7)}, {4, 1u << 0}, {5, 3u << 14}}},
+    {"pocsag2400_bch.sub",
+     2400,
+     77,
+     3,
+     "Two bit errors",
+     {{0, (1u << 25) | (1u << 12)}, {1, 1u << 31}, {3, (1u << 1) | (1u << 0)}}},
+    {"pocsag512_bch.sub", 512, 99999, 0, "911", {{0, 1u << 5}, {1, (1u << 28) | (1u << 11)}}},
+};
+
+static uint8_t gen_parity(uint32_t value) {
+    uint8_t parity = 0;
+    for(; value; value >>= 1)
+        parity ^= value & 1;
+    return parity;
+}
+
+// 21 data bits in, full codeword with BCH(31,21) and even parity out
+static uint32_t gen_codeword(uint32_t data) {
+    uint32_t code = data << 10;
+    for(int bit = 30; bit >= 10; bit--) {
+        if(code & (1u << bit)) code ^= (uint32_t)POCSAG_BCH_POLY << (bit - 10);
+    }
+    uint32_t word = ((data << 10) | code) << 1;
+    return word | gen_parity(word);
+}
+
+static size_t gen_message_words(const GenPage* page, uint32_t* words) {
+    size_t count = 0;
+    uint32_t data = 0;
+    uint8_t bits = 0;
+
+    if(page->func == 0) {
+        // Numeric: 4 bit BCD, LSB first, padded with spaces
+        const char* bcd = "0123456789*U -)(";
+        size_t len = strlen(page->message);
+        size_t digits = (len + 4) / 5 * 5;
+        for(size_t i = 0; i < digits; i++) {
+            char c = i < len ? page->message[i] : ' ';
+            uint8_t value = strchr(bcd, c) - bcd;
+            for(uint8_t b = 0; b < 4; b++) {
+                data = (data << 1) | ((value >> b) & 1);
+                if(++bits == 20) {
+                    words[count++] = gen_codeword((1u << 20) | data);
+                    data = 0;
+                    bits = 0;
+                }
+            }
+        }
+        return count;
+    }
+
+    // Alphanumeric: 7 bit ASCII, LSB first, last word padded with zeros
+    for(const char* c = page->message; *c; c++) {
+        for(uint8_t b = 0; b < 7; b++) {
+            data = (data << 1) | ((*c >> b) & 1);
+            if(++bits == 20) {
+                words[count++] = gen_codeword((1u << 20) | data);
+                data = 0;
+                bits = 0;
+            }
+        }
+    }
+    if(bits > 0) words[count++] = gen_codeword((1u << 20) | (data << (20 - bits)));
+    return count;
+}
+
+typedef struct {
+    FILE* file;
+    double te;
+    double clock;
+    bool level;
+    double run;
+    size_t on_line;
+    uint32_t seed;
+} GenWriter;
+
+static void gen_emit(GenWriter* writer, bool level, uint32_t duration) {
+    if(writer->on_line == GEN_RAW_PER_LINE) {
+        fprintf(writer->file, "\n");
+        writer->on_line = 0;
+    }
+    if(writer->on_line == 0) fprintf(writer->file, "RAW_Data:");
+    fprintf(writer->file, " %s%u", level ? "" : "-", duration);
+    writer->on_line++;
+}
+
+static int32_t gen_jitter(GenWriter* writer, int32_t range) {
+    writer->seed = writer->seed * 1103515245 + 12345;
+    return (int32_t)((writer->seed >> 16) % (2 * range + 1)) - range;
+}
+
+static void gen_flush_run(GenWriter* writer) {
+    if(writer->run == 0) return;
+    // Radio edges land a little off the bit clock
+    int32_t jitter = gen_jitter(writer, (int32_t)(writer->te / 40));
+    gen_emit(writer, writer->level, (uint32_t)(writer->run + jitter));
+    writer->run = 0;
+}
+
+// POCSAG is sent inverted, a one is the low level
+static void gen_bit(GenWriter* writer, bool bit) {
+    bool level = !bit;
+    if(writer->run > 0 && level != writer->level) gen_flush_run(writer);
+    writer->level = level;
+    writer->run += writer->te * writer->clock;
+}
+
+static void gen_word(GenWriter* writer, uint32_t word) {
+    for(int8_t bit = 31; bit >= 0; bit--)
+        gen_bit(writer, (word >> bit) & 1);
+}
+
+static bool gen_page(const GenPage* page, const char* dir) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", dir, page->file);
+    FILE* file = fopen(path, "w");
+    if(!file) {
+        perror(path);
+        return false;
+    }
+
+    fprintf(file, "Filetype: Flipper SubGhz RAW File\n");
+    fprintf(file, "Version: 1\n");
+    fprintf(file, "Frequency: 439987500\n");
+    fprintf(file, "Preset: FuriHalSubGhzPreset2FSKDev476Async\n");
+    fprintf(file, "Protocol: RAW\n");
+
+    // Address, then message words, then idle to the end of the batch
+    uint32_t words[GEN_MAX_WORDS];
+    size_t count = 0;
+    uint8_t frame = page->ric & 7;
+    for(uint8_t i = 0; i < frame * 2; i++)
+        words[count++] = POCSAG_IDLE_CODE_WORD;
+    size_t address = count;
+    words[count++] = gen_codeword(((page->ric >> 3) << 2) | page->func);
+    count += gen_message_words(page, &words[count]);
+    do {
+        words[count++] = POCSAG_IDLE_CODE_WORD;
+    } while(count % POCSAG_BATCH_WORDS);
+
+    for(size_t i = 0; i < GEN_MAX_ERRORS && page->errors[i].mask; i++) {
+        words[address + page->errors[i].word] ^= page->errors[i].mask;
+    }
+
+    GenWriter writer = {
+        .file = file,
+        .te = 1000000.0 / page->baud,
+        // Pager transmitters are never exactly on rate
+        .clock = 1.004,
+        .seed = page->baud ^ page->ric,
+    };
+
+    // Noise before the carrier
+    gen_emit(&writer, true, 150);
+    gen_emit(&writer, false, 3200);
+    for(uint16_t i = 0; i < POCSAG_PREAMBLE_BITS; i++)
+        gen_bit(&writer, !(i & 1));
+    for(size_t i = 0; i < count; i++) {
+        if(i % POCSAG_BATCH_WORDS == 0) gen_word(&writer, POCSAG_FRAME_SYNC_CODE);
+        gen_word(&writer, words[i]);
+    }
+    gen_flush_run(&writer);
+    // Carrier gone
+    gen_emit(&writer, !writer.level, 25000);
+    gen_emit(&writer, writer.level, 90);
+    gen_emit(&writer, !writer.level, 12000);
+    fprintf(file, "\n");
+
+    fclose(file);
+    printf("%s: %zu codewords\n", path, count);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* dir = argc > 1 ? argv[1] : "pulses";
+    for(size_t i = 0; i < sizeof(pages) / sizeof(pages[0]); i++) {
+        if(!gen_page(&pages[i], dir)) return 1;
+    }
+    return 0;
+}
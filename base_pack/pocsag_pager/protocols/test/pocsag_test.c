@@ -0,0 +1,177 @@
+// Replays Flipper RAW captures through the POCSAG decoder and checks the decoded pages
+#include <furi.h>
+#include <subghz.h>
+
+#include "../pocsag.h"
+#include "../pocsag_bch.h"
+
+void* subghz_protocol_decoder_pocsag_alloc(SubGhzEnvironment* environment);
+void subghz_protocol_decoder_pocsag_free(void* context);
+void subghz_protocol_decoder_pocsag_feed(void* context, bool level, uint32_t duration);
+
+#define TEST_MAX_PAGES 4
+#define TEST_MAX_MESSAGE 256
+
+typedef struct {
+    uint32_t version;
+    uint32_t ric;
+    uint8_t func;
+    const char* message;
+} TestPage;
+
+typedef struct {
+    const char* file;
+    TestPage pages[TEST_MAX_PAGES];
+} TestCapture;
+
+// Every message ends with the separator the decoder puts between pages
+static const TestCapture captures[] = {
+    {"pocsag512_numeric.sub", {{512, 1234567, 0, "0123456789-12   "}}},
+    {"pocsag1200_alpha.sub", {{1200, 2000000, 3, "Hello, DAPNET! 73 de Flipper "}}},
+    {"pocsag2400_alpha.sub", {{2400, 8, 3, "Short "}}},
+    {"pocsag1200_bch.sub", {{1200, 424242, 3, "Weak signal, still readable "}}},
+    {"pocsag2400_bch.sub", {{2400, 77, 3, "Two bit errors "}}},
+    {"pocsag512_bch.sub", {{512, 99999, 0, "911   "}}},
+};
+
+typedef struct {
+    size_t count;
+    uint32_t version[TEST_MAX_PAGES];
+    uint32_t ric[TEST_MAX_PAGES];
+    uint8_t func[TEST_MAX_PAGES];
+    char message[TEST_MAX_PAGES][TEST_MAX_MESSAGE];
+} TestResult;
+
+static void test_rx_callback(SubGhzProtocolDecoderBase* decoder, void* context) {
+    TestResult* result = context;
+    PocsagPage page;
+    subghz_protocol_decoder_pocsag_get_page(decoder, &page);
+    if(result->count < TEST_MAX_PAGES) {
+        result->version[result->count] = page.version;
+        result->ric[result->count] = page.ric;
+        result->func[result->count] = page.func;
+        snprintf(
+            result->message[result->count],
+            TEST_MAX_MESSAGE,
+            "%s",
+            furi_string_get_cstr(page.message));
+    }
+    result->count++;
+}
+
+// Feeds every RAW_Data value, positive is high level, returns number of pulses
+static size_t test_replay(const char* path, void* decoder) {
+    FILE* file = fopen(path, "r");
+    if(!file) {
+        perror(path);
+        return 0;
+    }
+
+    size_t pulses = 0;
+    char token[32];
+    bool raw = false;
+    while(fscanf(file, "%31s", token) == 1) {
+        if(strchr(token, ':')) {
+            raw = strcmp(token, "RAW_Data:") == 0;
+            continue;
+        }
+        if(!raw) continue;
+        long value = strtol(token, NULL, 10);
+        subghz_protocol_decoder_pocsag_feed(decoder, value > 0, value > 0 ? value : -value);
+        pulses++;
+    }
+
+    fclose(file);
+    return pulses;
+}
+
+static bool test_capture(const TestCapture* capture, const char* dir) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", dir, capture->file);
+
+    TestResult result = {0};
+    void* decoder = subghz_protocol_decoder_pocsag_alloc(NULL);
+    SubGhzProtocolDecoderBase* base = decoder;
+    base->callback = test_rx_callback;
+    base->context = &result;
+
+    size_t pulses = test_replay(path, decoder);
+    subghz_protocol_decoder_pocsag_free(decoder);
+
+    size_t expected = 0;
+    while(expected < TEST_MAX_PAGES && capture->pages[expected].message)
+        expected++;
+
+    bool ok = pulses > 0 && result.count == expected;
+    for(size_t i = 0; ok && i < expected; i++) {
+        const TestPage* page = &capture->pages[i];
+        ok = result.version[i] == page->version && result.ric[i] == page->ric &&
+             result.func[i] == page->func && strcmp(result.message[i], page->message) == 0;
+    }
+
+    printf(
+        "%-24s %6zu pulses, %zu pages  %s\n",
+        capture->file,
+        pulses,
+        result.count,
+        ok ? "ok" : "FAIL");
+    if(!ok) {
+        for(size_t i = 0; i < result.count && i < TEST_MAX_PAGES; i++) {
+            printf(
+                "  got P%u RIC %u func %u \"%s\"\n",
+                (unsigned)result.version[i],
+                (unsigned)result.ric[i],
+                result.func[i],
+                result.message[i]);
+        }
+    }
+    return ok;
+}
+
+// Every single and double error in a codeword has to be fixed, triple errors must not pass
+static bool test_bch(void) {
+    const uint32_t codewords[] = {0x7CD215D8, 0x7A89C197, 0x00000000};
+    bool ok = true;
+    size_t checked = 0;
+
+    pocsag_bch_init();
+    for(size_t c = 0; c < sizeof(codewords) / sizeof(codewords[0]); c++) {
+        uint32_t good = codewords[c];
+        uint32_t fixed = good;
+        if(pocsag_bch_correct(&fixed) != 0 || fixed != good) {
+            printf("  %08X is not a valid codeword\n", (unsigned)good);
+            ok = false;
+            continue;
+        }
+        for(uint8_t i = 0; i < 32; i++) {
+            for(uint8_t j = i; j < 32; j++) {
+                uint32_t broken = good ^ (1u << i) ^ (i == j ? 0 : 1u << j);
+                uint8_t errors = pocsag_bch_correct(&broken);
+                if(broken != good || errors != (i == j ? 1 : 2)) {
+                    printf("  %08X bits %u,%u: %u errors\n", (unsigned)good, i, j, errors);
+                    ok = false;
+                }
+                checked++;
+            }
+        }
+        // Three flips in the BCH part, even parity can't miss those
+        uint32_t broken = good ^ 0x70000000;
+        if(pocsag_bch_correct(&broken) != POCSAG_BCH_UNCORRECTABLE) {
+            printf("  %08X: three bit error accepted\n", (unsigned)good);
+            ok = false;
+        }
+    }
+
+    printf("%-24s %6zu patterns            %s\n", "bch", checked, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    const char* dir = argc > 1 ? argv[1] : "pulses";
+    bool ok = test_bch();
+    for(size_t i = 0; i < sizeof(captures) / sizeof(captures[0]); i++) {
+        ok &= test_capture(&captures[i], dir);
+    }
+    printf(ok ? "All passed\n" : "Failed\n");
+    return ok ? 0 : 1;
+}
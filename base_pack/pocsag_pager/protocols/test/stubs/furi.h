@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Furi malloc hands out zeroed memory and the decoder relies on that
+#define malloc(size) calloc(1, size)
+
+#define UNUSED(x) (void)(x)
+#define furi_assert(x) \
+    ((x) ? (void)0 : (fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #x), abort()))
+#define FURI_LOG_E(tag, ...)
+#define FURI_LOG_D(tag, ...)
+
+typedef struct FuriString FuriString;
+
+FuriString* furi_string_alloc(void);
+void furi_string_free(FuriString* string);
+void furi_string_reset(FuriString* string);
+void furi_string_set(FuriString* string, const FuriString* source);
+void furi_string_set_str(FuriString* string, const char* source);
+void furi_string_set_strn(FuriString* string, const char* source, size_t length);
+size_t furi_string_size(const FuriString* string);
+char furi_string_get_char(const FuriString* string, size_t index);
+const char* furi_string_get_cstr(const FuriString* string);
+void furi_string_push_back(FuriString* string, char c);
+void furi_string_cat(FuriString* string, const FuriString* source);
+void furi_string_cat_str(FuriString* string, const char* source);
+int furi_string_printf(FuriString* string, const char* format, ...);
+int furi_string_cat_printf(FuriString* string, const char* format, ...);
@@ -0,0 +1,152 @@
+#include <furi.h>
+#include <subghz.h>
+
+#include "../../pcsg_generic.h"
+
+struct FuriString {
+    char* data;
+    size_t size;
+    size_t capacity;
+};
+
+static void furi_string_reserve(FuriString* string, size_t size) {
+    if(size + 1 <= string->capacity) return;
+    while(string->capacity < size + 1)
+        string->capacity *= 2;
+    string->data = realloc(string->data, string->capacity);
+}
+
+FuriString* furi_string_alloc(void) {
+    FuriString* string = malloc(sizeof(FuriString));
+    string->capacity = 16;
+    string->data = malloc(string->capacity);
+    furi_string_reset(string);
+    return string;
+}
+
+void furi_string_free(FuriString* string) {
+    free(string->data);
+    free(string);
+}
+
+void furi_string_reset(FuriString* string) {
+    string->size = 0;
+    string->data[0] = '\0';
+}
+
+void furi_string_set_strn(FuriString* string, const char* source, size_t length) {
+    furi_string_reserve(string, length);
+    memmove(string->data, source, length);
+    string->size = length;
+    string->data[length] = '\0';
+}
+
+void furi_string_set(FuriString* string, const FuriString* source) {
+    furi_string_set_strn(string, source->data, source->size);
+}
+
+void furi_string_set_str(FuriString* string, const char* source) {
+    furi_string_set_strn(string, source, strlen(source));
+}
+
+size_t furi_string_size(const FuriString* string) {
+    return string->size;
+}
+
+char furi_string_get_char(const FuriString* string, size_t index) {
+    furi_assert(index < string->size);
+    return string->data[index];
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->data;
+}
+
+void furi_string_push_back(FuriString* string, char c) {
+    furi_string_reserve(string, string->size + 1);
+    string->data[string->size++] = c;
+    string->data[string->size] = '\0';
+}
+
+void furi_string_cat_str(FuriString* string, const char* source) {
+    size_t length = strlen(source);
+    furi_string_reserve(string, string->size + length);
+    memcpy(&string->data[string->size], source, length + 1);
+    string->size += length;
+}
+
+void furi_string_cat(FuriString* string, const FuriString* source) {
+    furi_string_cat_str(string, source->data);
+}
+
+static int furi_string_vcat_printf(FuriString* string, const char* format, va_list args) {
+    va_list copy;
+    va_copy(copy, args);
+    int length = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+    if(length < 0) return length;
+    furi_string_reserve(string, string->size + length);
+    vsnprintf(&string->data[string->size], length + 1, format, args);
+    string->size += length;
+    return length;
+}
+
+int furi_string_printf(FuriString* string, const char* format, ...) {
+    furi_string_reset(string);
+    va_list args;
+    va_start(args, format);
+    int length = furi_string_vcat_printf(string, format, args);
+    va_end(args);
+    return length;
+}
+
+int furi_string_cat_printf(FuriString* string, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int length = furi_string_vcat_printf(string, format, args);
+    va_end(args);
+    return length;
+}
+
+// Saving pages isn't covered by the replay test
+bool flipper_format_write_uint32(
+    FlipperFormat* ff,
+    const char* key,
+    const uint32_t* data,
+    uint16_t n) {
+    UNUSED(ff), UNUSED(key), UNUSED(data), UNUSED(n);
+    return false;
+}
+
+bool flipper_format_read_uint32(FlipperFormat* ff, const char* key, uint32_t* data, uint16_t n) {
+    UNUSED(ff), UNUSED(key), UNUSED(data), UNUSED(n);
+    return false;
+}
+
+bool flipper_format_write_hex(
+    FlipperFormat* ff,
+    const char* key,
+    const uint8_t* data,
+    uint16_t n) {
+    UNUSED(ff), UNUSED(key), UNUSED(data), UNUSED(n);
+    return false;
+}
+
+bool flipper_format_read_hex(FlipperFormat* ff, const char* key, uint8_t* data, uint16_t n) {
+    UNUSED(ff), UNUSED(key), UNUSED(data), UNUSED(n);
+    return false;
+}
+
+SubGhzProtocolStatus pcsg_block_generic_serialize(
+    PCSGBlockGeneric* instance,
+    FlipperFormat* flipper_format,
+    SubGhzRadioPreset* preset) {
+    UNUSED(instance), UNUSED(flipper_format), UNUSED(preset);
+    return SubGhzProtocolStatusError;
+}
+
+SubGhzProtocolStatus
+    pcsg_block_generic_deserialize(PCSGBlockGeneric* instance, FlipperFormat* flipper_format) {
+    UNUSED(instance), UNUSED(flipper_format);
+    return SubGhzProtocolStatusError;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "furi.h"
+
+#define DURATION_DIFF(x, y) (((x) < (y)) ? ((y) - (x)) : ((x) - (y)))
+
+typedef struct FlipperFormat FlipperFormat;
+typedef struct SubGhzEnvironment SubGhzEnvironment;
+typedef struct SubGhzRadioPreset SubGhzRadioPreset;
+
+typedef enum {
+    SubGhzProtocolStatusOk = 0,
+    SubGhzProtocolStatusError = -1,
+} SubGhzProtocolStatus;
+
+typedef enum {
+    SubGhzProtocolTypeStatic,
+} SubGhzProtocolType;
+
+typedef enum {
+    SubGhzProtocolFlag_FM = (1 << 3),
+    SubGhzProtocolFlag_Decodable = (1 << 4),
+    SubGhzProtocolFlag_Save = (1 << 7),
+    SubGhzProtocolFlag_Load = (1 << 8),
+} SubGhzProtocolFlag;
+
+typedef struct {
+    const uint16_t te_long;
+    const uint16_t te_short;
+    const uint16_t te_delta;
+    const uint8_t min_count_bit_for_found;
+} SubGhzBlockConst;
+
+typedef struct {
+    uint32_t parser_step;
+    uint32_t te_last;
+    uint64_t decode_data;
+    uint8_t decode_count_bit;
+} SubGhzBlockDecoder;
+
+static inline void subghz_protocol_blocks_add_bit(SubGhzBlockDecoder* decoder, uint8_t bit) {
+    decoder->decode_data = decoder->decode_data << 1 | bit;
+    decoder->decode_count_bit++;
+}
+
+typedef struct SubGhzProtocol SubGhzProtocol;
+typedef struct SubGhzProtocolDecoderBase SubGhzProtocolDecoderBase;
+
+typedef void (
+    *SubGhzProtocolDecoderBaseRxCallback)(SubGhzProtocolDecoderBase* instance, void* context);
+
+struct SubGhzProtocolDecoderBase {
+    const SubGhzProtocol* protocol;
+    SubGhzProtocolDecoderBaseRxCallback callback;
+    void* context;
+};
+
+typedef struct {
+    void* (*alloc)(SubGhzEnvironment* environment);
+    void (*free)(void* decoder);
+    void (*feed)(void* decoder, bool level, uint32_t duration);
+    void (*reset)(void* decoder);
+    uint8_t (*get_hash_data)(void* decoder);
+    void (*get_string)(void* decoder, FuriString* output);
+    SubGhzProtocolStatus (*serialize)(
+        void* decoder,
+        FlipperFormat* flipper_format,
+        SubGhzRadioPreset* preset);
+    SubGhzProtocolStatus (*deserialize)(void* decoder, FlipperFormat* flipper_format);
+} SubGhzProtocolDecoder;
+
+typedef struct {
+    void* alloc;
+    void* free;
+    void* deserialize;
+    void* stop;
+    void* yield;
+} SubGhzProtocolEncoder;
+
+struct SubGhzProtocol {
+    const char* name;
+    SubGhzProtocolType type;
+    SubGhzProtocolFlag flag;
+    const SubGhzProtocolEncoder* encoder;
+    const SubGhzProtocolDecoder* decoder;
+};
+
+bool flipper_format_write_uint32(
+    FlipperFormat* ff,
+    const char* key,
+    const uint32_t* data,
+    uint16_t n);
+bool flipper_format_read_uint32(FlipperFormat* ff, const char* key, uint32_t* data, uint16_t n);
+bool flipper_format_write_hex(FlipperFormat* ff, const char* key, const uint8_t* data, uint16_t n);
+bool flipper_format_read_hex(FlipperFormat* ff, const char* key, uint8_t* data, uint16_t n);
@@ -59,32 +59,42 @@ static void pocsag_pager_scene_receiver_update_statusbar(void* context) {
     furi_string_free(history_stat_str);
 }
 
+// Scene state is true while the history scans its index for a new RIC filter
+static void pocsag_pager_scene_receiver_apply_filter(POCSAGPagerApp* app) {
+    pcsg_view_receiver_set_item_count(
+        app->pcsg_receiver, pcsg_history_get_item(app->txrx->history));
+    pcsg_view_receiver_set_idx_menu(app->pcsg_receiver, 0);
+    pocsag_pager_scene_receiver_update_statusbar(app);
+}
+
 void pocsag_pager_scene_receiver_callback(PCSGCustomEvent event, void* context) {
     furi_assert(context);
     POCSAGPagerApp* app = context;
     view_dispatcher_send_custom_event(app->view_dispatcher, event);
 }
 
+static void pocsag_pager_scene_receiver_item_callback(
+    FuriString* item_str,
+    uint8_t* type,
+    uint16_t idx,
+    void* context) {
+    furi_assert(context);
+    POCSAGPagerApp* app = context;
+    pcsg_history_get_text_item_menu(app->txrx->history, item_str, idx);
+    *type = pcsg_history_get_type_protocol(app->txrx->history, idx);
+}
+
 static void pocsag_pager_scene_receiver_add_to_history_callback(
     SubGhzReceiver* receiver,
     SubGhzProtocolDecoderBase* decoder_base,
     void* context) {
     furi_assert(context);
     POCSAGPagerApp* app = context;
-    FuriString* str_buff;
-    str_buff = furi_string_alloc();
 
     if(pcsg_history_add_to_history(app->txrx->history, decoder_base, app->txrx->preset) ==
        PCSGHistoryStateAddKeyNewDada) {
-        furi_string_reset(str_buff);
-
-        pcsg_history_get_text_item_menu(
-            app->txrx->history, str_buff, pcsg_history_get_item(app->txrx->history) - 1);
-        pcsg_view_receiver_add_item_to_menu(
-            app->pcsg_receiver,
-            furi_string_get_cstr(str_buff),
-            pcsg_history_get_type_protocol(
-                app->txrx->history, pcsg_history_get_item(app->txrx->history) - 1));
+        pcsg_view_receiver_set_item_count(
+            app->pcsg_receiver, pcsg_history_get_item(app->txrx->history));
 
         pocsag_pager_scene_receiver_update_statusbar(app);
         notification_message(app->notifications, &sequence_blink_green_10);
@@ -95,19 +105,16 @@ static void pocsag_pager_scene_receiver_add_to_history_callback(
         }
     }
     subghz_receiver_reset(receiver);
-    furi_string_free(str_buff);
     app->txrx->rx_key_state = PCSGRxKeyStateAddKey;
 }
 
 void pocsag_pager_scene_receiver_on_enter(void* context) {
     POCSAGPagerApp* app = context;
 
-    FuriString* str_buff;
-    str_buff = furi_string_alloc();
-
     if(app->txrx->rx_key_state == PCSGRxKeyStateIDLE) {
         pcsg_preset_init(app, "FM95", 439987500, NULL, 0);
         pcsg_history_reset(app->txrx->history);
+        scene_manager_set_scene_state(app->scene_manager, POCSAGPagerSceneReceiver, false);
         app->txrx->rx_key_state = PCSGRxKeyStateStart;
     }
 
@@ -115,18 +122,15 @@ void pocsag_pager_scene_receiver_on_enter(void* context) {
     pcsg_view_receiver_set_ext_module_state(
         app->pcsg_receiver, radio_device_loader_is_external(app->txrx->radio_device));
 
-    //Load history to receiver
+    //Load history to receiver, items are read on demand
     pcsg_view_receiver_exit(app->pcsg_receiver);
-    for(uint8_t i = 0; i < pcsg_history_get_item(app->txrx->history); i++) {
-        furi_string_reset(str_buff);
-        pcsg_history_get_text_item_menu(app->txrx->history, str_buff, i);
-        pcsg_view_receiver_add_item_to_menu(
-            app->pcsg_receiver,
-            furi_string_get_cstr(str_buff),
-            pcsg_history_get_type_protocol(app->txrx->history, i));
+    pcsg_view_receiver_set_item_callback(
+        app->pcsg_receiver, pocsag_pager_scene_receiver_item_callback, app);
+    pcsg_view_receiver_set_item_count(
+        app->pcsg_receiver, pcsg_history_get_item(app->txrx->history));
+    if(pcsg_history_get_item(app->txrx->history)) {
         app->txrx->rx_key_state = PCSGRxKeyStateAddKey;
     }
-    furi_string_free(str_buff);
     pocsag_pager_scene_receiver_update_statusbar(app);
 
     pcsg_view_receiver_set_callback(app->pcsg_receiver, pocsag_pager_scene_receiver_callback, app);
@@ -182,6 +186,24 @@ bool pocsag_pager_scene_receiver_on_event(void* context, SceneManagerEvent event
             scene_manager_next_scene(app->scene_manager, POCSAGPagerSceneReceiverConfig);
             consumed = true;
             break;
+        case PCSGCustomEventViewReceiverFilter: {
+            // Right toggles listing only pages for the RIC under cursor
+            uint32_t ric = PCSG_HISTORY_FILTER_NONE;
+            if(pcsg_history_get_filter(app->txrx->history) == PCSG_HISTORY_FILTER_NONE) {
+                ric = pcsg_history_get_ric(
+                    app->txrx->history, pcsg_view_receiver_get_idx_menu(app->pcsg_receiver));
+            }
+            pcsg_history_set_filter(app->txrx->history, ric);
+            if(pcsg_history_filter_pending(app->txrx->history)) {
+                scene_manager_set_scene_state(app->scene_manager, POCSAGPagerSceneReceiver, true);
+                pocsag_pager_scene_receiver_update_statusbar(app);
+            } else {
+                scene_manager_set_scene_state(app->scene_manager, POCSAGPagerSceneReceiver, false);
+                pocsag_pager_scene_receiver_apply_filter(app);
+            }
+            consumed = true;
+            break;
+        }
         case PCSGCustomEventViewReceiverOffDisplay:
             notification_message(app->notifications, &sequence_display_backlight_off);
             consumed = true;
@@ -194,6 +216,12 @@ bool pocsag_pager_scene_receiver_on_event(void* context, SceneManagerEvent event
             break;
         }
     } else if(event.type == SceneManagerEventTypeTick) {
+        pcsg_history_sync(app->txrx->history);
+        if(scene_manager_get_scene_state(app->scene_manager, POCSAGPagerSceneReceiver) &&
+           !pcsg_history_filter_pending(app->txrx->history)) {
+            scene_manager_set_scene_state(app->scene_manager, POCSAGPagerSceneReceiver, false);
+            pocsag_pager_scene_receiver_apply_filter(app);
+        }
         if(app->txrx->hopper_state != PCSGHopperStateOFF) {
             pcsg_hopper_update(app);
             pocsag_pager_scene_receiver_update_statusbar(app);
@@ -7,6 +7,12 @@ void pocsag_pager_scene_receiver_info_callback(PCSGCustomEvent event, void* cont
     view_dispatcher_send_custom_event(app->view_dispatcher, event);
 }
 
+static void pocsag_pager_scene_receiver_info_update(POCSAGPagerApp* app) {
+    // Record is read back from SD card and may be unavailable
+    FlipperFormat* raw = pcsg_history_get_raw_data(app->txrx->history, app->txrx->idx_menu_chosen);
+    if(raw) pcsg_view_receiver_info_update(app->pcsg_receiver_info, raw);
+}
+
 static void pocsag_pager_scene_receiver_info_add_to_history_callback(
     SubGhzReceiver* receiver,
     SubGhzProtocolDecoderBase* decoder_base,
@@ -16,9 +22,7 @@ static void pocsag_pager_scene_receiver_info_add_to_history_callback(
 
     if(pcsg_history_add_to_history(app->txrx->history, decoder_base, app->txrx->preset) ==
        PCSGHistoryStateAddKeyUpdateData) {
-        pcsg_view_receiver_info_update(
-            app->pcsg_receiver_info,
-            pcsg_history_get_raw_data(app->txrx->history, app->txrx->idx_menu_chosen));
+        pocsag_pager_scene_receiver_info_update(app);
         subghz_receiver_reset(receiver);
 
         notification_message(app->notifications, &sequence_blink_green_10);
@@ -31,9 +35,7 @@ void pocsag_pager_scene_receiver_info_on_enter(void* context) {
 
     subghz_receiver_set_rx_callback(
         app->txrx->receiver, pocsag_pager_scene_receiver_info_add_to_history_callback, app);
-    pcsg_view_receiver_info_update(
-        app->pcsg_receiver_info,
-        pcsg_history_get_raw_data(app->txrx->history, app->txrx->idx_menu_chosen));
+    pocsag_pager_scene_receiver_info_update(app);
     view_dispatcher_switch_to_view(app->view_dispatcher, POCSAGPagerViewReceiverInfo);
 }
 
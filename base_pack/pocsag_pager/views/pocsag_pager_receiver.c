@@ -5,7 +5,6 @@
 
 #include <input/input.h>
 #include <gui/elements.h>
-#include <m-array.h>
 
 #define FRAME_HEIGHT 12
 #define MAX_LEN_PX 112
@@ -14,20 +13,7 @@
 
 #define SUBGHZ_RAW_THRESHOLD_MIN -90.0f
 
-typedef struct {
-    FuriString* item_str;
-    uint8_t type;
-} PCSGReceiverMenuItem;
-
-ARRAY_DEF(PCSGReceiverMenuItemArray, PCSGReceiverMenuItem, M_POD_OPLIST)
-
-#define M_OPL_PCSGReceiverMenuItemArray_t() ARRAY_OPLIST(PCSGReceiverMenuItemArray, M_POD_OPLIST)
-
-struct PCSGReceiverHistory {
-    PCSGReceiverMenuItemArray_t data;
-};
-
-typedef struct PCSGReceiverHistory PCSGReceiverHistory;
+#define WINDOW_NONE UINT16_MAX
 
 static const Icon* ReceiverItemIcons[] = {
     [SubGhzProtocolTypeUnknown] = &I_Quest_7x8,
@@ -49,13 +35,19 @@ struct PCSGReceiver {
     View* view;
     PCSGReceiverCallback callback;
     void* context;
+    PCSGReceiverItemCallback item_callback;
+    void* item_context;
 };
 
 typedef struct {
     FuriString* frequency_str;
     FuriString* preset_str;
     FuriString* history_stat_str;
-    PCSGReceiverHistory* history;
+    // Only visible items are kept, the rest stays in history
+    FuriString* item_str[MENU_ITEMS];
+    uint8_t item_type[MENU_ITEMS];
+    uint16_t window_offset;
+    uint16_t window_gen; // Bumped whenever listed items change
     uint16_t idx;
     uint16_t list_offset;
     uint16_t history_item;
@@ -115,9 +107,23 @@ void pcsg_view_receiver_set_callback(
     pcsg_receiver->context = context;
 }
 
+void pcsg_view_receiver_set_item_callback(
+    PCSGReceiver* pcsg_receiver,
+    PCSGReceiverItemCallback callback,
+    void* context) {
+    furi_assert(pcsg_receiver);
+    furi_assert(callback);
+    pcsg_receiver->item_callback = callback;
+    pcsg_receiver->item_context = context;
+}
+
 static void pcsg_view_receiver_update_offset(PCSGReceiver* pcsg_receiver) {
     furi_assert(pcsg_receiver);
 
+    bool refresh = false;
+    uint16_t list_offset = 0;
+    uint16_t window_gen = 0;
+    size_t count = 0;
     with_view_model(
         pcsg_receiver->view,
         PCSGReceiverModel * model,
@@ -133,29 +139,61 @@ static void pcsg_view_receiver_update_offset(PCSGReceiver* pcsg_receiver) {
             } else if(model->list_offset > model->idx - bounds) {
                 model->list_offset = CLAMP(model->idx - 1, (int16_t)(history_item - bounds), 0);
             }
+
+            refresh = model->window_offset != model->list_offset && pcsg_receiver->item_callback;
+            list_offset = model->list_offset;
+            window_gen = model->window_gen;
+            count = MIN(history_item, MENU_ITEMS);
         },
         true);
+    if(!refresh) return;
+
+    // Items come from history on SD card, model stays unlocked so drawing isn't held up
+    FuriString* item_str[MENU_ITEMS];
+    uint8_t item_type[MENU_ITEMS];
+    for(size_t i = 0; i < count; ++i) {
+        item_str[i] = furi_string_alloc();
+        pcsg_receiver->item_callback(
+            item_str[i], &item_type[i], list_offset + i, pcsg_receiver->item_context);
+    }
+
+    with_view_model(
+        pcsg_receiver->view,
+        PCSGReceiverModel * model,
+        {
+            // Window moved or history changed meanwhile, whoever did it fetches again
+            if(model->list_offset == list_offset && model->window_gen == window_gen) {
+                for(size_t i = 0; i < count; ++i) {
+                    furi_string_swap(model->item_str[i], item_str[i]);
+                    model->item_type[i] = item_type[i];
+                }
+                model->window_offset = list_offset;
+            }
+        },
+        true);
+
+    for(size_t i = 0; i < count; ++i) {
+        furi_string_free(item_str[i]);
+    }
 }
 
-void pcsg_view_receiver_add_item_to_menu(
-    PCSGReceiver* pcsg_receiver,
-    const char* name,
-    uint8_t type) {
+void pcsg_view_receiver_set_item_count(PCSGReceiver* pcsg_receiver, uint16_t count) {
     furi_assert(pcsg_receiver);
     with_view_model(
         pcsg_receiver->view,
         PCSGReceiverModel * model,
         {
-            PCSGReceiverMenuItem* item_menu =
-                PCSGReceiverMenuItemArray_push_raw(model->history->data);
-            item_menu->item_str = furi_string_alloc_set(name);
-            item_menu->type = type;
-            if((model->idx == model->history_item - 1)) {
-                model->history_item++;
-                model->idx++;
-            } else {
-                model->history_item++;
+            if(count > model->history_item && model->history_item &&
+               model->idx == model->history_item - 1) {
+                // Cursor on the last item follows new ones
+                model->idx = count - 1;
+            } else if(model->idx >= count) {
+                model->idx = count ? count - 1 : 0;
             }
+            if(model->list_offset >= count) model->list_offset = 0;
+            model->history_item = count;
+            model->window_offset = WINDOW_NONE;
+            model->window_gen++;
         },
         true);
     pcsg_view_receiver_update_offset(pcsg_receiver);
@@ -178,6 +216,13 @@ void pcsg_view_receiver_add_data_statusbar(
         true);
 }
 
+static uint16_t pcsg_view_receiver_get_item_count(PCSGReceiver* pcsg_receiver) {
+    uint16_t count = 0;
+    with_view_model(
+        pcsg_receiver->view, PCSGReceiverModel * model, { count = model->history_item; }, false);
+    return count;
+}
+
 static void pcsg_view_receiver_draw_frame(Canvas* canvas, uint16_t idx, bool scrollbar) {
     canvas_set_color(canvas, ColorBlack);
     canvas_draw_box(canvas, 0, 0 + idx * FRAME_HEIGHT, scrollbar ? 122 : 127, FRAME_HEIGHT);
@@ -214,12 +259,9 @@ void pcsg_view_receiver_draw(Canvas* canvas, PCSGReceiverModel* model) {
     FuriString* str_buff;
     str_buff = furi_string_alloc();
 
-    PCSGReceiverMenuItem* item_menu;
-
     for(size_t i = 0; i < MIN(model->history_item, MENU_ITEMS); ++i) {
         size_t idx = CLAMP((uint16_t)(i + model->list_offset), model->history_item, 0);
-        item_menu = PCSGReceiverMenuItemArray_get(model->history->data, idx);
-        furi_string_set(str_buff, item_menu->item_str);
+        furi_string_set(str_buff, model->item_str[i]);
         furi_string_replace_all(str_buff, "#", "");
         elements_string_fit_width(canvas, str_buff, scrollbar ? MAX_LEN_PX - 7 : MAX_LEN_PX);
         if(model->idx == idx) {
@@ -227,7 +269,7 @@ void pcsg_view_receiver_draw(Canvas* canvas, PCSGReceiverModel* model) {
         } else {
             canvas_set_color(canvas, ColorBlack);
         }
-        canvas_draw_icon(canvas, 4, 2 + i * FRAME_HEIGHT, ReceiverItemIcons[item_menu->type]);
+        canvas_draw_icon(canvas, 4, 2 + i * FRAME_HEIGHT, ReceiverItemIcons[model->item_type[i]]);
         canvas_draw_str(canvas, 15, 9 + i * FRAME_HEIGHT, furi_string_get_cstr(str_buff));
         furi_string_reset(str_buff);
     }
@@ -350,16 +392,14 @@ bool pcsg_view_receiver_input(InputEvent* event, void* context) {
             true);
     } else if(event->key == InputKeyLeft && event->type == InputTypeShort) {
         pcsg_receiver->callback(PCSGCustomEventViewReceiverConfig, pcsg_receiver->context);
+    } else if(event->key == InputKeyRight && event->type == InputTypeShort) {
+        if(pcsg_view_receiver_get_item_count(pcsg_receiver) != 0) {
+            pcsg_receiver->callback(PCSGCustomEventViewReceiverFilter, pcsg_receiver->context);
+        }
     } else if(event->key == InputKeyOk && event->type == InputTypeShort) {
-        with_view_model(
-            pcsg_receiver->view,
-            PCSGReceiverModel * model,
-            {
-                if(model->history_item != 0) {
-                    pcsg_receiver->callback(PCSGCustomEventViewReceiverOK, pcsg_receiver->context);
-                }
-            },
-            false);
+        if(pcsg_view_receiver_get_item_count(pcsg_receiver) != 0) {
+            pcsg_receiver->callback(PCSGCustomEventViewReceiverOK, pcsg_receiver->context);
+        }
     }
 
     pcsg_view_receiver_update_offset(pcsg_receiver);
@@ -381,15 +421,10 @@ void pcsg_view_receiver_exit(void* context) {
             furi_string_reset(model->frequency_str);
             furi_string_reset(model->preset_str);
             furi_string_reset(model->history_stat_str);
-                for
-                    M_EACH(item_menu, model->history->data, PCSGReceiverMenuItemArray_t) {
-                        furi_string_free(item_menu->item_str);
-                        item_menu->type = 0;
-                    }
-                PCSGReceiverMenuItemArray_reset(model->history->data);
-                model->idx = 0;
-                model->list_offset = 0;
-                model->history_item = 0;
+            model->window_offset = WINDOW_NONE;
+            model->idx = 0;
+            model->list_offset = 0;
+            model->history_item = 0;
         },
         false);
     furi_timer_stop(pcsg_receiver->timer);
@@ -418,8 +453,11 @@ PCSGReceiver* pcsg_view_receiver_alloc() {
             model->preset_str = furi_string_alloc();
             model->history_stat_str = furi_string_alloc();
             model->bar_show = PCSGReceiverBarShowDefault;
-            model->history = malloc(sizeof(PCSGReceiverHistory));
-            PCSGReceiverMenuItemArray_init(model->history->data);
+            for(size_t i = 0; i < MENU_ITEMS; ++i) {
+                model->item_str[i] = furi_string_alloc();
+                model->item_type[i] = 0;
+            }
+            model->window_offset = WINDOW_NONE;
         },
         true);
     pcsg_receiver->timer =
@@ -437,13 +475,9 @@ void pcsg_view_receiver_free(PCSGReceiver* pcsg_receiver) {
             furi_string_free(model->frequency_str);
             furi_string_free(model->preset_str);
             furi_string_free(model->history_stat_str);
-                for
-                    M_EACH(item_menu, model->history->data, PCSGReceiverMenuItemArray_t) {
-                        furi_string_free(item_menu->item_str);
-                        item_menu->type = 0;
-                    }
-                PCSGReceiverMenuItemArray_clear(model->history->data);
-                free(model->history);
+            for(size_t i = 0; i < MENU_ITEMS; ++i) {
+                furi_string_free(model->item_str[i]);
+            }
         },
         false);
     furi_timer_free(pcsg_receiver->timer);
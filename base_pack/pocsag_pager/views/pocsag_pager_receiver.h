@@ -8,6 +8,12 @@ typedef struct PCSGReceiver PCSGReceiver;
 
 typedef void (*PCSGReceiverCallback)(PCSGCustomEvent event, void* context);
 
+typedef void (*PCSGReceiverItemCallback)(
+    FuriString* item_str,
+    uint8_t* type,
+    uint16_t idx,
+    void* context);
+
 void pcsg_receiver_rssi(PCSGReceiver* instance, float rssi);
 
 void pcsg_view_receiver_set_lock(PCSGReceiver* pcsg_receiver, PCSGLock keyboard);
@@ -31,10 +37,12 @@ void pcsg_view_receiver_add_data_statusbar(
     const char* preset_str,
     const char* history_stat_str);
 
-void pcsg_view_receiver_add_item_to_menu(
+void pcsg_view_receiver_set_item_callback(
     PCSGReceiver* pcsg_receiver,
-    const char* name,
-    uint8_t type);
+    PCSGReceiverItemCallback callback,
+    void* context);
+
+void pcsg_view_receiver_set_item_count(PCSGReceiver* pcsg_receiver, uint16_t count);
 
 uint16_t pcsg_view_receiver_get_idx_menu(PCSGReceiver* pcsg_receiver);
 
@@ -0,0 +1,454 @@
+#include "text_viewer_file.h"
+#include <ctype.h>
+
+#define TAG "TextViewerFile"
+
+#define TEXT_VIEWER_CHUNK_SIZE 512u
+#define TEXT_VIEWER_FIND_BLOCK_SIZE 4096u
+#define TEXT_VIEWER_INDEX_MAX 1024u
+#define TEXT_VIEWER_INDEX_STEP 16u
+#define TEXT_VIEWER_NO_MATCH UINT32_MAX
+
+typedef enum {
+    TextViewerFileEvtStop = (1 << 0),
+} TextViewerFileEvtFlags;
+
+struct TextViewerFile {
+    Storage* storage;
+    // Storage refuses to open a file twice, so all threads share it and seek before each read
+    File* file;
+    FuriMutex* io_mutex;
+    uint32_t size;
+
+    // Last chunk read by UI thread, all layout and search goes through it
+    uint8_t buf[TEXT_VIEWER_CHUNK_SIZE];
+    uint32_t buf_offset;
+    uint32_t buf_len;
+
+    uint32_t top; // Offset of the top row
+    uint32_t top_line;
+    uint32_t top_line_offset; // Start of the line containing top row
+    uint32_t last_match;
+
+    // Sparse index, entry k is the start of line k * index_step
+    FuriMutex* mutex;
+    uint32_t index[TEXT_VIEWER_INDEX_MAX];
+    uint32_t index_count;
+    uint32_t index_step;
+    uint32_t lines_total;
+    bool indexed;
+
+    FuriThread* thread;
+    uint8_t index_buf[TEXT_VIEWER_CHUNK_SIZE];
+
+    // Search runs on its own thread, UI polls its state and applies the match
+    FuriThread* find_thread;
+    volatile TextViewerFindState find_state;
+    volatile bool find_cancel;
+    volatile uint32_t find_pos;
+    char find_needle[TEXT_VIEWER_SEARCH_MAX_LEN + 1];
+    size_t find_len;
+    uint32_t find_from;
+    uint32_t find_line;
+    uint32_t find_line_start;
+    uint32_t find_match;
+};
+
+static size_t
+    text_viewer_file_read_at(TextViewerFile* file, uint32_t offset, uint8_t* buf, size_t len) {
+    size_t read = 0;
+    furi_check(furi_mutex_acquire(file->io_mutex, FuriWaitForever) == FuriStatusOk);
+    if(storage_file_seek(file->file, offset, true)) {
+        read = storage_file_read(file->file, buf, len);
+    } else {
+        FURI_LOG_E(TAG, "Unable to seek to %lu", offset);
+    }
+    furi_mutex_release(file->io_mutex);
+    return read;
+}
+
+// Must be called with mutex taken
+static void text_viewer_file_index_add(TextViewerFile* file, uint32_t line, uint32_t offset) {
+    if(line % file->index_step != 0) return;
+
+    if(file->index_count == TEXT_VIEWER_INDEX_MAX) {
+        // Out of room: keep every other entry, so memory stays bounded on huge files
+        for(uint32_t i = 0; i < TEXT_VIEWER_INDEX_MAX / 2; i++) {
+            file->index[i] = file->index[i * 2];
+        }
+        file->index_count = TEXT_VIEWER_INDEX_MAX / 2;
+        file->index_step *= 2;
+        if(line % file->index_step != 0) return;
+    }
+
+    file->index[file->index_count++] = offset;
+}
+
+static int32_t text_viewer_file_index_worker(void* context) {
+    TextViewerFile* file = context;
+
+    uint32_t offset = 0;
+    uint32_t lines = (file->size > 0) ? 1 : 0;
+    while(offset < file->size) {
+        if(furi_thread_flags_get() & TextViewerFileEvtStop) break;
+
+        size_t read =
+            text_viewer_file_read_at(file, offset, file->index_buf, TEXT_VIEWER_CHUNK_SIZE);
+        if(read == 0) {
+            FURI_LOG_E(TAG, "Index read failed at %lu", offset);
+            break;
+        }
+
+        furi_check(furi_mutex_acquire(file->mutex, FuriWaitForever) == FuriStatusOk);
+        for(size_t i = 0; i < read; i++) {
+            uint32_t next = offset + i + 1;
+            if(file->index_buf[i] == '\n' && next < file->size) {
+                text_viewer_file_index_add(file, lines, next);
+                lines++;
+            }
+        }
+        file->lines_total = lines;
+        furi_mutex_release(file->mutex);
+
+        offset += read;
+        furi_thread_yield();
+    }
+
+    furi_check(furi_mutex_acquire(file->mutex, FuriWaitForever) == FuriStatusOk);
+    file->indexed = (offset >= file->size);
+    furi_mutex_release(file->mutex);
+
+    FURI_LOG_D(TAG, "Indexed %lu lines, step %lu", lines, file->index_step);
+    return 0;
+}
+
+static bool text_viewer_file_byte(TextViewerFile* file, uint32_t offset, uint8_t* byte) {
+    if(offset >= file->size) return false;
+
+    if(offset < file->buf_offset || offset >= file->buf_offset + file->buf_len) {
+        uint32_t start = offset - (offset % TEXT_VIEWER_CHUNK_SIZE);
+        file->buf_offset = start;
+        file->buf_len = text_viewer_file_read_at(file, start, file->buf, TEXT_VIEWER_CHUNK_SIZE);
+        if(offset >= start + file->buf_len) return false;
+    }
+
+    *byte = file->buf[offset - file->buf_offset];
+    return true;
+}
+
+// Lays out one screen row starting at offset, out may be NULL when only the size matters.
+// Returns offset of the next row, line_end is set if the row finishes its line.
+static uint32_t
+    text_viewer_file_row(TextViewerFile* file, uint32_t offset, char* out, bool* line_end) {
+    size_t len = 0;
+    uint8_t byte;
+
+    *line_end = false;
+    while(text_viewer_file_byte(file, offset, &byte)) {
+        if(byte == '\n') {
+            offset++;
+            *line_end = true;
+            break;
+        }
+        if(byte == '\r') {
+            offset++;
+            continue;
+        }
+        if(len == TEXT_VIEWER_ROW_CHARS) break;
+
+        if(out) out[len] = (byte == '\t') ? ' ' : (byte < ' ') ? '.' : (char)byte;
+        len++;
+        offset++;
+    }
+
+    if(out) out[len] = '\0';
+    if(offset >= file->size) *line_end = true;
+    return offset;
+}
+
+// Moves top to the row of the current line that contains target offset
+static void text_viewer_file_set_top(TextViewerFile* file, uint32_t target) {
+    uint32_t row = file->top_line_offset;
+    bool line_end;
+    while(true) {
+        uint32_t next = text_viewer_file_row(file, row, NULL, &line_end);
+        if(next > target || line_end) break;
+        row = next;
+    }
+    file->top = row;
+}
+
+static bool text_viewer_file_scroll_down(TextViewerFile* file) {
+    bool line_end;
+    uint32_t next = text_viewer_file_row(file, file->top, NULL, &line_end);
+    if(next >= file->size) return false;
+
+    if(line_end) {
+        file->top_line++;
+        file->top_line_offset = next;
+    }
+    file->top = next;
+    return true;
+}
+
+static bool text_viewer_file_scroll_up(TextViewerFile* file) {
+    if(file->top == 0) return false;
+
+    if(file->top == file->top_line_offset) {
+        // Walk back over the previous line, it ends with '\n' right before top
+        uint32_t offset = file->top - 1;
+        uint8_t byte;
+        while(offset > 0 && text_viewer_file_byte(file, offset - 1, &byte) && byte != '\n') {
+            offset--;
+        }
+        file->top_line--;
+        file->top_line_offset = offset;
+    }
+
+    text_viewer_file_set_top(file, file->top - 1);
+    return true;
+}
+
+TextViewerFile* text_viewer_file_alloc(Storage* storage, const char* path) {
+    furi_assert(storage);
+    furi_assert(path);
+
+    TextViewerFile* file = malloc(sizeof(TextViewerFile));
+    file->storage = storage;
+    file->file = storage_file_alloc(storage);
+
+    if(!storage_file_open(file->file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        FURI_LOG_E(TAG, "Unable to open %s", path);
+        storage_file_free(file->file);
+        free(file);
+        return NULL;
+    }
+
+    file->size = storage_file_size(file->file);
+    file->buf_offset = 0;
+    file->buf_len = 0;
+    file->top = 0;
+    file->top_line = 0;
+    file->top_line_offset = 0;
+    file->last_match = TEXT_VIEWER_NO_MATCH;
+    file->find_thread = NULL;
+    file->find_state = TextViewerFindIdle;
+    file->find_cancel = false;
+
+    file->io_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    file->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    file->index[0] = 0;
+    file->index_count = 1;
+    file->index_step = TEXT_VIEWER_INDEX_STEP;
+    file->lines_total = 0;
+    file->indexed = false;
+
+    file->thread =
+        furi_thread_alloc_ex("TextViewerIndex", 1024, text_viewer_file_index_worker, file);
+    furi_thread_start(file->thread);
+
+    return file;
+}
+
+void text_viewer_file_free(TextViewerFile* file) {
+    furi_assert(file);
+
+    text_viewer_file_find_cancel(file);
+    furi_thread_flags_set(furi_thread_get_id(file->thread), TextViewerFileEvtStop);
+    furi_thread_join(file->thread);
+    furi_thread_free(file->thread);
+    furi_mutex_free(file->mutex);
+    furi_mutex_free(file->io_mutex);
+
+    storage_file_close(file->file);
+    storage_file_free(file->file);
+    free(file);
+}
+
+void text_viewer_file_get_window(TextViewerFile* file, TextViewerWindow* window) {
+    furi_assert(file);
+    furi_assert(window);
+
+    uint32_t offset = file->top;
+    bool line_end;
+    window->rows_count = 0;
+    while(window->rows_count < TEXT_VIEWER_ROWS && offset < file->size) {
+        offset = text_viewer_file_row(file, offset, window->rows[window->rows_count], &line_end);
+        window->rows_count++;
+    }
+
+    window->line = file->top_line;
+    window->offset = file->top;
+    window->file_size = file->size;
+
+    furi_check(furi_mutex_acquire(file->mutex, FuriWaitForever) == FuriStatusOk);
+    window->lines_total = file->lines_total;
+    window->indexed = file->indexed;
+    furi_mutex_release(file->mutex);
+}
+
+bool text_viewer_file_scroll(TextViewerFile* file, int32_t rows) {
+    furi_assert(file);
+
+    bool moved = false;
+    for(; rows > 0 && text_viewer_file_scroll_down(file); rows--) moved = true;
+    for(; rows < 0 && text_viewer_file_scroll_up(file); rows++) moved = true;
+    return moved;
+}
+
+void text_viewer_file_goto_line(TextViewerFile* file, uint32_t line) {
+    furi_assert(file);
+
+    // Start from the closest known line: index entry or current position
+    furi_check(furi_mutex_acquire(file->mutex, FuriWaitForever) == FuriStatusOk);
+    uint32_t entry = MIN(line / file->index_step, file->index_count - 1);
+    uint32_t cur_line = entry * file->index_step;
+    uint32_t line_start = file->index[entry];
+    furi_mutex_release(file->mutex);
+
+    if(file->top_line <= line && file->top_line > cur_line) {
+        cur_line = file->top_line;
+        line_start = file->top_line_offset;
+    }
+
+    uint32_t offset = line_start;
+    uint8_t byte;
+    while(cur_line < line && text_viewer_file_byte(file, offset, &byte)) {
+        offset++;
+        if(byte == '\n' && offset < file->size) {
+            cur_line++;
+            line_start = offset;
+        }
+    }
+
+    file->top = line_start;
+    file->top_line = cur_line;
+    file->top_line_offset = line_start;
+    file->last_match = TEXT_VIEWER_NO_MATCH;
+}
+
+static int32_t text_viewer_file_find_worker(void* context) {
+    TextViewerFile* file = context;
+    const char* needle = file->find_needle;
+    size_t len = file->find_len;
+    uint32_t line = file->find_line;
+    uint32_t line_start = file->find_line_start;
+
+    // Tail of the previous block is kept in front of the next one for matches crossing blocks.
+    // Every offset is checked once: offsets of the kept tail were not reached in previous block.
+    uint8_t* block = malloc(TEXT_VIEWER_FIND_BLOCK_SIZE + TEXT_VIEWER_SEARCH_MAX_LEN - 1);
+    TextViewerFindState state = TextViewerFindNotFound;
+    uint32_t read_offset = file->find_from;
+    size_t kept = 0;
+
+    while(read_offset < file->size && state == TextViewerFindNotFound) {
+        if(file->find_cancel) {
+            state = TextViewerFindCancelled;
+            break;
+        }
+        size_t read =
+            text_viewer_file_read_at(file, read_offset, &block[kept], TEXT_VIEWER_FIND_BLOCK_SIZE);
+        if(read == 0) {
+            FURI_LOG_E(TAG, "Find read failed at %lu", read_offset);
+            break;
+        }
+
+        size_t avail = kept + read;
+        uint32_t block_offset = read_offset - kept;
+        for(size_t i = 0; i + len <= avail; i++) {
+            size_t j = 0;
+            while(j < len && tolower(block[i + j]) == needle[j]) j++;
+            if(j == len) {
+                file->find_match = block_offset + i;
+                state = TextViewerFindFound;
+                break;
+            }
+            if(block[i] == '\n') {
+                line++;
+                line_start = block_offset + i + 1;
+            }
+        }
+
+        read_offset += read;
+        file->find_pos = read_offset;
+        kept = MIN(len - 1, avail);
+        memmove(block, &block[avail - kept], kept);
+    }
+
+    free(block);
+    file->find_line = line;
+    file->find_line_start = line_start;
+    file->find_state = state;
+    return 0;
+}
+
+bool text_viewer_file_find_start(TextViewerFile* file, const char* needle) {
+    furi_assert(file);
+    furi_assert(needle);
+
+    size_t len = strlen(needle);
+    if(len == 0 || len > TEXT_VIEWER_SEARCH_MAX_LEN || file->find_thread) return false;
+
+    // Continue after the previous match only while it is still in the top row
+    bool line_end;
+    uint32_t from = file->top;
+    uint32_t top_next = text_viewer_file_row(file, file->top, NULL, &line_end);
+    if(file->last_match != TEXT_VIEWER_NO_MATCH && file->last_match >= file->top &&
+       file->last_match < top_next) {
+        from = file->last_match + 1;
+    }
+
+    for(size_t i = 0; i <= len; i++) {
+        file->find_needle[i] = tolower((unsigned char)needle[i]);
+    }
+    file->find_len = len;
+    file->find_from = from;
+    file->find_pos = from;
+    // Top row may start inside a line, line start is still the one of the top line
+    file->find_line = file->top_line;
+    file->find_line_start = file->top_line_offset;
+    file->find_cancel = false;
+    file->find_state = TextViewerFindRunning;
+
+    file->find_thread =
+        furi_thread_alloc_ex("TextViewerFind", 1024, text_viewer_file_find_worker, file);
+    furi_thread_start(file->find_thread);
+    return true;
+}
+
+void text_viewer_file_find_cancel(TextViewerFile* file) {
+    furi_assert(file);
+    if(!file->find_thread) return;
+
+    // Worker stops after the block being read
+    file->find_cancel = true;
+    furi_thread_join(file->find_thread);
+    furi_thread_free(file->find_thread);
+    file->find_thread = NULL;
+    file->find_state = TextViewerFindCancelled;
+}
+
+TextViewerFindState text_viewer_file_find_poll(TextViewerFile* file, uint8_t* percent) {
+    furi_assert(file);
+
+    TextViewerFindState state = file->find_state;
+    if(state == TextViewerFindRunning) {
+        uint32_t total = file->size - file->find_from;
+        uint32_t done = file->find_pos - file->find_from;
+        *percent = total > 0 ? (uint64_t)done * 100 / total : 100;
+        return state;
+    }
+
+    if(file->find_thread) {
+        furi_thread_join(file->find_thread);
+        furi_thread_free(file->find_thread);
+        file->find_thread = NULL;
+        if(state == TextViewerFindFound) {
+            file->top_line = file->find_line;
+            file->top_line_offset = file->find_line_start;
+            file->last_match = file->find_match;
+            text_viewer_file_set_top(file, file->find_match);
+        }
+    }
+    return state;
+}
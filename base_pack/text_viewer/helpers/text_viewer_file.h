@@ -0,0 +1,51 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+#define TEXT_VIEWER_ROW_CHARS 20u
+#define TEXT_VIEWER_ROWS 6u
+#define TEXT_VIEWER_SEARCH_MAX_LEN 32u
+
+typedef struct TextViewerFile TextViewerFile;
+
+typedef enum {
+    TextViewerFindIdle,
+    TextViewerFindRunning,
+    TextViewerFindFound,
+    TextViewerFindNotFound,
+    TextViewerFindCancelled,
+} TextViewerFindState;
+
+typedef struct {
+    char rows[TEXT_VIEWER_ROWS][TEXT_VIEWER_ROW_CHARS + 1];
+    uint8_t rows_count;
+    uint32_t line; // Line of the top row, starting from 0
+    uint32_t offset; // File offset of the top row
+    uint32_t file_size;
+    uint32_t lines_total; // Lines found by the indexer so far
+    bool indexed;
+} TextViewerWindow;
+
+// Opens file and starts building line index in background, NULL on error
+TextViewerFile* text_viewer_file_alloc(Storage* storage, const char* path);
+void text_viewer_file_free(TextViewerFile* file);
+
+// Lays out only the rows visible from the current position
+void text_viewer_file_get_window(TextViewerFile* file, TextViewerWindow* window);
+
+// Positive rows scroll down, negative up. Returns false if position did not change
+bool text_viewer_file_scroll(TextViewerFile* file, int32_t rows);
+
+// Line starts from 0, lines past the end move to the last line
+void text_viewer_file_goto_line(TextViewerFile* file, uint32_t line);
+
+// Starts case insensitive forward search on a worker, repeated searches continue after the
+// previous match. Returns false if the needle is empty or a search is already running.
+bool text_viewer_file_find_start(TextViewerFile* file, const char* needle);
+
+// Stops the search and waits for the worker, position stays as it was
+void text_viewer_file_find_cancel(TextViewerFile* file);
+
+// Returns search state and percent done while running, a match moves position to it
+TextViewerFindState text_viewer_file_find_poll(TextViewerFile* file, uint8_t* percent);
@@ -1 +1,4 @@
 ADD_SCENE(text_viewer, show, Show)
+ADD_SCENE(text_viewer, menu, Menu)
+ADD_SCENE(text_viewer, goto_line, GotoLine)
+ADD_SCENE(text_viewer, find, Find)
\ No newline at end of file
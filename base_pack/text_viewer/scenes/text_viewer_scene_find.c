@@ -0,0 +1,79 @@
+#include "../text_viewer.h"
+
+static void text_viewer_scene_find_callback(void* context) {
+    TextViewer* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, TextViewerCustomEventInputDone);
+}
+
+void text_viewer_scene_find_on_enter(void* context) {
+    furi_assert(context);
+    TextViewer* app = context;
+
+    text_input_set_header_text(app->text_input, "Find text");
+    text_input_set_result_callback(
+        app->text_input,
+        text_viewer_scene_find_callback,
+        app,
+        app->search_buf,
+        sizeof(app->search_buf),
+        false);
+
+    view_dispatcher_switch_to_view(app->view_dispatcher, TextViewerViewTextInput);
+}
+
+static void text_viewer_scene_find_show_progress(TextViewer* app, uint8_t percent) {
+    char progress[8];
+    snprintf(progress, sizeof(progress), "%u%%", percent);
+    widget_reset(app->widget);
+    widget_add_string_element(
+        app->widget, 64, 24, AlignCenter, AlignCenter, FontPrimary, "Searching...");
+    widget_add_string_element(
+        app->widget, 64, 40, AlignCenter, AlignCenter, FontSecondary, progress);
+}
+
+static void text_viewer_scene_find_finish(TextViewer* app, bool failed) {
+    scene_manager_set_scene_state(app->scene_manager, TextViewerSceneFind, false);
+    app->search_failed = failed;
+    scene_manager_search_and_switch_to_previous_scene(app->scene_manager, TextViewerSceneShow);
+}
+
+bool text_viewer_scene_find_on_event(void* context, SceneManagerEvent event) {
+    furi_assert(context);
+    TextViewer* app = context;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom &&
+       event.event == TextViewerCustomEventInputDone) {
+        // Search runs on a worker, Back cancels it and keeps the position
+        if(text_viewer_file_find_start(app->file, app->search_buf)) {
+            scene_manager_set_scene_state(app->scene_manager, TextViewerSceneFind, true);
+            text_viewer_scene_find_show_progress(app, 0);
+            view_dispatcher_switch_to_view(app->view_dispatcher, TextViewerViewWidget);
+        } else {
+            text_viewer_scene_find_finish(app, true);
+        }
+        consumed = true;
+    } else if(
+        event.type == SceneManagerEventTypeTick &&
+        scene_manager_get_scene_state(app->scene_manager, TextViewerSceneFind)) {
+        uint8_t percent;
+        TextViewerFindState state = text_viewer_file_find_poll(app->file, &percent);
+        if(state == TextViewerFindRunning) {
+            text_viewer_scene_find_show_progress(app, percent);
+        } else {
+            text_viewer_scene_find_finish(app, state != TextViewerFindFound);
+        }
+        consumed = true;
+    }
+
+    return consumed;
+}
+
+void text_viewer_scene_find_on_exit(void* context) {
+    furi_assert(context);
+    TextViewer* app = context;
+    scene_manager_set_scene_state(app->scene_manager, TextViewerSceneFind, false);
+    text_viewer_file_find_cancel(app->file);
+    text_input_reset(app->text_input);
+    widget_reset(app->widget);
+}
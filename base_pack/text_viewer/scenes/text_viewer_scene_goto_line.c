@@ -0,0 +1,46 @@
+#include "../text_viewer.h"
+
+static void text_viewer_scene_goto_line_callback(void* context) {
+    TextViewer* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, TextViewerCustomEventInputDone);
+}
+
+void text_viewer_scene_goto_line_on_enter(void* context) {
+    furi_assert(context);
+    TextViewer* app = context;
+
+    text_input_set_header_text(app->text_input, "Go to line");
+    text_input_set_result_callback(
+        app->text_input,
+        text_viewer_scene_goto_line_callback,
+        app,
+        app->line_buf,
+        TEXT_VIEWER_LINE_INPUT,
+        true);
+
+    view_dispatcher_switch_to_view(app->view_dispatcher, TextViewerViewTextInput);
+}
+
+bool text_viewer_scene_goto_line_on_event(void* context, SceneManagerEvent event) {
+    furi_assert(context);
+    TextViewer* app = context;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom &&
+       event.event == TextViewerCustomEventInputDone) {
+        // Lines are shown starting from 1
+        uint32_t line = strtoul(app->line_buf, NULL, 10);
+        text_viewer_file_goto_line(app->file, line > 0 ? line - 1 : 0);
+        scene_manager_search_and_switch_to_previous_scene(
+            app->scene_manager, TextViewerSceneShow);
+        consumed = true;
+    }
+
+    return consumed;
+}
+
+void text_viewer_scene_goto_line_on_exit(void* context) {
+    furi_assert(context);
+    TextViewer* app = context;
+    text_input_reset(app->text_input);
+}
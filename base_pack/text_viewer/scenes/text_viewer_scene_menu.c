@@ -0,0 +1,66 @@
+#include "../text_viewer.h"
+
+enum SubmenuIndex {
+    SubmenuIndexGotoLine,
+    SubmenuIndexFind,
+    SubmenuIndexFindNext,
+};
+
+static void text_viewer_scene_menu_submenu_callback(void* context, uint32_t index) {
+    TextViewer* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, index);
+}
+
+void text_viewer_scene_menu_on_enter(void* context) {
+    furi_assert(context);
+    TextViewer* app = context;
+
+    submenu_add_item(
+        app->submenu,
+        "Go to line",
+        SubmenuIndexGotoLine,
+        text_viewer_scene_menu_submenu_callback,
+        app);
+    submenu_add_item(
+        app->submenu, "Find text", SubmenuIndexFind, text_viewer_scene_menu_submenu_callback, app);
+    if(strlen(app->search_buf)) {
+        submenu_add_item(
+            app->submenu,
+            "Find next",
+            SubmenuIndexFindNext,
+            text_viewer_scene_menu_submenu_callback,
+            app);
+    }
+
+    submenu_set_selected_item(
+        app->submenu, scene_manager_get_scene_state(app->scene_manager, TextViewerSceneMenu));
+
+    view_dispatcher_switch_to_view(app->view_dispatcher, TextViewerViewMenu);
+}
+
+bool text_viewer_scene_menu_on_event(void* context, SceneManagerEvent event) {
+    furi_assert(context);
+    TextViewer* app = context;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom) {
+        scene_manager_set_scene_state(app->scene_manager, TextViewerSceneMenu, event.event);
+        consumed = true;
+        if(event.event == SubmenuIndexGotoLine) {
+            scene_manager_next_scene(app->scene_manager, TextViewerSceneGotoLine);
+        } else if(event.event == SubmenuIndexFind) {
+            scene_manager_next_scene(app->scene_manager, TextViewerSceneFind);
+        } else if(event.event == SubmenuIndexFindNext) {
+            app->search_failed = !text_viewer_file_find(app->file, app->search_buf);
+            scene_manager_previous_scene(app->scene_manager);
+        }
+    }
+
+    return consumed;
+}
+
+void text_viewer_scene_menu_on_exit(void* context) {
+    furi_assert(context);
+    TextViewer* app = context;
+    submenu_reset(app->submenu);
+}
@@ -1,127 +1,108 @@
 #include "../text_viewer.h"
 
-#define SHOW_MAX_FILE_SIZE 8000
+static void text_viewer_scene_show_error(TextViewer* app, const char* text) {
+    widget_add_text_box_element(
+        app->widget, 0, 0, 128, 64, AlignLeft, AlignCenter, text, false);
+    view_dispatcher_switch_to_view(app->view_dispatcher, TextViewerViewWidget);
+}
 
-void text_viewer_scene_show_widget_callback(GuiButtonType result, InputType type, void* context) {
+static void text_viewer_scene_show_reader_callback(TextViewerReaderEvent event, void* context) {
     furi_assert(context);
     TextViewer* app = (TextViewer*)context;
-    if(type == InputTypeShort) {
-        view_dispatcher_send_custom_event(app->view_dispatcher, result);
-    }
+    view_dispatcher_send_custom_event(app->view_dispatcher, event);
 }
 
-static bool text_show_read_lines(File* file, FuriString* str_result) {
-    //furi_string_reset(str_result);
-    uint8_t buffer[SHOW_MAX_FILE_SIZE];
-
-    uint16_t read_count = storage_file_read(file, buffer, SHOW_MAX_FILE_SIZE);
-    if(storage_file_get_error(file) != FSE_OK) {
-        return false;
-    }
+static void text_viewer_scene_show_refresh(TextViewer* app) {
+    TextViewerWindow window;
+    text_viewer_file_get_window(app->file, &window);
+    app->indexed = window.indexed;
 
-    for(uint16_t i = 0; i < read_count; i++) {
-        furi_string_push_back(str_result, buffer[i]);
+    char status[24];
+    if(app->search_failed) {
+        snprintf(status, sizeof(status), "Not found");
+    } else {
+        uint32_t percent =
+            window.file_size ? (uint32_t)((uint64_t)window.offset * 100 / window.file_size) : 0;
+        snprintf(
+            status,
+            sizeof(status),
+            "Ln %lu/%lu%s %lu%%",
+            window.line + 1,
+            window.lines_total,
+            window.indexed ? "" : "+",
+            percent);
     }
 
-    return true;
+    text_viewer_reader_set_window(app->reader, &window, status);
 }
 
 void text_viewer_scene_show_on_enter(void* context) {
     furi_assert(context);
     TextViewer* app = context;
 
-    FuriString* buffer;
-    buffer = furi_string_alloc();
-
-    Storage* storage = furi_record_open(RECORD_STORAGE);
-    File* file = storage_file_alloc(storage);
-
-    FileInfo fileinfo;
-    FS_Error error = storage_common_stat(storage, furi_string_get_cstr(app->path), &fileinfo);
-    if(error == FSE_OK) {
-        if((fileinfo.size < SHOW_MAX_FILE_SIZE) && (fileinfo.size > 2)) {
-            bool ok = storage_file_open(
-                file, furi_string_get_cstr(app->path), FSAM_READ, FSOM_OPEN_EXISTING);
-            if(ok) {
-                if(!text_show_read_lines(file, buffer)) {
-                    goto text_file_read_err;
-                }
-                if(!furi_string_size(buffer)) {
-                    goto text_file_read_err;
-                }
-
-                storage_file_seek(file, 0, true);
-
-                widget_add_text_scroll_element(
-                    app->widget, 0, 0, 128, 64, furi_string_get_cstr(buffer));
+    if(!app->file) {
+        FileInfo fileinfo;
+        FS_Error error =
+            storage_common_stat(app->storage, furi_string_get_cstr(app->path), &fileinfo);
+        if(error != FSE_OK) {
+            text_viewer_scene_show_error(app, "\e#Error:\nFile system error\e#");
+            return;
+        }
+        if(fileinfo.size < 2) {
+            text_viewer_scene_show_error(app, "\e#Error:\nFile is too small\e#");
+            return;
+        }
 
-            } else {
-            text_file_read_err:
-                widget_add_text_box_element(
-                    app->widget,
-                    0,
-                    0,
-                    128,
-                    64,
-                    AlignLeft,
-                    AlignCenter,
-                    "\e#Error:\nStorage file open error\e#",
-                    false);
-            }
-            storage_file_close(file);
-        } else if(fileinfo.size < 2) {
-            widget_add_text_box_element(
-                app->widget,
-                0,
-                0,
-                128,
-                64,
-                AlignLeft,
-                AlignCenter,
-                "\e#Error:\nFile is too small\e#",
-                false);
-        } else {
-            widget_add_text_box_element(
-                app->widget,
-                0,
-                0,
-                128,
-                64,
-                AlignLeft,
-                AlignCenter,
-                "\e#Error:\nFile is too large to show\e#",
-                false);
+        app->file = text_viewer_file_alloc(app->storage, furi_string_get_cstr(app->path));
+        if(!app->file) {
+            text_viewer_scene_show_error(app, "\e#Error:\nStorage file open error\e#");
+            return;
         }
-    } else {
-        widget_add_text_box_element(
-            app->widget,
-            0,
-            0,
-            128,
-            64,
-            AlignLeft,
-            AlignCenter,
-            "\e#Error:\nFile system error\e#",
-            false);
     }
 
-    furi_string_free(buffer);
-
-    storage_file_free(file);
-    furi_record_close(RECORD_STORAGE);
-
-    view_dispatcher_switch_to_view(app->view_dispatcher, TextViewerViewWidget);
+    text_viewer_reader_set_callback(app->reader, text_viewer_scene_show_reader_callback, app);
+    text_viewer_scene_show_refresh(app);
+    view_dispatcher_switch_to_view(app->view_dispatcher, TextViewerViewReader);
 }
 
 bool text_viewer_scene_show_on_event(void* context, SceneManagerEvent event) {
     furi_assert(context);
     TextViewer* app = (TextViewer*)context;
+    bool consumed = false;
+
+    if(!app->file) return consumed;
 
     if(event.type == SceneManagerEventTypeCustom) {
-        scene_manager_previous_scene(app->scene_manager);
-        return true;
+        app->search_failed = false;
+        consumed = true;
+        switch(event.event) {
+        case TextViewerReaderEventUp:
+            text_viewer_file_scroll(app->file, -1);
+            break;
+        case TextViewerReaderEventDown:
+            text_viewer_file_scroll(app->file, 1);
+            break;
+        case TextViewerReaderEventPageUp:
+            text_viewer_file_scroll(app->file, -(int32_t)(TEXT_VIEWER_ROWS - 1));
+            break;
+        case TextViewerReaderEventPageDown:
+            text_viewer_file_scroll(app->file, TEXT_VIEWER_ROWS - 1);
+            break;
+        case TextViewerReaderEventMenu:
+            scene_manager_next_scene(app->scene_manager, TextViewerSceneMenu);
+            return consumed;
+        default:
+            consumed = false;
+            break;
+        }
+        text_viewer_scene_show_refresh(app);
+    } else if(event.type == SceneManagerEventTypeTick) {
+        // Keep line counter moving while the index is being built
+        if(!app->indexed) text_viewer_scene_show_refresh(app);
+        consumed = true;
     }
-    return false;
+
+    return consumed;
 }
 
 void text_viewer_scene_show_on_exit(void* context) {
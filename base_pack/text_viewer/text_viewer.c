@@ -12,9 +12,16 @@ static bool text_viewer_back_event_callback(void* context) {
     return scene_manager_handle_back_event(app->scene_manager);
 }
 
+static void text_viewer_tick_event_callback(void* context) {
+    furi_assert(context);
+    TextViewer* app = context;
+    scene_manager_handle_tick_event(app->scene_manager);
+}
+
 TextViewer* text_viewer_alloc() {
     TextViewer* app = malloc(sizeof(TextViewer));
     app->gui = furi_record_open(RECORD_GUI);
+    app->storage = furi_record_open(RECORD_STORAGE);
 
     app->view_dispatcher = view_dispatcher_alloc();
     app->scene_manager = scene_manager_alloc(&text_viewer_scene_handlers, app);
@@ -25,6 +32,8 @@ TextViewer* text_viewer_alloc() {
         app->view_dispatcher, text_viewer_custom_event_callback);
     view_dispatcher_set_navigation_event_callback(
         app->view_dispatcher, text_viewer_back_event_callback);
+    view_dispatcher_set_tick_event_callback(
+        app->view_dispatcher, text_viewer_tick_event_callback, 500);
 
     view_dispatcher_attach_to_gui(app->view_dispatcher, app->gui, ViewDispatcherTypeFullscreen);
 
@@ -32,7 +41,24 @@ TextViewer* text_viewer_alloc() {
     view_dispatcher_add_view(
         app->view_dispatcher, TextViewerViewWidget, widget_get_view(app->widget));
 
+    app->reader = text_viewer_reader_alloc();
+    view_dispatcher_add_view(
+        app->view_dispatcher, TextViewerViewReader, text_viewer_reader_get_view(app->reader));
+
+    app->submenu = submenu_alloc();
+    view_dispatcher_add_view(
+        app->view_dispatcher, TextViewerViewMenu, submenu_get_view(app->submenu));
+
+    app->text_input = text_input_alloc();
+    view_dispatcher_add_view(
+        app->view_dispatcher, TextViewerViewTextInput, text_input_get_view(app->text_input));
+
     app->path = furi_string_alloc();
+    app->file = NULL;
+    app->indexed = false;
+    app->search_failed = false;
+    app->line_buf[0] = '\0';
+    app->search_buf[0] = '\0';
 
     return app;
 }
@@ -42,12 +68,22 @@ void text_viewer_free(TextViewer* app) {
 
     view_dispatcher_remove_view(app->view_dispatcher, TextViewerViewWidget);
     widget_free(app->widget);
+    view_dispatcher_remove_view(app->view_dispatcher, TextViewerViewReader);
+    text_viewer_reader_free(app->reader);
+    view_dispatcher_remove_view(app->view_dispatcher, TextViewerViewMenu);
+    submenu_free(app->submenu);
+    view_dispatcher_remove_view(app->view_dispatcher, TextViewerViewTextInput);
+    text_input_free(app->text_input);
 
     view_dispatcher_free(app->view_dispatcher);
     scene_manager_free(app->scene_manager);
 
+    if(app->file) {
+        text_viewer_file_free(app->file);
+    }
     furi_string_free(app->path);
 
+    furi_record_close(RECORD_STORAGE);
     furi_record_close(RECORD_GUI);
     free(app);
 }
@@ -6,21 +6,43 @@
 #include <gui/view_dispatcher.h>
 #include <gui/scene_manager.h>
 #include <gui/modules/widget.h>
+#include <gui/modules/submenu.h>
+#include <gui/modules/text_input.h>
 #include "text_viewer_icons.h"
 #include "scenes/text_viewer_scene.h"
+#include "helpers/text_viewer_file.h"
+#include "views/text_viewer_reader.h"
 
 #define TEXT_VIEWER_PATH STORAGE_EXT_PATH_PREFIX
 #define TEXT_VIEWER_EXTENSION "*"
+#define TEXT_VIEWER_LINE_INPUT 11
 
 typedef struct {
     Gui* gui;
     SceneManager* scene_manager;
     ViewDispatcher* view_dispatcher;
     Widget* widget;
+    Submenu* submenu;
+    TextInput* text_input;
+    TextViewerReader* reader;
+    Storage* storage;
 
     FuriString* path;
+    TextViewerFile* file;
+    bool indexed;
+    bool search_failed;
+    char line_buf[TEXT_VIEWER_LINE_INPUT];
+    char search_buf[TEXT_VIEWER_SEARCH_MAX_LEN + 1];
 } TextViewer;
 
 typedef enum {
     TextViewerViewWidget,
+    TextViewerViewReader,
+    TextViewerViewMenu,
+    TextViewerViewTextInput,
 } TextViewerView;
+
+typedef enum {
+    // Reader view events go first, see TextViewerReaderEvent
+    TextViewerCustomEventInputDone = 100,
+} TextViewerCustomEvent;
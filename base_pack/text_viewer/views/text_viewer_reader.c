@@ -0,0 +1,130 @@
+#include "text_viewer_reader.h"
+#include <gui/elements.h>
+
+#define STATUS_LEN 24
+#define ROW_HEIGHT 9
+#define TOP_OFFSET 8
+
+struct TextViewerReader {
+    View* view;
+    TextViewerReaderCallback callback;
+    void* context;
+};
+
+typedef struct {
+    TextViewerWindow window;
+    char status[STATUS_LEN];
+} TextViewerReaderModel;
+
+static void text_viewer_reader_draw(Canvas* canvas, void* _model) {
+    TextViewerReaderModel* model = _model;
+    TextViewerWindow* window = &model->window;
+
+    canvas_clear(canvas);
+    canvas_set_color(canvas, ColorBlack);
+    canvas_set_font(canvas, FontKeyboard);
+
+    canvas_draw_str(canvas, 0, TOP_OFFSET - 1, model->status);
+    canvas_draw_line(canvas, 0, TOP_OFFSET, canvas_width(canvas), TOP_OFFSET);
+
+    for(uint8_t i = 0; i < window->rows_count; i++) {
+        canvas_draw_str(canvas, 0, TOP_OFFSET + ROW_HEIGHT * (i + 1), window->rows[i]);
+    }
+
+    // Position by bytes, line count is unknown until the index is complete
+    if(window->file_size > 0) {
+        elements_scrollbar_pos(
+            canvas,
+            canvas_width(canvas),
+            TOP_OFFSET + 2,
+            canvas_height(canvas) - TOP_OFFSET - 2,
+            window->offset / 256,
+            window->file_size / 256 + 1);
+    }
+}
+
+static bool text_viewer_reader_input(InputEvent* event, void* context) {
+    TextViewerReader* reader = context;
+    furi_assert(reader->callback);
+
+    if(event->type != InputTypeShort && event->type != InputTypeRepeat) return false;
+
+    switch(event->key) {
+    case InputKeyUp:
+        reader->callback(TextViewerReaderEventUp, reader->context);
+        return true;
+    case InputKeyDown:
+        reader->callback(TextViewerReaderEventDown, reader->context);
+        return true;
+    case InputKeyLeft:
+        reader->callback(TextViewerReaderEventPageUp, reader->context);
+        return true;
+    case InputKeyRight:
+        reader->callback(TextViewerReaderEventPageDown, reader->context);
+        return true;
+    case InputKeyOk:
+        if(event->type == InputTypeShort) {
+            reader->callback(TextViewerReaderEventMenu, reader->context);
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+TextViewerReader* text_viewer_reader_alloc() {
+    TextViewerReader* reader = malloc(sizeof(TextViewerReader));
+    reader->view = view_alloc();
+    reader->callback = NULL;
+    reader->context = NULL;
+    view_allocate_model(reader->view, ViewModelTypeLocking, sizeof(TextViewerReaderModel));
+    view_set_context(reader->view, reader);
+    view_set_draw_callback(reader->view, text_viewer_reader_draw);
+    view_set_input_callback(reader->view, text_viewer_reader_input);
+
+    with_view_model(
+        reader->view,
+        TextViewerReaderModel * model,
+        {
+            memset(&model->window, 0, sizeof(model->window));
+            model->status[0] = '\0';
+        },
+        false);
+
+    return reader;
+}
+
+void text_viewer_reader_free(TextViewerReader* reader) {
+    furi_assert(reader);
+    view_free(reader->view);
+    free(reader);
+}
+
+View* text_viewer_reader_get_view(TextViewerReader* reader) {
+    furi_assert(reader);
+    return reader->view;
+}
+
+void text_viewer_reader_set_callback(
+    TextViewerReader* reader,
+    TextViewerReaderCallback callback,
+    void* context) {
+    furi_assert(reader);
+    reader->callback = callback;
+    reader->context = context;
+}
+
+void text_viewer_reader_set_window(
+    TextViewerReader* reader,
+    const TextViewerWindow* window,
+    const char* status) {
+    furi_assert(reader);
+    with_view_model(
+        reader->view,
+        TextViewerReaderModel * model,
+        {
+            model->window = *window;
+            strlcpy(model->status, status, STATUS_LEN);
+        },
+        true);
+}
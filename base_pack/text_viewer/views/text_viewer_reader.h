@@ -0,0 +1,31 @@
+#pragma once
+
+#include <gui/view.h>
+#include "../helpers/text_viewer_file.h"
+
+typedef struct TextViewerReader TextViewerReader;
+
+typedef enum {
+    TextViewerReaderEventUp,
+    TextViewerReaderEventDown,
+    TextViewerReaderEventPageUp,
+    TextViewerReaderEventPageDown,
+    TextViewerReaderEventMenu,
+} TextViewerReaderEvent;
+
+typedef void (*TextViewerReaderCallback)(TextViewerReaderEvent event, void* context);
+
+TextViewerReader* text_viewer_reader_alloc();
+void text_viewer_reader_free(TextViewerReader* reader);
+View* text_viewer_reader_get_view(TextViewerReader* reader);
+
+void text_viewer_reader_set_callback(
+    TextViewerReader* reader,
+    TextViewerReaderCallback callback,
+    void* context);
+
+// Copies visible rows and status line shown on top of them
+void text_viewer_reader_set_window(
+    TextViewerReader* reader,
+    const TextViewerWindow* window,
+    const char* status);
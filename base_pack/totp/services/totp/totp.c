@@ -3,8 +3,13 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <math.h>
+#include <string.h>
+#include <stdbool.h>
+#include <furi_hal_random.h>
+#include <memset_s.h>
 #include "../../config/wolfssl/config.h"
 #include <wolfssl/wolfcrypt/hmac.h>
+#include <wolfssl/wolfcrypt/hash.h>
 #ifdef NO_INLINE
 #include <wolfssl/wolfcrypt/misc.h>
 #else
@@ -13,6 +18,19 @@
 #endif
 
 #define HMAC_MAX_RESULT_SIZE WC_SHA512_DIGEST_SIZE
+#define HMAC_MAX_BLOCK_SIZE WC_SHA512_BLOCK_SIZE
+#define HMAC_IPAD (0x36)
+#define HMAC_OPAD (0x5C)
+
+struct TotpHmacMidstate {
+    enum wc_HashType type;
+    wc_HashAlg inner;
+    wc_HashAlg outer;
+    // Random pad XOR-ed over inner and outer states. It lives next to the states, so this is
+    // obfuscation only (keeps ready-to-use HMAC states out of plain memory dumps and stray
+    // reads); it gives no protection against anyone who can read the whole struct.
+    uint8_t obfuscation_pad[sizeof(wc_HashAlg)];
+};
 
 static int32_t timezone_offset_from_hours(float hours) {
     return hours * 3600.0f;
@@ -42,6 +60,21 @@ uint64_t totp_timecode(uint8_t interval, uint64_t for_time) {
     return for_time / interval;
 }
 
+/**
+ * @brief Performs HOTP dynamic truncation of a HMAC result
+ * @param hmac HMAC result
+ * @param hmac_len HMAC result length
+ * @return Truncated OTP code
+ */
+static uint64_t otp_truncate(const uint8_t* hmac, int hmac_len) {
+    uint64_t offset = (hmac[hmac_len - 1] & 0xF);
+    uint64_t i_code =
+        ((hmac[offset] & 0x7F) << 24 | (hmac[offset + 1] & 0xFF) << 16 |
+         (hmac[offset + 2] & 0xFF) << 8 | (hmac[offset + 3] & 0xFF));
+
+    return i_code;
+}
+
 /**
  * @brief Generates an OTP (One Time Password)
  * @param algo hashing algorithm to be used
@@ -65,12 +98,13 @@ uint64_t otp_generate(
         return OTP_ERROR;
     }
 
-    uint64_t offset = (hmac[hmac_len - 1] & 0xF);
-    uint64_t i_code =
-        ((hmac[offset] & 0x7F) << 24 | (hmac[offset + 1] & 0xFF) << 16 |
-         (hmac[offset + 2] & 0xFF) << 8 | (hmac[offset + 3] & 0xFF));
+    return otp_truncate(&hmac[0], hmac_len);
+}
 
-    return i_code;
+uint64_t totp_timeblock_at(uint64_t for_time, float timezone, uint8_t interval) {
+    uint64_t for_time_adjusted =
+        timezone_offset_apply(for_time, timezone_offset_from_hours(timezone));
+    return totp_timecode(interval, for_time_adjusted);
 }
 
 uint64_t totp_at(
@@ -80,10 +114,8 @@ uint64_t totp_at(
     uint64_t for_time,
     float timezone,
     uint8_t interval) {
-    uint64_t for_time_adjusted =
-        timezone_offset_apply(for_time, timezone_offset_from_hours(timezone));
     return otp_generate(
-        algo, plain_secret, plain_secret_length, totp_timecode(interval, for_time_adjusted));
+        algo, plain_secret, plain_secret_length, totp_timeblock_at(for_time, timezone, interval));
 }
 
 uint64_t hotp_at(
@@ -145,3 +177,137 @@ static int totp_algo_sha512(
 const TOTP_ALGO TOTP_ALGO_SHA1 = (TOTP_ALGO)(&totp_algo_sha1);
 const TOTP_ALGO TOTP_ALGO_SHA256 = (TOTP_ALGO)(&totp_algo_sha256);
 const TOTP_ALGO TOTP_ALGO_SHA512 = (TOTP_ALGO)(&totp_algo_sha512);
+
+static enum wc_HashType totp_algo_hash_type(TOTP_ALGO algo) {
+    if(algo == TOTP_ALGO_SHA1) {
+        return WC_HASH_TYPE_SHA;
+    }
+
+    if(algo == TOTP_ALGO_SHA256) {
+        return WC_HASH_TYPE_SHA256;
+    }
+
+    if(algo == TOTP_ALGO_SHA512) {
+        return WC_HASH_TYPE_SHA512;
+    }
+
+    return WC_HASH_TYPE_NONE;
+}
+
+/**
+ * @brief XORs hash state with the midstate obfuscation pad, used both to obfuscate and restore it
+ * @param midstate HMAC midstate holding the obfuscation pad
+ * @param state hash state to be (de)obfuscated in-place
+ */
+static void totp_hmac_midstate_xor_pad(const TotpHmacMidstate* midstate, wc_HashAlg* state) {
+    uint8_t* state_bytes = (uint8_t*)state;
+    for(size_t i = 0; i < sizeof(wc_HashAlg); i++) {
+        state_bytes[i] ^= midstate->obfuscation_pad[i];
+    }
+}
+
+/**
+ * @brief Absorbs key block XOR-ed with a given pad into a fresh hash state
+ * @param type hash type
+ * @param key_block key block padded to hash block size
+ * @param block_size hash block size
+ * @param pad pad byte to XOR key block with
+ * @param[out] state hash state to initialize
+ * @return \c true if hash state has been successfully initialized; \c false otherwise
+ */
+static bool totp_hmac_absorb_pad(
+    enum wc_HashType type,
+    const uint8_t* key_block,
+    size_t block_size,
+    uint8_t pad,
+    wc_HashAlg* state) {
+    uint8_t padded_block[HMAC_MAX_BLOCK_SIZE];
+    for(size_t i = 0; i < block_size; i++) {
+        padded_block[i] = key_block[i] ^ pad;
+    }
+
+    bool result = wc_HashInit(state, type) == 0 &&
+                  wc_HashUpdate(state, type, &padded_block[0], block_size) == 0;
+    memset_s(&padded_block[0], sizeof(padded_block), 0, sizeof(padded_block));
+    return result;
+}
+
+TotpHmacMidstate* totp_hmac_midstate_alloc(
+    TOTP_ALGO algo,
+    const uint8_t* plain_secret,
+    size_t plain_secret_length) {
+    enum wc_HashType type = totp_algo_hash_type(algo);
+    int block_size = wc_HashGetBlockSize(type);
+    if(type == WC_HASH_TYPE_NONE || block_size <= 0 || block_size > HMAC_MAX_BLOCK_SIZE) {
+        return NULL;
+    }
+
+    TotpHmacMidstate* midstate = malloc(sizeof(TotpHmacMidstate));
+    if(midstate == NULL) {
+        return NULL;
+    }
+
+    midstate->type = type;
+
+    uint8_t key_block[HMAC_MAX_BLOCK_SIZE] = {0};
+    bool success = true;
+    if(plain_secret_length > (size_t)block_size) {
+        wc_HashAlg key_hash;
+        success = wc_HashInit(&key_hash, type) == 0 &&
+                  wc_HashUpdate(&key_hash, type, plain_secret, plain_secret_length) == 0 &&
+                  wc_HashFinal(&key_hash, type, &key_block[0]) == 0;
+        wc_HashFree(&key_hash, type);
+        memset_s(&key_hash, sizeof(key_hash), 0, sizeof(key_hash));
+    } else if(plain_secret_length > 0) {
+        memcpy(&key_block[0], plain_secret, plain_secret_length);
+    }
+
+    success = success &&
+              totp_hmac_absorb_pad(type, &key_block[0], block_size, HMAC_IPAD, &midstate->inner) &&
+              totp_hmac_absorb_pad(type, &key_block[0], block_size, HMAC_OPAD, &midstate->outer);
+
+    memset_s(&key_block[0], sizeof(key_block), 0, sizeof(key_block));
+
+    if(!success) {
+        totp_hmac_midstate_free(midstate);
+        return NULL;
+    }
+
+    furi_hal_random_fill_buf(&midstate->obfuscation_pad[0], sizeof(midstate->obfuscation_pad));
+    totp_hmac_midstate_xor_pad(midstate, &midstate->inner);
+    totp_hmac_midstate_xor_pad(midstate, &midstate->outer);
+
+    return midstate;
+}
+
+void totp_hmac_midstate_free(TotpHmacMidstate* midstate) {
+    if(midstate == NULL) return;
+    memset_s(midstate, sizeof(TotpHmacMidstate), 0, sizeof(TotpHmacMidstate));
+    free(midstate);
+}
+
+uint64_t otp_at_midstate(const TotpHmacMidstate* midstate, uint64_t counter) {
+    uint8_t hmac[HMAC_MAX_RESULT_SIZE] = {0};
+    uint64_t counter_swapped = ByteReverseWord64(counter);
+    const enum wc_HashType type = midstate->type;
+    const int digest_size = wc_HashGetDigestSize(type);
+    wc_HashAlg state;
+
+    memcpy(&state, &midstate->inner, sizeof(wc_HashAlg));
+    totp_hmac_midstate_xor_pad(midstate, &state);
+    bool success = wc_HashUpdate(&state, type, (uint8_t*)&counter_swapped, 8) == 0 &&
+                   wc_HashFinal(&state, type, &hmac[0]) == 0;
+
+    if(success) {
+        memcpy(&state, &midstate->outer, sizeof(wc_HashAlg));
+        totp_hmac_midstate_xor_pad(midstate, &state);
+        success = wc_HashUpdate(&state, type, &hmac[0], digest_size) == 0 &&
+                  wc_HashFinal(&state, type, &hmac[0]) == 0;
+    }
+
+    memset_s(&state, sizeof(state), 0, sizeof(state));
+
+    uint64_t i_code = success ? otp_truncate(&hmac[0], digest_size) : OTP_ERROR;
+    memset_s(&hmac[0], sizeof(hmac), 0, sizeof(hmac));
+    return i_code;
+}
@@ -5,6 +5,11 @@
 
 #define OTP_ERROR (0)
 
+/**
+ * @brief HMAC inner and outer hash states precomputed for a single secret
+ */
+typedef struct TotpHmacMidstate TotpHmacMidstate;
+
 /**
  * @brief Must compute HMAC using passed arguments, output as char array through output.
  *        \p key is secret key buffer.
@@ -67,3 +72,42 @@ uint64_t hotp_at(
     const uint8_t* plain_secret,
     size_t plain_secret_length,
     uint64_t counter);
+
+/**
+ * @brief Calculates the TOTP timeblock (HOTP counter) for a given time.
+ * @param for_time the time to calculate timeblock for
+ * @param timezone UTC timezone adjustment
+ * @param interval token lifetime in seconds
+ * @return TOTP timeblock
+ */
+uint64_t totp_timeblock_at(uint64_t for_time, float timezone, uint8_t interval);
+
+/**
+ * @brief Precomputes HMAC inner and outer hash states (ipad/opad absorbed) for a given secret.
+ *        Precomputed states are XOR-obfuscated with a random pad stored alongside them and are
+ *        restored on stack only while generating code. This is obfuscation, not encryption:
+ *        the states are as sensitive as the plain secret and must be freed as soon as possible.
+ * @param algo hashing algorithm to be used
+ * @param plain_secret plain token secret
+ * @param plain_secret_length plain token secret length
+ * @return Precomputed HMAC midstate if precomputation succeeded; \c NULL otherwise
+ */
+TotpHmacMidstate* totp_hmac_midstate_alloc(
+    TOTP_ALGO algo,
+    const uint8_t* plain_secret,
+    size_t plain_secret_length);
+
+/**
+ * @brief Wipes and releases precomputed HMAC midstate
+ * @param midstate HMAC midstate
+ */
+void totp_hmac_midstate_free(TotpHmacMidstate* midstate);
+
+/**
+ * @brief Generates an OTP code using precomputed HMAC midstate.
+ *        Costs a single hash finalization per HMAC half.
+ * @param midstate precomputed HMAC midstate
+ * @param counter the HOTP counter or TOTP timeblock
+ * @return OTP code if code was successfully generated; 0 otherwise
+ */
+uint64_t otp_at_midstate(const TotpHmacMidstate* midstate, uint64_t counter);
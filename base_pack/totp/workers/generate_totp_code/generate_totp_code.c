@@ -8,6 +8,20 @@
 #include <memset_s.h>
 
 #define ONE_SEC_MS (1000)
+#define LOOKAHEAD_CODES_COUNT (3)
+
+/**
+ * @brief Per-session cache of the active token HMAC midstate and codes precomputed for upcoming counters
+ */
+typedef struct {
+    TotpHmacMidstate* hmac_midstate;
+    uint8_t* encrypted_token;
+    size_t encrypted_token_length;
+    TokenHashAlgo algo;
+    uint64_t lookahead_first_counter;
+    uint64_t lookahead_codes[LOOKAHEAD_CODES_COUNT];
+    uint8_t lookahead_count;
+} OtpCodeCache;
 
 struct TotpGenerateCodeWorkerContext {
     char* code_buffer;
@@ -20,6 +34,7 @@ struct TotpGenerateCodeWorkerContext {
     void* on_new_code_generated_handler_context;
     TOTP_CODE_LIFETIME_CHANGED_HANDLER on_code_lifetime_changed_handler;
     void* on_code_lifetime_changed_handler_context;
+    OtpCodeCache code_cache;
 };
 
 static const char STEAM_ALGO_ALPHABET[] = "23456789BCDFGHJKMNPQRTVWXY";
@@ -63,37 +78,107 @@ static TOTP_ALGO get_totp_algo_impl(TokenHashAlgo algo) {
     return NULL;
 }
 
-static void generate_totp_code(
-    TotpGenerateCodeWorkerContext* context,
+static void otp_code_cache_reset(OtpCodeCache* cache) {
+    totp_hmac_midstate_free(cache->hmac_midstate);
+    if(cache->encrypted_token != NULL) {
+        free(cache->encrypted_token);
+    }
+
+    memset_s(cache, sizeof(OtpCodeCache), 0, sizeof(OtpCodeCache));
+}
+
+static bool otp_code_cache_is_valid_for(const OtpCodeCache* cache, const TokenInfo* token_info) {
+    return cache->hmac_midstate != NULL && cache->algo == token_info->algo &&
+           cache->encrypted_token_length == token_info->token_length &&
+           memcmp(cache->encrypted_token, token_info->token, token_info->token_length) == 0;
+}
+
+static bool otp_code_cache_prepare(
+    OtpCodeCache* cache,
+    const TokenInfo* token_info,
+    const CryptoSettings* crypto_settings) {
+    if(otp_code_cache_is_valid_for(cache, token_info)) {
+        return true;
+    }
+
+    otp_code_cache_reset(cache);
+
+    size_t key_length;
+    uint8_t* key = totp_crypto_decrypt(
+        token_info->token, token_info->token_length, crypto_settings, &key_length);
+    cache->hmac_midstate =
+        totp_hmac_midstate_alloc(get_totp_algo_impl(token_info->algo), key, key_length);
+    memset_s(key, key_length, 0, key_length);
+    free(key);
+
+    if(cache->hmac_midstate == NULL) {
+        return false;
+    }
+
+    cache->encrypted_token = malloc(token_info->token_length);
+    furi_check(cache->encrypted_token != NULL);
+    memcpy(cache->encrypted_token, token_info->token, token_info->token_length);
+    cache->encrypted_token_length = token_info->token_length;
+    cache->algo = token_info->algo;
+    return true;
+}
+
+static uint64_t otp_code_cache_get(OtpCodeCache* cache, uint64_t counter) {
+    if(counter >= cache->lookahead_first_counter &&
+       counter - cache->lookahead_first_counter < cache->lookahead_count) {
+        return cache->lookahead_codes[counter - cache->lookahead_first_counter];
+    }
+
+    return otp_at_midstate(cache->hmac_midstate, counter);
+}
+
+static void otp_code_cache_fill_lookahead(OtpCodeCache* cache, uint64_t current_counter) {
+    if(cache->hmac_midstate == NULL) return;
+
+    uint64_t first_counter = current_counter + 1;
+    uint64_t codes[LOOKAHEAD_CODES_COUNT];
+    uint8_t reused = 0;
+    while(reused < LOOKAHEAD_CODES_COUNT &&
+          first_counter + reused >= cache->lookahead_first_counter &&
+          first_counter + reused - cache->lookahead_first_counter < cache->lookahead_count) {
+        codes[reused] =
+            cache->lookahead_codes[first_counter + reused - cache->lookahead_first_counter];
+        reused++;
+    }
+
+    for(uint8_t i = reused; i < LOOKAHEAD_CODES_COUNT; i++) {
+        codes[i] = otp_at_midstate(cache->hmac_midstate, first_counter + i);
+    }
+
+    memcpy(&cache->lookahead_codes[0], &codes[0], sizeof(codes));
+    memset_s(&codes[0], sizeof(codes), 0, sizeof(codes));
+    cache->lookahead_first_counter = first_counter;
+    cache->lookahead_count = LOOKAHEAD_CODES_COUNT;
+}
+
+static uint64_t get_otp_counter(
+    const TotpGenerateCodeWorkerContext* context,
     const TokenInfo* token_info,
     uint32_t current_ts) {
-    if(token_info->token != NULL && token_info->token_length > 0) {
-        size_t key_length;
-        uint8_t* key = totp_crypto_decrypt(
-            token_info->token, token_info->token_length, context->crypto_settings, &key_length);
-
-        uint64_t otp_code;
-        if(token_info->type == TokenTypeTOTP) {
-            otp_code = totp_at(
-                get_totp_algo_impl(token_info->algo),
-                key,
-                key_length,
-                current_ts,
-                context->timezone_offset,
-                token_info->duration);
-        } else if(token_info->type == TokenTypeHOTP) {
-            otp_code = hotp_at(
-                get_totp_algo_impl(token_info->algo), key, key_length, token_info->counter);
-        } else {
-            furi_crash("Unknown token type");
-        }
+    if(token_info->type == TokenTypeTOTP) {
+        return totp_timeblock_at(current_ts, context->timezone_offset, token_info->duration);
+    } else if(token_info->type == TokenTypeHOTP) {
+        return token_info->counter;
+    }
 
-        int_token_to_str(otp_code, context->code_buffer, token_info->digits, token_info->algo);
-        memset_s(key, key_length, 0, key_length);
-        free(key);
-    } else {
-        int_token_to_str(0, context->code_buffer, token_info->digits, token_info->algo);
+    furi_crash("Unknown token type");
+}
+
+static uint64_t generate_otp_code(
+    TotpGenerateCodeWorkerContext* context,
+    const TokenInfo* token_info,
+    uint64_t counter) {
+    if(token_info->token == NULL || token_info->token_length == 0 ||
+       !otp_code_cache_prepare(&context->code_cache, token_info, context->crypto_settings)) {
+        return OTP_ERROR;
     }
+
+    return otp_code_cache_get(&context->code_cache, counter);
 }
 
 static int32_t totp_generate_worker_callback(void* context) {
@@ -129,17 +214,24 @@ static int32_t totp_generate_worker_callback(void* context) {
         bool time_left = false;
         if(flags & TotpGenerateCodeWorkerEventForceUpdate ||
            (is_time_based && (time_left = (curr_ts % token_info->duration) == 0))) {
+            uint64_t counter = get_otp_counter(t_context, token_info, curr_ts);
+            uint64_t otp_code = generate_otp_code(t_context, token_info, counter);
             if(furi_mutex_acquire(t_context->code_buffer_sync, FuriWaitForever) == FuriStatusOk) {
-                generate_totp_code(t_context, token_info, curr_ts);
-                if(is_time_based) {
-                    curr_ts = furi_hal_rtc_get_timestamp();
-                }
+                int_token_to_str(
+                    otp_code, t_context->code_buffer, token_info->digits, token_info->algo);
                 furi_mutex_release(t_context->code_buffer_sync);
                 if(t_context->on_new_code_generated_handler != NULL) {
                     (*(t_context->on_new_code_generated_handler))(
                         time_left, t_context->on_new_code_generated_handler_context);
                 }
             }
+
+            memset_s(&otp_code, sizeof(otp_code), 0, sizeof(otp_code));
+            otp_code_cache_fill_lookahead(&t_context->code_cache, counter);
+
+            if(is_time_based) {
+                curr_ts = furi_hal_rtc_get_timestamp();
+            }
         }
 
         if(t_context->on_code_lifetime_changed_handler != NULL &&
@@ -151,6 +243,8 @@ static int32_t totp_generate_worker_callback(void* context) {
         }
     }
 
+    otp_code_cache_reset(&t_context->code_cache);
+
     return 0;
 }
 
@@ -167,6 +261,7 @@ TotpGenerateCodeWorkerContext* totp_generate_code_worker_start(
     context->code_buffer_sync = code_buffer_sync;
     context->timezone_offset = timezone_offset;
     context->crypto_settings = crypto_settings;
+    memset(&context->code_cache, 0, sizeof(OtpCodeCache));
     context->thread = furi_thread_alloc();
     furi_thread_set_name(context->thread, "TOTPGenerateWorker");
     furi_thread_set_stack_size(context->thread, 2048);
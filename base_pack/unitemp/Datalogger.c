@@ -0,0 +1,870 @@
+/*
+    Unitemp - Universal temperature reader
+    Copyright (C) 2022-2023  Victor Nikitchuk (https://github.com/quen0n)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "Datalogger.h"
+#include <datetime/datetime.h>
+#include <math.h>
+
+/*
+ * Формат журнала
+ *
+ * Журнал состоит из блоков фиксированного размера UNITEMP_LOG_BLOCK_SIZE. Блок заполняется в ОЗУ
+ * и пишется на SD-карту целиком. Неполный блок раз в UNITEMP_LOG_FLUSH_INTERVAL переписывается
+ * на своём месте в файле, чтобы при сбое питания терялось не больше этого времени.
+ * Блок начинается с заголовка и таблицы датчиков, за ними идут записи:
+ *   varint  - секунды от предыдущей записи (от start_time для первой записи)
+ *   varint  - маска каналов, для которых в записи есть значения
+ *   varint  - zigzag-разность с предыдущим значением канала, для каждого канала из маски
+ * Канал - величина датчика, каналы идут в порядке датчиков таблицы и величин log_quantities.
+ * Значения хранятся целыми числами в единицах из настроек, умноженными на масштаб величины.
+ * Каждый блок декодируется независимо от остальных.
+ */
+
+//Сигнатура блока журнала
+#define UNITEMP_LOG_MAGIC "UTLG"
+//Версия формата блока
+#define UNITEMP_LOG_VERSION 1
+//Максимальный размер записи: время, маска и разности всех каналов
+#define UNITEMP_LOG_FRAME_MAX (5 + 5 + 5 * UNITEMP_LOG_CHANNELS_MAX)
+//Количество последних блоков с SD-карты, по которым строится график
+#define UNITEMP_LOG_GRAPH_FILE_BLOCKS 32
+//Размер текста CSV, после которого он пишется на SD-карту
+#define UNITEMP_LOG_CSV_CHUNK 2048
+//Период записи неполного блока на SD-карту, мс
+#define UNITEMP_LOG_FLUSH_INTERVAL (60 * 1000)
+//Блока кольца ещё нет в файле журнала
+#define UNITEMP_LOG_NO_OFFSET UINT32_MAX
+
+//Заголовок блока журнала
+typedef struct {
+    //Сигнатура UNITEMP_LOG_MAGIC
+    char magic[4];
+    //Версия формата
+    uint8_t version;
+    //Количество датчиков в таблице
+    uint8_t sensors_count;
+    //Единица измерения температуры
+    uint8_t temp_unit;
+    //Единица измерения давления
+    uint8_t pressure_unit;
+    //Время начала блока (unix)
+    uint32_t start_time;
+    //Занято байт в блоке вместе с заголовком
+    uint16_t used;
+    //Количество записей
+    uint16_t samples;
+} UnitempLogBlockHeader;
+
+//Датчик в таблице блока
+typedef struct {
+    char name[11];
+    //Набор величин датчика (SensorDataType)
+    uint8_t datatype;
+} UnitempLogSensorEntry;
+
+//Состояние журнала
+typedef struct {
+    //Кольцо блоков
+    uint8_t* ring;
+    //Индекс заполняемого блока
+    uint8_t current;
+    //Блок кольца заполнен и целиком записан на SD-карту, ячейку можно занимать
+    bool written[UNITEMP_LOG_RAM_BLOCKS];
+    //Смещение копии блока кольца в файле журнала, UNITEMP_LOG_NO_OFFSET если копии нет
+    uint32_t file_offset[UNITEMP_LOG_RAM_BLOCKS];
+    //Количество записей блока кольца, которые уже есть на SD-карте
+    uint16_t flushed[UNITEMP_LOG_RAM_BLOCKS];
+    //Тик следующей записи
+    uint32_t next_sample;
+    //Тик следующей записи неполного блока на SD-карту
+    uint32_t next_flush;
+    //Время последней записи текущего блока
+    uint32_t last_time;
+    //Последние значения каналов текущего блока
+    int32_t last_values[UNITEMP_LOG_CHANNELS_MAX];
+    //Таблица датчиков для сравнения с текущим блоком
+    UnitempLogSensorEntry table[UNITEMP_LOG_CHANNELS_MAX];
+    //Поток экспорта в CSV, NULL если экспорт не идёт
+    FuriThread* export_thread;
+    //Количество уже выгруженных значений
+    volatile int32_t export_rows;
+    //Поток сборки ряда для графика, NULL если ряд не собирается
+    FuriThread* series_thread;
+    //Ряд, который собирает поток
+    UnitempLogSeries series;
+    char series_name[11];
+    uint8_t series_quantity;
+    //Остановка фонового чтения журнала
+    volatile bool cancel;
+} UnitempDatalogger;
+
+//Колбек декодера на каждую запись блока
+typedef void(UnitempLogSampleCallback)(
+    const uint8_t* block,
+    uint32_t time,
+    const int32_t* values,
+    uint32_t mask,
+    void* context);
+
+//Величины в порядке каналов
+static const uint8_t log_quantities[] = {UT_TEMPERATURE, UT_HUMIDITY, UT_PRESSURE, UT_CO2};
+
+static UnitempDatalogger* logger = NULL;
+
+uint32_t unitemp_datalogger_getIntervalMs(logInterval interval) {
+    switch(interval) {
+    case UT_LOG_1S:
+        return 1000;
+    case UT_LOG_10S:
+        return 10 * 1000;
+    case UT_LOG_1M:
+        return 60 * 1000;
+    case UT_LOG_5M:
+        return 5 * 60 * 1000;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Масштаб хранения величины: 0.1 для температуры и влажности, 0.01 для давления
+ */
+static int32_t unitemp_datalogger_getScale(uint8_t quantity) {
+    if(quantity == UT_PRESSURE) return 100;
+    if(quantity == UT_CO2) return 1;
+    return 10;
+}
+
+static float unitemp_datalogger_getValue(Sensor* sensor, uint8_t quantity) {
+    if(quantity == UT_TEMPERATURE) return sensor->temp;
+    if(quantity == UT_HUMIDITY) return sensor->hum;
+    if(quantity == UT_PRESSURE) return sensor->pressure;
+    return sensor->co2;
+}
+
+static uint8_t unitemp_datalogger_putVarint(uint8_t* buf, uint32_t value) {
+    uint8_t len = 0;
+    while(value >= 0x80) {
+        buf[len++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    buf[len++] = value;
+    return len;
+}
+
+static bool unitemp_datalogger_getVarint(
+    const uint8_t* buf,
+    uint16_t* pos,
+    uint16_t end,
+    uint32_t* value) {
+    *value = 0;
+    for(uint8_t shift = 0; shift < 35; shift += 7) {
+        if(*pos >= end) return false;
+        uint8_t byte = buf[(*pos)++];
+        *value |= (uint32_t)(byte & 0x7F) << shift;
+        if(!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+static uint8_t
+    unitemp_datalogger_getChannelsCount(const UnitempLogSensorEntry* table, uint8_t count) {
+    uint8_t channels = 0;
+    for(uint8_t i = 0; i < count; i++) {
+        for(uint8_t q = 0; q < COUNT_OF(log_quantities); q++) {
+            if(table[i].datatype & log_quantities[q]) channels++;
+        }
+    }
+    return channels;
+}
+
+static bool unitemp_datalogger_isValidBlock(const uint8_t* block) {
+    const UnitempLogBlockHeader* header = (const UnitempLogBlockHeader*)block;
+    if(memcmp(header->magic, UNITEMP_LOG_MAGIC, 4) != 0) return false;
+    if(header->version != UNITEMP_LOG_VERSION) return false;
+    if(header->used > UNITEMP_LOG_BLOCK_SIZE) return false;
+    if(header->sensors_count > UNITEMP_LOG_CHANNELS_MAX) return false;
+    const UnitempLogSensorEntry* table =
+        (const UnitempLogSensorEntry*)(block + sizeof(UnitempLogBlockHeader));
+    if(header->used < sizeof(UnitempLogBlockHeader) +
+                          header->sensors_count * sizeof(UnitempLogSensorEntry))
+        return false;
+    return unitemp_datalogger_getChannelsCount(table, header->sensors_count) <=
+           UNITEMP_LOG_CHANNELS_MAX;
+}
+
+/**
+ * @brief Поиск канала величины датчика в блоке
+ *
+ * @return Номер канала, -1 если датчика или величины в блоке нет
+ */
+static int8_t
+    unitemp_datalogger_findChannel(const uint8_t* block, const char* name, uint8_t quantity) {
+    const UnitempLogBlockHeader* header = (const UnitempLogBlockHeader*)block;
+    const UnitempLogSensorEntry* table =
+        (const UnitempLogSensorEntry*)(block + sizeof(UnitempLogBlockHeader));
+    int8_t channel = 0;
+    for(uint8_t i = 0; i < header->sensors_count; i++) {
+        for(uint8_t q = 0; q < COUNT_OF(log_quantities); q++) {
+            if(!(table[i].datatype & log_quantities[q])) continue;
+            if(log_quantities[q] == quantity && !strncmp(table[i].name, name, 10)) return channel;
+            channel++;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Декодирование всех записей блока
+ */
+static void unitemp_datalogger_decodeBlock(
+    const uint8_t* block,
+    UnitempLogSampleCallback* callback,
+    void* context) {
+    if(!unitemp_datalogger_isValidBlock(block)) return;
+    const UnitempLogBlockHeader* header = (const UnitempLogBlockHeader*)block;
+    uint8_t channels = unitemp_datalogger_getChannelsCount(
+        (const UnitempLogSensorEntry*)(block + sizeof(UnitempLogBlockHeader)),
+        header->sensors_count);
+
+    int32_t values[UNITEMP_LOG_CHANNELS_MAX] = {0};
+    uint32_t time = header->start_time;
+    uint16_t pos =
+        sizeof(UnitempLogBlockHeader) + header->sensors_count * sizeof(UnitempLogSensorEntry);
+
+    while(pos < header->used) {
+        uint32_t dt, mask, delta;
+        if(!unitemp_datalogger_getVarint(block, &pos, header->used, &dt)) return;
+        if(!unitemp_datalogger_getVarint(block, &pos, header->used, &mask)) return;
+        time += dt;
+        for(uint8_t ch = 0; ch < channels; ch++) {
+            if(!(mask & (1UL << ch))) continue;
+            if(!unitemp_datalogger_getVarint(block, &pos, header->used, &delta)) return;
+            //zigzag
+            values[ch] += (int32_t)(delta >> 1) ^ -(int32_t)(delta & 1);
+        }
+        callback(block, time, values, mask, context);
+    }
+}
+
+/**
+ * @brief Запись блока кольца на SD-карту одной записью. Блок, который уже есть в файле,
+ * переписывается на своём месте, новый дописывается в конец. Переполненный журнал уходит
+ * в log.bin.old
+ *
+ * @param index Номер ячейки кольца
+ * @return Истина если блок записан
+ */
+static bool unitemp_datalogger_writeBlock(uint8_t index) {
+    const uint8_t* block = logger->ring + index * UNITEMP_LOG_BLOCK_SIZE;
+    FuriString* filepath = furi_string_alloc();
+    furi_string_printf(filepath, "%s/%s", APP_PATH_FOLDER, APP_FILENAME_LOG);
+    storage_common_mkdir(app->storage, APP_PATH_FOLDER);
+
+    Stream* stream = file_stream_alloc(app->storage);
+    bool success = file_stream_open(
+        stream, furi_string_get_cstr(filepath), FSAM_READ_WRITE, FSOM_OPEN_ALWAYS);
+    uint32_t offset = logger->file_offset[index];
+    if(success && offset == UNITEMP_LOG_NO_OFFSET) {
+        //Недописанный при сбое кусок блока в конце файла затирается
+        offset = stream_size(stream) / UNITEMP_LOG_BLOCK_SIZE * UNITEMP_LOG_BLOCK_SIZE;
+        if(offset >= UNITEMP_LOG_FILE_BLOCKS_MAX * UNITEMP_LOG_BLOCK_SIZE) {
+            file_stream_close(stream);
+            FuriString* oldpath =
+                furi_string_alloc_printf("%s.old", furi_string_get_cstr(filepath));
+            storage_common_remove(app->storage, furi_string_get_cstr(oldpath));
+            storage_common_rename(
+                app->storage, furi_string_get_cstr(filepath), furi_string_get_cstr(oldpath));
+            furi_string_free(oldpath);
+            success = file_stream_open(
+                stream, furi_string_get_cstr(filepath), FSAM_READ_WRITE, FSOM_CREATE_ALWAYS);
+            offset = 0;
+        }
+    }
+    if(success) {
+        success = stream_seek(stream, offset, StreamOffsetFromStart) &&
+                  stream_write(stream, block, UNITEMP_LOG_BLOCK_SIZE) == UNITEMP_LOG_BLOCK_SIZE;
+    }
+    if(success) {
+        logger->file_offset[index] = offset;
+        logger->flushed[index] = ((const UnitempLogBlockHeader*)block)->samples;
+    } else {
+        FURI_LOG_E(
+            APP_NAME,
+            "An error occurred while writing the log: %d",
+            file_stream_get_error(stream));
+    }
+
+    file_stream_close(stream);
+    stream_free(stream);
+    furi_string_free(filepath);
+    return success;
+}
+
+/**
+ * @brief Запись на SD-карту блоков кольца, которых там нет, от старого к текущему
+ * Заполненный блок после записи освобождает ячейку, текущий пишется как есть и остаётся
+ * в кольце. Блоки пишутся по порядку: пока не записан старый, следующий ждёт в кольце
+ *
+ * @return Истина если все блоки на SD-карте
+ */
+static bool unitemp_datalogger_flush(void) {
+    for(uint8_t i = 1; i <= UNITEMP_LOG_RAM_BLOCKS; i++) {
+        uint8_t index = (logger->current + i) % UNITEMP_LOG_RAM_BLOCKS;
+        const uint8_t* block = logger->ring + index * UNITEMP_LOG_BLOCK_SIZE;
+        const UnitempLogBlockHeader* header = (const UnitempLogBlockHeader*)block;
+        if(logger->written[index] || !unitemp_datalogger_isValidBlock(block)) continue;
+        if(header->samples == 0) continue;
+
+        if(logger->flushed[index] != header->samples &&
+           !unitemp_datalogger_writeBlock(index)) {
+            return false;
+        }
+        if(index != logger->current) logger->written[index] = true;
+    }
+    return true;
+}
+
+/**
+ * @brief Заполнение таблицы датчиков из активных датчиков
+ *
+ * @return Количество датчиков в таблице
+ */
+static uint8_t unitemp_datalogger_buildTable(void) {
+    uint8_t count = 0;
+    uint8_t channels = 0;
+    for(uint8_t i = 0; i < unitemp_sensors_getActiveCount(); i++) {
+        Sensor* sensor = unitemp_sensor_getActive(i);
+        UnitempLogSensorEntry* entry = &logger->table[count];
+        memset(entry, 0, sizeof(UnitempLogSensorEntry));
+        entry->datatype = sensor->type->datatype;
+        //Датчики, не влезающие в маску каналов, не пишутся
+        channels += unitemp_datalogger_getChannelsCount(entry, 1);
+        if(channels > UNITEMP_LOG_CHANNELS_MAX) break;
+        strncpy(entry->name, sensor->name, sizeof(entry->name) - 1);
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Начало нового блока в текущей ячейке кольца
+ */
+static void unitemp_datalogger_startBlock(uint8_t sensors_count) {
+    uint8_t* block = logger->ring + logger->current * UNITEMP_LOG_BLOCK_SIZE;
+    UnitempLogBlockHeader* header = (UnitempLogBlockHeader*)block;
+    memset(block, 0, UNITEMP_LOG_BLOCK_SIZE);
+
+    memcpy(header->magic, UNITEMP_LOG_MAGIC, 4);
+    header->version = UNITEMP_LOG_VERSION;
+    header->sensors_count = sensors_count;
+    header->temp_unit = app->settings.temp_unit;
+    header->pressure_unit = app->settings.pressure_unit;
+    header->start_time = furi_hal_rtc_get_timestamp();
+    memcpy(
+        block + sizeof(UnitempLogBlockHeader),
+        logger->table,
+        sensors_count * sizeof(UnitempLogSensorEntry));
+    header->used =
+        sizeof(UnitempLogBlockHeader) + sensors_count * sizeof(UnitempLogSensorEntry);
+
+    logger->written[logger->current] = false;
+    logger->file_offset[logger->current] = UNITEMP_LOG_NO_OFFSET;
+    logger->flushed[logger->current] = 0;
+    logger->last_time = header->start_time;
+    memset(logger->last_values, 0, sizeof(logger->last_values));
+}
+
+/**
+ * @brief Переход к следующей ячейке кольца и запись заполненного блока на SD-карту
+ *
+ * @return Ложь если следующая ячейка занята блоком, который не удалось записать
+ */
+static bool unitemp_datalogger_sealBlock(void) {
+    uint8_t* block = logger->ring + logger->current * UNITEMP_LOG_BLOCK_SIZE;
+    UnitempLogBlockHeader* header = (UnitempLogBlockHeader*)block;
+    if(!unitemp_datalogger_isValidBlock(block) || header->samples == 0) return true;
+
+    //Незаписанный блок не затирается, сначала повтор записи
+    uint8_t next = (logger->current + 1) % UNITEMP_LOG_RAM_BLOCKS;
+    uint8_t* next_block = logger->ring + next * UNITEMP_LOG_BLOCK_SIZE;
+    if(!logger->written[next] && unitemp_datalogger_isValidBlock(next_block)) {
+        unitemp_datalogger_flush();
+        if(!logger->written[next]) return false;
+    }
+
+    logger->current = next;
+    //Следующий блок начнётся при первой записи
+    memset(next_block, 0, UNITEMP_LOG_BLOCK_SIZE);
+    unitemp_datalogger_flush();
+    return true;
+}
+
+/**
+ * @brief Запись значений активных датчиков в текущий блок
+ */
+static void unitemp_datalogger_sample(void) {
+    uint8_t sensors_count = unitemp_datalogger_buildTable();
+    if(sensors_count == 0) return;
+
+    uint8_t* block = logger->ring + logger->current * UNITEMP_LOG_BLOCK_SIZE;
+    UnitempLogBlockHeader* header = (UnitempLogBlockHeader*)block;
+
+    //Новый блок при смене набора датчиков, единиц измерения или нехватке места
+    if(!unitemp_datalogger_isValidBlock(block) || header->sensors_count != sensors_count ||
+       header->temp_unit != app->settings.temp_unit ||
+       header->pressure_unit != app->settings.pressure_unit ||
+       memcmp(
+           block + sizeof(UnitempLogBlockHeader),
+           logger->table,
+           sensors_count * sizeof(UnitempLogSensorEntry)) != 0 ||
+       header->used + UNITEMP_LOG_FRAME_MAX > UNITEMP_LOG_BLOCK_SIZE) {
+        //Кольцо занято блоками, которые не удалось записать, новые значения некуда класть
+        if(!unitemp_datalogger_sealBlock()) {
+            FURI_LOG_W(APP_NAME, "Log ring is full, the sample is skipped");
+            return;
+        }
+        unitemp_datalogger_startBlock(sensors_count);
+        block = logger->ring + logger->current * UNITEMP_LOG_BLOCK_SIZE;
+        header = (UnitempLogBlockHeader*)block;
+    }
+
+    //Маска каналов с действительными значениями
+    uint32_t mask = 0;
+    uint8_t channel = 0;
+    for(uint8_t i = 0; i < sensors_count; i++) {
+        Sensor* sensor = unitemp_sensor_getActive(i);
+        bool valid = sensor->status != UT_SENSORSTATUS_TIMEOUT &&
+                     sensor->status != UT_SENSORSTATUS_ERROR &&
+                     sensor->status != UT_SENSORSTATUS_BADCRC && (int16_t)sensor->temp != -128;
+        for(uint8_t q = 0; q < COUNT_OF(log_quantities); q++) {
+            if(!(sensor->type->datatype & log_quantities[q])) continue;
+            if(valid) mask |= 1UL << channel;
+            channel++;
+        }
+    }
+
+    uint32_t now = furi_hal_rtc_get_timestamp();
+    //Часы переведены назад - время записи не может быть раньше предыдущей
+    if(now < logger->last_time) now = logger->last_time;
+
+    uint8_t* frame = block + header->used;
+    uint16_t len = 0;
+    len += unitemp_datalogger_putVarint(frame + len, now - logger->last_time);
+    len += unitemp_datalogger_putVarint(frame + len, mask);
+    channel = 0;
+    for(uint8_t i = 0; i < sensors_count; i++) {
+        Sensor* sensor = unitemp_sensor_getActive(i);
+        for(uint8_t q = 0; q < COUNT_OF(log_quantities); q++) {
+            if(!(sensor->type->datatype & log_quantities[q])) continue;
+            if(mask & (1UL << channel)) {
+                int32_t value = lroundf(
+                    unitemp_datalogger_getValue(sensor, log_quantities[q]) *
+                    unitemp_datalogger_getScale(log_quantities[q]));
+                int32_t delta = value - logger->last_values[channel];
+                len += unitemp_datalogger_putVarint(
+                    frame + len, ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+                logger->last_values[channel] = value;
+            }
+            channel++;
+        }
+    }
+
+    header->used += len;
+    header->samples++;
+    logger->last_time = now;
+}
+
+void unitemp_datalogger_tick(void) {
+    if(logger == NULL) return;
+
+    uint32_t now = furi_get_tick();
+    //Экспорт и сборка графика читают кольцо и файлы журнала, до их окончания записи нет
+    if(logger->export_thread != NULL || logger->series_thread != NULL) return;
+
+    if((int32_t)(now - logger->next_flush) >= 0) {
+        logger->next_flush = now + UNITEMP_LOG_FLUSH_INTERVAL;
+        unitemp_datalogger_flush();
+    }
+
+    uint32_t interval = unitemp_datalogger_getIntervalMs(app->settings.log_interval);
+    if(interval == 0) return;
+    if((int32_t)(now - logger->next_sample) < 0) return;
+    //Пока открыто меню, датчики не опрашиваются и значения устарели
+    if(!app->sensors_ready) return;
+
+    logger->next_sample = now + interval;
+    unitemp_datalogger_sample();
+}
+
+void unitemp_datalogger_alloc(void) {
+    logger = malloc(sizeof(UnitempDatalogger));
+    memset(logger, 0, sizeof(UnitempDatalogger));
+    logger->ring = malloc(UNITEMP_LOG_RAM_BLOCKS * UNITEMP_LOG_BLOCK_SIZE);
+    memset(logger->ring, 0, UNITEMP_LOG_RAM_BLOCKS * UNITEMP_LOG_BLOCK_SIZE);
+    for(uint8_t i = 0; i < UNITEMP_LOG_RAM_BLOCKS; i++) {
+        logger->file_offset[i] = UNITEMP_LOG_NO_OFFSET;
+    }
+    //Первая запись - после первого опроса датчиков
+    logger->next_sample = furi_get_tick() + 1000;
+    logger->next_flush = logger->next_sample + UNITEMP_LOG_FLUSH_INTERVAL;
+}
+
+void unitemp_datalogger_free(void) {
+    if(logger == NULL) return;
+    logger->cancel = true;
+    if(logger->export_thread != NULL) {
+        furi_thread_join(logger->export_thread);
+        furi_thread_free(logger->export_thread);
+    }
+    if(logger->series_thread != NULL) {
+        furi_thread_join(logger->series_thread);
+        furi_thread_free(logger->series_thread);
+    }
+    unitemp_datalogger_flush();
+    free(logger->ring);
+    free(logger);
+    logger = NULL;
+}
+
+/**
+ * @brief Проверка, что блок файла журнала - копия блока, который ещё в кольце
+ *
+ * @param offset Смещение блока в файле журнала
+ */
+static bool unitemp_datalogger_isInRing(uint32_t offset) {
+    for(uint8_t i = 0; i < UNITEMP_LOG_RAM_BLOCKS; i++) {
+        if(!logger->written[i] && logger->file_offset[i] == offset) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Декодирование блоков файла журнала по порядку
+ * Блоки текущего журнала, которые ещё в кольце, пропускаются - их декодирует decodeRing
+ *
+ * @param filename Имя файла журнала
+ * @param last_blocks Сколько последних блоков файла декодировать, 0 - все
+ * @return Ложь если файл есть, но прочитать его не удалось
+ */
+static bool unitemp_datalogger_decodeFile(
+    const char* filename,
+    uint16_t last_blocks,
+    UnitempLogSampleCallback* callback,
+    void* context) {
+    bool success = true;
+    FuriString* filepath = furi_string_alloc_printf("%s/%s", APP_PATH_FOLDER, filename);
+    Stream* stream = file_stream_alloc(app->storage);
+    if(file_stream_open(stream, furi_string_get_cstr(filepath), FSAM_READ, FSOM_OPEN_EXISTING)) {
+        bool current_log = !strcmp(filename, APP_FILENAME_LOG);
+        uint8_t* block = malloc(UNITEMP_LOG_BLOCK_SIZE);
+        uint32_t blocks = stream_size(stream) / UNITEMP_LOG_BLOCK_SIZE;
+        uint32_t first = (last_blocks == 0 || blocks <= last_blocks) ? 0 : blocks - last_blocks;
+        stream_seek(stream, first * UNITEMP_LOG_BLOCK_SIZE, StreamOffsetFromStart);
+        for(uint32_t i = first; i < blocks && !logger->cancel; i++) {
+            if(stream_read(stream, block, UNITEMP_LOG_BLOCK_SIZE) != UNITEMP_LOG_BLOCK_SIZE) {
+                success = false;
+                break;
+            }
+            if(current_log && unitemp_datalogger_isInRing(i * UNITEMP_LOG_BLOCK_SIZE)) continue;
+            unitemp_datalogger_decodeBlock(block, callback, context);
+        }
+        free(block);
+    } else if(file_stream_get_error(stream) != FSE_NOT_EXIST) {
+        success = false;
+    }
+    file_stream_close(stream);
+    stream_free(stream);
+    furi_string_free(filepath);
+    return success;
+}
+
+/**
+ * @brief Декодирование блоков кольца, которых нет на SD-карте, от старого к текущему
+ */
+static void unitemp_datalogger_decodeRing(UnitempLogSampleCallback* callback, void* context) {
+    if(logger == NULL) return;
+    for(uint8_t i = 1; i <= UNITEMP_LOG_RAM_BLOCKS; i++) {
+        uint8_t index = (logger->current + i) % UNITEMP_LOG_RAM_BLOCKS;
+        if(logger->written[index]) continue;
+        unitemp_datalogger_decodeBlock(
+            logger->ring + index * UNITEMP_LOG_BLOCK_SIZE, callback, context);
+    }
+}
+
+/* ================================ График ================================ */
+
+typedef struct {
+    UnitempLogSeries* series;
+    const char* name;
+    uint8_t quantity;
+    //Канал величины в текущем блоке
+    const uint8_t* block;
+    int8_t channel;
+    //Накопитель точки
+    int64_t sum;
+    uint16_t accumulated;
+} UnitempLogSeriesContext;
+
+static void unitemp_datalogger_pushPoint(UnitempLogSeriesContext* ctx) {
+    UnitempLogSeries* series = ctx->series;
+    //Ряд заполнен - соседние точки усредняются, на точку приходится вдвое больше отсчётов
+    if(series->count == UNITEMP_LOG_GRAPH_POINTS) {
+        for(uint8_t i = 0; i < UNITEMP_LOG_GRAPH_POINTS / 2; i++) {
+            series->values[i] = (series->values[2 * i] + series->values[2 * i + 1]) / 2;
+        }
+        series->count = UNITEMP_LOG_GRAPH_POINTS / 2;
+        series->stride *= 2;
+    }
+    series->values[series->count++] = (float)ctx->sum / ctx->accumulated /
+                                      unitemp_datalogger_getScale(ctx->quantity);
+    ctx->sum = 0;
+    ctx->accumulated = 0;
+}
+
+static void unitemp_datalogger_seriesCallback(
+    const uint8_t* block,
+    uint32_t time,
+    const int32_t* values,
+    uint32_t mask,
+    void* context) {
+    UnitempLogSeriesContext* ctx = context;
+    const UnitempLogBlockHeader* header = (const UnitempLogBlockHeader*)block;
+
+    if(block != ctx->block) {
+        ctx->block = block;
+        ctx->channel = unitemp_datalogger_findChannel(block, ctx->name, ctx->quantity);
+        //Значения в других единицах измерения не смешиваются с текущими
+        if((ctx->quantity == UT_TEMPERATURE && header->temp_unit != app->settings.temp_unit) ||
+           (ctx->quantity == UT_PRESSURE && header->pressure_unit != app->settings.pressure_unit))
+            ctx->channel = -1;
+    }
+    if(ctx->channel < 0 || !(mask & (1UL << ctx->channel))) return;
+
+    if(ctx->series->stride == 0) {
+        ctx->series->stride = 1;
+        ctx->series->first_time = time;
+    }
+    ctx->series->last_time = time;
+    ctx->sum += values[ctx->channel];
+    if(++ctx->accumulated >= ctx->series->stride) unitemp_datalogger_pushPoint(ctx);
+}
+
+static int32_t unitemp_datalogger_buildSeries(void* context) {
+    UNUSED(context);
+    UnitempLogSeries* series = &logger->series;
+    memset(series, 0, sizeof(UnitempLogSeries));
+    UnitempLogSeriesContext ctx = {
+        .series = series,
+        .name = logger->series_name,
+        .quantity = logger->series_quantity,
+        .block = NULL,
+        .channel = -1,
+        .sum = 0,
+        .accumulated = 0,
+    };
+    unitemp_datalogger_decodeFile(
+        APP_FILENAME_LOG, UNITEMP_LOG_GRAPH_FILE_BLOCKS, unitemp_datalogger_seriesCallback, &ctx);
+    unitemp_datalogger_decodeRing(unitemp_datalogger_seriesCallback, &ctx);
+    if(ctx.accumulated > 0) unitemp_datalogger_pushPoint(&ctx);
+    return 0;
+}
+
+/**
+ * @brief Остановка потока сборки ряда без результата
+ */
+static void unitemp_datalogger_seriesStop(void) {
+    if(logger->series_thread == NULL) return;
+    logger->cancel = true;
+    furi_thread_join(logger->series_thread);
+    furi_thread_free(logger->series_thread);
+    logger->series_thread = NULL;
+    logger->cancel = false;
+}
+
+bool unitemp_datalogger_seriesStart(Sensor* sensor, uint8_t datatype) {
+    //Пока идёт экспорт, журнал не читается ничем другим
+    if(logger == NULL || logger->export_thread != NULL) return false;
+
+    //Ряд для прежней величины уже не нужен
+    unitemp_datalogger_seriesStop();
+    memset(logger->series_name, 0, sizeof(logger->series_name));
+    strncpy(logger->series_name, sensor->name, sizeof(logger->series_name) - 1);
+    logger->series_quantity = datatype;
+    logger->series_thread =
+        furi_thread_alloc_ex("UnitempSeries", 1024, unitemp_datalogger_buildSeries, NULL);
+    furi_thread_start(logger->series_thread);
+    return true;
+}
+
+bool unitemp_datalogger_seriesPoll(UnitempLogSeries* series) {
+    if(logger == NULL || logger->series_thread == NULL) return false;
+    if(furi_thread_get_state(logger->series_thread) != FuriThreadStateStopped) return false;
+
+    furi_thread_join(logger->series_thread);
+    furi_thread_free(logger->series_thread);
+    logger->series_thread = NULL;
+    memcpy(series, &logger->series, sizeof(UnitempLogSeries));
+    return true;
+}
+
+/* ============================== Экспорт CSV ============================== */
+
+typedef struct {
+    Stream* stream;
+    FuriString* text;
+    int32_t rows;
+    bool success;
+} UnitempLogCSVContext;
+
+static const char*
+    unitemp_datalogger_getUnit(const UnitempLogBlockHeader* header, uint8_t quantity) {
+    static const char* pressure_units[UT_PRESSURE_COUNT] = {"mmHg", "inHg", "kPa", "hPa"};
+    if(quantity == UT_TEMPERATURE) return header->temp_unit == UT_TEMP_FAHRENHEIT ? "F" : "C";
+    if(quantity == UT_HUMIDITY) return "%";
+    if(quantity == UT_PRESSURE) {
+        return header->pressure_unit < UT_PRESSURE_COUNT ? pressure_units[header->pressure_unit] :
+                                                           "";
+    }
+    return "ppm";
+}
+
+static void unitemp_datalogger_writeCSV(UnitempLogCSVContext* ctx) {
+    size_t size = furi_string_size(ctx->text);
+    if(size == 0 || !ctx->success) return;
+    if(stream_write(ctx->stream, (const uint8_t*)furi_string_get_cstr(ctx->text), size) != size) {
+        ctx->success = false;
+    }
+    furi_string_reset(ctx->text);
+}
+
+static void unitemp_datalogger_csvCallback(
+    const uint8_t* block,
+    uint32_t time,
+    const int32_t* values,
+    uint32_t mask,
+    void* context) {
+    static const char* quantity_names[] = {"temperature", "humidity", "pressure", "co2"};
+    UnitempLogCSVContext* ctx = context;
+    const UnitempLogBlockHeader* header = (const UnitempLogBlockHeader*)block;
+    const UnitempLogSensorEntry* table =
+        (const UnitempLogSensorEntry*)(block + sizeof(UnitempLogBlockHeader));
+
+    DateTime datetime;
+    datetime_timestamp_to_datetime(time, &datetime);
+
+    uint8_t channel = 0;
+    for(uint8_t i = 0; i < header->sensors_count; i++) {
+        for(uint8_t q = 0; q < COUNT_OF(log_quantities); q++) {
+            if(!(table[i].datatype & log_quantities[q])) continue;
+            if(mask & (1UL << channel)) {
+                int32_t value = values[channel];
+                int32_t scale = unitemp_datalogger_getScale(log_quantities[q]);
+                furi_string_cat_printf(
+                    ctx->text,
+                    "%04u-%02u-%02u %02u:%02u:%02u,%.10s,%s,%s%ld",
+                    datetime.year,
+                    datetime.month,
+                    datetime.day,
+                    datetime.hour,
+                    datetime.minute,
+                    datetime.second,
+                    table[i].name,
+                    quantity_names[q],
+                    value < 0 ? "-" : "",
+                    labs(value) / scale);
+                if(scale == 10) furi_string_cat_printf(ctx->text, ".%01ld", labs(value) % 10);
+                if(scale == 100) furi_string_cat_printf(ctx->text, ".%02ld", labs(value) % 100);
+                furi_string_cat_printf(
+                    ctx->text, ",%s\n", unitemp_datalogger_getUnit(header, log_quantities[q]));
+                ctx->rows++;
+            }
+            channel++;
+        }
+    }
+    if(furi_string_size(ctx->text) >= UNITEMP_LOG_CSV_CHUNK) {
+        unitemp_datalogger_writeCSV(ctx);
+        logger->export_rows = ctx->rows;
+    }
+}
+
+static int32_t unitemp_datalogger_exportCSV(void* context) {
+    UNUSED(context);
+
+    FuriString* filepath =
+        furi_string_alloc_printf("%s/%s", APP_PATH_FOLDER, APP_FILENAME_LOG_CSV);
+    storage_common_mkdir(app->storage, APP_PATH_FOLDER);
+
+    UnitempLogCSVContext ctx = {
+        .stream = file_stream_alloc(app->storage),
+        .text = furi_string_alloc(),
+        .rows = 0,
+        .success = true,
+    };
+    if(!file_stream_open(
+           ctx.stream, furi_string_get_cstr(filepath), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        FURI_LOG_E(
+            APP_NAME,
+            "An error occurred while exporting the log: %d",
+            file_stream_get_error(ctx.stream));
+        ctx.success = false;
+    } else {
+        furi_string_set_str(ctx.text, "time,sensor,quantity,value,unit\n");
+        //Сначала предыдущий журнал, потом текущий вместе с кольцом
+        if(!unitemp_datalogger_decodeFile(
+               APP_FILENAME_LOG ".old", 0, unitemp_datalogger_csvCallback, &ctx) ||
+           !unitemp_datalogger_decodeFile(
+               APP_FILENAME_LOG, 0, unitemp_datalogger_csvCallback, &ctx)) {
+            ctx.success = false;
+        }
+        unitemp_datalogger_decodeRing(unitemp_datalogger_csvCallback, &ctx);
+        unitemp_datalogger_writeCSV(&ctx);
+    }
+
+    file_stream_close(ctx.stream);
+    stream_free(ctx.stream);
+    furi_string_free(ctx.text);
+    furi_string_free(filepath);
+    return ctx.success ? ctx.rows : -1;
+}
+
+bool unitemp_datalogger_exportStart(void) {
+    if(logger == NULL || logger->export_thread != NULL) return false;
+    //Экспорт важнее картинки графика, её можно собрать заново
+    unitemp_datalogger_seriesStop();
+
+    logger->export_rows = 0;
+    logger->export_thread =
+        furi_thread_alloc_ex("UnitempExport", 2048, unitemp_datalogger_exportCSV, NULL);
+    furi_thread_start(logger->export_thread);
+    return true;
+}
+
+bool unitemp_datalogger_exportPoll(int32_t* rows) {
+    if(logger == NULL || logger->export_thread == NULL) return false;
+
+    if(furi_thread_get_state(logger->export_thread) != FuriThreadStateStopped) {
+        *rows = logger->export_rows;
+        return false;
+    }
+
+    furi_thread_join(logger->export_thread);
+    *rows = furi_thread_get_return_code(logger->export_thread);
+    furi_thread_free(logger->export_thread);
+    logger->export_thread = NULL;
+    return true;
+}
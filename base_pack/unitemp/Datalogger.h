@@ -0,0 +1,111 @@
+/*
+    Unitemp - Universal temperature reader
+    Copyright (C) 2022-2023  Victor Nikitchuk (https://github.com/quen0n)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef UNITEMP_DATALOGGER
+#define UNITEMP_DATALOGGER
+
+#include "unitemp.h"
+
+//Имя файла журнала
+#define APP_FILENAME_LOG "log.bin"
+//Имя файла экспорта журнала
+#define APP_FILENAME_LOG_CSV "log.csv"
+
+//Размер блока журнала. Блок пишется на SD-карту целиком одной записью
+#define UNITEMP_LOG_BLOCK_SIZE 4096
+//Количество блоков в кольце в ОЗУ (текущий и последние записанные)
+#define UNITEMP_LOG_RAM_BLOCKS 2
+//Максимальный размер файла журнала в блоках, после него файл уходит в log.bin.old
+#define UNITEMP_LOG_FILE_BLOCKS_MAX 1024
+//Максимальное количество каналов (датчик + величина) в блоке
+#define UNITEMP_LOG_CHANNELS_MAX 32
+//Количество точек на графике
+#define UNITEMP_LOG_GRAPH_POINTS 100
+
+//Ряд значений одной величины датчика для графика
+typedef struct {
+    //Значения, каждое - среднее за stride отсчётов
+    float values[UNITEMP_LOG_GRAPH_POINTS];
+    //Количество точек
+    uint8_t count;
+    //Количество отсчётов журнала на одну точку
+    uint16_t stride;
+    //Время первого и последнего отсчёта (unix)
+    uint32_t first_time;
+    uint32_t last_time;
+} UnitempLogSeries;
+
+/**
+ * @brief Выделение памяти под кольцо журнала
+ */
+void unitemp_datalogger_alloc(void);
+
+/**
+ * @brief Запись неполного блока на SD-карту и освобождение памяти журнала
+ */
+void unitemp_datalogger_free(void);
+
+/**
+ * @brief Запись значений активных датчиков, если подошло время
+ * Вызывается после опроса датчиков
+ */
+void unitemp_datalogger_tick(void);
+
+/**
+ * @brief Получить период записи в журнал в миллисекундах
+ *
+ * @param interval Период из настроек
+ * @return Период в мс, 0 если журнал выключен
+ */
+uint32_t unitemp_datalogger_getIntervalMs(logInterval interval);
+
+/**
+ * @brief Запуск сборки ряда значений величины датчика из журнала (последние блоки с SD-карты
+ * и кольцо) в отдельном потоке. Прежняя незаконченная сборка отменяется
+ * Пока ряд собирается, новые значения в журнал не записываются
+ *
+ * @param sensor Указатель на датчик
+ * @param datatype Величина (UT_TEMPERATURE, UT_HUMIDITY, UT_PRESSURE, UT_CO2)
+ * @return Ложь если идёт экспорт
+ */
+bool unitemp_datalogger_seriesStart(Sensor* sensor, uint8_t datatype);
+
+/**
+ * @brief Проверка сборки ряда, вызывается из потока интерфейса
+ *
+ * @param series Указатель на ряд, куда по окончании будут записаны значения
+ * @return Истина если ряд собран
+ */
+bool unitemp_datalogger_seriesPoll(UnitempLogSeries* series);
+
+/**
+ * @brief Запуск экспорта всего журнала в CSV-файл на SD-карте в отдельном потоке
+ * Пока идёт экспорт, новые значения в журнал не записываются
+ *
+ * @return Ложь если экспорт уже идёт
+ */
+bool unitemp_datalogger_exportStart(void);
+
+/**
+ * @brief Проверка хода экспорта, вызывается из потока интерфейса
+ *
+ * @param rows Выгружено значений, по окончании - итог экспорта, -1 при ошибке
+ * @return Истина если экспорт закончился
+ */
+bool unitemp_datalogger_exportPoll(int32_t* rows);
+
+#endif
@@ -30,6 +30,8 @@ const GpioPin RX_14 = {.pin = LL_GPIO_PIN_7, .port = GPIOB};
 #define INTERFACES_TYPES_COUNT (int)(sizeof(interfaces) / sizeof(const Interface*))
 //Количество типов датчиков
 #define SENSOR_TYPES_COUNT (int)(sizeof(sensorTypes) / sizeof(const SensorType*))
+//Время, которое можно потратить на опрос датчиков за один тик, мс
+#define UNITEMP_POLLING_BUDGET 20
 
 //Перечень достуных портов ввода/вывода
 static const GPIO GPIOList[] = {
@@ -511,8 +513,9 @@ Sensor* unitemp_sensor_alloc(char* name, const SensorType* type, char* args) {
     //Статус датчика по умолчанию - ошибка
     sensor->status = UT_SENSORSTATUS_ERROR;
     //Время последнего опроса
-    sensor->lastPollingTime =
-        furi_get_tick() - 10000; //чтобы первый опрос произошёл как можно раньше
+    sensor->lastPollingTime = furi_get_tick();
+    //Первый опрос как можно раньше
+    sensor->nextPollingTime = sensor->lastPollingTime;
 
     sensor->temp = -128.0f;
     sensor->hum = -128.0f;
@@ -610,11 +613,16 @@ bool unitemp_sensors_deInit(void) {
     return result;
 }
 
+static bool unitemp_sensor_isDue(Sensor* sensor, uint32_t now) {
+    return (int32_t)(now - sensor->nextPollingTime) >= 0;
+}
+
 UnitempStatus unitemp_sensor_updateData(Sensor* sensor) {
     if(sensor == NULL) return UT_SENSORSTATUS_ERROR;
 
+    uint32_t now = furi_get_tick();
     //Проверка на допустимость опроса датчика
-    if(furi_get_tick() - sensor->lastPollingTime < sensor->type->pollingInterval) {
+    if(!unitemp_sensor_isDue(sensor, now)) {
         //Возврат ошибки если последний опрос датчика был неудачным
         if(sensor->status == UT_SENSORSTATUS_TIMEOUT) {
             return UT_SENSORSTATUS_TIMEOUT;
@@ -622,7 +630,10 @@ UnitempStatus unitemp_sensor_updateData(Sensor* sensor) {
         return UT_SENSORSTATUS_EARLYPOOL;
     }
 
-    sensor->lastPollingTime = furi_get_tick();
+    //Новый цикл опроса начинается, если датчик не ждёт окончания преобразования
+    if(sensor->status != UT_SENSORSTATUS_POLLING) {
+        sensor->lastPollingTime = now;
+    }
 
     if(!furi_hal_power_is_otg_enabled()) {
         furi_hal_power_enable_otg();
@@ -630,6 +641,13 @@ UnitempStatus unitemp_sensor_updateData(Sensor* sensor) {
 
     sensor->status = sensor->type->interface->updater(sensor);
 
+    if(sensor->status == UT_SENSORSTATUS_POLLING) {
+        //Результат будет готов через время преобразования, пока можно заняться другими датчиками
+        sensor->nextPollingTime = furi_get_tick() + sensor->type->conversionTime;
+    } else {
+        sensor->nextPollingTime = sensor->lastPollingTime + sensor->type->pollingInterval;
+    }
+
     if(sensor->status != UT_SENSORSTATUS_OK && sensor->status != UT_SENSORSTATUS_POLLING) {
         UNITEMP_DEBUG("Sensor %s update status %d", sensor->name, sensor->status);
     }
@@ -659,7 +677,22 @@ UnitempStatus unitemp_sensor_updateData(Sensor* sensor) {
 }
 
 void unitemp_sensors_updateValues(void) {
-    for(uint8_t i = 0; i < unitemp_sensors_getCount(); i++) {
-        unitemp_sensor_updateData(unitemp_sensor_getActive(i));
+    uint32_t start = furi_get_tick();
+
+    while(furi_get_tick() - start < UNITEMP_POLLING_BUDGET) {
+        //Поиск датчика с самым ранним наступившим сроком опроса
+        uint32_t now = furi_get_tick();
+        Sensor* next = NULL;
+        for(uint8_t i = 0; i < unitemp_sensors_getCount(); i++) {
+            Sensor* sensor = unitemp_sensor_getActive(i);
+            if(sensor == NULL || !unitemp_sensor_isDue(sensor, now)) continue;
+            if(next == NULL ||
+               (int32_t)(sensor->nextPollingTime - next->nextPollingTime) < 0) {
+                next = sensor;
+            }
+        }
+        if(next == NULL) break;
+
+        unitemp_sensor_updateData(next);
     }
 }
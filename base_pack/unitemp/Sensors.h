@@ -101,6 +101,8 @@ typedef struct {
     const Interface* interface;
     //Интервал опроса датчика
     uint16_t pollingInterval;
+    //Время от запуска преобразования (UT_SENSORSTATUS_POLLING) до готовности результата, мс
+    uint16_t conversionTime;
     //Функция выделения памяти для датчика
     SensorAllocator* allocator;
     //Функция высвыбождения памяти для датчика
@@ -132,6 +134,8 @@ typedef struct Sensor {
     UnitempStatus status;
     //Время последнего опроса датчика
     uint32_t lastPollingTime;
+    //Время, когда датчик нужно опросить в следующий раз
+    uint32_t nextPollingTime;
     //Смещение по температуре (x10)
     int8_t temp_offset;
     //Экземпляр датчика
@@ -162,6 +166,9 @@ void unitemp_sensor_free(Sensor* sensor);
 
 /**
  * @brief Обновление данных указанного датчика
+ * 
+ * Если датчик вернул UT_SENSORSTATUS_POLLING, то следующий вызов произойдёт через
+ * conversionTime его типа, иначе через pollingInterval от начала цикла опроса
  * @param sensor Указатель на датчик
  * @return Статус опроса датчика
  */
@@ -225,7 +232,10 @@ bool unitemp_sensors_deInit(void);
 void unitemp_sensors_free(void);
 
 /**
- * @brief Обновить данные всех датчиков
+ * @brief Опросить датчики, срок опроса которых наступил
+ * 
+ * Датчики опрашиваются в порядке наступления сроков, пока не истечёт бюджет времени тика.
+ * Не успевшие датчики будут опрошены в следующий тик
  */
 void unitemp_sensors_updateValues(void);
 
@@ -124,7 +124,8 @@ bool unitemp_I2C_sensor_free(Sensor* sensor) {
 }
 
 UnitempStatus unitemp_I2C_sensor_update(Sensor* sensor) {
-    if(sensor->status != UT_SENSORSTATUS_OK) {
+    //Во время преобразования датчик не переинициализируется
+    if(sensor->status != UT_SENSORSTATUS_OK && sensor->status != UT_SENSORSTATUS_POLLING) {
         sensor->type->initializer(sensor);
     }
     return sensor->type->updater(sensor);
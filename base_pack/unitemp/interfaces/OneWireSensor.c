@@ -27,6 +27,7 @@ const SensorType Dallas = {
     .interface = &ONE_WIRE,
     .datatype = UT_DATA_TYPE_TEMP,
     .pollingInterval = 1000,
+    .conversionTime = 750,
     .allocator = unitemp_onewire_sensor_alloc,
     .mem_releaser = unitemp_onewire_sensor_free,
     .initializer = unitemp_onewire_sensor_init,
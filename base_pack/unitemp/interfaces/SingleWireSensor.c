@@ -17,8 +17,16 @@
 */
 #include "SingleWireSensor.h"
 
-//Максимальное количество попугаев ожидания датчика
-#define POLLING_TIMEOUT_TICKS 500
+//Длительность стартового импульса, мс
+#define SINGLE_WIRE_START_TIME 19
+//Время на приём ответа датчика после стартового импульса, мс
+#define SINGLE_WIRE_ANSWER_TIME 6
+//Порог длительности высокого уровня между нулём (26-28 мкс) и единицей (70 мкс), мкс
+#define SINGLE_WIRE_ONE_THRESHOLD 50
+
+//Датчик, с которым идёт обмен. Прерывания портов с одинаковым номером общие,
+//поэтому обмен ведётся только с одним датчиком за раз
+static SingleWireSensor* capture_owner = NULL;
 
 /* Типы датчиков и их параметры */
 const SensorType DHT11 = {
@@ -26,6 +34,7 @@ const SensorType DHT11 = {
     .interface = &SINGLE_WIRE,
     .datatype = UT_DATA_TYPE_TEMP_HUM,
     .pollingInterval = 2000,
+    .conversionTime = 30,
     .allocator = unitemp_singlewire_alloc,
     .mem_releaser = unitemp_singlewire_free,
     .initializer = unitemp_singlewire_init,
@@ -36,6 +45,7 @@ const SensorType DHT12_SW = {
     .interface = &SINGLE_WIRE,
     .datatype = UT_DATA_TYPE_TEMP_HUM,
     .pollingInterval = 2000,
+    .conversionTime = 30,
     .allocator = unitemp_singlewire_alloc,
     .mem_releaser = unitemp_singlewire_free,
     .initializer = unitemp_singlewire_init,
@@ -47,6 +57,7 @@ const SensorType DHT21 = {
     .interface = &SINGLE_WIRE,
     .datatype = UT_DATA_TYPE_TEMP_HUM,
     .pollingInterval = 1000,
+    .conversionTime = 30,
     .allocator = unitemp_singlewire_alloc,
     .mem_releaser = unitemp_singlewire_free,
     .initializer = unitemp_singlewire_init,
@@ -58,6 +69,7 @@ const SensorType DHT22 = {
     .interface = &SINGLE_WIRE,
     .datatype = UT_DATA_TYPE_TEMP_HUM,
     .pollingInterval = 2000,
+    .conversionTime = 30,
     .allocator = unitemp_singlewire_alloc,
     .mem_releaser = unitemp_singlewire_free,
     .initializer = unitemp_singlewire_init,
@@ -69,12 +81,80 @@ const SensorType AM2320_SW = {
     .interface = &SINGLE_WIRE,
     .datatype = UT_DATA_TYPE_TEMP_HUM,
     .pollingInterval = 2000,
+    .conversionTime = 30,
     .allocator = unitemp_singlewire_alloc,
     .mem_releaser = unitemp_singlewire_free,
     .initializer = unitemp_singlewire_init,
     .deinitializer = unitemp_singlewire_deinit,
     .updater = unitemp_singlewire_update};
 
+static void unitemp_singlewire_edge_callback(void* context) {
+    SingleWireSensor* instance = context;
+    if(instance->edgesCount >= SINGLE_WIRE_EDGES) return;
+    instance->edges[instance->edgesCount++] =
+        (DWT->CYCCNT & ~1UL) | furi_hal_gpio_read(instance->gpio->pin);
+}
+
+static void unitemp_singlewire_start_callback(void* context) {
+    SingleWireSensor* instance = context;
+    if(instance->phase != SINGLE_WIRE_START) return;
+
+    instance->edgesCount = 0;
+    //Подъём линии
+    furi_hal_gpio_write(instance->gpio->pin, true);
+    //Ответ датчика записывается по прерываниям от фронтов, остальные прерывания не мешают
+    furi_hal_gpio_init(
+        instance->gpio->pin, GpioModeInterruptRiseFall, GpioPullUp, GpioSpeedVeryHigh);
+    furi_hal_gpio_add_int_callback(instance->gpio->pin, unitemp_singlewire_edge_callback, instance);
+    instance->captureTime = furi_get_tick();
+    instance->phase = SINGLE_WIRE_CAPTURE;
+}
+
+/**
+ * @brief Прервать обмен с датчиком и вернуть линию в режим открытого стока
+ * 
+ * @param instance Указатель на инстанс датчика
+ */
+static void unitemp_singlewire_stop(SingleWireSensor* instance) {
+    furi_timer_stop(instance->timer);
+    if(instance->phase == SINGLE_WIRE_CAPTURE) {
+        furi_hal_gpio_remove_int_callback(instance->gpio->pin);
+    }
+    if(instance->phase != SINGLE_WIRE_IDLE) {
+        furi_hal_gpio_write(instance->gpio->pin, true);
+        furi_hal_gpio_init(
+            instance->gpio->pin, GpioModeOutputOpenDrain, GpioPullUp, GpioSpeedVeryHigh);
+    }
+    instance->phase = SINGLE_WIRE_IDLE;
+    if(capture_owner == instance) capture_owner = NULL;
+}
+
+/**
+ * @brief Восстановить байты ответа по записанным фронтам
+ * 
+ * Данные - последние 40 импульсов высокого уровня, перед ними импульс подтверждения
+ * @param instance Указатель на инстанс датчика
+ * @param data Массив для 5 байт ответа
+ * @return Истина если импульсов хватило на все биты
+ */
+static bool unitemp_singlewire_decode(SingleWireSensor* instance, uint8_t* data) {
+    uint32_t threshold =
+        SINGLE_WIRE_ONE_THRESHOLD * furi_hal_cortex_instructions_per_microsecond();
+    int8_t bit = 39;
+
+    for(int16_t i = instance->edgesCount - 2; i >= 0 && bit >= 0; i--) {
+        uint32_t rise = instance->edges[i];
+        uint32_t fall = instance->edges[i + 1];
+        //Нужен подъём, за которым следует спад
+        if(!(rise & 1) || (fall & 1)) continue;
+
+        if((fall & ~1UL) - (rise & ~1UL) > threshold) data[bit / 8] |= 1 << (7 - bit % 8);
+        bit--;
+    }
+
+    return bit < 0;
+}
+
 bool unitemp_singlewire_alloc(Sensor* sensor, char* args) {
     if(args == NULL) return false;
     SingleWireSensor* instance = malloc(sizeof(SingleWireSensor));
@@ -83,6 +163,9 @@ bool unitemp_singlewire_alloc(Sensor* sensor, char* args) {
         return false;
     }
     sensor->instance = instance;
+    instance->timer =
+        furi_timer_alloc(unitemp_singlewire_start_callback, FuriTimerTypeOnce, instance);
+    instance->phase = SINGLE_WIRE_IDLE;
 
     int gpio = 255;
     sscanf(args, "%d", &gpio);
@@ -91,11 +174,15 @@ bool unitemp_singlewire_alloc(Sensor* sensor, char* args) {
         return true;
     }
     FURI_LOG_E(APP_NAME, "Sensor %s GPIO setting error", sensor->name);
+    furi_timer_free(instance->timer);
     free(instance);
     return false;
 }
 bool unitemp_singlewire_free(Sensor* sensor) {
-    free(sensor->instance);
+    SingleWireSensor* instance = sensor->instance;
+    unitemp_singlewire_stop(instance);
+    furi_timer_free(instance->timer);
+    free(instance);
 
     return true;
 }
@@ -121,6 +208,7 @@ bool unitemp_singlewire_init(Sensor* sensor) {
 bool unitemp_singlewire_deinit(Sensor* sensor) {
     SingleWireSensor* instance = ((Sensor*)sensor)->instance;
     if(instance == NULL || instance->gpio == NULL) return false;
+    unitemp_singlewire_stop(instance);
     unitemp_gpio_unlock(instance->gpio);
     //Низкий уровень по умолчанию
     furi_hal_gpio_write(instance->gpio->pin, false);
@@ -152,80 +240,29 @@ UnitempStatus unitemp_singlewire_update(Sensor* sensor) {
     uint8_t data[5] = {0};
 
     /* Запрос */
-    //Опускание линии
-    furi_hal_gpio_write(instance->gpio->pin, false);
-    //Ожидание более 18 мс
-    furi_delay_ms(19);
-    //Выключение прерываний, чтобы ничто не мешало обработке данных
-    __disable_irq();
-    //Подъём линии
-    furi_hal_gpio_write(instance->gpio->pin, true);
+    if(instance->phase == SINGLE_WIRE_IDLE) {
+        //Линия другого датчика ещё занята, попытка через время преобразования
+        if(capture_owner != NULL) return UT_SENSORSTATUS_POLLING;
+        capture_owner = instance;
 
-    /* Ответ датчика */
-    //Переменная-счётчик
-    uint16_t timeout = 0;
-
-    //Ожидание подъёма линии
-    while(!furi_hal_gpio_read(instance->gpio->pin)) {
-        timeout++;
-        if(timeout > POLLING_TIMEOUT_TICKS) {
-            //Включение прерываний
-            __enable_irq();
-            //Возврат признака отсутствующего датчика
-            return UT_SENSORSTATUS_TIMEOUT;
-        }
-    }
-    timeout = 0;
-
-    //Ожидание спада линии
-    while(furi_hal_gpio_read(instance->gpio->pin)) {
-        timeout++;
-        if(timeout > POLLING_TIMEOUT_TICKS) {
-            //Включение прерываний
-            __enable_irq();
-            //Возврат признака отсутствующего датчика
-            return UT_SENSORSTATUS_TIMEOUT;
-        }
+        //Опускание линии, поднимет её таймер через SINGLE_WIRE_START_TIME
+        instance->phase = SINGLE_WIRE_START;
+        furi_hal_gpio_write(instance->gpio->pin, false);
+        furi_timer_start(instance->timer, furi_ms_to_ticks(SINGLE_WIRE_START_TIME));
+        return UT_SENSORSTATUS_POLLING;
     }
 
-    //Ожидание подъёма линии
-    while(!furi_hal_gpio_read(instance->gpio->pin)) {
-        timeout++;
-        if(timeout > POLLING_TIMEOUT_TICKS) {
-            //Включение прерываний
-            __enable_irq();
-            //Возврат признака отсутствующего датчика
-            return UT_SENSORSTATUS_TIMEOUT;
-        }
-    }
-    timeout = 0;
-
-    //Ожидание спада линии
-    while(furi_hal_gpio_read(instance->gpio->pin)) {
-        timeout++;
-        if(timeout > POLLING_TIMEOUT_TICKS) {
-            //Включение прерываний
-            __enable_irq();
-            //Возврат признака отсутствующего датчика
-            return UT_SENSORSTATUS_TIMEOUT;
-        }
+    /* Ответ датчика */
+    //Ожидание окончания приёма
+    if(instance->phase == SINGLE_WIRE_START ||
+       furi_get_tick() - instance->captureTime < SINGLE_WIRE_ANSWER_TIME) {
+        return UT_SENSORSTATUS_POLLING;
     }
 
-    /* Чтение данных с датчика*/
-    //Приём 5 байт
-    for(uint8_t a = 0; a < 5; a++) {
-        for(uint8_t b = 7; b != 255; b--) {
-            uint16_t hT = 0, lT = 0;
-            //Пока линия в низком уровне, инкремент переменной lT
-            while(!furi_hal_gpio_read(instance->gpio->pin) && lT != 65535) lT++;
-            //Пока линия в высоком уровне, инкремент переменной hT
-            while(furi_hal_gpio_read(instance->gpio->pin) && hT != 65535) hT++;
-            //Если hT больше lT, то пришла единица
-            if(hT > lT) data[a] |= (1 << b);
-        }
-    }
-    //Включение прерываний
-    __enable_irq();
+    bool received = unitemp_singlewire_decode(instance, data);
+    unitemp_singlewire_stop(instance);
+    //Возврат признака отсутствующего датчика
+    if(!received) return UT_SENSORSTATUS_TIMEOUT;
 
     //Проверка контрольной суммы
     if((uint8_t)(data[0] + data[1] + data[2] + data[3]) != data[4]) {
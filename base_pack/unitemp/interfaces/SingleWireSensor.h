@@ -21,10 +21,30 @@
 #include "../unitemp.h"
 #include "../Sensors.h"
 
+//Максимум записываемых фронтов: в ответе датчика 84, остальное запас на помехи
+#define SINGLE_WIRE_EDGES 90
+
+//Этапы обмена с датчиком
+typedef enum {
+    SINGLE_WIRE_IDLE, //Обмена нет
+    SINGLE_WIRE_START, //Линия прижата стартовым импульсом
+    SINGLE_WIRE_CAPTURE, //Линия отпущена, фронты ответа записываются
+} SingleWirePhase;
+
 //Интерфейс Single Wire
 typedef struct {
     //Порт подключения датчика
     const GPIO* gpio;
+    //Таймер окончания стартового импульса
+    FuriTimer* timer;
+    //Текущий этап обмена
+    volatile SingleWirePhase phase;
+    //Время начала записи ответа
+    volatile uint32_t captureTime;
+    //Метки фронтов в тактах ядра, младший бит - уровень линии после фронта
+    volatile uint32_t edges[SINGLE_WIRE_EDGES];
+    //Количество записанных фронтов
+    volatile uint8_t edgesCount;
 } SingleWireSensor;
 
 /* Датчики */
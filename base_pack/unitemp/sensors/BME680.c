@@ -23,6 +23,8 @@ const SensorType BME680 = {
     .interface = &I2C,
     .datatype = UT_TEMPERATURE | UT_HUMIDITY | UT_PRESSURE,
     .pollingInterval = 500,
+    //T x2, P x4, H x1: 7 * 1.963 мс + переключения и пробуждение, нагреватель не включается
+    .conversionTime = 20,
     .allocator = unitemp_BME680_alloc,
     .mem_releaser = unitemp_BME680_free,
     .initializer = unitemp_BME680_init,
@@ -385,25 +387,29 @@ UnitempStatus unitemp_BME680_update(Sensor* sensor) {
     I2CSensor* i2c_sensor = (I2CSensor*)sensor->instance;
     BME680_instance* instance = i2c_sensor->sensorInstance;
 
-    uint32_t t = furi_get_tick();
-
     uint8_t buff[3];
-    //Проверка инициализированности датчика
-    unitemp_i2c_readRegArray(i2c_sensor, 0xF4, 2, buff);
-    if(buff[0] == 0) {
-        FURI_LOG_W(APP_NAME, "Sensor %s is not initialized!", sensor->name);
-        return UT_SENSORSTATUS_ERROR;
-    }
 
-    unitemp_i2c_writeReg(
-        i2c_sensor,
-        BME680_REG_CTRL_MEAS,
-        unitemp_i2c_readReg(i2c_sensor, BME680_REG_CTRL_MEAS) | 1);
+    //Запуск измерения, результат забирается при следующем опросе
+    if(sensor->status != UT_SENSORSTATUS_POLLING) {
+        //Проверка инициализированности датчика
+        unitemp_i2c_readRegArray(i2c_sensor, 0xF4, 2, buff);
+        if(buff[0] == 0) {
+            FURI_LOG_W(APP_NAME, "Sensor %s is not initialized!", sensor->name);
+            return UT_SENSORSTATUS_ERROR;
+        }
 
-    while(BME680_isMeasuring(sensor)) {
-        if(furi_get_tick() - t > 100) {
+        if(!unitemp_i2c_writeReg(
+               i2c_sensor,
+               BME680_REG_CTRL_MEAS,
+               unitemp_i2c_readReg(i2c_sensor, BME680_REG_CTRL_MEAS) | BME680_MODE_FORCED))
             return UT_SENSORSTATUS_TIMEOUT;
-        }
+        return UT_SENSORSTATUS_POLLING;
+    }
+
+    //Измерение ещё идёт, ждать дальше, но не дольше 100 мс с запуска
+    if(BME680_isMeasuring(sensor)) {
+        if(furi_get_tick() - sensor->lastPollingTime > 100) return UT_SENSORSTATUS_TIMEOUT;
+        return UT_SENSORSTATUS_POLLING;
     }
 
     if(furi_get_tick() - instance->last_cal_update_time > BOSCH_CAL_UPDATE_INTERVAL) {
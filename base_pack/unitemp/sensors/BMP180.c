@@ -35,6 +35,12 @@ typedef struct {
 typedef struct {
     //Калибровочные значения
     BMP180_cal bmp180_cal;
+    //Идёт измерение давления, температура уже прочитана
+    bool pressure_pending;
+    //Промежуточное значение из расчёта температуры для расчёта давления
+    int32_t B5;
+    //Температура ждёт давления, чтобы оба значения обновились вместе
+    float temp;
 } BMP180_instance;
 
 const SensorType BMP180 = {
@@ -42,6 +48,7 @@ const SensorType BMP180 = {
     .interface = &I2C,
     .datatype = UT_TEMPERATURE | UT_PRESSURE,
     .pollingInterval = 1000,
+    .conversionTime = 26,
     .allocator = unitemp_BMP180_I2C_alloc,
     .mem_releaser = unitemp_BMP180_I2C_free,
     .initializer = unitemp_BMP180_init,
@@ -128,24 +135,39 @@ UnitempStatus unitemp_BMP180_I2C_update(Sensor* sensor) {
     I2CSensor* i2c_sensor = (I2CSensor*)sensor->instance;
     BMP180_instance* bmp180_instance = i2c_sensor->sensorInstance;
 
-    //Чтение температуры
-    if(!unitemp_i2c_writeReg(i2c_sensor, 0xF4, 0x2E)) return UT_SENSORSTATUS_TIMEOUT;
-    furi_delay_ms(5);
     uint8_t buff[3] = {0};
-    if(!unitemp_i2c_readRegArray(i2c_sensor, 0xF6, 2, buff)) return UT_SENSORSTATUS_TIMEOUT;
-    int32_t UT = ((uint16_t)buff[0] << 8) + buff[1];
-    int32_t X1 = (UT - bmp180_instance->bmp180_cal.AC6) * bmp180_instance->bmp180_cal.AC5 >> 15;
-    int32_t X2 = (bmp180_instance->bmp180_cal.MC << 11) / (X1 + bmp180_instance->bmp180_cal.MD);
-    int32_t B5 = X1 + X2;
-    sensor->temp = ((B5 + 8) / 16) * 0.1f;
+
+    //Запуск измерения температуры
+    if(sensor->status != UT_SENSORSTATUS_POLLING) {
+        bmp180_instance->pressure_pending = false;
+        if(!unitemp_i2c_writeReg(i2c_sensor, 0xF4, 0x2E)) return UT_SENSORSTATUS_TIMEOUT;
+        return UT_SENSORSTATUS_POLLING;
+    }
+
+    //Чтение температуры и запуск измерения давления
+    if(!bmp180_instance->pressure_pending) {
+        if(!unitemp_i2c_readRegArray(i2c_sensor, 0xF6, 2, buff)) return UT_SENSORSTATUS_TIMEOUT;
+        int32_t UT = ((uint16_t)buff[0] << 8) + buff[1];
+        int32_t X1 =
+            (UT - bmp180_instance->bmp180_cal.AC6) * bmp180_instance->bmp180_cal.AC5 >> 15;
+        int32_t X2 =
+            (bmp180_instance->bmp180_cal.MC << 11) / (X1 + bmp180_instance->bmp180_cal.MD);
+        bmp180_instance->B5 = X1 + X2;
+        bmp180_instance->temp = ((bmp180_instance->B5 + 8) / 16) * 0.1f;
+
+        if(!unitemp_i2c_writeReg(i2c_sensor, 0xF4, 0x34 + (0b11 << 6)))
+            return UT_SENSORSTATUS_TIMEOUT;
+        bmp180_instance->pressure_pending = true;
+        return UT_SENSORSTATUS_POLLING;
+    }
 
     //Чтение давления
-    if(!unitemp_i2c_writeReg(i2c_sensor, 0xF4, 0x34 + (0b11 << 6))) return UT_SENSORSTATUS_TIMEOUT;
-    furi_delay_ms(26);
+    bmp180_instance->pressure_pending = false;
     if(!unitemp_i2c_readRegArray(i2c_sensor, 0xF6, 3, buff)) return UT_SENSORSTATUS_TIMEOUT;
     uint32_t UP = ((buff[0] << 16) + (buff[1] << 8) + buff[2]) >> (8 - 0b11);
 
-    int32_t B6, X3, B3, P;
+    int32_t B5 = bmp180_instance->B5;
+    int32_t B6, X1, X2, X3, B3, P;
     uint32_t B4, B7;
     B6 = B5 - 4000;
     X1 = (bmp180_instance->bmp180_cal.B2 * ((B6 * B6) >> 12)) >> 11;
@@ -165,6 +187,7 @@ UnitempStatus unitemp_BMP180_I2C_update(Sensor* sensor) {
     X1 = (X1 * 3038) >> 16;
     X2 = (-7357 * (P)) >> 16;
     P = P + ((X1 + X2 + 3791) >> 4);
+    sensor->temp = bmp180_instance->temp;
     sensor->pressure = P;
 
     return UT_SENSORSTATUS_OK;
@@ -22,6 +22,8 @@ const SensorType BMP280 = {
     .interface = &I2C,
     .datatype = UT_TEMPERATURE | UT_PRESSURE,
     .pollingInterval = 500,
+    //Наибольшее время измерения при T x2, P x4, H x1
+    .conversionTime = 19,
     .allocator = unitemp_BMx280_alloc,
     .mem_releaser = unitemp_BMx280_free,
     .initializer = unitemp_BMx280_init,
@@ -33,6 +35,8 @@ const SensorType BME280 = {
     .datatype = UT_TEMPERATURE | UT_HUMIDITY | UT_PRESSURE,
 
     .pollingInterval = 500,
+    //Наибольшее время измерения при T x2, P x4, H x1
+    .conversionTime = 19,
     .allocator = unitemp_BMx280_alloc,
     .mem_releaser = unitemp_BMx280_free,
     .initializer = unitemp_BMx280_init,
@@ -306,8 +310,6 @@ UnitempStatus unitemp_BMx280_update(Sensor* sensor) {
     I2CSensor* i2c_sensor = (I2CSensor*)sensor->instance;
     BMx280_instance* instance = i2c_sensor->sensorInstance;
 
-    uint32_t t = furi_get_tick();
-
     uint8_t buff[3];
     //Проверка инициализированности датчика
     unitemp_i2c_readRegArray(i2c_sensor, 0xF4, 2, buff);
@@ -316,10 +318,10 @@ UnitempStatus unitemp_BMx280_update(Sensor* sensor) {
         return UT_SENSORSTATUS_ERROR;
     }
 
-    while(bmp280_isMeasuring(sensor)) {
-        if(furi_get_tick() - t > 100) {
-            return UT_SENSORSTATUS_TIMEOUT;
-        }
+    //Датчик в нормальном режиме, идущее измерение дочитывается при следующем опросе
+    if(bmp280_isMeasuring(sensor)) {
+        if(furi_get_tick() - sensor->lastPollingTime > 100) return UT_SENSORSTATUS_TIMEOUT;
+        return UT_SENSORSTATUS_POLLING;
     }
 
     if(furi_get_tick() - instance->last_cal_update_time > BOSCH_CAL_UPDATE_INTERVAL) {
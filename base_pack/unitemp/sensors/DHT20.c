@@ -18,12 +18,18 @@
 #include "DHT20.h"
 #include "../interfaces/I2CSensor.h"
 
+typedef struct {
+    //Измерение запущено, иначе датчик только что сброшен и ждёт запуска
+    bool measuring;
+} DHT20_instance;
+
 const SensorType DHT20 = {
     .typename = "DHT20",
     .altname = "DHT20/AM2108/AHT20",
     .interface = &I2C,
     .datatype = UT_TEMPERATURE | UT_HUMIDITY,
     .pollingInterval = 1000,
+    .conversionTime = 80,
     .allocator = unitemp_DHT20_I2C_alloc,
     .mem_releaser = unitemp_DHT20_I2C_free,
     .initializer = unitemp_DHT20_init,
@@ -34,6 +40,7 @@ const SensorType AHT10 = {
     .interface = &I2C,
     .datatype = UT_TEMPERATURE | UT_HUMIDITY,
     .pollingInterval = 1000,
+    .conversionTime = 80,
     .allocator = unitemp_DHT20_I2C_alloc,
     .mem_releaser = unitemp_DHT20_I2C_free,
     .initializer = unitemp_DHT20_init,
@@ -84,12 +91,16 @@ bool unitemp_DHT20_I2C_alloc(Sensor* sensor, char* args) {
     //Адреса на шине I2C (7 бит)
     i2c_sensor->minI2CAdr = 0x38 << 1;
     i2c_sensor->maxI2CAdr = (sensor->type == &DHT20) ? (0x38 << 1) : (0x39 << 1);
+
+    DHT20_instance* dht20_instance = malloc(sizeof(DHT20_instance));
+    dht20_instance->measuring = false;
+    i2c_sensor->sensorInstance = dht20_instance;
     return true;
 }
 
 bool unitemp_DHT20_I2C_free(Sensor* sensor) {
-    //Нечего высвобождать, так как ничего не было выделено
-    UNUSED(sensor);
+    I2CSensor* i2c_sensor = (I2CSensor*)sensor->instance;
+    free(i2c_sensor->sensorInstance);
     return true;
 }
 
@@ -115,20 +126,34 @@ bool unitemp_DHT20_I2C_deinit(Sensor* sensor) {
 
 UnitempStatus unitemp_DHT20_I2C_update(Sensor* sensor) {
     I2CSensor* i2c_sensor = (I2CSensor*)sensor->instance;
+    DHT20_instance* dht20_instance = i2c_sensor->sensorInstance;
+
+    uint8_t data[7] = {0xAC, 0x33, 0x00};
 
-    if(DHT20_get_status(i2c_sensor) != 0x18) {
-        DHT20_reset_reg(i2c_sensor, 0x1B);
-        DHT20_reset_reg(i2c_sensor, 0x1C);
-        DHT20_reset_reg(i2c_sensor, 0x1E);
+    if(sensor->status != UT_SENSORSTATUS_POLLING) {
+        dht20_instance->measuring = false;
+        //После сброса измерение запускается на следующем шаге, через conversionTime
+        if(DHT20_get_status(i2c_sensor) != 0x18) {
+            DHT20_reset_reg(i2c_sensor, 0x1B);
+            DHT20_reset_reg(i2c_sensor, 0x1C);
+            DHT20_reset_reg(i2c_sensor, 0x1E);
+            return UT_SENSORSTATUS_POLLING;
+        }
     }
-    furi_delay_ms(10);
 
-    uint8_t data[7] = {0xAC, 0x33, 0x00};
-    if(!unitemp_i2c_writeArray(i2c_sensor, 3, data)) return UT_SENSORSTATUS_TIMEOUT;
-    furi_delay_ms(80);
-    uint32_t t = furi_get_tick();
-    while(DHT20_get_status(i2c_sensor) == 0x80) {
-        if(furi_get_tick() - t > 10) return UT_SENSORSTATUS_TIMEOUT;
+    //Запуск измерения, результат будет прочитан через conversionTime
+    if(!dht20_instance->measuring) {
+        if(!unitemp_i2c_writeArray(i2c_sensor, 3, data)) return UT_SENSORSTATUS_TIMEOUT;
+        dht20_instance->measuring = true;
+        return UT_SENSORSTATUS_POLLING;
+    }
+
+    //Датчик ещё измеряет
+    if(DHT20_get_status(i2c_sensor) & 0x80) {
+        if(furi_get_tick() - sensor->lastPollingTime > sensor->type->pollingInterval) {
+            return UT_SENSORSTATUS_TIMEOUT;
+        }
+        return UT_SENSORSTATUS_POLLING;
     }
 
     if(!unitemp_i2c_readArray(i2c_sensor, 7, data)) return UT_SENSORSTATUS_TIMEOUT;
@@ -23,6 +23,7 @@ const SensorType HDC1080 = {
     .interface = &I2C,
     .datatype = UT_DATA_TYPE_TEMP_HUM,
     .pollingInterval = 250,
+    .conversionTime = 20,
     .allocator = unitemp_HDC1080_alloc,
     .mem_releaser = unitemp_HDC1080_free,
     .initializer = unitemp_HDC1080_init,
@@ -59,7 +60,8 @@ bool unitemp_HDC1080_init(Sensor* sensor) {
             device_id);
         return false;
     }
-    data[0] = 0b0001000;
+    //Температура и влажность измеряются одним запуском, по 14 бит
+    data[0] = 0b00010000;
     data[1] = 0;
     //Установка режима работы и разрядности измерений
     if(!unitemp_i2c_writeRegArray(i2c_sensor, 0x02, 2, data)) return UT_SENSORSTATUS_TIMEOUT;
@@ -76,19 +78,17 @@ bool unitemp_HDC1080_deinit(Sensor* sensor) {
 UnitempStatus unitemp_HDC1080_update(Sensor* sensor) {
     I2CSensor* i2c_sensor = (I2CSensor*)sensor->instance;
 
-    uint8_t data[2] = {0};
-    //Запуск измерения
-    if(!unitemp_i2c_writeArray(i2c_sensor, 1, data)) return UT_SENSORSTATUS_TIMEOUT;
-    furi_delay_ms(10);
-    if(!unitemp_i2c_readArray(i2c_sensor, 2, data)) return UT_SENSORSTATUS_TIMEOUT;
+    uint8_t data[4] = {0};
+    //Запуск измерения, результат будет прочитан через conversionTime
+    if(sensor->status != UT_SENSORSTATUS_POLLING) {
+        if(!unitemp_i2c_writeArray(i2c_sensor, 1, data)) return UT_SENSORSTATUS_TIMEOUT;
+        return UT_SENSORSTATUS_POLLING;
+    }
 
+    //Чтение температуры и влажности одним пакетом
+    if(!unitemp_i2c_readArray(i2c_sensor, 4, data)) return UT_SENSORSTATUS_TIMEOUT;
     sensor->temp = ((float)(((uint16_t)data[0] << 8) | data[1]) / 65536) * 165 - 40;
-
-    data[0] = 1;
-    if(!unitemp_i2c_writeArray(i2c_sensor, 1, data)) return UT_SENSORSTATUS_TIMEOUT;
-    furi_delay_ms(10);
-    if(!unitemp_i2c_readArray(i2c_sensor, 2, data)) return UT_SENSORSTATUS_TIMEOUT;
-    sensor->hum = ((float)(((uint16_t)data[0] << 8) | data[1]) / 65536) * 100;
+    sensor->hum = ((float)(((uint16_t)data[2] << 8) | data[3]) / 65536) * 100;
 
     return UT_SENSORSTATUS_OK;
 }
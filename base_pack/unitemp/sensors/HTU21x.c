@@ -24,6 +24,7 @@ const SensorType HTU21x = {
     .interface = &I2C,
     .datatype = UT_DATA_TYPE_TEMP_HUM,
     .pollingInterval = 250,
+    .conversionTime = 50,
     .allocator = unitemp_HTU21x_alloc,
     .mem_releaser = unitemp_HTU21x_free,
     .initializer = unitemp_HTU21x_init,
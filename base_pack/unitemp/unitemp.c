@@ -18,6 +18,7 @@
 #include "unitemp.h"
 #include "interfaces/SingleWireSensor.h"
 #include "Sensors.h"
+#include "Datalogger.h"
 #include "./views/UnitempViews.h"
 
 #include <furi_hal_power.h>
@@ -97,6 +98,7 @@ bool unitemp_saveSettings(void) {
     stream_write_format(app->file_stream, "TEMP_UNIT %d\n", app->settings.temp_unit);
     stream_write_format(app->file_stream, "PRESSURE_UNIT %d\n", app->settings.pressure_unit);
     stream_write_format(app->file_stream, "HEAT_INDEX %d\n", app->settings.heat_index);
+    stream_write_format(app->file_stream, "LOG_INTERVAL %d\n", app->settings.log_interval);
 
     //Закрытие потока и освобождение памяти
     file_stream_close(app->file_stream);
@@ -205,6 +207,11 @@ bool unitemp_loadSettings(void) {
             int p = 0;
             sscanf(((char*)(file_buf + line_end)), "\nHEAT_INDEX %d", &p);
             app->settings.heat_index = p;
+        } else if(!strcmp(buff, "LOG_INTERVAL")) {
+            //Чтение значения параметра
+            int p = 0;
+            sscanf(((char*)(file_buf + line_end)), "\nLOG_INTERVAL %d", &p);
+            if(p >= 0 && p < UT_LOG_INTERVALS_COUNT) app->settings.log_interval = p;
         } else {
             FURI_LOG_W(APP_NAME, "Unknown settings parameter: %s", buff);
         }
@@ -229,6 +236,9 @@ static void unitemp_sensors_update_callback(void* context) {
     if(app->sensors_ready) {
         unitemp_sensors_updateValues();
     }
+    unitemp_datalogger_tick();
+    unitemp_Graph_tick();
+    unitemp_log_export_tick();
     view_port_update(app->view_port);
 }
 
@@ -255,6 +265,7 @@ static bool unitemp_alloc(void) {
     app->settings.temp_unit = UT_TEMP_CELSIUS; //Единица измерения температуры - градусы Цельсия
     app->settings.pressure_unit = UT_PRESSURE_MM_HG; //Единица измерения давления - мм рт. ст.
     app->settings.heat_index = false;
+    app->settings.log_interval = UT_LOG_OFF; //Журнал выключен
 
     app->gui = furi_record_open(RECORD_GUI);
     //Диспетчер окон
@@ -270,6 +281,8 @@ static bool unitemp_alloc(void) {
 
     app->buff = malloc(BUFF_SIZE);
 
+    unitemp_datalogger_alloc();
+
     unitemp_General_alloc();
 
     unitemp_MainMenu_alloc();
@@ -278,6 +291,7 @@ static bool unitemp_alloc(void) {
     unitemp_SensorEdit_alloc();
     unitemp_SensorNameEdit_alloc();
     unitemp_SensorActions_alloc();
+    unitemp_Graph_alloc();
     unitemp_widgets_alloc();
 
     //Всплывающее окно
@@ -301,6 +315,7 @@ static void unitemp_free(void) {
     view_dispatcher_remove_view(app->view_dispatcher, UnitempViewPopup);
     unitemp_widgets_free();
 
+    unitemp_Graph_free();
     unitemp_SensorActions_free();
     unitemp_SensorNameEdit_free();
     unitemp_SensorEdit_free();
@@ -363,6 +378,8 @@ int32_t unitemp_app() {
 
     view_dispatcher_run(app->view_dispatcher);
 
+    //Запись неполного блока журнала
+    unitemp_datalogger_free();
     //Деинициализация датчиков
     unitemp_sensors_deInit();
     //Автоматическое управление подсветкой
@@ -71,6 +71,16 @@ typedef enum {
 
     UT_PRESSURE_COUNT
 } pressureMeasureUnit;
+//Период записи в журнал
+typedef enum {
+    UT_LOG_OFF,
+    UT_LOG_1S,
+    UT_LOG_10S,
+    UT_LOG_1M,
+    UT_LOG_5M,
+
+    UT_LOG_INTERVALS_COUNT
+} logInterval;
 /* Объявление структур */
 //Настройки плагина
 typedef struct {
@@ -84,6 +94,8 @@ typedef struct {
     bool heat_index;
     //Последнее состояние OTG
     bool lastOTGState;
+    //Период записи в журнал
+    logInterval log_interval;
 } UnitempSettings;
 
 //Основная структура плагина
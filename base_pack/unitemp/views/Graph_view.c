@@ -0,0 +1,246 @@
+/*
+    Unitemp - Universal temperature reader
+    Copyright (C) 2022-2023  Victor Nikitchuk (https://github.com/quen0n)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "UnitempViews.h"
+#include "unitemp_icons.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+//Текущий вид
+static View* view;
+//Датчик, для которого строится график
+static Sensor* current_sensor;
+//Отображаемая величина
+static uint8_t current_quantity;
+//Значения из журнала
+static UnitempLogSeries series;
+//Ряд собирается в отдельном потоке
+static bool loading = false;
+//Текст результата экспорта, всплывающее окно хранит только указатель
+static char export_message[32];
+//Экспорт журнала идёт в отдельном потоке
+static bool exporting = false;
+static uint32_t export_prev_view_id;
+
+//Область графика
+#define GRAPH_X (128 - UNITEMP_LOG_GRAPH_POINTS)
+#define GRAPH_Y 13
+#define GRAPH_HEIGHT (64 - GRAPH_Y)
+
+#define VIEW_ID UnitempViewGraph
+
+static const char* _quantity_name(uint8_t quantity) {
+    static const char* pressure_units[UT_PRESSURE_COUNT] = {"mm Hg", "in Hg", "kPa", "hPa"};
+    switch(quantity) {
+    case UT_TEMPERATURE:
+        return app->settings.temp_unit == UT_TEMP_CELSIUS ? "Temp *C" : "Temp *F";
+    case UT_HUMIDITY:
+        return "Hum %";
+    case UT_PRESSURE:
+        return pressure_units[app->settings.pressure_unit];
+    default:
+        return "CO2 ppm";
+    }
+}
+
+/**
+ * @brief Переход к следующей величине, которую измеряет датчик
+ *
+ * @param forward Направление перебора
+ */
+static void _next_quantity(bool forward) {
+    for(uint8_t i = 0; i < 4; i++) {
+        current_quantity = forward ? current_quantity << 1 : current_quantity >> 1;
+        if(current_quantity > UT_CO2) current_quantity = UT_TEMPERATURE;
+        if(current_quantity == 0) current_quantity = UT_CO2;
+        if(current_sensor->type->datatype & current_quantity) return;
+    }
+}
+
+/**
+ * @brief Печать значения с одним знаком после запятой в буфер приложения
+ */
+static void _format_value(float value) {
+    int32_t value_x10 = value * 10 + (value < 0 ? -0.5f : 0.5f);
+    snprintf(
+        app->buff,
+        BUFF_SIZE,
+        "%s%ld.%ld",
+        value_x10 < 0 ? "-" : "",
+        labs(value_x10) / 10,
+        labs(value_x10) % 10);
+}
+
+static void _draw_callback(Canvas* canvas, void* _model) {
+    UNUSED(_model);
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(canvas, 0, 9, current_sensor->name);
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str_aligned(
+        canvas, 127, 9, AlignRight, AlignBottom, _quantity_name(current_quantity));
+
+    if(loading && series.count == 0) {
+        canvas_draw_str_aligned(canvas, 64, 38, AlignCenter, AlignCenter, "Reading log...");
+        return;
+    }
+    if(series.count == 0) {
+        canvas_draw_str_aligned(canvas, 64, 32, AlignCenter, AlignCenter, "No log data");
+        canvas_draw_str_aligned(
+            canvas, 64, 44, AlignCenter, AlignCenter, "Enable log in Settings");
+        return;
+    }
+
+    float min = series.values[0], max = series.values[0];
+    for(uint8_t i = 1; i < series.count; i++) {
+        if(series.values[i] < min) min = series.values[i];
+        if(series.values[i] > max) max = series.values[i];
+    }
+    //Ровная линия рисуется посередине
+    float range = max - min;
+    if(range < 0.1f) {
+        range = 1;
+        min -= 0.5f;
+    }
+
+    //Шкала
+    _format_value(min + range);
+    canvas_draw_str(canvas, 0, GRAPH_Y + 8, app->buff);
+    _format_value(min);
+    canvas_draw_str(canvas, 0, 63, app->buff);
+    //Длительность журнала на графике
+    uint32_t span = (series.last_time - series.first_time) / 60;
+    if(span < 60) {
+        snprintf(app->buff, BUFF_SIZE, "%lum", span);
+    } else {
+        snprintf(app->buff, BUFF_SIZE, "%luh", span / 60);
+    }
+    canvas_draw_str(canvas, 0, GRAPH_Y + 8 + 19, app->buff);
+
+    canvas_draw_line(canvas, GRAPH_X - 1, GRAPH_Y, GRAPH_X - 1, 63);
+
+    uint8_t prev_y = 0;
+    for(uint8_t i = 0; i < series.count; i++) {
+        uint8_t y = GRAPH_Y + (GRAPH_HEIGHT - 1) -
+                    (uint8_t)((series.values[i] - min) * (GRAPH_HEIGHT - 1) / range);
+        uint8_t x = GRAPH_X + (UNITEMP_LOG_GRAPH_POINTS - series.count) + i;
+        if(i == 0) {
+            canvas_draw_dot(canvas, x, y);
+        } else {
+            canvas_draw_line(canvas, x - 1, prev_y, x, y);
+        }
+        prev_y = y;
+    }
+}
+
+/**
+ * @brief Запуск сборки ряда для текущей величины, до её окончания виден прежний график
+ *
+ * @param clear Прежний график относится к другой величине и не показывается
+ */
+static void _load_series(bool clear) {
+    if(clear) memset(&series, 0, sizeof(series));
+    loading = unitemp_datalogger_seriesStart(current_sensor, current_quantity);
+}
+
+static bool _input_callback(InputEvent* event, void* context) {
+    UNUSED(context);
+    if(event->type != InputTypeShort) return false;
+
+    //Переключение величины
+    if(event->key == InputKeyLeft || event->key == InputKeyRight) {
+        _next_quantity(event->key == InputKeyRight);
+        _load_series(true);
+        return true;
+    }
+    //Обновление графика
+    if(event->key == InputKeyOk) {
+        _load_series(false);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Функция обработки нажатия кнопки "Назад"
+ *
+ * @param context Указатель на данные приложения
+ * @return ID вида в который нужно переключиться
+ */
+static uint32_t _exit_callback(void* context) {
+    UNUSED(context);
+    app->sensors_ready = false;
+    //Возврат предыдущий вид
+    return UnitempViewSensorActions;
+}
+
+void unitemp_Graph_alloc(void) {
+    view = view_alloc();
+    view_set_context(view, app);
+    view_set_draw_callback(view, _draw_callback);
+    view_set_input_callback(view, _input_callback);
+    view_set_previous_callback(view, _exit_callback);
+
+    view_dispatcher_add_view(app->view_dispatcher, VIEW_ID, view);
+}
+
+void unitemp_Graph_switch(Sensor* sensor) {
+    current_sensor = sensor;
+    current_quantity = UT_TEMPERATURE;
+    _load_series(true);
+    //Журнал продолжает пополняться, пока открыт график
+    app->sensors_ready = true;
+    view_dispatcher_switch_to_view(app->view_dispatcher, VIEW_ID);
+}
+
+void unitemp_Graph_free(void) {
+    view_dispatcher_remove_view(app->view_dispatcher, VIEW_ID);
+    view_free(view);
+}
+
+void unitemp_Graph_tick(void) {
+    if(!loading) return;
+    if(unitemp_datalogger_seriesPoll(&series)) loading = false;
+}
+
+void unitemp_log_export(uint32_t prev_view_id) {
+    if(!unitemp_datalogger_exportStart()) return;
+    //Экспорт отменил сборку ряда
+    loading = false;
+    export_prev_view_id = prev_view_id;
+    exporting = true;
+    snprintf(export_message, sizeof(export_message), "%d values", 0);
+    unitemp_popup_progress(&I_sherlok_53x45, "Exporting log", export_message);
+}
+
+void unitemp_log_export_tick(void) {
+    if(!exporting) return;
+    int32_t rows;
+    if(!unitemp_datalogger_exportPoll(&rows)) {
+        snprintf(export_message, sizeof(export_message), "%ld values", rows);
+        unitemp_popup_update(export_message);
+        return;
+    }
+    exporting = false;
+    if(rows < 0) {
+        unitemp_popup(&I_Cry_dolph_55x52, "Export failed", "Check SD card", export_prev_view_id);
+        return;
+    }
+    snprintf(
+        export_message, sizeof(export_message), "%ld values\nto %s", rows, APP_FILENAME_LOG_CSV);
+    unitemp_popup(&I_DolphinCommon_56x48, "Log exported", export_message, export_prev_view_id);
+}
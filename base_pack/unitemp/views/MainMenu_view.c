@@ -50,10 +50,13 @@ static void _enter_callback(void* context, uint32_t index) {
     if(index == 1) { //Settings
         unitemp_Settings_switch();
     }
-    if(index == 2) {
-        unitemp_widget_help_switch();
+    if(index == 2) { //Export log to CSV
+        unitemp_log_export(VIEW_ID);
     }
     if(index == 3) {
+        unitemp_widget_help_switch();
+    }
+    if(index == 4) {
         unitemp_widget_about_switch();
     }
 }
@@ -68,6 +71,7 @@ void unitemp_MainMenu_alloc(void) {
 
     variable_item_list_add(variable_item_list, "Add new sensor", 1, NULL, NULL);
     variable_item_list_add(variable_item_list, "Settings", 1, NULL, NULL);
+    variable_item_list_add(variable_item_list, "Export log to CSV", 1, NULL, NULL);
     variable_item_list_add(variable_item_list, "Help", 1, NULL, NULL);
     variable_item_list_add(variable_item_list, "About", 1, NULL, NULL);
 
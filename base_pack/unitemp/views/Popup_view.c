@@ -28,18 +28,42 @@ static void _popup_callback(void* context) {
     view_dispatcher_switch_to_view(app->view_dispatcher, _prev_view_id);
 }
 
-void unitemp_popup(const Icon* icon, char* header, char* message, uint32_t prev_view_id) {
-    _prev_view_id = prev_view_id;
+static const Icon* _popup_icon;
+
+//Пока идёт фоновая операция нажатия кнопок игнорируются
+static void _progress_callback(void* context) {
+    UNUSED(context);
+}
+
+static void _popup_set(const Icon* icon, char* header, char* message) {
+    _popup_icon = icon;
     popup_reset(app->popup);
     popup_set_icon(app->popup, 0, 64 - icon_get_height(icon), icon);
     popup_set_header(app->popup, header, 64, 6, AlignCenter, AlignCenter);
+    unitemp_popup_update(message);
+}
+
+void unitemp_popup_update(char* message) {
     popup_set_text(
         app->popup,
         message,
-        (128 - icon_get_width(icon)) / 2 + icon_get_width(icon),
+        (128 - icon_get_width(_popup_icon)) / 2 + icon_get_width(_popup_icon),
         32,
         AlignCenter,
         AlignCenter);
+}
+
+void unitemp_popup_progress(const Icon* icon, char* header, char* message) {
+    _popup_set(icon, header, message);
+    popup_set_callback(app->popup, _progress_callback);
+    popup_disable_timeout(app->popup);
+
+    view_dispatcher_switch_to_view(app->view_dispatcher, VIEW_ID);
+}
+
+void unitemp_popup(const Icon* icon, char* header, char* message, uint32_t prev_view_id) {
+    _prev_view_id = prev_view_id;
+    _popup_set(icon, header, message);
 
     popup_set_timeout(app->popup, 5000);
     popup_set_callback(app->popup, _popup_callback);
@@ -60,21 +60,27 @@ static void _enter_callback(void* context, uint32_t index) {
         unitemp_General_switch();
         return;
     case 1:
-        unitemp_SensorEdit_switch(current_sensor);
+        unitemp_Graph_switch(current_sensor);
         break;
     case 2:
-        unitemp_widget_delete_switch(current_sensor);
+        unitemp_SensorEdit_switch(current_sensor);
         break;
     case 3:
-        unitemp_SensorsList_switch();
+        unitemp_widget_delete_switch(current_sensor);
         break;
     case 4:
-        unitemp_Settings_switch();
+        unitemp_SensorsList_switch();
         break;
     case 5:
-        unitemp_widget_help_switch();
+        unitemp_Settings_switch();
         break;
     case 6:
+        unitemp_log_export(VIEW_ID);
+        break;
+    case 7:
+        unitemp_widget_help_switch();
+        break;
+    case 8:
         unitemp_widget_about_switch();
         break;
     }
@@ -89,11 +95,13 @@ void unitemp_SensorActions_alloc(void) {
     variable_item_list_reset(variable_item_list);
 
     variable_item_list_add(variable_item_list, "Info", 1, NULL, NULL);
+    variable_item_list_add(variable_item_list, "Trend", 1, NULL, NULL);
     variable_item_list_add(variable_item_list, "Edit", 1, NULL, NULL);
     variable_item_list_add(variable_item_list, "Delete", 1, NULL, NULL);
 
     variable_item_list_add(variable_item_list, "Add new sensor", 1, NULL, NULL);
     variable_item_list_add(variable_item_list, "Settings", 1, NULL, NULL);
+    variable_item_list_add(variable_item_list, "Export log to CSV", 1, NULL, NULL);
     variable_item_list_add(variable_item_list, "Help", 1, NULL, NULL);
     variable_item_list_add(variable_item_list, "About", 1, NULL, NULL);
 
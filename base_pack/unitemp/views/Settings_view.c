@@ -27,6 +27,7 @@ static const char states[2][9] = {"Auto", "Infinity"};
 static const char temp_units[UT_TEMP_COUNT][3] = {"*C", "*F"};
 static const char pressure_units[UT_PRESSURE_COUNT][6] = {"mm Hg", "in Hg", "kPa", "hPA"};
 static const char heat_index_bool[2][4] = {"OFF", "ON"};
+static const char log_intervals[UT_LOG_INTERVALS_COUNT][4] = {"OFF", "1s", "10s", "1m", "5m"};
 
 //Элемент списка - бесконечная подсветка
 VariableItem* infinity_backlight_item;
@@ -36,6 +37,8 @@ VariableItem* temperature_unit_item;
 VariableItem* pressure_unit_item;
 
 VariableItem* heat_index_item;
+//Период записи в журнал
+VariableItem* log_interval_item;
 #define VIEW_ID UnitempViewSettings
 
 /**
@@ -61,6 +64,7 @@ static uint32_t _exit_callback(void* context) {
     app->settings.temp_unit = variable_item_get_current_value_index(temperature_unit_item);
     app->settings.pressure_unit = variable_item_get_current_value_index(pressure_unit_item);
     app->settings.heat_index = variable_item_get_current_value_index(heat_index_item);
+    app->settings.log_interval = variable_item_get_current_value_index(log_interval_item);
     unitemp_saveSettings();
     unitemp_loadSettings();
 
@@ -99,6 +103,11 @@ static void _setting_change_callback(VariableItem* item) {
             heat_index_item,
             heat_index_bool[variable_item_get_current_value_index(heat_index_item)]);
     }
+    if(item == log_interval_item) {
+        variable_item_set_current_value_text(
+            log_interval_item,
+            log_intervals[variable_item_get_current_value_index(log_interval_item)]);
+    }
 }
 
 /**
@@ -117,6 +126,8 @@ void unitemp_Settings_alloc(void) {
         variable_item_list, "Press. unit", UT_PRESSURE_COUNT, _setting_change_callback, app);
     heat_index_item = variable_item_list_add(
         variable_item_list, "Calc. heat index", 2, _setting_change_callback, app);
+    log_interval_item = variable_item_list_add(
+        variable_item_list, "Log interval", UT_LOG_INTERVALS_COUNT, _setting_change_callback, app);
 
     //Добавление колбека на нажатие средней кнопки
     variable_item_list_set_enter_callback(variable_item_list, _enter_callback, app);
@@ -154,6 +165,11 @@ void unitemp_Settings_switch(void) {
     variable_item_set_current_value_text(
         heat_index_item, heat_index_bool[variable_item_get_current_value_index(heat_index_item)]);
 
+    variable_item_set_current_value_index(log_interval_item, (uint8_t)app->settings.log_interval);
+    variable_item_set_current_value_text(
+        log_interval_item,
+        log_intervals[variable_item_get_current_value_index(log_interval_item)]);
+
     view_dispatcher_switch_to_view(app->view_dispatcher, VIEW_ID);
 }
 
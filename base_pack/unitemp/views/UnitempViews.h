@@ -19,6 +19,7 @@
 #define UNITEMP_SCENES
 
 #include "../unitemp.h"
+#include "../Datalogger.h"
 
 //Виды менюшек
 typedef enum UnitempViews {
@@ -29,6 +30,7 @@ typedef enum UnitempViews {
     UnitempViewSensorEdit,
     UnitempViewSensorNameEdit,
     UnitempViewSensorActions,
+    UnitempViewGraph,
     UnitempViewWidget,
     UnitempViewPopup,
 
@@ -45,6 +47,23 @@ typedef enum UnitempViews {
  */
 void unitemp_popup(const Icon* icon, char* header, char* message, uint32_t prev_view_id);
 
+/**
+ * @brief Вывести всплывающее окно на время фоновой операции
+ * Окно не закрывается само и не реагирует на кнопки
+ *
+ * @param icon Указатель на иконку
+ * @param header Заголовок
+ * @param message Сообщение
+ */
+void unitemp_popup_progress(const Icon* icon, char* header, char* message);
+
+/**
+ * @brief Обновить сообщение во всплывающем окне
+ *
+ * @param message Сообщение
+ */
+void unitemp_popup_update(char* message);
+
 /* Общий вид на датчики */
 void unitemp_General_alloc(void);
 void unitemp_General_switch(void);
@@ -81,6 +100,28 @@ void unitemp_SensorActions_alloc(void);
 void unitemp_SensorActions_switch(Sensor* sensor);
 void unitemp_SensorActions_free(void);
 
+/* График значений из журнала */
+void unitemp_Graph_alloc(void);
+void unitemp_Graph_switch(Sensor* sensor);
+void unitemp_Graph_free(void);
+
+/**
+ * @brief Проверка сборки графика, вызывается по таймеру обновления
+ */
+void unitemp_Graph_tick(void);
+
+/**
+ * @brief Запуск экспорта журнала в CSV с выводом хода и результата во всплывающем окне
+ *
+ * @param prev_view_id ID вида, в который нужно вернуться
+ */
+void unitemp_log_export(uint32_t prev_view_id);
+
+/**
+ * @brief Проверка хода экспорта журнала, вызывается по таймеру обновления
+ */
+void unitemp_log_export_tick(void);
+
 /* Виджеты */
 void unitemp_widgets_alloc(void);
 void unitemp_widgets_free(void);
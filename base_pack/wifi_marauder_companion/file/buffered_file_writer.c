@@ -0,0 +1,185 @@
+#include "buffered_file_writer.h"
+
+#include <furi.h>
+
+#define TAG "BufferedFileWriter"
+
+struct BufferedFileWriter {
+    File* file;
+    FuriThread* thread;
+    FuriMutex* mutex;
+
+    // buffers[active] is filled by write(), buffers[pending] is being written to the card
+    uint8_t buffers[2][BUFFERED_FILE_WRITER_BLOCK_SIZE];
+    uint8_t active;
+    size_t fill;
+    int8_t pending;
+    size_t pending_len;
+
+    size_t dropped;
+};
+
+typedef enum {
+    WriterEvtStop = (1 << 0),
+    WriterEvtWrite = (1 << 1),
+} WriterEvtFlags;
+
+#define WRITER_ALL_EVENTS (WriterEvtStop | WriterEvtWrite)
+
+// Hands the active buffer over to the thread, called with the mutex held
+static bool buffered_file_writer_swap(BufferedFileWriter* writer) {
+    if(writer->pending >= 0 || writer->fill == 0) {
+        return false;
+    }
+    writer->pending = writer->active;
+    writer->pending_len = writer->fill;
+    writer->active ^= 1;
+    writer->fill = 0;
+    return true;
+}
+
+static void buffered_file_writer_write_pending(BufferedFileWriter* writer) {
+    while(1) {
+        furi_mutex_acquire(writer->mutex, FuriWaitForever);
+        int8_t pending = writer->pending;
+        size_t len = writer->pending_len;
+        furi_mutex_release(writer->mutex);
+
+        if(pending < 0) {
+            return;
+        }
+
+        size_t written = storage_file_write(writer->file, writer->buffers[pending], len);
+        if(written != len) {
+            FURI_LOG_E(TAG, "Wrote %u of %u bytes", written, len);
+        }
+
+        furi_mutex_acquire(writer->mutex, FuriWaitForever);
+        writer->dropped += len - written;
+        writer->pending = -1;
+        // The other buffer may have filled up while the card was busy
+        bool more = writer->fill == BUFFERED_FILE_WRITER_BLOCK_SIZE &&
+                    buffered_file_writer_swap(writer);
+        furi_mutex_release(writer->mutex);
+
+        if(!more) {
+            return;
+        }
+    }
+}
+
+static int32_t buffered_file_writer_worker(void* context) {
+    BufferedFileWriter* writer = context;
+
+    while(1) {
+        uint32_t events = furi_thread_flags_wait(
+            WRITER_ALL_EVENTS, FuriFlagWaitAny, BUFFERED_FILE_WRITER_FLUSH_MS);
+        if(events == (uint32_t)FuriFlagErrorTimeout) {
+            // No full buffer for a while, write out what is there so it is not lost on a crash
+            furi_mutex_acquire(writer->mutex, FuriWaitForever);
+            buffered_file_writer_swap(writer);
+            furi_mutex_release(writer->mutex);
+            events = WriterEvtWrite;
+        }
+        furi_check((events & FuriFlagError) == 0);
+        if(events & WriterEvtWrite) {
+            buffered_file_writer_write_pending(writer);
+        }
+        if(events & WriterEvtStop) break;
+    }
+
+    // write() is not called anymore, write out the pending and the partial buffer
+    buffered_file_writer_write_pending(writer);
+    furi_mutex_acquire(writer->mutex, FuriWaitForever);
+    buffered_file_writer_swap(writer);
+    furi_mutex_release(writer->mutex);
+    buffered_file_writer_write_pending(writer);
+
+    return 0;
+}
+
+BufferedFileWriter* buffered_file_writer_alloc(File* file, const char* thread_name) {
+    furi_assert(file);
+    BufferedFileWriter* writer = malloc(sizeof(BufferedFileWriter));
+
+    writer->file = file;
+    writer->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    writer->active = 0;
+    writer->fill = 0;
+    writer->pending = -1;
+    writer->pending_len = 0;
+    writer->dropped = 0;
+
+    writer->thread = furi_thread_alloc();
+    furi_thread_set_name(writer->thread, thread_name);
+    furi_thread_set_stack_size(writer->thread, 1024);
+    furi_thread_set_context(writer->thread, writer);
+    furi_thread_set_callback(writer->thread, buffered_file_writer_worker);
+    furi_thread_start(writer->thread);
+
+    return writer;
+}
+
+void buffered_file_writer_free(BufferedFileWriter* writer) {
+    furi_assert(writer);
+
+    furi_thread_flags_set(furi_thread_get_id(writer->thread), WriterEvtStop);
+    furi_thread_join(writer->thread);
+    furi_thread_free(writer->thread);
+
+    if(writer->dropped > 0) {
+        FURI_LOG_W(TAG, "Dropped %u bytes", writer->dropped);
+    }
+
+    furi_mutex_free(writer->mutex);
+    free(writer);
+}
+
+bool buffered_file_writer_write(BufferedFileWriter* writer, const uint8_t* data, size_t len) {
+    furi_assert(writer);
+    bool success = true;
+
+    furi_mutex_acquire(writer->mutex, FuriWaitForever);
+
+    size_t free_space = BUFFERED_FILE_WRITER_BLOCK_SIZE - writer->fill;
+    if(writer->pending < 0) {
+        free_space += BUFFERED_FILE_WRITER_BLOCK_SIZE;
+    }
+
+    if(len > free_space) {
+        // A chunk is either stored whole or dropped whole
+        writer->dropped += len;
+        success = false;
+    } else {
+        bool swapped = false;
+        while(len > 0) {
+            // The free space check guarantees the other buffer is available here
+            if(writer->fill == BUFFERED_FILE_WRITER_BLOCK_SIZE) {
+                swapped |= buffered_file_writer_swap(writer);
+            }
+            size_t part = MIN(len, BUFFERED_FILE_WRITER_BLOCK_SIZE - writer->fill);
+            memcpy(&writer->buffers[writer->active][writer->fill], data, part);
+            writer->fill += part;
+            data += part;
+            len -= part;
+        }
+        if(writer->fill == BUFFERED_FILE_WRITER_BLOCK_SIZE) {
+            swapped |= buffered_file_writer_swap(writer);
+        }
+        if(swapped) {
+            furi_thread_flags_set(furi_thread_get_id(writer->thread), WriterEvtWrite);
+        }
+    }
+
+    furi_mutex_release(writer->mutex);
+
+    return success;
+}
+
+size_t buffered_file_writer_get_dropped(BufferedFileWriter* writer) {
+    furi_assert(writer);
+    furi_mutex_acquire(writer->mutex, FuriWaitForever);
+    size_t dropped = writer->dropped;
+    furi_mutex_release(writer->mutex);
+    return dropped;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <storage/storage.h>
+
+// Size of each of the two staging buffers, full buffers are written to the card in one call
+#define BUFFERED_FILE_WRITER_BLOCK_SIZE (4096)
+// A partially filled buffer is written out after the input has been idle for this long
+#define BUFFERED_FILE_WRITER_FLUSH_MS (1000)
+
+typedef struct BufferedFileWriter BufferedFileWriter;
+
+// Starts a writer thread for an already opened file, the file stays owned by the caller
+BufferedFileWriter* buffered_file_writer_alloc(File* file, const char* thread_name);
+
+// Writes everything that is still buffered and stops the thread, the file can be closed after
+void buffered_file_writer_free(BufferedFileWriter* writer);
+
+// Copies data to the staging buffer without waiting for the card.
+// Returns false if both buffers are busy and the whole chunk was dropped.
+bool buffered_file_writer_write(BufferedFileWriter* writer, const uint8_t* data, size_t len);
+
+// Bytes dropped because the card did not keep up or a write failed
+size_t buffered_file_writer_get_dropped(BufferedFileWriter* writer);
@@ -0,0 +1,162 @@
+#include "pcap_framer.h"
+
+#include <furi.h>
+
+#define TAG "PcapFramer"
+
+#define PCAP_FILE_HEADER_SIZE (24)
+#define PCAP_RECORD_HEADER_SIZE (16)
+#define PCAP_MAGIC_US (0xa1b2c3d4)
+#define PCAP_MAGIC_NS (0xa1b23c4d)
+// Used when the file header has no sane snaplen
+#define PCAP_MAX_SNAPLEN (262144)
+
+struct PcapFramer {
+    // File header or record collected so far
+    uint8_t record[PCAP_FRAMER_RECORD_MAX];
+    size_t record_len;
+    // Full size of the current record, 0 until its header is in
+    size_t record_size;
+    // Body bytes of a record that is too large and skipped
+    size_t skip_left;
+
+    bool has_file_header;
+    // File was written big endian
+    bool swapped;
+    uint32_t snaplen;
+
+    bool broken;
+    size_t dropped;
+};
+
+static uint32_t pcap_framer_u32(bool swapped, const uint8_t* p) {
+    if(swapped) {
+        return ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+    }
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool pcap_framer_is_magic(uint32_t value) {
+    return value == PCAP_MAGIC_US || value == PCAP_MAGIC_NS;
+}
+
+// The magic comes first in a file header, a record starts with its timestamp instead
+static bool pcap_framer_has_magic(const uint8_t* p) {
+    return pcap_framer_is_magic(pcap_framer_u32(false, p)) ||
+           pcap_framer_is_magic(pcap_framer_u32(true, p));
+}
+
+static void pcap_framer_file_header(PcapFramer* framer, BufferedFileWriter* writer) {
+    if(framer->has_file_header) {
+        // Marauder sends a new file header every time sniffing starts, the file keeps the first
+        return;
+    }
+    if(!pcap_framer_has_magic(framer->record)) {
+        FURI_LOG_E(TAG, "No PCAP file header");
+        framer->broken = true;
+        return;
+    }
+    framer->swapped = !pcap_framer_is_magic(pcap_framer_u32(false, framer->record));
+    framer->snaplen = pcap_framer_u32(framer->swapped, &framer->record[16]);
+    if(framer->snaplen == 0 || framer->snaplen > PCAP_MAX_SNAPLEN) {
+        framer->snaplen = PCAP_MAX_SNAPLEN;
+    }
+    // A capture without its file header is of no use
+    if(!buffered_file_writer_write(writer, framer->record, PCAP_FILE_HEADER_SIZE)) {
+        framer->broken = true;
+        return;
+    }
+    framer->has_file_header = true;
+}
+
+static void pcap_framer_record_header(PcapFramer* framer) {
+    uint32_t incl_len = pcap_framer_u32(framer->swapped, &framer->record[8]);
+    if(incl_len > framer->snaplen) {
+        // Bytes were lost before they reached us, record boundaries are unknown from here on
+        FURI_LOG_E(TAG, "Record of %lu bytes, stream out of sync", incl_len);
+        framer->broken = true;
+        return;
+    }
+
+    size_t size = PCAP_RECORD_HEADER_SIZE + incl_len;
+    if(size > PCAP_FRAMER_RECORD_MAX) {
+        framer->dropped += size;
+        framer->skip_left = incl_len;
+        framer->record_len = 0;
+        return;
+    }
+    framer->record_size = size;
+}
+
+PcapFramer* pcap_framer_alloc(void) {
+    PcapFramer* framer = malloc(sizeof(PcapFramer));
+    memset(framer, 0, sizeof(PcapFramer));
+    return framer;
+}
+
+void pcap_framer_free(PcapFramer* framer) {
+    furi_assert(framer);
+    free(framer);
+}
+
+bool pcap_framer_feed(
+    PcapFramer* framer,
+    BufferedFileWriter* writer,
+    const uint8_t* data,
+    size_t len) {
+    furi_assert(framer);
+    furi_assert(writer);
+
+    while(!framer->broken) {
+        if(framer->skip_left > 0) {
+            if(len == 0) break;
+            size_t part = MIN(len, framer->skip_left);
+            framer->skip_left -= part;
+            data += part;
+            len -= part;
+            continue;
+        }
+
+        size_t need = framer->record_size;
+        if(need == 0) {
+            // Record headers are shorter, a file header is told apart by its magic
+            need = PCAP_RECORD_HEADER_SIZE;
+            if(!framer->has_file_header ||
+               (framer->record_len >= 4 && pcap_framer_has_magic(framer->record))) {
+                need = PCAP_FILE_HEADER_SIZE;
+            }
+        }
+        if(framer->record_len < need) {
+            if(len == 0) break;
+            size_t part = MIN(len, need - framer->record_len);
+            memcpy(&framer->record[framer->record_len], data, part);
+            framer->record_len += part;
+            data += part;
+            len -= part;
+            // Recheck the size once the magic is in
+            continue;
+        }
+
+        if(framer->record_size == 0) {
+            if(need == PCAP_FILE_HEADER_SIZE) {
+                pcap_framer_file_header(framer, writer);
+                framer->record_len = 0;
+            } else {
+                pcap_framer_record_header(framer);
+            }
+            continue;
+        }
+
+        // The writer stores the record whole or counts it as dropped
+        buffered_file_writer_write(writer, framer->record, framer->record_len);
+        framer->record_len = 0;
+        framer->record_size = 0;
+    }
+
+    return !framer->broken;
+}
+
+size_t pcap_framer_get_dropped(PcapFramer* framer) {
+    furi_assert(framer);
+    return framer->dropped;
+}
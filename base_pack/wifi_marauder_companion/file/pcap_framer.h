@@ -0,0 +1,25 @@
+#pragma once
+
+#include "buffered_file_writer.h"
+
+// Largest record that is kept, 802.11 frames are well below it
+#define PCAP_FRAMER_RECORD_MAX (BUFFERED_FILE_WRITER_BLOCK_SIZE)
+
+typedef struct PcapFramer PcapFramer;
+
+PcapFramer* pcap_framer_alloc(void);
+
+void pcap_framer_free(PcapFramer* framer);
+
+// Splits the serial PCAP stream into the file header and records and hands each record to the
+// writer in one write(), so a slow card drops whole records and never leaves half of one.
+// A repeated file header from a restarted sniff is skipped.
+// Returns false once the stream can't be parsed anymore, nothing is written after that.
+bool pcap_framer_feed(
+    PcapFramer* framer,
+    BufferedFileWriter* writer,
+    const uint8_t* data,
+    size_t len);
+
+// Bytes of records skipped because they are larger than PCAP_FRAMER_RECORD_MAX
+size_t pcap_framer_get_dropped(PcapFramer* framer);
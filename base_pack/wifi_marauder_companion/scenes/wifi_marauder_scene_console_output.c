@@ -40,34 +40,93 @@ bool _wifi_marauder_is_saving_enabled(WifiMarauderApp* app) {
             strncmp("evilportal", app->selected_tx_string, strlen("evilportal")) == 0);
 }
 
+void _wifi_marauder_console_output_append(WifiMarauderApp* app, const char* text, size_t len) {
+    // If text box store gets too big, then truncate it
+    app->text_box_store_strlen += len;
+    if(app->text_box_store_strlen >= WIFI_MARAUDER_TEXT_BOX_STORE_SIZE - 1) {
+        furi_string_right(app->text_box_store, app->text_box_store_strlen / 2);
+        app->text_box_store_strlen = furi_string_size(app->text_box_store) + len;
+    }
+
+    furi_string_cat_str(app->text_box_store, text);
+    view_dispatcher_send_custom_event(app->view_dispatcher, WifiMarauderEventRefreshConsoleOutput);
+}
+
+// Called from the UART thread after a write, so the console shows when the SD card falls behind
+void _wifi_marauder_console_output_report_dropped(WifiMarauderApp* app) {
+    size_t dropped = 0;
+    furi_mutex_acquire(app->writer_mutex, FuriWaitForever);
+    if(app->capture_writer) {
+        dropped += buffered_file_writer_get_dropped(app->capture_writer);
+    }
+    if(app->capture_framer) {
+        dropped += pcap_framer_get_dropped(app->capture_framer);
+    }
+    if(app->log_writer) {
+        dropped += buffered_file_writer_get_dropped(app->log_writer);
+    }
+    furi_mutex_release(app->writer_mutex);
+    if(dropped == app->reported_dropped_bytes) {
+        return;
+    }
+
+    // Don't flood the console while the card keeps dropping
+    uint32_t now = furi_get_tick();
+    if(app->reported_dropped_bytes > 0 &&
+       now - app->last_drop_report_tick < furi_ms_to_ticks(1000)) {
+        return;
+    }
+    app->reported_dropped_bytes = dropped;
+    app->last_drop_report_tick = now;
+
+    char msg[48];
+    int len = snprintf(msg, sizeof(msg), "\n[SD too slow, %u bytes dropped]\n", dropped);
+    _wifi_marauder_console_output_append(app, msg, len);
+}
+
 void wifi_marauder_console_output_handle_rx_data_cb(uint8_t* buf, size_t len, void* context) {
     furi_assert(context);
     WifiMarauderApp* app = context;
 
+    furi_mutex_acquire(app->writer_mutex, FuriWaitForever);
     if(app->is_writing_log) {
         app->has_saved_logs_this_session = true;
-        storage_file_write(app->log_file, buf, len);
-    }
-
-    // If text box store gets too big, then truncate it
-    app->text_box_store_strlen += len;
-    if(app->text_box_store_strlen >= WIFI_MARAUDER_TEXT_BOX_STORE_SIZE - 1) {
-        furi_string_right(app->text_box_store, app->text_box_store_strlen / 2);
-        app->text_box_store_strlen = furi_string_size(app->text_box_store) + len;
+        buffered_file_writer_write(app->log_writer, buf, len);
     }
+    furi_mutex_release(app->writer_mutex);
 
     // Null-terminate buf and append to text box store
     buf[len] = '\0';
-    furi_string_cat_printf(app->text_box_store, "%s", buf);
-    view_dispatcher_send_custom_event(app->view_dispatcher, WifiMarauderEventRefreshConsoleOutput);
+    _wifi_marauder_console_output_append(app, (char*)buf, len);
+
+    _wifi_marauder_console_output_report_dropped(app);
 }
 
 void wifi_marauder_console_output_handle_rx_packets_cb(uint8_t* buf, size_t len, void* context) {
     furi_assert(context);
     WifiMarauderApp* app = context;
 
+    bool writing = false;
+    bool stopped = false;
+    furi_mutex_acquire(app->writer_mutex, FuriWaitForever);
     if(app->is_writing_pcap) {
-        storage_file_write(app->capture_file, buf, len);
+        writing = true;
+        if(app->capture_framer) {
+            // Records after a lost byte can't be found, keep the file readable up to here
+            stopped = !pcap_framer_feed(app->capture_framer, app->capture_writer, buf, len);
+            app->is_writing_pcap = !stopped;
+        } else {
+            buffered_file_writer_write(app->capture_writer, buf, len);
+        }
+    }
+    furi_mutex_release(app->writer_mutex);
+
+    if(stopped) {
+        const char* msg = "\n[PCAP stream out of sync, capture stopped]\n";
+        _wifi_marauder_console_output_append(app, msg, strlen(msg));
+    }
+    if(writing) {
+        _wifi_marauder_console_output_report_dropped(app);
     }
 }
 
@@ -107,6 +166,8 @@ void wifi_marauder_scene_console_output_on_enter(void* context) {
     // Set starting text
     text_box_set_text(app->text_box, furi_string_get_cstr(app->text_box_store));
 
+    app->reported_dropped_bytes = 0;
+
     // Set scene state and switch view
     scene_manager_set_scene_state(app->scene_manager, WifiMarauderSceneConsoleOutput, 0);
     view_dispatcher_switch_to_view(app->view_dispatcher, WifiMarauderAppViewConsoleOutput);
@@ -138,6 +199,8 @@ void wifi_marauder_scene_console_output_on_enter(void* context) {
                 free(resolved_path);
                 if(storage_file_open(
                        app->log_file, app->log_file_path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+                    app->log_writer =
+                        buffered_file_writer_alloc(app->log_file, "WifiMarauderLogWriter");
                     app->is_writing_log = true;
                 } else {
                     dialog_message_show_storage_error(app->dialogs, "Cannot open log file");
@@ -151,15 +214,20 @@ void wifi_marauder_scene_console_output_on_enter(void* context) {
         if(_wifi_marauder_is_saving_enabled(app)) {
             const char* folder = NULL;
             const char* extension = NULL;
+            bool pcap = false;
             if(app->script || // Scripts only support sniff functions, but selected_tx_string is empty
                strncmp("sniff", app->selected_tx_string, strlen("sniff")) == 0) {
                 folder = MARAUDER_APP_FOLDER_PCAPS;
                 extension = "pcap";
+                pcap = true;
             } else {
                 folder = MARAUDER_APP_FOLDER_DUMPS;
                 extension = "txt";
             }
             if(sequential_file_open(app->storage, app->capture_file, folder, prefix, extension)) {
+                app->capture_writer =
+                    buffered_file_writer_alloc(app->capture_file, "WifiMarauderPcapWriter");
+                app->capture_framer = pcap ? pcap_framer_alloc() : NULL;
                 app->is_writing_pcap = true;
             } else {
                 dialog_message_show_storage_error(app->dialogs, "Cannot open capture file");
@@ -243,12 +311,33 @@ void wifi_marauder_scene_console_output_on_exit(void* context) {
         app->script_worker = NULL;
     }
 
+    // The UART thread may still be inside a callback that was taken before the unregister,
+    // once the writers are detached under the lock it can't reach them anymore
+    furi_mutex_acquire(app->writer_mutex, FuriWaitForever);
     app->is_writing_pcap = false;
+    app->is_writing_log = false;
+    BufferedFileWriter* capture_writer = app->capture_writer;
+    PcapFramer* capture_framer = app->capture_framer;
+    BufferedFileWriter* log_writer = app->log_writer;
+    app->capture_writer = NULL;
+    app->capture_framer = NULL;
+    app->log_writer = NULL;
+    furi_mutex_release(app->writer_mutex);
+
+    // Write out whatever is still buffered before closing the files
+    if(capture_writer) {
+        buffered_file_writer_free(capture_writer);
+    }
+    if(capture_framer) {
+        pcap_framer_free(capture_framer);
+    }
     if(app->capture_file && storage_file_is_open(app->capture_file)) {
         storage_file_close(app->capture_file);
     }
 
-    app->is_writing_log = false;
+    if(log_writer) {
+        buffered_file_writer_free(log_writer);
+    }
     if(app->log_file && storage_file_is_open(app->log_file)) {
         storage_file_close(app->log_file);
     }
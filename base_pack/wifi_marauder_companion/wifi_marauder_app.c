@@ -76,6 +76,10 @@ WifiMarauderApp* wifi_marauder_app_alloc() {
         app->view_dispatcher, WifiMarauderAppViewWidget, widget_get_view(app->widget));
 
     app->has_saved_logs_this_session = false;
+    app->capture_writer = NULL;
+    app->capture_framer = NULL;
+    app->log_writer = NULL;
+    app->writer_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
 
     // if user hasn't confirmed whether to save pcaps and logs to sdcard, then prompt when scene starts
     app->need_to_prompt_settings_init =
@@ -170,6 +174,7 @@ void wifi_marauder_app_free(WifiMarauderApp* app) {
     scene_manager_free(app->scene_manager);
 
     wifi_marauder_uart_free(app->uart);
+    furi_mutex_free(app->writer_mutex);
 
     // Close records
     furi_record_close(RECORD_GUI);
@@ -8,6 +8,8 @@
 #include "wifi_marauder_uart.h"
 #include "wifi_marauder_ep.h"
 #include "file/sequential_file.h"
+#include "file/buffered_file_writer.h"
+#include "file/pcap_framer.h"
 #include "script/wifi_marauder_script.h"
 #include "script/wifi_marauder_script_worker.h"
 #include "script/wifi_marauder_script_executor.h"
@@ -90,6 +92,14 @@ struct WifiMarauderApp {
     bool show_stopscan_tip;
     bool is_writing_pcap;
     bool is_writing_log;
+    BufferedFileWriter* capture_writer;
+    // Splits .pcap captures into whole records, NULL for text dumps
+    PcapFramer* capture_framer;
+    BufferedFileWriter* log_writer;
+    // Held by the UART thread while it uses the writers, so the scene can free them safely
+    FuriMutex* writer_mutex;
+    size_t reported_dropped_bytes;
+    uint32_t last_drop_report_tick;
 
     // User input
     WifiMarauderUserInputType user_input_type;
@@ -0,0 +1,24 @@
+#!/bin/bash
+# Copy the shared nRF24 driver into every app that builds it, or with --check only
+# report copies that drifted. Apps keep real copies because CI moves each app out of
+# this tree on its own.
+cd "$(dirname "$0")/../.."
+APPS="base_pack/nrfsniff base_pack/mousejacker non_catalog_apps/nrfsniff_ms non_catalog_apps/mousejacker_ms"
+FILES="nrf24.c nrf24.h"
+STATUS=0
+for app in $APPS
+do
+	for file in $FILES
+	do
+		if [ "$1" == "--check" ]; then
+			if ! diff -u "lib/nrf24/$file" "$app/lib/nrf24/$file"; then
+				echo "$app/lib/nrf24/$file differs from lib/nrf24/$file, run lib/nrf24/sync.sh"
+				STATUS=1
+			fi
+		else
+			mkdir -p "$app/lib/nrf24"
+			cp "lib/nrf24/$file" "$app/lib/nrf24/$file"
+		fi
+	done
+done
+exit $STATUS
@@ -0,0 +1,183 @@
+// Host test of the SPI traffic the driver generates, see test/Makefile. Not part of any FAP.
+//
+// A mock radio stands in for the SPI bus through nrf24_set_spi_backend. It keeps the registers
+// and the three slot RX FIFO, answers every command with STATUS and counts the transfers.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../nrf24.h"
+
+const GpioPin gpio_ext_pb2;
+FuriHalSpiBusHandle furi_hal_spi_bus_handle_external = {.cs = &gpio_ext_pb2};
+
+#define MOCK_FIFO_SLOTS 3
+#define MOCK_RX_DR 0x40
+#define MOCK_RX_P_NO_EMPTY 0x0E
+
+static uint8_t mock_regs[32];
+static uint8_t mock_fifo[MOCK_FIFO_SLOTS][32];
+static uint8_t mock_fifo_len[MOCK_FIFO_SLOTS];
+static int mock_fifo_count;
+static int mock_transfers;
+static int failures;
+
+static uint8_t mock_status(void) {
+    return (mock_regs[REG_STATUS] & 0x70) | (mock_fifo_count ? 0 : MOCK_RX_P_NO_EMPTY);
+}
+
+// A packet arrives over the air, filled with id, id + 1, ...
+static void mock_receive(uint8_t id, uint8_t len) {
+    if(mock_fifo_count == MOCK_FIFO_SLOTS) return;
+    for(int i = 0; i < 32; i++) {
+        mock_fifo[mock_fifo_count][i] = id + i;
+    }
+    mock_fifo_len[mock_fifo_count] = len;
+    mock_fifo_count++;
+    mock_regs[REG_STATUS] |= MOCK_RX_DR;
+}
+
+static void mock_pop(void) {
+    memmove(mock_fifo, mock_fifo + 1, sizeof(mock_fifo[0]) * (MOCK_FIFO_SLOTS - 1));
+    memmove(mock_fifo_len, mock_fifo_len + 1, MOCK_FIFO_SLOTS - 1);
+    mock_fifo_count--;
+}
+
+static void mock_trx(FuriHalSpiBusHandle* handle, uint8_t* tx, uint8_t* rx, uint8_t size) {
+    (void)handle;
+    uint8_t cmd = tx[0];
+
+    mock_transfers++;
+    rx[0] = mock_status();
+
+    if(cmd == R_RX_PAYLOAD) {
+        for(int i = 1; i < size; i++) {
+            rx[i] = mock_fifo_count ? mock_fifo[0][i - 1] : 0;
+        }
+        if(mock_fifo_count) mock_pop();
+    } else if(cmd == R_RX_PL_WID) {
+        rx[1] = mock_fifo_count ? mock_fifo_len[0] : 0;
+    } else if(cmd == FLUSH_RX) {
+        mock_fifo_count = 0;
+    } else if((cmd & 0xE0) == W_REGISTER) {
+        uint8_t reg = cmd & REGISTER_MASK;
+        if(reg == REG_STATUS) {
+            // interrupt flags are cleared by writing ones
+            mock_regs[REG_STATUS] &= ~(tx[1] & 0x70);
+        } else {
+            for(int i = 1; i < size; i++) {
+                mock_regs[reg] = tx[i];
+            }
+        }
+    } else if((cmd & 0xE0) == R_REGISTER) {
+        uint8_t reg = cmd & REGISTER_MASK;
+        for(int i = 1; i < size; i++) {
+            rx[i] = reg == REG_STATUS ? mock_status() : mock_regs[reg];
+        }
+    }
+}
+
+static void mock_reset(void) {
+    memset(mock_regs, 0, sizeof(mock_regs));
+    mock_fifo_count = 0;
+    mock_transfers = 0;
+}
+
+#define CHECK(name, value, expected)                                                   \
+    do {                                                                               \
+        int v = (value);                                                               \
+        if(v != (expected)) {                                                          \
+            printf("%s: %s is %d, expected %d\n", name, #value, v, (int)(expected)); \
+            failures++;                                                                \
+        }                                                                              \
+    } while(0)
+
+static void test_promisc_init(void) {
+    mock_reset();
+    nrf24_init_promisc_mode(nrf24_HANDLE, 5, 8);
+    CHECK("promisc", mock_transfers, 13);
+    CHECK("promisc", mock_regs[REG_RF_CH], 5);
+    CHECK("promisc", mock_regs[RX_PW_P0], 32);
+}
+
+static void test_configure(void) {
+    uint8_t mac[5] = {1, 2, 3, 4, 5};
+
+    mock_reset();
+    nrf24_configure(nrf24_HANDLE, 2, mac, mac, 5, 10, false, false);
+    CHECK("configure", mock_transfers, 13);
+    CHECK("configure", mock_regs[REG_RF_CH], 10);
+    CHECK("configure", mock_regs[REG_SETUP_AW], 3);
+    CHECK("configure", mock_regs[REG_RX_ADDR_P0], 5);
+}
+
+static void test_drain(void) {
+    uint8_t packets[3][32];
+    uint8_t sizes[3];
+
+    mock_reset();
+    mock_regs[RX_PW_P0] = 32;
+    mock_receive(0x10, 32);
+    mock_receive(0x20, 32);
+    mock_receive(0x30, 32);
+
+    uint8_t count = nrf24_rxpackets(nrf24_HANDLE, packets, sizes, true);
+    CHECK("drain", count, 3);
+    CHECK("drain", mock_transfers, 7);
+    CHECK("drain", packets[0][0], 0x10);
+    CHECK("drain", packets[2][0], 0x30);
+    CHECK("drain", sizes[1], 32);
+    CHECK("drain", mock_regs[REG_STATUS] & MOCK_RX_DR, 0);
+
+    // an empty FIFO costs a single transfer
+    mock_transfers = 0;
+    count = nrf24_rxpackets(nrf24_HANDLE, packets, sizes, true);
+    CHECK("drain idle", count, 0);
+    CHECK("drain idle", mock_transfers, 1);
+}
+
+static void test_drain_dynamic(void) {
+    uint8_t packets[3][32];
+    uint8_t sizes[3];
+
+    mock_reset();
+    mock_receive(1, 7);
+    mock_receive(2, 9);
+
+    uint8_t count = nrf24_rxpackets(nrf24_HANDLE, packets, sizes, false);
+    CHECK("dynamic", count, 2);
+    CHECK("dynamic", sizes[0], 7);
+    CHECK("dynamic", sizes[1], 9);
+    CHECK("dynamic", mock_transfers, 6);
+}
+
+static void test_single(void) {
+    uint8_t packet[32];
+    uint8_t len;
+    int received = 0;
+
+    mock_reset();
+    mock_regs[RX_PW_P0] = 32;
+    mock_receive(0x40, 32);
+    mock_receive(0x50, 32);
+
+    // the second packet waits behind an already cleared RX_DR and must not be lost
+    for(int i = 0; i < 3; i++) {
+        if(nrf24_rxpacket(nrf24_HANDLE, packet, &len, true) & MOCK_RX_DR) received++;
+    }
+    CHECK("single", received, 2);
+    CHECK("single", mock_transfers, 7);
+}
+
+int main(void) {
+    nrf24_set_spi_backend(mock_trx);
+
+    test_promisc_init();
+    test_configure();
+    test_drain();
+    test_drain_dynamic();
+    test_single();
+
+    printf("%s\n", failures ? "FAIL" : "ok");
+    return failures != 0;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdio.h>
+
+#include "furi_hal_spi.h"
+
+#define UNUSED(x) (void)(x)
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+#define FURI_LOG_D(...)
+
+static inline void furi_delay_ms(uint32_t ms) {
+    (void)ms;
+}
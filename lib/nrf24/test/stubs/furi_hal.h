@@ -0,0 +1,22 @@
+#pragma once
+
+#include "furi_hal_spi.h"
+
+#define GpioModeOutputPushPull 0
+#define GpioModeAnalog 0
+#define GpioPullUp 0
+#define GpioPullNo 0
+#define GpioSpeedVeryHigh 0
+#define GpioSpeedLow 0
+
+static inline void furi_hal_gpio_init(const GpioPin* pin, int mode, int pull, int speed) {
+    (void)pin;
+    (void)mode;
+    (void)pull;
+    (void)speed;
+}
+
+static inline void furi_hal_gpio_write(const GpioPin* pin, bool state) {
+    (void)pin;
+    (void)state;
+}
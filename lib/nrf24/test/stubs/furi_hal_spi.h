@@ -0,0 +1,48 @@
+#pragma once
+
+// Just enough of the Furi HAL for building the driver on the host
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+    int x;
+} GpioPin;
+
+typedef struct {
+    const GpioPin* cs;
+} FuriHalSpiBusHandle;
+
+extern const GpioPin gpio_ext_pb2;
+extern FuriHalSpiBusHandle furi_hal_spi_bus_handle_external;
+
+static inline bool furi_hal_spi_bus_trx(
+    FuriHalSpiBusHandle* handle,
+    uint8_t* tx,
+    uint8_t* rx,
+    size_t size,
+    uint32_t timeout) {
+    (void)handle;
+    (void)tx;
+    (void)rx;
+    (void)size;
+    (void)timeout;
+    return false;
+}
+
+static inline void furi_hal_spi_bus_handle_init(FuriHalSpiBusHandle* handle) {
+    (void)handle;
+}
+
+static inline void furi_hal_spi_bus_handle_deinit(FuriHalSpiBusHandle* handle) {
+    (void)handle;
+}
+
+static inline void furi_hal_spi_acquire(FuriHalSpiBusHandle* handle) {
+    (void)handle;
+}
+
+static inline void furi_hal_spi_release(FuriHalSpiBusHandle* handle) {
+    (void)handle;
+}
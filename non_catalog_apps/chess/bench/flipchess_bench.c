@@ -0,0 +1,124 @@
+// Host benchmark for the chess engine, see bench/Makefile. Not part of the FAP.
+//
+//   ./flipchess_bench                  perft and search on the built-in positions
+//   ./flipchess_bench "<FEN>" [depth]  perft and search on the given position
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#define SCL_960_CASTLING 0
+#define SCL_EVALUATION_FUNCTION SCL_boardEvaluateStatic
+#define SCL_DEBUG_AI 0
+
+#include "../chess/smallchesslib.h"
+
+#define BENCH_TT_ENTRIES (8 * 1024) // what the device gets with a typical free heap
+#define BENCH_SEARCH_DEPTH 5 // FlipChessPlayerAI3
+#define BENCH_SEARCH_TIME 8000 // ms, FlipChessPlayerAI3
+
+typedef struct {
+    const char* name;
+    const char* fen;
+    uint8_t depth;
+    uint32_t expected; // perft result at depth, 0 if unknown
+} BenchPosition;
+
+static const BenchPosition bench_positions[] = {
+    {"start", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 4, 197281},
+    {"kiwipete",
+     "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+     3,
+     97862},
+};
+
+static SCL_TTEntry bench_tt[BENCH_TT_ENTRIES];
+
+static uint32_t bench_millis(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static double bench_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int bench_position(const BenchPosition* position) {
+    SCL_Board board;
+    int failed = 0;
+
+    if(!SCL_boardFromFEN(board, position->fen)) {
+        printf("%s: invalid FEN\n", position->name);
+        return 1;
+    }
+
+    for(uint8_t depth = 1; depth <= position->depth; depth++) {
+        double start = bench_seconds();
+        uint32_t nodes = SCL_boardPerft(board, depth);
+        double elapsed = bench_seconds() - start;
+
+        printf(
+            "%s: perft %u = %u, %.3f s, %.0f nodes/s\n",
+            position->name,
+            depth,
+            nodes,
+            elapsed,
+            elapsed > 0 ? nodes / elapsed : 0);
+    }
+
+    if(position->expected) {
+        uint32_t nodes = SCL_boardPerft(board, position->depth);
+        if(nodes != position->expected) {
+            printf("%s: expected %u\n", position->name, position->expected);
+            failed = 1;
+        }
+    }
+
+    SCL_setTranspositionTable(bench_tt, BENCH_TT_ENTRIES);
+    SCL_randomBetterSeed(1);
+
+    uint8_t from, to;
+    char prom;
+    double start = bench_seconds();
+    int16_t value = SCL_getAIMoveTimed(
+        board,
+        BENCH_SEARCH_DEPTH,
+        3,
+        1,
+        SCL_boardEvaluateStatic,
+        SCL_randomBetter,
+        0,
+        255,
+        255,
+        bench_millis,
+        BENCH_SEARCH_TIME,
+        &from,
+        &to,
+        &prom);
+    double elapsed = bench_seconds() - start;
+
+    char move[6];
+    SCL_moveToString(board, from, to, prom, move);
+    printf("%s: search %s (%d), %.3f s\n", position->name, move, value, elapsed);
+
+    return failed;
+}
+
+int main(int argc, char** argv) {
+    int failed = 0;
+
+    if(argc > 1) {
+        BenchPosition position = {"fen", argv[1], argc > 2 ? atoi(argv[2]) : 3, 0};
+        failed = bench_position(&position);
+    } else {
+        for(size_t i = 0; i < sizeof(bench_positions) / sizeof(bench_positions[0]); i++) {
+            failed |= bench_position(&bench_positions[i]);
+        }
+    }
+
+    return failed;
+}
@@ -124,6 +124,7 @@ typedef uint8_t SCL_SquareSet[8];
 
 void SCL_squareSetClear(SCL_SquareSet squareSet);
 void SCL_squareSetAdd(SCL_SquareSet squareSet, uint8_t square);
+void SCL_squareSetRemove(SCL_SquareSet squareSet, uint8_t square);
 uint8_t SCL_squareSetContains(const SCL_SquareSet squareSet, uint8_t square);
 uint8_t SCL_squareSetSize(const SCL_SquareSet squareSet);
 uint8_t SCL_squareSetEmpty(const SCL_SquareSet squareSet);
@@ -659,6 +660,88 @@ int16_t SCL_getAIMove(
     uint8_t* resultTo,
     char* resultProm);
 
+/**
+  Returns current time in milliseconds, used to limit the AI thinking time.
+*/
+typedef uint32_t (*SCL_TimeFunction)(void);
+
+/**
+  Like SCL_getAIMove, but uses iterative deepening: the search is repeated with
+  depth 1, 2, ... up to maxDepth (plus endgameExtraDepth in the endgame) until
+  timeLimit milliseconds measured by timeFunc run out. The move of the last
+  fully finished depth is returned, depth 1 always finishes. The best move of
+  each iteration is searched first in the next one, which together with the
+  transposition table (see SCL_setTranspositionTable) makes the deeper
+  iterations a lot cheaper.
+*/
+int16_t SCL_getAIMoveTimed(
+    SCL_Board board,
+    uint8_t maxDepth,
+    uint8_t extensionExtraDepth,
+    uint8_t endgameExtraDepth,
+    SCL_StaticEvaluationFunction evalFunc,
+    SCL_RandomFunction randFunc,
+    uint8_t randomness,
+    uint8_t repetitionMoveFrom,
+    uint8_t repetitionMoveTo,
+    SCL_TimeFunction timeFunc,
+    uint32_t timeLimit,
+    uint8_t* resultFrom,
+    uint8_t* resultTo,
+    char* resultProm);
+
+#define SCL_TT_EMPTY 0x00
+#define SCL_TT_EXACT 0x01 ///< value is the exact position value
+#define SCL_TT_LOWER 0x02 ///< value is a lower bound for the player to move
+
+/**
+  Transposition table entry, remembers the result of searching one position so
+  that it doesn't have to be searched again when reached by a different move
+  order or in the next iteration of iterative deepening.
+*/
+typedef struct {
+    uint32_t hash; ///< SCL_boardHash32 of the position
+    int16_t value; ///< value for the player to move
+    int8_t depth; ///< depth the position was searched to
+    uint8_t flags; ///< SCL_TT_EXACT, SCL_TT_LOWER or SCL_TT_EMPTY
+    uint8_t bestFrom; ///< best move found, searched first next time
+    uint8_t bestTo;
+} SCL_TTEntry;
+
+/**
+  Gives the AI memory to use as a transposition table. The number of entries
+  has to be a power of two, passing 0 entries turns the table off (which is
+  the default). The memory stays owned by the caller and is cleared here.
+*/
+void SCL_setTranspositionTable(SCL_TTEntry* table, uint32_t entries);
+
+/**
+  Forgets all positions stored in the transposition table.
+*/
+void SCL_clearTranspositionTable(void);
+
+/**
+  Looks up the best move remembered in the transposition table for given
+  position, e.g. to guess the opponent's reply for pondering. Returns 1 if a
+  move was found, 0 otherwise.
+*/
+uint8_t SCL_getTranspositionMove(SCL_Board board, uint8_t* squareFrom, uint8_t* squareTo);
+
+/**
+  Requests (1) the AI search running in another thread to stop as soon as
+  possible, or allows (0) searching again. A stopped SCL_getAIMoveTimed returns
+  the move of the last finished depth, or 255 as resultFrom if even depth 1 was
+  interrupted. The request stays in effect until it is set back to 0.
+*/
+void SCL_setSearchStop(uint8_t stop);
+
+/**
+  Counts leaf positions reachable from the board in given number of plies
+  (perft), useful for checking the move generator and measuring its speed.
+  Like elsewhere in the library, promotions are only counted as to queen.
+*/
+uint32_t SCL_boardPerft(SCL_Board board, uint8_t depth);
+
 /**
   Function that prints out a single character. This is passed to printing
   functions.
@@ -1517,6 +1600,10 @@ void SCL_squareSetAdd(SCL_SquareSet squareSet, uint8_t square) {
     squareSet[square / 8] |= 0x01 << (square % 8);
 }
 
+void SCL_squareSetRemove(SCL_SquareSet squareSet, uint8_t square) {
+    squareSet[square / 8] &= ~(0x01 << (square % 8));
+}
+
 uint8_t SCL_squareSetContains(const SCL_SquareSet squareSet, uint8_t square) {
     return squareSet[square / 8] & (0x01 << (square % 8));
 }
@@ -2534,6 +2621,83 @@ SCL_StaticEvaluationFunction _SCL_staticEvaluationFunction;
 int16_t _SCL_currentEval;
 int8_t _SCL_depthHardLimit;
 
+SCL_TTEntry* _SCL_transpositionTable = 0;
+uint32_t _SCL_transpositionTableMask = 0;
+
+SCL_TimeFunction _SCL_timeFunction = 0; ///< 0 means no time limit
+uint32_t _SCL_timeStart;
+uint32_t _SCL_timeLimit;
+uint8_t _SCL_timeCheckCounter = 0;
+uint8_t _SCL_searchAborted = 0;
+volatile uint8_t _SCL_searchStop = 0; ///< may be set from another thread
+
+void SCL_setTranspositionTable(SCL_TTEntry* table, uint32_t entries) {
+    _SCL_transpositionTable = entries != 0 ? table : 0;
+    _SCL_transpositionTableMask = entries - 1;
+
+    SCL_clearTranspositionTable();
+}
+
+void SCL_clearTranspositionTable(void) {
+    if(_SCL_transpositionTable == 0) return;
+
+    for(uint32_t i = 0; i <= _SCL_transpositionTableMask; ++i)
+        _SCL_transpositionTable[i].flags = SCL_TT_EMPTY;
+}
+
+uint8_t SCL_getTranspositionMove(SCL_Board board, uint8_t* squareFrom, uint8_t* squareTo) {
+    if(_SCL_transpositionTable == 0) return 0;
+
+    uint32_t hash = SCL_boardHash32(board);
+    SCL_TTEntry* entry = _SCL_transpositionTable + (hash & _SCL_transpositionTableMask);
+
+    if(entry->flags == SCL_TT_EMPTY || entry->hash != hash ||
+       entry->bestFrom >= SCL_BOARD_SQUARES ||
+       !SCL_boardMoveIsLegal(board, entry->bestFrom, entry->bestTo))
+        return 0;
+
+    *squareFrom = entry->bestFrom;
+    *squareTo = entry->bestTo;
+
+    return 1;
+}
+
+void SCL_setSearchStop(uint8_t stop) {
+    _SCL_searchStop = stop;
+}
+
+uint32_t SCL_boardPerft(SCL_Board board, uint8_t depth) {
+    if(depth == 0) return 1;
+
+    uint32_t result = 0;
+    uint8_t whitesTurn = SCL_boardWhitesTurn(board);
+
+    for(uint8_t i = 0; i < SCL_BOARD_SQUARES; ++i) {
+        char s = board[i];
+
+        if(s == '.' || SCL_pieceIsWhite(s) != whitesTurn) continue;
+
+        SCL_SquareSet moves;
+
+        SCL_boardGetMoves(board, i, moves);
+
+        if(depth == 1) {
+            result += SCL_squareSetSize(moves);
+            continue;
+        }
+
+        SCL_SQUARE_SET_ITERATE_BEGIN(moves)
+
+        SCL_MoveUndo undo = SCL_boardMakeMove(board, i, iteratedSquare, 'q');
+        result += SCL_boardPerft(board, depth - 1);
+        SCL_boardUndoMove(board, undo);
+
+        SCL_SQUARE_SET_ITERATE_END
+    }
+
+    return result;
+}
+
 /**
   Inner recursive function for SCL_boardEvaluateDynamic. It is passed a square
   (or -1) at which last capture happened, to implement capture extension.
@@ -2551,11 +2715,47 @@ int16_t _SCL_boardEvaluateDynamic(
     wdt_reset();
 #endif
 
+    if(_SCL_searchStop ||
+       (_SCL_timeFunction != 0 && (++_SCL_timeCheckCounter & 0x3f) == 0 &&
+        _SCL_timeFunction() - _SCL_timeStart >= _SCL_timeLimit))
+        _SCL_searchAborted = 1;
+
+    if(_SCL_searchAborted) return 0; // result will be thrown away anyway
+
     uint8_t whitesTurn = SCL_boardWhitesTurn(board);
     int8_t valueMultiply = whitesTurn ? 1 : -1;
+
+    SCL_TTEntry* ttEntry = 0;
+    uint32_t hash = 0;
+    uint8_t ttFrom = 255, ttTo = 255;
+
+    if(_SCL_transpositionTable != 0 && depth > 0) {
+        /* Only the main search is cached, extended positions depend on the
+       capture square and are cheap anyway. */
+        hash = SCL_boardHash32(board);
+        ttEntry = _SCL_transpositionTable + (hash & _SCL_transpositionTableMask);
+
+        if(ttEntry->flags != SCL_TT_EMPTY && ttEntry->hash == hash) {
+            if(ttEntry->depth >= depth) {
+                if(ttEntry->flags == SCL_TT_EXACT) return ttEntry->value * valueMultiply;
+
+#if SCL_ALPHA_BETA
+                if(ttEntry->value > alphaBeta * valueMultiply)
+                    return ttEntry->value * valueMultiply;
+#endif
+            }
+
+            ttFrom = ttEntry->bestFrom;
+            ttTo = ttEntry->bestTo;
+        }
+    }
+
     int16_t bestMoveValue = -1 * SCL_EVALUATION_MAX_SCORE;
+    uint8_t bestFrom = 255, bestTo = 255;
+    int8_t searchDepth = depth;
     uint8_t shouldCompute = depth > 0;
     uint8_t extended = 0;
+    uint8_t end = 0;
     uint8_t positionType = SCL_boardGetPosition(board);
 
     if(!shouldCompute) {
@@ -2579,84 +2779,113 @@ int16_t _SCL_boardEvaluateDynamic(
 #endif
 
         alphaBeta *= valueMultiply;
-        uint8_t end = 0;
-        const char* b = board;
+        SCL_SquareSet ttPieceMoves;
 
         depth--;
 
-        for(uint8_t i = 0; i < SCL_BOARD_SQUARES; ++i, ++b) {
-            char s = *b;
+        /* Square -1 stands for the best move remembered in the transposition
+       table, it is searched first as it is the most likely to cause a cutoff
+       (the entry may come from a hash collision, so the move is verified). */
+        for(int8_t i = -1; i < SCL_BOARD_SQUARES; ++i) {
+            uint8_t from = i;
+            SCL_SquareSet moves;
+
+            SCL_squareSetClear(moves);
+
+            if(i < 0) {
+                if(ttFrom >= SCL_BOARD_SQUARES || board[ttFrom] == '.' ||
+                   SCL_pieceIsWhite(board[ttFrom]) != whitesTurn) {
+                    ttFrom = 255;
+                    continue;
+                }
 
-            if(s != '.' && SCL_pieceIsWhite(s) == whitesTurn) {
-                SCL_SquareSet moves;
+                SCL_boardGetMoves(board, ttFrom, ttPieceMoves);
 
-                SCL_squareSetClear(moves);
+                if(!SCL_squareSetContains(ttPieceMoves, ttTo)) {
+                    ttFrom = 255;
+                    continue;
+                }
 
-                SCL_boardGetMoves(board, i, moves);
+                from = ttFrom;
+                SCL_squareSetAdd(moves, ttTo);
+                SCL_squareSetRemove(ttPieceMoves, ttTo);
+            } else {
+                char s = board[i];
 
-                if(!SCL_squareSetEmpty(moves)) {
-                    SCL_SQUARE_SET_ITERATE_BEGIN(moves)
+                if(s == '.' || SCL_pieceIsWhite(s) != whitesTurn) continue;
 
-                    int8_t captureExtension = -1;
+                if(i == ttFrom)
+                    for(uint8_t j = 0; j < 8; ++j) moves[j] = ttPieceMoves[j];
+                else
+                    SCL_boardGetMoves(board, i, moves);
+            }
+
+            if(!SCL_squareSetEmpty(moves)) {
+                SCL_SQUARE_SET_ITERATE_BEGIN(moves)
 
-                    if(board[iteratedSquare] != '.' && // takes a piece
-                       (takenSquare == -1 || // extend on first taken sq.
-                        (extended && takenSquare != -1) || // ignore check extension
-                        (iteratedSquare == takenSquare))) // extend on same sq. taken
-                        captureExtension = iteratedSquare;
+                int8_t captureExtension = -1;
 
-                    SCL_MoveUndo undo = SCL_boardMakeMove(board, i, iteratedSquare, 'q');
+                if(board[iteratedSquare] != '.' && // takes a piece
+                   (takenSquare == -1 || // extend on first taken sq.
+                    (extended && takenSquare != -1) || // ignore check extension
+                    (iteratedSquare == takenSquare))) // extend on same sq. taken
+                    captureExtension = iteratedSquare;
 
-                    uint8_t s0Dummy, s1Dummy;
-                    char pDummy;
+                SCL_MoveUndo undo = SCL_boardMakeMove(board, from, iteratedSquare, 'q');
 
-                    SCL_UNUSED(s0Dummy);
-                    SCL_UNUSED(s1Dummy);
-                    SCL_UNUSED(pDummy);
+                uint8_t s0Dummy, s1Dummy;
+                char pDummy;
+
+                SCL_UNUSED(s0Dummy);
+                SCL_UNUSED(s1Dummy);
+                SCL_UNUSED(pDummy);
 
 #if SCL_DEBUG_AI
-                    if(debugFirst)
-                        debugFirst = 0;
-                    else
-                        putchar(',');
+                if(debugFirst)
+                    debugFirst = 0;
+                else
+                    putchar(',');
 
-                    if(extended) putchar('*');
+                if(extended) putchar('*');
 
-                    printf("%s ", SCL_moveToString(board, i, iteratedSquare, 'q', moveStr));
+                printf("%s ", SCL_moveToString(board, from, iteratedSquare, 'q', moveStr));
 #endif
 
-                    int16_t value = _SCL_boardEvaluateDynamic(
-                                        board,
-                                        depth, // this is depth - 1, we decremented it
+                int16_t value = _SCL_boardEvaluateDynamic(
+                                    board,
+                                    depth, // this is depth - 1, we decremented it
 #if SCL_ALPHA_BETA
-                                        valueMultiply * bestMoveValue,
+                                    valueMultiply * bestMoveValue,
 #else
-                                        0,
+                                    0,
 #endif
-                                        captureExtension) *
-                                    valueMultiply;
+                                    captureExtension) *
+                                valueMultiply;
 
-                    SCL_boardUndoMove(board, undo);
+                SCL_boardUndoMove(board, undo);
 
-                    if(value > bestMoveValue) {
-                        bestMoveValue = value;
+                if(value > bestMoveValue) {
+                    bestMoveValue = value;
+                    bestFrom = from;
+                    bestTo = iteratedSquare;
 
 #if SCL_ALPHA_BETA
-                        // alpha-beta pruning:
+                    // alpha-beta pruning:
 
-                        if(value > alphaBeta) // no, >= can't be here
-                        {
-                            end = 1;
-                            iterationEnd = 1;
-                        }
-#endif
+                    if(value > alphaBeta) // no, >= can't be here
+                    {
+                        end = 1;
+                        iterationEnd = 1;
                     }
+#endif
+                }
 
-                    SCL_SQUARE_SET_ITERATE_END
-                } // !squre set empty?
-            } // valid piece?
+                if(_SCL_searchAborted) iterationEnd = 1;
+
+                SCL_SQUARE_SET_ITERATE_END
+            } // !squre set empty?
 
-            if(end) break;
+            if(end || _SCL_searchAborted) break;
 
         } // for each square
 
@@ -2686,6 +2915,17 @@ int16_t _SCL_boardEvaluateDynamic(
      moves as leading to mate). */
     bestMoveValue += bestMoveValue > _SCL_currentEval * valueMultiply ? -1 : 1;
 
+    if(ttEntry != 0 && !_SCL_searchAborted &&
+       (ttEntry->hash != hash || ttEntry->flags == SCL_TT_EMPTY ||
+        ttEntry->depth <= searchDepth)) {
+        ttEntry->hash = hash;
+        ttEntry->value = bestMoveValue;
+        ttEntry->depth = searchDepth;
+        ttEntry->flags = end ? SCL_TT_LOWER : SCL_TT_EXACT;
+        ttEntry->bestFrom = bestFrom;
+        ttEntry->bestTo = bestTo;
+    }
+
 #if SCL_DEBUG_AI
     printf("%d", bestMoveValue * valueMultiply);
 #endif
@@ -2693,21 +2933,36 @@ int16_t _SCL_boardEvaluateDynamic(
     return bestMoveValue * valueMultiply;
 }
 
-int16_t SCL_boardEvaluateDynamic(
+/**
+  Like SCL_boardEvaluateDynamic, but the search may stop early once the position
+  is known to be worse than bound for the player who moved into it (the result
+  is then only a bound too).
+*/
+int16_t _SCL_boardEvaluateDynamicBound(
     SCL_Board board,
     uint8_t baseDepth,
     uint8_t extensionExtraDepth,
-    SCL_StaticEvaluationFunction evalFunction) {
+    SCL_StaticEvaluationFunction evalFunction,
+    int16_t bound) {
     _SCL_staticEvaluationFunction = evalFunction;
     _SCL_currentEval = evalFunction(board);
     _SCL_depthHardLimit = 0;
     _SCL_depthHardLimit -= extensionExtraDepth;
 
-    return _SCL_boardEvaluateDynamic(
+    return _SCL_boardEvaluateDynamic(board, baseDepth, bound, -1);
+}
+
+int16_t SCL_boardEvaluateDynamic(
+    SCL_Board board,
+    uint8_t baseDepth,
+    uint8_t extensionExtraDepth,
+    SCL_StaticEvaluationFunction evalFunction) {
+    return _SCL_boardEvaluateDynamicBound(
         board,
         baseDepth,
-        SCL_boardWhitesTurn(board) ? SCL_EVALUATION_MAX_SCORE : (-1 * SCL_EVALUATION_MAX_SCORE),
-        -1);
+        extensionExtraDepth,
+        evalFunction,
+        SCL_boardWhitesTurn(board) ? SCL_EVALUATION_MAX_SCORE : (-1 * SCL_EVALUATION_MAX_SCORE));
 }
 
 void SCL_boardRandomMove(
@@ -2758,16 +3013,21 @@ void SCL_printBoardSimple(
     SCL_printBoard(board, putCharFunc, s, selectSquare, format, 1, 1, 0);
 }
 
-int16_t SCL_getAIMove(
+/**
+  Root search for SCL_getAIMove and SCL_getAIMoveTimed. If firstFrom is a valid
+  square, the move firstFrom -> firstTo (which must be legal) is searched first.
+*/
+int16_t _SCL_getAIMove(
     SCL_Board board,
     uint8_t baseDepth,
     uint8_t extensionExtraDepth,
-    uint8_t endgameExtraDepth,
     SCL_StaticEvaluationFunction evalFunc,
     SCL_RandomFunction randFunc,
     uint8_t randomness,
     uint8_t repetitionMoveFrom,
     uint8_t repetitionMoveTo,
+    uint8_t firstFrom,
+    uint8_t firstTo,
     uint8_t* resultFrom,
     uint8_t* resultTo,
     char* resultProm) {
@@ -2778,17 +3038,6 @@ int16_t SCL_getAIMove(
     char moveStr[8];
 #endif
 
-    if(baseDepth == 0) {
-        SCL_boardRandomMove(board, randFunc, resultFrom, resultTo, resultProm);
-#ifndef SCL_EVALUATION_FUNCTION
-        return evalFunc(board);
-#else
-        return SCL_EVALUATION_FUNCTION(board);
-#endif
-    }
-
-    if(SCL_boardEstimatePhase(board) == SCL_PHASE_ENDGAME) baseDepth += endgameExtraDepth;
-
     *resultFrom = 0;
     *resultTo = 0;
     *resultProm = 'q';
@@ -2796,75 +3045,105 @@ int16_t SCL_getAIMove(
     int16_t bestScore = SCL_boardWhitesTurn(board) ? -1 * SCL_EVALUATION_MAX_SCORE - 1 :
                                                      (SCL_EVALUATION_MAX_SCORE + 1);
 
-    for(uint8_t i = 0; i < SCL_BOARD_SQUARES; ++i)
-        if(board[i] != '.' && SCL_boardWhitesTurn(board) == SCL_pieceIsWhite(board[i])) {
-            SCL_SquareSet moves;
+    for(int8_t i = -1; i < SCL_BOARD_SQUARES; ++i) {
+        uint8_t from = i;
+        SCL_SquareSet moves;
 
-            SCL_squareSetClear(moves);
+        SCL_squareSetClear(moves);
+
+        if(i < 0) {
+            if(firstFrom >= SCL_BOARD_SQUARES) continue;
+
+            from = firstFrom;
+            SCL_squareSetAdd(moves, firstTo);
+        } else {
+            if(board[i] == '.' || SCL_boardWhitesTurn(board) != SCL_pieceIsWhite(board[i]))
+                continue;
 
             SCL_boardGetMoves(board, i, moves);
 
-            SCL_SQUARE_SET_ITERATE_BEGIN(moves)
+            if(i == firstFrom) SCL_squareSetRemove(moves, firstTo);
+        }
+
+        SCL_SQUARE_SET_ITERATE_BEGIN(moves)
 
-            int16_t score = 0;
+        int16_t score = 0;
 
 #if SCL_DEBUG_AI
-            if(debugFirst)
-                debugFirst = 0;
-            else
-                putchar(',');
+        if(debugFirst)
+            debugFirst = 0;
+        else
+            putchar(',');
 
-            printf("%s ", SCL_moveToString(board, i, iteratedSquare, 'q', moveStr));
+        printf("%s ", SCL_moveToString(board, from, iteratedSquare, 'q', moveStr));
 
 #endif
 
-            if(i != repetitionMoveFrom || iteratedSquare != repetitionMoveTo) {
-                SCL_MoveUndo undo = SCL_boardMakeMove(board, i, iteratedSquare, 'q');
+        if(from != repetitionMoveFrom || iteratedSquare != repetitionMoveTo) {
+            SCL_MoveUndo undo = SCL_boardMakeMove(board, from, iteratedSquare, 'q');
 
-                score =
-                    SCL_boardEvaluateDynamic(board, baseDepth - 1, extensionExtraDepth, evalFunc);
+#if SCL_ALPHA_BETA
+            /* Moves that can't beat the best one so far don't need an exact
+           value, unless randomness may still make them win. The bound is moved
+           by 1 so that the depth adjustment of the score can't create a false
+           tie with the best move. */
+            if(randomness <= 1)
+                score = _SCL_boardEvaluateDynamicBound(
+                    board,
+                    baseDepth - 1,
+                    extensionExtraDepth,
+                    evalFunc,
+                    bestScore + (SCL_boardWhitesTurn(board) ? 1 : -1));
+            else
+#endif
+                score = SCL_boardEvaluateDynamic(
+                    board, baseDepth - 1, extensionExtraDepth, evalFunc);
 
-                SCL_boardUndoMove(board, undo);
-            }
+            SCL_boardUndoMove(board, undo);
+        }
 
-            if(randFunc != 0 && randomness > 1 && score < 16000 && score > -16000) {
-                /*^ We limit randomizing by about half the max score for two reasons:
-            to prevent over/under flows and secondly we don't want to alter
-            the highest values for checkmate -- these are modified by tiny
-            values depending on their depth so as to prevent endless loops in
-            which most moves are winning, biasing such values would completely
-            kill that algorithm */
-
-                int16_t bias = randFunc();
-                bias = (bias - 128) / 2;
-                bias *= randomness - 1;
-                score += bias;
-            }
+        if(randFunc != 0 && randomness > 1 && score < 16000 && score > -16000) {
+            /*^ We limit randomizing by about half the max score for two reasons:
+        to prevent over/under flows and secondly we don't want to alter
+        the highest values for checkmate -- these are modified by tiny
+        values depending on their depth so as to prevent endless loops in
+        which most moves are winning, biasing such values would completely
+        kill that algorithm */
+
+            int16_t bias = randFunc();
+            bias = (bias - 128) / 2;
+            bias *= randomness - 1;
+            score += bias;
+        }
 
-            uint8_t comparison = score == bestScore;
+        uint8_t comparison = score == bestScore;
 
-            if((comparison != 1) && ((SCL_boardWhitesTurn(board) && score > bestScore) ||
-                                     (!SCL_boardWhitesTurn(board) && score < bestScore)))
-                comparison = 2;
+        if((comparison != 1) && ((SCL_boardWhitesTurn(board) && score > bestScore) ||
+                                 (!SCL_boardWhitesTurn(board) && score < bestScore)))
+            comparison = 2;
 
-            uint8_t replace = 0;
+        uint8_t replace = 0;
 
-            if(randFunc == 0)
-                replace = comparison == 2;
-            else
-                replace =
-                    (comparison == 2) ||
-                    ((comparison == 1) && (randFunc() < 160)); // not uniform distr. but simple
-
-            if(replace) {
-                *resultFrom = i;
-                *resultTo = iteratedSquare;
-                bestScore = score;
-            }
-
-            SCL_SQUARE_SET_ITERATE_END
+        if(randFunc == 0)
+            replace = comparison == 2;
+        else
+            replace =
+                (comparison == 2) ||
+                ((comparison == 1) && (randFunc() < 160)); // not uniform distr. but simple
+
+        if(replace) {
+            *resultFrom = from;
+            *resultTo = iteratedSquare;
+            bestScore = score;
         }
 
+        if(_SCL_searchAborted) iterationEnd = 1;
+
+        SCL_SQUARE_SET_ITERATE_END
+
+        if(_SCL_searchAborted) break;
+    }
+
 #if SCL_DEBUG_AI
     printf(")%d %s\n", bestScore, SCL_moveToString(board, *resultFrom, *resultTo, 'q', moveStr));
     puts("===== AI debug end ===== ");
@@ -2873,6 +3152,130 @@ int16_t SCL_getAIMove(
     return bestScore;
 }
 
+int16_t SCL_getAIMove(
+    SCL_Board board,
+    uint8_t baseDepth,
+    uint8_t extensionExtraDepth,
+    uint8_t endgameExtraDepth,
+    SCL_StaticEvaluationFunction evalFunc,
+    SCL_RandomFunction randFunc,
+    uint8_t randomness,
+    uint8_t repetitionMoveFrom,
+    uint8_t repetitionMoveTo,
+    uint8_t* resultFrom,
+    uint8_t* resultTo,
+    char* resultProm) {
+    if(baseDepth == 0) {
+        SCL_boardRandomMove(board, randFunc, resultFrom, resultTo, resultProm);
+#ifndef SCL_EVALUATION_FUNCTION
+        return evalFunc(board);
+#else
+        return SCL_EVALUATION_FUNCTION(board);
+#endif
+    }
+
+    if(SCL_boardEstimatePhase(board) == SCL_PHASE_ENDGAME) baseDepth += endgameExtraDepth;
+
+    return _SCL_getAIMove(
+        board,
+        baseDepth,
+        extensionExtraDepth,
+        evalFunc,
+        randFunc,
+        randomness,
+        repetitionMoveFrom,
+        repetitionMoveTo,
+        255,
+        255,
+        resultFrom,
+        resultTo,
+        resultProm);
+}
+
+int16_t SCL_getAIMoveTimed(
+    SCL_Board board,
+    uint8_t maxDepth,
+    uint8_t extensionExtraDepth,
+    uint8_t endgameExtraDepth,
+    SCL_StaticEvaluationFunction evalFunc,
+    SCL_RandomFunction randFunc,
+    uint8_t randomness,
+    uint8_t repetitionMoveFrom,
+    uint8_t repetitionMoveTo,
+    SCL_TimeFunction timeFunc,
+    uint32_t timeLimit,
+    uint8_t* resultFrom,
+    uint8_t* resultTo,
+    char* resultProm) {
+    if(maxDepth == 0)
+        return SCL_getAIMove(
+            board,
+            0,
+            extensionExtraDepth,
+            endgameExtraDepth,
+            evalFunc,
+            randFunc,
+            randomness,
+            repetitionMoveFrom,
+            repetitionMoveTo,
+            resultFrom,
+            resultTo,
+            resultProm);
+
+    if(SCL_boardEstimatePhase(board) == SCL_PHASE_ENDGAME) maxDepth += endgameExtraDepth;
+
+    uint32_t start = timeFunc();
+    int16_t result = 0;
+    uint8_t bestFrom = 255, bestTo = 255;
+    char bestProm = 'q';
+
+    for(uint8_t depth = 1; depth <= maxDepth; ++depth) {
+        uint8_t from, to;
+        char prom;
+
+        // the first iteration always finishes so that there is a move to play
+        _SCL_timeFunction = depth > 1 ? timeFunc : 0;
+        _SCL_timeStart = start;
+        _SCL_timeLimit = timeLimit;
+        _SCL_searchAborted = 0;
+
+        int16_t score = _SCL_getAIMove(
+            board,
+            depth,
+            extensionExtraDepth,
+            evalFunc,
+            randFunc,
+            randomness,
+            repetitionMoveFrom,
+            repetitionMoveTo,
+            bestFrom,
+            bestTo,
+            &from,
+            &to,
+            &prom);
+
+        if(_SCL_searchAborted) break;
+
+        result = score;
+        bestFrom = from;
+        bestTo = to;
+        bestProm = prom;
+
+        /* Every iteration takes several times longer than the previous one, so
+       don't start one that most likely won't finish. */
+        if(timeFunc() - start >= timeLimit / 2) break;
+    }
+
+    _SCL_timeFunction = 0;
+    _SCL_searchAborted = 0;
+
+    *resultFrom = bestFrom;
+    *resultTo = bestTo;
+    *resultProm = bestProm;
+
+    return result;
+}
+
 uint8_t SCL_boardToFEN(SCL_Board board, char* string) {
     uint8_t square = 56;
     uint8_t spaces = 0;
@@ -20,13 +20,20 @@
 #define ENABLE_960 0 // setting to 1 enables 960 chess
 #define MAX_TEXT_LEN 15 // 15 = max length of text
 #define MAX_TEXT_BUF (MAX_TEXT_LEN + 1) // max length of text + null terminator
-#define THREAD_WAIT_TIME 20 // time to wait for draw thread to finish
+#define TT_MAX_ENTRIES 4096 // transposition table cap, 12 bytes per entry
+#define TT_MIN_ENTRIES 256 // smaller table isn't worth it
+#define TT_HEAP_SHARE 4 // use at most 1/4 of the largest free heap block
+#define PONDER_TIME_LIMIT 60000 // ms, pondering normally ends by reaching the depth
+
+typedef enum {
+    FlipChessWorkerEvtStop = (1 << 0),
+    FlipChessWorkerEvtThink = (1 << 1),
+    FlipChessWorkerEvtPonder = (1 << 2),
+} FlipChessWorkerEvtFlags;
+
+#define FLIPCHESS_WORKER_EVT_ALL \
+    (FlipChessWorkerEvtStop | FlipChessWorkerEvtThink | FlipChessWorkerEvtPonder)
 
-struct FlipChessScene1 {
-    View* view;
-    FlipChessScene1Callback callback;
-    void* context;
-};
 typedef struct {
     uint8_t paramPlayerW;
     uint8_t paramPlayerB;
@@ -65,8 +72,34 @@ typedef struct {
     uint8_t squareTo;
     uint8_t turnState;
 
+    // move found by the search worker, played by the next flipchess_turn
+    uint8_t aiMoveReady;
+    uint8_t aiFrom;
+    uint8_t aiTo;
+    char aiProm;
+
 } FlipChessScene1Model;
 
+struct FlipChessScene1 {
+    View* view;
+    FlipChessScene1Callback callback;
+    void* context;
+    SCL_TTEntry* transpositionTable;
+
+    FuriThread* worker; // runs while the scene is shown
+    FuriMutex* search_mutex; // held by the worker while searching
+    volatile bool search_stop;
+    volatile bool worker_exit; // no new search may start, set before search_stop
+    FlipChessScene1Model* search_model; // game copy the worker searches on
+
+    // pondering result for the expected reply, played at once if the guess was right
+    bool ponder_valid;
+    SCL_Board ponder_board;
+    uint8_t ponder_from;
+    uint8_t ponder_to;
+    char ponder_prom;
+};
+
 static uint8_t picture[SCL_BOARD_PICTURE_WIDTH * SCL_BOARD_PICTURE_WIDTH];
 
 void flipchess_putImagePixel(uint8_t pixel, uint16_t index) {
@@ -86,16 +119,32 @@ uint8_t flipchess_stringsEqual(const char* s1, const char* s2, int max) {
     return 1;
 }
 
+// The kernel ticks at 1 kHz, scaling the tick by 1000 would wrap after ~72 minutes
+uint32_t flipchess_millis(void) {
+    return furi_get_tick();
+}
+
 int16_t flipchess_makeAIMove(
     SCL_Board board,
     uint8_t* s0,
     uint8_t* s1,
     char* prom,
-    FlipChessScene1Model* model) {
+    FlipChessScene1Model* model,
+    bool ponder) {
     uint8_t level = SCL_boardWhitesTurn(board) ? model->paramPlayerW : model->paramPlayerB;
-    uint8_t depth = (level > 0) ? level : 1;
+    // higher levels search deeper, as far as their thinking time allows
+    uint8_t depth = 1;
+    uint32_t timeLimit = 0; // ms
     uint8_t extraDepth = 3;
     uint8_t endgameDepth = 1;
+
+    if(level == FlipChessPlayerAI2) {
+        depth = 3;
+        timeLimit = 4000;
+    } else if(level == FlipChessPlayerAI3) {
+        depth = 5;
+        timeLimit = 8000;
+    }
     uint8_t randomness =
         model->game.ply < 2 ? 1 : 0; /* in first moves increase randomness for different 
                              openings */
@@ -106,23 +155,27 @@ int16_t flipchess_makeAIMove(
     if(model->clockSeconds >= 0) // when using clock, choose AI params accordingly
     {
         if(model->clockSeconds <= 5) {
-            depth = 1;
+            timeLimit = 500;
             extraDepth = 2;
             endgameDepth = 0;
         } else if(model->clockSeconds < 15) {
-            depth = 2;
+            timeLimit = 1000;
             extraDepth = 2;
         } else if(model->clockSeconds < 100) {
-            depth = 2;
+            timeLimit = 2000;
         } else if(model->clockSeconds < 5 * 60) {
-            depth = 3;
+            timeLimit = 4000;
         } else {
-            depth = 3;
+            timeLimit = 8000;
             extraDepth = 4;
         }
+        depth = 5;
     }
 
-    return SCL_getAIMove(
+    // pondering uses the opponent's thinking time, so it isn't limited by the level
+    if(ponder) timeLimit = PONDER_TIME_LIMIT;
+
+    return SCL_getAIMoveTimed(
         board,
         depth,
         extraDepth,
@@ -132,6 +185,8 @@ int16_t flipchess_makeAIMove(
         randomness,
         rs0,
         rs1,
+        flipchess_millis,
+        timeLimit,
         s0,
         s1,
         prom);
@@ -251,10 +306,12 @@ uint8_t flipchess_turn(FlipChessScene1Model* model) {
                 SCL_squareSetClear(model->moveHighlight);
             }
 
-        } else {
+        } else if(model->aiMoveReady) {
             model->squareSelected = 255;
-            flipchess_makeAIMove(
-                model->game.board, &(model->squareFrom), &(model->squareTo), &movePromote, model);
+            model->squareFrom = model->aiFrom;
+            model->squareTo = model->aiTo;
+            movePromote = model->aiProm;
+            model->aiMoveReady = 0;
             moveType = FlipChessStatusMoveAI;
             model->turnState = 0;
         }
@@ -429,6 +486,7 @@ static int flipchess_scene_1_model_init(
     model->squareFrom = 255;
     model->squareTo = 255;
     model->turnState = 0;
+    model->aiMoveReady = 0;
 
     SCL_randomBetterSeed(furi_hal_random_get());
 
@@ -465,7 +523,7 @@ static int flipchess_scene_1_model_init(
         model->paramPlayerB = model->paramAnalyze;
 
         int16_t evaluation =
-            flipchess_makeAIMove(model->game.board, &(move[0]), &(move[1]), &p, model);
+            flipchess_makeAIMove(model->game.board, &(move[0]), &(move[1]), &p, model, false);
 
         if(model->paramAnalyze == 0) evaluation = SCL_boardEvaluateStatic(model->game.board);
 
@@ -506,6 +564,193 @@ static int flipchess_scene_1_model_init(
     return FlipChessStatusNone;
 }
 
+static bool flipchess_isAITurn(FlipChessScene1Model* model) {
+    return model->game.state == SCL_GAME_STATE_PLAYING && !flipchess_isPlayerTurn(model);
+}
+
+static void flipchess_worker_think(FlipChessScene1* instance) {
+    FlipChessScene1Model* search = instance->search_model;
+    bool ready = false;
+    bool found = false;
+    uint8_t s0 = 255, s1 = 255;
+    char prom = 'q';
+
+    furi_check(furi_mutex_acquire(instance->search_mutex, FuriWaitForever) == FuriStatusOk);
+    if(instance->worker_exit) {
+        furi_mutex_release(instance->search_mutex);
+        return;
+    }
+    instance->search_stop = false;
+    SCL_setSearchStop(0);
+
+    with_view_model(
+        instance->view,
+        FlipChessScene1Model * model,
+        {
+            ready = model->thinking && flipchess_isAITurn(model);
+            if(ready) memcpy(search, model, sizeof(FlipChessScene1Model));
+        },
+        false);
+
+    if(ready) {
+        if(instance->ponder_valid &&
+           !SCL_boardsDiffer(search->game.board, instance->ponder_board)) {
+            // the opponent played the expected move, the answer is ready
+            s0 = instance->ponder_from;
+            s1 = instance->ponder_to;
+            prom = instance->ponder_prom;
+            found = true;
+        } else {
+            flipchess_makeAIMove(search->game.board, &s0, &s1, &prom, search, false);
+            found = !instance->search_stop && s0 < SCL_BOARD_SQUARES;
+        }
+    }
+    instance->ponder_valid = false;
+
+    furi_mutex_release(instance->search_mutex);
+
+    if(!found) return;
+
+    FlipChess* app = instance->context;
+    bool ponder = false;
+
+    with_view_model(
+        instance->view,
+        FlipChessScene1Model * model,
+        {
+            // the game may have been restarted meanwhile
+            if(model->thinking && !SCL_boardsDiffer(model->game.board, search->game.board)) {
+                model->aiFrom = s0;
+                model->aiTo = s1;
+                model->aiProm = prom;
+                model->aiMoveReady = 1;
+
+                if(flipchess_turn(model) == FlipChessStatusReturn) {
+                    if(app->sound == 1) flipchess_voice_a_strange_game();
+                    flipchess_play_long_bump(app);
+                }
+                flipchess_saveState(app, model);
+                flipchess_drawBoard(model);
+
+                ponder = model->game.state == SCL_GAME_STATE_PLAYING &&
+                         flipchess_isPlayerTurn(model);
+            }
+        },
+        true);
+
+    if(ponder) furi_thread_flags_set(furi_thread_get_current_id(), FlipChessWorkerEvtPonder);
+}
+
+static void flipchess_worker_ponder(FlipChessScene1* instance) {
+    FlipChessScene1Model* search = instance->search_model;
+    bool ready = false;
+    uint8_t guessFrom, guessTo;
+
+    furi_check(furi_mutex_acquire(instance->search_mutex, FuriWaitForever) == FuriStatusOk);
+    instance->ponder_valid = false;
+    if(instance->worker_exit) {
+        furi_mutex_release(instance->search_mutex);
+        return;
+    }
+    instance->search_stop = false;
+    SCL_setSearchStop(0);
+
+    with_view_model(
+        instance->view,
+        FlipChessScene1Model * model,
+        {
+            uint8_t opponent = SCL_boardWhitesTurn(model->game.board) ? model->paramPlayerB :
+                                                                        model->paramPlayerW;
+            // level 1 answers instantly, nothing to gain there
+            ready = !model->thinking && model->game.state == SCL_GAME_STATE_PLAYING &&
+                    flipchess_isPlayerTurn(model) && opponent > FlipChessPlayerAI1;
+            if(ready) memcpy(search, model, sizeof(FlipChessScene1Model));
+        },
+        false);
+
+    // guess the reply from the last search, then answer it in advance
+    if(ready && SCL_getTranspositionMove(search->game.board, &guessFrom, &guessTo)) {
+        SCL_gameMakeMove(&(search->game), guessFrom, guessTo, 'q');
+
+        if(flipchess_isAITurn(search)) {
+            uint8_t s0 = 255, s1 = 255;
+            char prom = 'q';
+
+            flipchess_makeAIMove(search->game.board, &s0, &s1, &prom, search, true);
+
+            if(!instance->search_stop && s0 < SCL_BOARD_SQUARES) {
+                memcpy(instance->ponder_board, search->game.board, sizeof(SCL_Board));
+                instance->ponder_from = s0;
+                instance->ponder_to = s1;
+                instance->ponder_prom = prom;
+                instance->ponder_valid = true;
+            }
+        }
+    }
+
+    furi_mutex_release(instance->search_mutex);
+}
+
+static int32_t flipchess_scene_1_worker(void* context) {
+    FlipChessScene1* instance = context;
+
+    while(true) {
+        uint32_t flags =
+            furi_thread_flags_wait(FLIPCHESS_WORKER_EVT_ALL, FuriFlagWaitAny, FuriWaitForever);
+        furi_check((flags & FuriFlagError) == 0);
+        if(flags & FlipChessWorkerEvtStop) break;
+
+        // a pending move request makes pondering pointless
+        if(flags & FlipChessWorkerEvtThink) {
+            flipchess_worker_think(instance);
+        } else if(flags & FlipChessWorkerEvtPonder) {
+            flipchess_worker_ponder(instance);
+        }
+    }
+
+    return 0;
+}
+
+// must not be called with the model locked, the worker may be waiting for it
+static void flipchess_scene_1_stop_search(FlipChessScene1* instance) {
+    instance->search_stop = true;
+    SCL_setSearchStop(1);
+
+    // the search checks the stop request every node, so this is a short wait
+    furi_check(furi_mutex_acquire(instance->search_mutex, FuriWaitForever) == FuriStatusOk);
+    furi_mutex_release(instance->search_mutex);
+}
+
+static void flipchess_scene_1_start_worker(FlipChessScene1* instance) {
+    instance->worker_exit = false;
+    instance->worker =
+        furi_thread_alloc_ex("FlipChessAI", 4 * 1024, flipchess_scene_1_worker, instance);
+    furi_thread_start(instance->worker);
+}
+
+// Cancels the search or ponder and waits for the worker to end, the SCL search state is
+// global and must be idle before the next game is set up
+static void flipchess_scene_1_stop_worker(FlipChessScene1* instance) {
+    if(!instance->worker) return;
+
+    instance->worker_exit = true;
+    flipchess_scene_1_stop_search(instance);
+    furi_thread_flags_set(furi_thread_get_id(instance->worker), FlipChessWorkerEvtStop);
+    furi_thread_join(instance->worker);
+    furi_thread_free(instance->worker);
+    instance->worker = NULL;
+    instance->ponder_valid = false;
+}
+
+static void flipchess_scene_1_think(FlipChessScene1* instance) {
+    flipchess_scene_1_stop_search(instance);
+
+    with_view_model(
+        instance->view, FlipChessScene1Model * model, { model->thinking = 1; }, true);
+
+    furi_thread_flags_set(furi_thread_get_id(instance->worker), FlipChessWorkerEvtThink);
+}
+
 bool flipchess_scene_1_input(InputEvent* event, void* context) {
     furi_assert(context);
     FlipChessScene1* instance = context;
@@ -584,7 +829,9 @@ bool flipchess_scene_1_input(InputEvent* event, void* context) {
                 },
                 true);
             break;
-        case InputKeyOk:
+        case InputKeyOk: {
+            bool think = false;
+
             with_view_model(
                 instance->view,
                 FlipChessScene1Model * model,
@@ -593,54 +840,26 @@ bool flipchess_scene_1_input(InputEvent* event, void* context) {
                     //     instance->callback(FlipChessCustomEventScene1Back, instance->context);
                     //     break;
                     // }
-                    if(!flipchess_isPlayerTurn(model)) {
-                        model->thinking = 1;
-                    }
-                },
-                true);
-            furi_thread_flags_wait(0, FuriFlagWaitAny, THREAD_WAIT_TIME);
-
-            with_view_model(
-                instance->view,
-                FlipChessScene1Model * model,
-                {
-                    // first turn of round, probably player but could be AI
-                    if(flipchess_turn(model) == FlipChessStatusReturn) {
-                        if(app->sound == 1) flipchess_voice_a_strange_game();
-                        flipchess_play_long_bump(app);
-                    }
-                    flipchess_saveState(app, model);
-                    flipchess_drawBoard(model);
-                },
-                true);
+                    // the AI move is being searched in the background
+                    if(!model->thinking) {
+                        if(flipchess_isPlayerTurn(model)) {
+                            if(flipchess_turn(model) == FlipChessStatusReturn) {
+                                if(app->sound == 1) flipchess_voice_a_strange_game();
+                                flipchess_play_long_bump(app);
+                            }
+                            flipchess_saveState(app, model);
+                            flipchess_drawBoard(model);
+                        }
 
-            with_view_model(
-                instance->view,
-                FlipChessScene1Model * model,
-                {
-                    if(!flipchess_isPlayerTurn(model)) {
-                        model->thinking = 1;
+                        // if player played, let AI play
+                        think = flipchess_isAITurn(model);
                     }
                 },
                 true);
-            furi_thread_flags_wait(0, FuriFlagWaitAny, THREAD_WAIT_TIME);
 
-            with_view_model(
-                instance->view,
-                FlipChessScene1Model * model,
-                {
-                    // if player played, let AI play
-                    if(!flipchess_isPlayerTurn(model)) {
-                        if(flipchess_turn(model) == FlipChessStatusReturn) {
-                            if(app->sound == 1) flipchess_voice_a_strange_game();
-                            flipchess_play_long_bump(app);
-                        }
-                        flipchess_saveState(app, model);
-                        flipchess_drawBoard(model);
-                    }
-                },
-                true);
+            if(think) flipchess_scene_1_think(instance);
             break;
+        }
         case InputKeyMAX:
             break;
         }
@@ -652,8 +871,16 @@ void flipchess_scene_1_exit(void* context) {
     furi_assert(context);
     FlipChessScene1* instance = (FlipChessScene1*)context;
 
+    flipchess_scene_1_stop_worker(instance);
+
     with_view_model(
-        instance->view, FlipChessScene1Model * model, { model->paramExit = 0; }, true);
+        instance->view,
+        FlipChessScene1Model * model,
+        {
+            model->paramExit = 0;
+            model->thinking = 0;
+        },
+        true);
 }
 
 void flipchess_scene_1_enter(void* context) {
@@ -663,6 +890,10 @@ void flipchess_scene_1_enter(void* context) {
 
     flipchess_play_happy_bump(app);
 
+    flipchess_scene_1_start_worker(instance);
+
+    bool think = false;
+
     with_view_model(
         instance->view,
         FlipChessScene1Model * model,
@@ -687,6 +918,7 @@ void flipchess_scene_1_enter(void* context) {
                 } else {
                     flipchess_saveState(app, model);
                     flipchess_drawBoard(model);
+                    think = flipchess_isAITurn(model);
                 }
             }
 
@@ -696,6 +928,8 @@ void flipchess_scene_1_enter(void* context) {
             // }
         },
         true);
+
+    if(think) flipchess_scene_1_think(instance);
 }
 
 FlipChessScene1* flipchess_scene_1_alloc() {
@@ -708,16 +942,46 @@ FlipChessScene1* flipchess_scene_1_alloc() {
     view_set_enter_callback(instance->view, flipchess_scene_1_enter);
     view_set_exit_callback(instance->view, flipchess_scene_1_exit);
 
+    // size the transposition table by what the heap can spare
+    size_t entries = TT_MAX_ENTRIES;
+    while(entries >= TT_MIN_ENTRIES &&
+          entries * sizeof(SCL_TTEntry) > memmgr_heap_get_max_free_block() / TT_HEAP_SHARE) {
+        entries /= 2;
+    }
+
+    if(entries >= TT_MIN_ENTRIES) {
+        instance->transpositionTable = malloc(entries * sizeof(SCL_TTEntry));
+        SCL_setTranspositionTable(instance->transpositionTable, entries);
+    } else {
+        instance->transpositionTable = NULL;
+        SCL_setTranspositionTable(NULL, 0);
+    }
+
+    instance->search_model = malloc(sizeof(FlipChessScene1Model));
+    instance->search_stop = false;
+    instance->worker_exit = false;
+    instance->ponder_valid = false;
+    instance->search_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    instance->worker = NULL;
+
     return instance;
 }
 
 void flipchess_scene_1_free(FlipChessScene1* instance) {
     furi_assert(instance);
 
+    flipchess_scene_1_stop_worker(instance);
+    furi_mutex_free(instance->search_mutex);
+    free(instance->search_model);
+
     with_view_model(
         instance->view, FlipChessScene1Model * model, { UNUSED(model); }, true);
 
     view_free(instance->view);
+
+    SCL_setTranspositionTable(NULL, 0);
+    if(instance->transpositionTable) free(instance->transpositionTable);
+
     free(instance);
 }
 
@@ -19,6 +19,24 @@ void nrf24_deinit() {
     furi_hal_gpio_init(nrf24_CE_PIN, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
 }
 
+typedef struct {
+    uint8_t reg;
+    uint8_t value;
+} nrf24_reg_write;
+
+static void
+    nrf24_spi_bus_trx(FuriHalSpiBusHandle* handle, uint8_t* tx, uint8_t* rx, uint8_t size) {
+    furi_hal_gpio_write(handle->cs, false);
+    furi_hal_spi_bus_trx(handle, tx, rx, size, nrf24_TIMEOUT);
+    furi_hal_gpio_write(handle->cs, true);
+}
+
+static nrf24_spi_backend nrf24_spi = nrf24_spi_bus_trx;
+
+void nrf24_set_spi_backend(nrf24_spi_backend backend) {
+    nrf24_spi = backend ? backend : nrf24_spi_bus_trx;
+}
+
 void nrf24_spi_trx(
     FuriHalSpiBusHandle* handle,
     uint8_t* tx,
@@ -26,9 +44,7 @@ void nrf24_spi_trx(
     uint8_t size,
     uint32_t timeout) {
     UNUSED(timeout);
-    furi_hal_gpio_write(handle->cs, false);
-    furi_hal_spi_bus_trx(handle, tx, rx, size, nrf24_TIMEOUT);
-    furi_hal_gpio_write(handle->cs, true);
+    nrf24_spi(handle, tx, rx, size);
 }
 
 uint8_t nrf24_write_reg(FuriHalSpiBusHandle* handle, uint8_t reg, uint8_t data) {
@@ -49,6 +65,22 @@ uint8_t
     return rx[0];
 }
 
+// Registers are written one command per CS cycle, the table only keeps setup in one place
+static void
+    nrf24_write_regs(FuriHalSpiBusHandle* handle, const nrf24_reg_write* regs, size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        nrf24_write_reg(handle, regs[i].reg, regs[i].value);
+    }
+}
+
+// Address registers take up to 5 bytes, unused ones are cleared in the same transfer
+static uint8_t
+    nrf24_write_mac_reg(FuriHalSpiBusHandle* handle, uint8_t reg, uint8_t* mac, uint8_t size) {
+    uint8_t buf[5] = {0};
+    memcpy(buf, mac, MIN(size, (uint8_t)sizeof(buf)));
+    return nrf24_write_buf_reg(handle, reg, buf, sizeof(buf));
+}
+
 uint8_t nrf24_read_reg(FuriHalSpiBusHandle* handle, uint8_t reg, uint8_t* data, uint8_t size) {
     uint8_t tx[size + 1];
     uint8_t rx[size + 1];
@@ -149,12 +181,8 @@ uint8_t nrf24_get_src_mac(FuriHalSpiBusHandle* handle, uint8_t* mac) {
 }
 
 uint8_t nrf24_set_src_mac(FuriHalSpiBusHandle* handle, uint8_t* mac, uint8_t size) {
-    uint8_t status = 0;
-    uint8_t clearmac[] = {0, 0, 0, 0, 0};
     nrf24_set_maclen(handle, size);
-    nrf24_write_buf_reg(handle, REG_RX_ADDR_P0, clearmac, 5);
-    status = nrf24_write_buf_reg(handle, REG_RX_ADDR_P0, mac, size);
-    return status;
+    return nrf24_write_mac_reg(handle, REG_RX_ADDR_P0, mac, size);
 }
 
 uint8_t nrf24_get_dst_mac(FuriHalSpiBusHandle* handle, uint8_t* mac) {
@@ -166,12 +194,8 @@ uint8_t nrf24_get_dst_mac(FuriHalSpiBusHandle* handle, uint8_t* mac) {
 }
 
 uint8_t nrf24_set_dst_mac(FuriHalSpiBusHandle* handle, uint8_t* mac, uint8_t size) {
-    uint8_t status = 0;
-    uint8_t clearmac[] = {0, 0, 0, 0, 0};
     nrf24_set_maclen(handle, size);
-    nrf24_write_buf_reg(handle, REG_TX_ADDR, clearmac, 5);
-    status = nrf24_write_buf_reg(handle, REG_TX_ADDR, mac, size);
-    return status;
+    return nrf24_write_mac_reg(handle, REG_TX_ADDR, mac, size);
 }
 
 uint8_t nrf24_get_packetlen(FuriHalSpiBusHandle* handle) {
@@ -186,38 +210,75 @@ uint8_t nrf24_set_packetlen(FuriHalSpiBusHandle* handle, uint8_t len) {
     return status;
 }
 
-uint8_t
-    nrf24_rxpacket(FuriHalSpiBusHandle* handle, uint8_t* packet, uint8_t* packetsize, bool full) {
-    uint8_t status = 0;
-    uint8_t size = 0;
-    uint8_t tx_pl_wid[] = {R_RX_PL_WID, 0};
-    uint8_t rx_pl_wid[] = {0, 0};
-    uint8_t tx_cmd[33] = {0}; // 32 max payload size + 1 for command
-    uint8_t tmp_packet[33] = {0};
-
-    status = nrf24_status(handle);
+// Every command clocks STATUS out with its first byte, so status comes with the payload length
+static uint8_t nrf24_read_payload_len(FuriHalSpiBusHandle* handle, uint8_t* size, bool full) {
+    uint8_t tx[] = {full ? (R_REGISTER | RX_PW_P0) : R_RX_PL_WID, 0};
+    uint8_t rx[] = {0, 0};
+    nrf24_spi_trx(handle, tx, rx, 2, nrf24_TIMEOUT);
+    *size = rx[1];
+    return rx[0];
+}
 
-    if(status & 0x40) {
-        if(full)
-            size = nrf24_get_packetlen(handle);
-        else {
-            nrf24_spi_trx(handle, tx_pl_wid, rx_pl_wid, 2, nrf24_TIMEOUT);
-            size = rx_pl_wid[1];
+static uint8_t nrf24_rx_drain(
+    FuriHalSpiBusHandle* handle,
+    uint8_t (*packets)[NRF24_MAX_PAYLOAD],
+    uint8_t* sizes,
+    uint8_t max_count,
+    bool full,
+    uint8_t* status) {
+    uint8_t count = 0;
+    uint8_t size = 0;
+    uint8_t tx_cmd[NRF24_MAX_PAYLOAD + 1] = {0};
+    uint8_t tmp_packet[NRF24_MAX_PAYLOAD + 1] = {0};
+
+    *status = nrf24_read_payload_len(handle, &size, full);
+    while(count < max_count && !nrf24_rx_fifo_empty(*status)) {
+        if(size == 0 || size > NRF24_MAX_PAYLOAD) {
+            // Corrupted payload length or no radio on the bus, the datasheet asks to drop the FIFO
+            nrf24_flush_rx(handle);
+            nrf24_write_reg(handle, REG_STATUS, RX_DR);
+            break;
         }
 
         tx_cmd[0] = R_RX_PAYLOAD;
         nrf24_spi_trx(handle, tx_cmd, tmp_packet, size + 1, nrf24_TIMEOUT);
-        nrf24_write_reg(handle, REG_STATUS, 0x40); // clear bit.
-        memcpy(packet, &tmp_packet[1], size);
-    } else if(status == 0) {
-        nrf24_flush_rx(handle);
-        nrf24_write_reg(handle, REG_STATUS, 0x40); // clear bit.
+        memcpy(packets[count], &tmp_packet[1], size);
+        sizes[count++] = size;
+
+        // Clearing RX_DR returns STATUS after the read, its RX_P_NO tells if more packets wait
+        *status = nrf24_write_reg(handle, REG_STATUS, RX_DR);
+        if(!full && count < max_count && !nrf24_rx_fifo_empty(*status)) {
+            *status = nrf24_read_payload_len(handle, &size, full);
+        }
+    }
+
+    if(count) *status |= RX_DR;
+    return count;
+}
+
+uint8_t
+    nrf24_rxpacket(FuriHalSpiBusHandle* handle, uint8_t* packet, uint8_t* packetsize, bool full) {
+    uint8_t status = 0;
+    uint8_t tmp_packet[1][NRF24_MAX_PAYLOAD];
+    uint8_t size = 0;
+
+    if(nrf24_rx_drain(handle, tmp_packet, &size, 1, full, &status)) {
+        memcpy(packet, tmp_packet[0], size);
     }
 
     *packetsize = size;
     return status;
 }
 
+uint8_t nrf24_rxpackets(
+    FuriHalSpiBusHandle* handle,
+    uint8_t (*packets)[NRF24_MAX_PAYLOAD],
+    uint8_t* packetsizes,
+    bool full) {
+    uint8_t status = 0;
+    return nrf24_rx_drain(handle, packets, packetsizes, NRF24_RX_FIFO_SIZE, full, &status);
+}
+
 uint8_t nrf24_txpacket(FuriHalSpiBusHandle* handle, uint8_t* payload, uint8_t size, bool ack) {
     uint8_t status = 0;
     uint8_t tx[size + 1];
@@ -308,34 +369,31 @@ void nrf24_configure(
     else
         rate = 0; // 1Mbps
 
-    nrf24_write_reg(handle, REG_CONFIG, 0x00); // Stop nRF
-    nrf24_set_idle(handle);
-    nrf24_write_reg(handle, REG_STATUS, 0x1c); // clear interrupts
-    if(disable_aa)
-        nrf24_write_reg(handle, REG_EN_AA, 0x00); // Disable Shockburst
-    else
-        nrf24_write_reg(handle, REG_EN_AA, 0x1F); // Enable Shockburst
-
-    nrf24_write_reg(handle, REG_DYNPD, 0x3F); // enable dynamic payload length on all pipes
-    if(noack)
-        nrf24_write_reg(handle, REG_FEATURE, 0x05); // disable payload-with-ack, enable noack
-    else {
-        nrf24_write_reg(handle, REG_CONFIG, 0x0C); // 2 byte CRC
-        nrf24_write_reg(handle, REG_FEATURE, 0x07); // enable dyn payload and ack
+    // Radio stays powered down while it is set up, so idle is just CE low
+    furi_hal_gpio_write(nrf24_CE_PIN, false);
+    const nrf24_reg_write regs[] = {
+        {REG_CONFIG, noack ? 0x00 : 0x0C}, // Stop nRF, 2 byte CRC for acked packets
+        {REG_STATUS, RX_DR | TX_DS | MAX_RT}, // clear interrupts
+        {REG_EN_AA, disable_aa ? 0x00 : 0x1F}, // Disable or enable Shockburst
+        {REG_DYNPD, 0x3F}, // enable dynamic payload length on all pipes
+        // disable payload-with-ack and enable noack, or enable dyn payload and ack
+        {REG_FEATURE, noack ? 0x05 : 0x07},
+        {REG_RF_CH, channel},
+        {REG_RF_SETUP, rate},
+    };
+    nrf24_write_regs(handle, regs, COUNT_OF(regs));
+    if(!noack) {
         nrf24_write_reg(
             handle, REG_SETUP_RETR, 0x1f); // 15 retries for AA, 500us auto retransmit delay
     }
 
-    nrf24_set_idle(handle);
     nrf24_flush_rx(handle);
     nrf24_flush_tx(handle);
 
     if(maclen) nrf24_set_maclen(handle, maclen);
-    if(srcmac) nrf24_set_src_mac(handle, srcmac, maclen);
-    if(dstmac) nrf24_set_dst_mac(handle, dstmac, maclen);
+    if(srcmac) nrf24_write_mac_reg(handle, REG_RX_ADDR_P0, srcmac, maclen);
+    if(dstmac) nrf24_write_mac_reg(handle, REG_TX_ADDR, dstmac, maclen);
 
-    nrf24_write_reg(handle, REG_RF_CH, channel);
-    nrf24_write_reg(handle, REG_RF_SETUP, rate);
     furi_delay_ms(200);
 }
 
@@ -344,19 +402,23 @@ void nrf24_init_promisc_mode(FuriHalSpiBusHandle* handle, uint8_t channel, uint8
     uint8_t preamble[] = {0xAA, 0x00}; // little endian
     //uint8_t preamble[] = {0x00, 0x55}; // little endian
     //uint8_t preamble[] = {0x00, 0xAA}; // little endian
-    nrf24_write_reg(handle, REG_CONFIG, 0x00); // Stop nRF
-    nrf24_write_reg(handle, REG_STATUS, 0x1c); // clear interrupts
-    nrf24_write_reg(handle, REG_DYNPD, 0x0); // disable shockburst
-    nrf24_write_reg(handle, REG_EN_AA, 0x00); // Disable Shockburst
-    nrf24_write_reg(handle, REG_FEATURE, 0x05); // disable payload-with-ack, enable noack
-    nrf24_set_maclen(handle, 2); // shortest address
-    nrf24_set_src_mac(handle, preamble, 2); // set src mac to preamble bits to catch everything
-    nrf24_set_packetlen(handle, 32); // set max packet length
-    nrf24_set_idle(handle);
+    furi_hal_gpio_write(nrf24_CE_PIN, false);
+    const nrf24_reg_write regs[] = {
+        {REG_CONFIG, 0x00}, // Stop nRF
+        {REG_STATUS, RX_DR | TX_DS | MAX_RT}, // clear interrupts
+        {REG_DYNPD, 0x0}, // disable shockburst
+        {REG_EN_AA, 0x00}, // Disable Shockburst
+        {REG_FEATURE, 0x05}, // disable payload-with-ack, enable noack
+        {REG_SETUP_AW, 0x00}, // shortest address, 2 bytes
+        {RX_PW_P0, NRF24_MAX_PAYLOAD}, // set max packet length
+        {REG_RF_CH, channel},
+        {REG_RF_SETUP, rate},
+    };
+    nrf24_write_regs(handle, regs, COUNT_OF(regs));
+    // set src mac to preamble bits to catch everything
+    nrf24_write_mac_reg(handle, REG_RX_ADDR_P0, preamble, 2);
     nrf24_flush_rx(handle);
     nrf24_flush_tx(handle);
-    nrf24_write_reg(handle, REG_RF_CH, channel);
-    nrf24_write_reg(handle, REG_RF_SETUP, rate);
 
     // prime for RX, no checksum
     nrf24_write_reg(handle, REG_CONFIG, 0x03); // PWR_UP and PRIM_RX, disable AA and CRC
@@ -493,6 +555,25 @@ bool nrf24_sniff_address(FuriHalSpiBusHandle* handle, uint8_t maclen, uint8_t* a
     return found;
 }
 
+uint8_t nrf24_sniff_addresses(
+    FuriHalSpiBusHandle* handle,
+    uint8_t maclen,
+    uint8_t (*addresses)[5]) {
+    assert(maclen <= 5);
+    uint8_t packets[NRF24_RX_FIFO_SIZE][NRF24_MAX_PAYLOAD];
+    uint8_t packetsizes[NRF24_RX_FIFO_SIZE];
+    uint8_t found = 0;
+
+    uint8_t count = nrf24_rxpackets(handle, packets, packetsizes, true);
+    for(uint8_t i = 0; i < count; i++) {
+        if(!validate_address(packets[i])) continue;
+        for(uint8_t j = 0; j < maclen; j++) addresses[found][j] = packets[i][maclen - 1 - j];
+        found++;
+    }
+
+    return found;
+}
+
 uint8_t nrf24_find_channel(
     FuriHalSpiBusHandle* handle,
     uint8_t* srcmac,
@@ -517,4 +598,14 @@ uint8_t nrf24_find_channel(
     }
 
     return ch;
+}
+
+bool nrf24_check_connected(FuriHalSpiBusHandle* handle) {
+    uint8_t status = nrf24_status(handle);
+
+    if(status != 0x00) {
+        return true;
+    } else {
+        return false;
+    }
 }
\ No newline at end of file
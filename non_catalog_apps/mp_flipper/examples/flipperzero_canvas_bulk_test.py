@@ -0,0 +1,53 @@
+import time
+import flipperzero as f0
+
+WIDTH = 128
+HEIGHT = 64
+STRIDE = WIDTH // 8
+
+# render a checkerboard into a frame buffer and blit it in one call
+frame = bytearray(STRIDE * HEIGHT)
+
+for y in range(0, HEIGHT):
+    for i in range(0, STRIDE):
+        frame[y * STRIDE + i] = 0x55 if y % 2 else 0xAA
+
+f0.canvas_clear()
+f0.canvas_draw_bitmap(0, 0, WIDTH, HEIGHT, frame)
+f0.canvas_update()
+
+time.sleep(1)
+
+# animate a bouncing ball with a packed command list
+commands = bytearray([
+    f0.CANVAS_CMD_CLEAR,
+    f0.CANVAS_CMD_COLOR, f0.CANVAS_BLACK,
+    f0.CANVAS_CMD_FRAME, 0, 0, WIDTH, HEIGHT, 0,
+    f0.CANVAS_CMD_DISC, 0, 0, 6,
+])
+
+ball = len(commands) - 3
+
+x, y = 20, 20
+dx, dy = 3, 2
+
+start = time.ticks_ms()
+
+for _ in range(0, 200):
+    x += dx
+    y += dy
+
+    if x < 7 or x > WIDTH - 8:
+        dx = -dx
+    if y < 7 or y > HEIGHT - 8:
+        dy = -dy
+
+    commands[ball] = x
+    commands[ball + 1] = y
+
+    f0.canvas_draw_commands(commands)
+    f0.canvas_update()
+
+elapsed = time.ticks_diff(time.ticks_ms(), start)
+
+print('{} frames in {} ms'.format(200, elapsed))
@@ -0,0 +1,106 @@
+import time
+import flipperzero
+
+
+def bytecode_sum(n):
+    total = 0
+    for i in range(n):
+        total += i & 0xFF
+    return total
+
+
+@micropython.native
+def native_sum(n):
+    total = 0
+    for i in range(n):
+        total += i & 0xFF
+    return total
+
+
+@micropython.viper
+def viper_sum(n: int) -> int:
+    total = 0
+    i = 0
+    while i < n:
+        total += i & 0xFF
+        i += 1
+    return total
+
+
+def bytecode_fib(n):
+    return n if n < 2 else bytecode_fib(n - 1) + bytecode_fib(n - 2)
+
+
+@micropython.native
+def native_fib(n):
+    return n if n < 2 else native_fib(n - 1) + native_fib(n - 2)
+
+
+@micropython.viper
+def viper_fib(n: int) -> int:
+    if n < 2:
+        return n
+    return int(viper_fib(n - 1)) + int(viper_fib(n - 2))
+
+
+def bytecode_checker():
+    for x in range(128):
+        for y in range(64):
+            if (x ^ y) & 1:
+                flipperzero.canvas_draw_dot(x, y)
+
+
+@micropython.native
+def native_checker():
+    for x in range(128):
+        for y in range(64):
+            if (x ^ y) & 1:
+                flipperzero.canvas_draw_dot(x, y)
+
+
+@micropython.viper
+def viper_checker():
+    x = 0
+    while x < 128:
+        y = 0
+        while y < 64:
+            if (x ^ y) & 1:
+                flipperzero.canvas_draw_dot(x, y)
+            y += 1
+        x += 1
+
+
+def measure(name, function, argument=None):
+    start = time.ticks_us()
+
+    if argument is None:
+        function()
+    else:
+        function(argument)
+
+    duration = time.ticks_diff(time.ticks_us(), start)
+
+    print("%s: %d us" % (name, duration))
+
+    return duration
+
+
+benchmarks = [
+    ("sum", 20000, bytecode_sum, native_sum, viper_sum),
+    ("fib", 18, bytecode_fib, native_fib, viper_fib),
+    ("checker", None, bytecode_checker, native_checker, viper_checker),
+]
+
+for name, argument, bytecode, native, viper in benchmarks:
+    flipperzero.canvas_clear()
+
+    reference = measure(name + " bytecode", bytecode, argument)
+
+    for kind, function in (("native", native), ("viper", viper)):
+        duration = measure(name + " " + kind, function, argument)
+
+        speedup = reference * 100 // duration
+
+        print("%s %s speedup: %d.%02dx" % (name, kind, speedup // 100, speedup % 100))
+
+    flipperzero.canvas_update()
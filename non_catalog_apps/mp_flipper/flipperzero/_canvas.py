@@ -240,3 +240,124 @@ def canvas_draw_disc(x: int, y: int, r: int) -> None:
     .. versionadded:: 1.0.0
     """
     pass
+
+
+def canvas_draw_bitmap(x: int, y: int, w: int, h: int, data: bytes | bytearray) -> None:
+    """
+    Draw a 1-bit bitmap on the canvas in a single call. The set pixels are drawn by using the currently active color settings.
+    The data is expected in XBM format: each row starts on a new byte, the least significant bit is the leftmost pixel.
+    A full screen bitmap of 128x64 pixels takes 1024 bytes.
+
+    :param x: The horizontal position.
+    :param y: The vertical position.
+    :param w: The width of the bitmap.
+    :param h: The height of the bitmap.
+    :param data: The bitmap data, at least ``(w + 7) // 8 * h`` bytes.
+    :raises ValueError: The data is too short for the given size.
+
+    .. versionadded:: 1.7.0
+
+    .. code-block::
+
+        import flipperzero as f0
+
+        frame = bytearray(128 // 8 * 64)
+
+        # set the pixel at (10, 20)
+        frame[20 * 16 + 10 // 8] |= 1 << (10 % 8)
+
+        f0.canvas_clear()
+        f0.canvas_draw_bitmap(0, 0, 128, 64, frame)
+        f0.canvas_update()
+    """
+    pass
+
+
+CANVAS_CMD_DOT: int
+"""
+Command to draw a dot, followed by the ``x`` and ``y`` bytes.
+
+.. versionadded:: 1.7.0
+"""
+
+CANVAS_CMD_BOX: int
+"""
+Command to draw a box, followed by the ``x``, ``y``, ``w``, ``h`` and ``r`` bytes.
+
+.. versionadded:: 1.7.0
+"""
+
+CANVAS_CMD_FRAME: int
+"""
+Command to draw a frame, followed by the ``x``, ``y``, ``w``, ``h`` and ``r`` bytes.
+
+.. versionadded:: 1.7.0
+"""
+
+CANVAS_CMD_LINE: int
+"""
+Command to draw a line, followed by the ``x0``, ``y0``, ``x1`` and ``y1`` bytes.
+
+.. versionadded:: 1.7.0
+"""
+
+CANVAS_CMD_CIRCLE: int
+"""
+Command to draw a circle, followed by the ``x``, ``y`` and ``r`` bytes.
+
+.. versionadded:: 1.7.0
+"""
+
+CANVAS_CMD_DISC: int
+"""
+Command to draw a disc, followed by the ``x``, ``y`` and ``r`` bytes.
+
+.. versionadded:: 1.7.0
+"""
+
+CANVAS_CMD_COLOR: int
+"""
+Command to change the color, followed by one color byte.
+
+.. versionadded:: 1.7.0
+"""
+
+CANVAS_CMD_CLEAR: int
+"""
+Command to clear the canvas, without any arguments.
+
+.. versionadded:: 1.7.0
+"""
+
+
+def canvas_draw_commands(commands: bytes | bytearray) -> None:
+    """
+    Execute a packed list of drawing commands in a single call.
+    Each command is a ``CANVAS_CMD_*`` byte followed by its arguments, one byte per argument.
+    The list can be built once and drawn on every frame, which avoids the overhead of calling a function per shape.
+
+    :param commands: The packed command list.
+    :raises ValueError: The list contains an unknown command or ends in the middle of a command.
+
+    .. versionadded:: 1.7.0
+
+    .. code-block::
+
+        import flipperzero as f0
+
+        commands = bytes([
+            f0.CANVAS_CMD_CLEAR,
+            f0.CANVAS_CMD_COLOR, f0.CANVAS_BLACK,
+            f0.CANVAS_CMD_FRAME, 0, 0, 128, 64, 3,
+            f0.CANVAS_CMD_LINE, 0, 0, 127, 63,
+            f0.CANVAS_CMD_DISC, 64, 32, 10,
+        ])
+
+        f0.canvas_draw_commands(commands)
+        f0.canvas_update()
+
+    .. note::
+
+        Invalid commands stop the execution, but shapes drawn before remain on the canvas.
+    """
+    pass
@@ -13,7 +13,7 @@
 
 typedef struct {
     size_t pointer;
-    FuriString* content;
+    uint8_t* content;
     size_t size;
 } FileDescriptor;
 
@@ -40,16 +40,11 @@ inline void* mp_flipper_file_reader_context_alloc(const char* filename) {
         fd = malloc(sizeof(FileDescriptor));
 
         fd->pointer = 0;
-        fd->content = furi_string_alloc();
         fd->size = storage_file_size(file);
+        fd->content = malloc(fd->size);
 
-        char character = '\0';
-
-        for(size_t i = 0; i < fd->size; i++) {
-            storage_file_read(file, &character, 1);
-
-            furi_string_push_back(fd->content, character);
-        }
+        // read in one go, .mpy files are binary and may contain zero bytes
+        fd->size = storage_file_read(file, fd->content, fd->size);
     } while(false);
 
     storage_file_free(file);
@@ -65,13 +60,13 @@ inline uint32_t mp_flipper_file_reader_read(void* data) {
         return MP_FLIPPER_FILE_READER_EOF;
     }
 
-    return furi_string_get_char(fd->content, fd->pointer++);
+    return fd->content[fd->pointer++];
 }
 
 void mp_flipper_file_reader_close(void* data) {
     FileDescriptor* fd = data;
 
-    furi_string_free(fd->content);
+    free(fd->content);
 
     free(data);
 }
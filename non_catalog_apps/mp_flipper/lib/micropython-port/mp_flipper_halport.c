@@ -6,6 +6,7 @@
 #include <mp_flipper_runtime.h>
 #include <mp_flipper_halport.h>
 
+#include "mp_flipper_context.h"
 #include "mp_flipper_file_helper.h"
 
 inline void mp_flipper_stdout_tx_str(const char* str) {
@@ -28,6 +29,124 @@ inline mp_flipper_import_stat_t mp_flipper_import_stat(const char* path) {
     return stat;
 }
 
+static void mp_flipper_make_absolute_path(FuriString* path) {
+    if(!furi_string_start_with_str(path, "/")) {
+        furi_string_replace_at(path, 0, 0, "/");
+        furi_string_replace_at(path, 0, 0, mp_flipper_root_module_path);
+    }
+}
+
+static bool mp_flipper_import_cache_stamp(
+    Storage* storage,
+    const char* py_path,
+    mp_flipper_import_cache_header_t* header) {
+    FuriString* path = furi_string_alloc_set_str(py_path);
+    FileInfo info = {0};
+    uint32_t timestamp = 0;
+
+    mp_flipper_make_absolute_path(path);
+
+    bool stamped =
+        storage_common_stat(storage, furi_string_get_cstr(path), &info) == FSE_OK &&
+        storage_common_timestamp(storage, furi_string_get_cstr(path), &timestamp) == FSE_OK;
+
+    furi_string_free(path);
+
+    header->magic = MP_FLIPPER_IMPORT_CACHE_MAGIC;
+    header->source_size = info.size;
+    header->source_timestamp = timestamp;
+
+    return stamped;
+}
+
+static bool mp_flipper_import_cache_read_header(
+    Storage* storage,
+    const char* mpy_path,
+    mp_flipper_import_cache_header_t* header) {
+    FuriString* path = furi_string_alloc_set_str(mpy_path);
+    File* file = storage_file_alloc(storage);
+    bool read = false;
+
+    mp_flipper_make_absolute_path(path);
+
+    if(storage_file_open(file, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+        read = storage_file_read(file, header, sizeof(*header)) == sizeof(*header) &&
+               header->magic == MP_FLIPPER_IMPORT_CACHE_MAGIC;
+    }
+
+    storage_file_free(file);
+    furi_string_free(path);
+
+    return read;
+}
+
+bool mp_flipper_import_cache_is_cache(const char* mpy_path) {
+    mp_flipper_import_cache_header_t header;
+
+    return mp_flipper_import_cache_read_header(mp_flipper_context->storage, mpy_path, &header);
+}
+
+bool mp_flipper_import_cache_is_fresh(const char* py_path, const char* mpy_path) {
+    mp_flipper_context_t* ctx = mp_flipper_context;
+
+    mp_flipper_import_cache_header_t source;
+    mp_flipper_import_cache_header_t cached;
+
+    // any change to the source size or timestamp invalidates the cache, newer or not
+    return mp_flipper_import_cache_stamp(ctx->storage, py_path, &source) &&
+           mp_flipper_import_cache_read_header(ctx->storage, mpy_path, &cached) &&
+           cached.source_size == source.source_size &&
+           cached.source_timestamp == source.source_timestamp;
+}
+
+bool mp_flipper_import_cache_save(
+    const char* py_path,
+    const char* mpy_path,
+    const char* data,
+    size_t size) {
+    mp_flipper_context_t* ctx = mp_flipper_context;
+
+    mp_flipper_import_cache_header_t header;
+
+    if(!mp_flipper_import_cache_stamp(ctx->storage, py_path, &header)) {
+        return false;
+    }
+
+    FuriString* path = furi_string_alloc_set_str(mpy_path);
+    File* file = storage_file_alloc(ctx->storage);
+    bool saved = false;
+
+    mp_flipper_make_absolute_path(path);
+
+    if(storage_file_open(file, furi_string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        saved = storage_file_write(file, &header, sizeof(header)) == sizeof(header) &&
+                storage_file_write(file, data, size) == size;
+    }
+
+    storage_file_free(file);
+
+    // never leave a truncated cache behind
+    if(!saved) {
+        storage_common_remove(ctx->storage, furi_string_get_cstr(path));
+    }
+
+    furi_string_free(path);
+
+    return saved;
+}
+
+void mp_flipper_import_cache_remove(const char* mpy_path) {
+    mp_flipper_context_t* ctx = mp_flipper_context;
+
+    FuriString* path = furi_string_alloc_set_str(mpy_path);
+
+    mp_flipper_make_absolute_path(path);
+
+    storage_common_remove(ctx->storage, furi_string_get_cstr(path));
+
+    furi_string_free(path);
+}
+
 inline size_t mp_flipper_gc_get_max_new_split(void) {
     return memmgr_heap_get_max_free_block();
 }
@@ -106,3 +106,72 @@ inline void mp_flipper_canvas_clear() {
 
     canvas_clear(ctx->canvas);
 }
+
+inline void mp_flipper_canvas_draw_bitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t* data) {
+    mp_flipper_context_t* ctx = mp_flipper_context;
+
+    canvas_draw_xbm(ctx->canvas, x, y, w, h, data);
+}
+
+static const uint8_t canvas_command_args[] = {
+    [MP_FLIPPER_CANVAS_CMD_DOT] = 2,
+    [MP_FLIPPER_CANVAS_CMD_BOX] = 5,
+    [MP_FLIPPER_CANVAS_CMD_FRAME] = 5,
+    [MP_FLIPPER_CANVAS_CMD_LINE] = 4,
+    [MP_FLIPPER_CANVAS_CMD_CIRCLE] = 3,
+    [MP_FLIPPER_CANVAS_CMD_DISC] = 3,
+    [MP_FLIPPER_CANVAS_CMD_COLOR] = 1,
+    [MP_FLIPPER_CANVAS_CMD_CLEAR] = 0,
+};
+
+bool mp_flipper_canvas_draw_commands(const uint8_t* data, size_t length) {
+    mp_flipper_context_t* ctx = mp_flipper_context;
+    Canvas* canvas = ctx->canvas;
+
+    size_t offset = 0;
+
+    while(offset < length) {
+        uint8_t command = data[offset++];
+
+        if(command == 0 || command >= COUNT_OF(canvas_command_args)) {
+            return false;
+        }
+
+        const uint8_t* args = &data[offset];
+
+        offset += canvas_command_args[command];
+
+        if(offset > length) {
+            return false;
+        }
+
+        switch(command) {
+        case MP_FLIPPER_CANVAS_CMD_DOT:
+            canvas_draw_dot(canvas, args[0], args[1]);
+            break;
+        case MP_FLIPPER_CANVAS_CMD_BOX:
+            canvas_draw_rbox(canvas, args[0], args[1], args[2], args[3], args[4]);
+            break;
+        case MP_FLIPPER_CANVAS_CMD_FRAME:
+            canvas_draw_rframe(canvas, args[0], args[1], args[2], args[3], args[4]);
+            break;
+        case MP_FLIPPER_CANVAS_CMD_LINE:
+            canvas_draw_line(canvas, args[0], args[1], args[2], args[3]);
+            break;
+        case MP_FLIPPER_CANVAS_CMD_CIRCLE:
+            canvas_draw_circle(canvas, args[0], args[1], args[2]);
+            break;
+        case MP_FLIPPER_CANVAS_CMD_DISC:
+            canvas_draw_disc(canvas, args[0], args[1], args[2]);
+            break;
+        case MP_FLIPPER_CANVAS_CMD_COLOR:
+            canvas_set_color(canvas, args[0] == MP_FLIPPER_COLOR_BLACK ? ColorBlack : ColorWhite);
+            break;
+        case MP_FLIPPER_CANVAS_CMD_CLEAR:
+            canvas_clear(canvas);
+            break;
+        }
+    }
+
+    return true;
+}
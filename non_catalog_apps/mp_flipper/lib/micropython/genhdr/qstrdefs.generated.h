@@ -180,6 +180,14 @@ QDEF1(MP_QSTR_ALIGN_CENTER, 28, 12, "ALIGN_CENTER")
 QDEF1(MP_QSTR_ALIGN_END, 248, 9, "ALIGN_END")
 QDEF1(MP_QSTR_BinaryFileIO, 106, 12, "BinaryFileIO")
 QDEF1(MP_QSTR_CANVAS_BLACK, 213, 12, "CANVAS_BLACK")
+QDEF1(MP_QSTR_CANVAS_CMD_BOX, 210, 14, "CANVAS_CMD_BOX")
+QDEF1(MP_QSTR_CANVAS_CMD_CIRCLE, 53, 17, "CANVAS_CMD_CIRCLE")
+QDEF1(MP_QSTR_CANVAS_CMD_CLEAR, 30, 16, "CANVAS_CMD_CLEAR")
+QDEF1(MP_QSTR_CANVAS_CMD_COLOR, 58, 16, "CANVAS_CMD_COLOR")
+QDEF1(MP_QSTR_CANVAS_CMD_DISC, 250, 15, "CANVAS_CMD_DISC")
+QDEF1(MP_QSTR_CANVAS_CMD_DOT, 88, 14, "CANVAS_CMD_DOT")
+QDEF1(MP_QSTR_CANVAS_CMD_FRAME, 154, 16, "CANVAS_CMD_FRAME")
+QDEF1(MP_QSTR_CANVAS_CMD_LINE, 73, 15, "CANVAS_CMD_LINE")
 QDEF1(MP_QSTR_CANVAS_WHITE, 53, 12, "CANVAS_WHITE")
 QDEF1(MP_QSTR_DEBUG, 52, 5, "DEBUG")
 QDEF1(MP_QSTR_ERROR, 157, 5, "ERROR")
@@ -223,6 +231,7 @@ QDEF1(MP_QSTR_LIGHT_BLUE, 90, 10, "LIGHT_BLUE")
 QDEF1(MP_QSTR_LIGHT_GREEN, 95, 11, "LIGHT_GREEN")
 QDEF1(MP_QSTR_LIGHT_RED, 215, 9, "LIGHT_RED")
 QDEF1(MP_QSTR_NONE, 79, 4, "NONE")
+QDEF1(MP_QSTR_None, 111, 4, "None")
 QDEF1(MP_QSTR_SEEK_CUR, 134, 8, "SEEK_CUR")
 QDEF1(MP_QSTR_SEEK_END, 237, 8, "SEEK_END")
 QDEF1(MP_QSTR_SEEK_SET, 128, 8, "SEEK_SET")
@@ -341,6 +350,7 @@ QDEF1(MP_QSTR_TextFileIO, 56, 10, "TextFileIO")
 QDEF1(MP_QSTR_UART, 183, 4, "UART")
 QDEF1(MP_QSTR_UART_MODE_LPUART, 250, 16, "UART_MODE_LPUART")
 QDEF1(MP_QSTR_UART_MODE_USART, 53, 15, "UART_MODE_USART")
+QDEF1(MP_QSTR_ViperTypeError, 221, 14, "ViperTypeError")
 QDEF1(MP_QSTR_WARN, 239, 4, "WARN")
 QDEF0(MP_QSTR___add__, 196, 7, "__add__")
 QDEF1(MP_QSTR___bases__, 3, 9, "__bases__")
@@ -371,11 +381,20 @@ QDEF1(MP_QSTR__input_trigger_handler, 108, 22, "_input_trigger_handler")
 QDEF1(MP_QSTR_adc_read_pin_value, 178, 18, "adc_read_pin_value")
 QDEF1(MP_QSTR_adc_read_pin_voltage, 251, 20, "adc_read_pin_voltage")
 QDEF1(MP_QSTR_add, 68, 3, "add")
+QDEF1(MP_QSTR_align, 168, 5, "align")
+QDEF1(MP_QSTR_and_, 145, 4, "and_")
+QDEF1(MP_QSTR_asm_thumb, 67, 9, "asm_thumb")
+QDEF1(MP_QSTR_asr, 101, 3, "asr")
+QDEF1(MP_QSTR_b, 199, 1, "b")
 QDEF1(MP_QSTR_bin, 224, 3, "bin")
+QDEF1(MP_QSTR_bl, 203, 2, "bl")
 QDEF1(MP_QSTR_bound_method, 151, 12, "bound_method")
+QDEF1(MP_QSTR_bx, 223, 2, "bx")
 QDEF1(MP_QSTR_canvas_clear, 107, 12, "canvas_clear")
+QDEF1(MP_QSTR_canvas_draw_bitmap, 238, 18, "canvas_draw_bitmap")
 QDEF1(MP_QSTR_canvas_draw_box, 56, 15, "canvas_draw_box")
 QDEF1(MP_QSTR_canvas_draw_circle, 63, 18, "canvas_draw_circle")
+QDEF1(MP_QSTR_canvas_draw_commands, 185, 20, "canvas_draw_commands")
 QDEF1(MP_QSTR_canvas_draw_disc, 176, 16, "canvas_draw_disc")
 QDEF1(MP_QSTR_canvas_draw_dot, 178, 15, "canvas_draw_dot")
 QDEF1(MP_QSTR_canvas_draw_frame, 240, 17, "canvas_draw_frame")
@@ -391,6 +410,11 @@ QDEF1(MP_QSTR_canvas_update, 131, 13, "canvas_update")
 QDEF1(MP_QSTR_canvas_width, 180, 12, "canvas_width")
 QDEF1(MP_QSTR_choice, 46, 6, "choice")
 QDEF1(MP_QSTR_closure, 116, 7, "closure")
+QDEF1(MP_QSTR_clz, 80, 3, "clz")
+QDEF1(MP_QSTR_cmp, 59, 3, "cmp")
+QDEF1(MP_QSTR_cpsid, 232, 5, "cpsid")
+QDEF1(MP_QSTR_cpsie, 233, 5, "cpsie")
+QDEF1(MP_QSTR_data, 21, 4, "data")
 QDEF1(MP_QSTR_debug, 212, 5, "debug")
 QDEF1(MP_QSTR_decode, 169, 6, "decode")
 QDEF1(MP_QSTR_default, 206, 7, "default")
@@ -431,6 +455,11 @@ QDEF1(MP_QSTR_isdisjoint, 247, 10, "isdisjoint")
 QDEF1(MP_QSTR_issubset, 185, 8, "issubset")
 QDEF1(MP_QSTR_issuperset, 252, 10, "issuperset")
 QDEF1(MP_QSTR_iterator, 71, 8, "iterator")
+QDEF1(MP_QSTR_label, 67, 5, "label")
+QDEF1(MP_QSTR_ldr, 95, 3, "ldr")
+QDEF1(MP_QSTR_ldrb, 93, 4, "ldrb")
+QDEF1(MP_QSTR_ldrex, 226, 5, "ldrex")
+QDEF1(MP_QSTR_ldrh, 87, 4, "ldrh")
 QDEF1(MP_QSTR_level, 211, 5, "level")
 QDEF1(MP_QSTR_light_blink_set_color, 217, 21, "light_blink_set_color")
 QDEF1(MP_QSTR_light_blink_start, 121, 17, "light_blink_start")
@@ -438,14 +467,28 @@ QDEF1(MP_QSTR_light_blink_stop, 33, 16, "light_blink_stop")
 QDEF1(MP_QSTR_light_set, 134, 9, "light_set")
 QDEF1(MP_QSTR_log, 33, 3, "log")
 QDEF1(MP_QSTR_logging, 70, 7, "logging")
+QDEF1(MP_QSTR_lsl, 182, 3, "lsl")
+QDEF1(MP_QSTR_lsr, 168, 3, "lsr")
 QDEF1(MP_QSTR_max, 177, 3, "max")
 QDEF1(MP_QSTR_maximum_space_recursion_space_depth_space_exceeded, 115, 32, "maximum recursion depth exceeded")
 QDEF1(MP_QSTR_min, 175, 3, "min")
 QDEF1(MP_QSTR_module, 191, 6, "module")
+QDEF1(MP_QSTR_mov, 241, 3, "mov")
+QDEF1(MP_QSTR_movt, 101, 4, "movt")
+QDEF1(MP_QSTR_movw, 102, 4, "movw")
+QDEF1(MP_QSTR_movwt, 82, 5, "movwt")
+QDEF1(MP_QSTR_mrs, 137, 3, "mrs")
 QDEF1(MP_QSTR_name, 162, 4, "name")
+QDEF1(MP_QSTR_native, 132, 6, "native")
+QDEF1(MP_QSTR_nop, 180, 3, "nop")
 QDEF1(MP_QSTR_oct, 253, 3, "oct")
 QDEF1(MP_QSTR_on_gpio, 106, 7, "on_gpio")
 QDEF1(MP_QSTR_on_input, 141, 8, "on_input")
+QDEF1(MP_QSTR_ptr, 83, 3, "ptr")
+QDEF1(MP_QSTR_ptr16, 244, 5, "ptr16")
+QDEF1(MP_QSTR_ptr32, 178, 5, "ptr32")
+QDEF1(MP_QSTR_ptr8, 139, 4, "ptr8")
+QDEF1(MP_QSTR_push, 187, 4, "push")
 QDEF1(MP_QSTR_pwm_is_running, 82, 14, "pwm_is_running")
 QDEF1(MP_QSTR_pwm_start, 240, 9, "pwm_start")
 QDEF1(MP_QSTR_pwm_stop, 200, 8, "pwm_stop")
@@ -453,9 +496,11 @@ QDEF1(MP_QSTR_randint, 175, 7, "randint")
 QDEF1(MP_QSTR_random, 190, 6, "random")
 QDEF1(MP_QSTR_randrange, 163, 9, "randrange")
 QDEF1(MP_QSTR_rb, 213, 2, "rb")
+QDEF1(MP_QSTR_rbit, 232, 4, "rbit")
 QDEF1(MP_QSTR_readable, 93, 8, "readable")
 QDEF1(MP_QSTR_readlines, 106, 9, "readlines")
 QDEF1(MP_QSTR_reversed, 161, 8, "reversed")
+QDEF1(MP_QSTR_sdiv, 205, 4, "sdiv")
 QDEF1(MP_QSTR_seed, 146, 4, "seed")
 QDEF1(MP_QSTR_seek, 157, 4, "seek")
 QDEF1(MP_QSTR_setLevel, 81, 8, "setLevel")
@@ -465,6 +510,10 @@ QDEF1(MP_QSTR_sleep_us, 19, 8, "sleep_us")
 QDEF1(MP_QSTR_speaker_set_volume, 116, 18, "speaker_set_volume")
 QDEF1(MP_QSTR_speaker_start, 1, 13, "speaker_start")
 QDEF1(MP_QSTR_speaker_stop, 153, 12, "speaker_stop")
+QDEF1(MP_QSTR_strb, 50, 4, "strb")
+QDEF1(MP_QSTR_strex, 173, 5, "strex")
+QDEF1(MP_QSTR_strh, 56, 4, "strh")
+QDEF1(MP_QSTR_sub, 33, 3, "sub")
 QDEF1(MP_QSTR_symmetric_difference, 206, 20, "symmetric_difference")
 QDEF1(MP_QSTR_symmetric_difference_update, 96, 27, "symmetric_difference_update")
 QDEF1(MP_QSTR_tell, 20, 4, "tell")
@@ -477,9 +526,22 @@ QDEF1(MP_QSTR_time, 240, 4, "time")
 QDEF1(MP_QSTR_time_ns, 114, 7, "time_ns")
 QDEF1(MP_QSTR_trace, 164, 5, "trace")
 QDEF1(MP_QSTR_uart_open, 220, 9, "uart_open")
+QDEF1(MP_QSTR_udiv, 139, 4, "udiv")
+QDEF1(MP_QSTR_uint, 227, 4, "uint")
 QDEF1(MP_QSTR_uniform, 1, 7, "uniform")
 QDEF1(MP_QSTR_union, 246, 5, "union")
+QDEF1(MP_QSTR_vcmp, 173, 4, "vcmp")
+QDEF1(MP_QSTR_vcvt_f32_s32, 71, 12, "vcvt_f32_s32")
+QDEF1(MP_QSTR_vcvt_s32_f32, 7, 12, "vcvt_s32_f32")
 QDEF1(MP_QSTR_vibro_set, 216, 9, "vibro_set")
+QDEF1(MP_QSTR_viper, 93, 5, "viper")
+QDEF1(MP_QSTR_vldr, 201, 4, "vldr")
+QDEF1(MP_QSTR_vmov, 231, 4, "vmov")
+QDEF1(MP_QSTR_vmrs, 159, 4, "vmrs")
+QDEF1(MP_QSTR_vneg, 255, 4, "vneg")
+QDEF1(MP_QSTR_vsqrt, 247, 5, "vsqrt")
+QDEF1(MP_QSTR_vstr, 198, 4, "vstr")
 QDEF1(MP_QSTR_warn, 175, 4, "warn")
+QDEF1(MP_QSTR_wfi, 157, 3, "wfi")
 QDEF1(MP_QSTR_writable, 247, 8, "writable")
 QDEF1(MP_QSTR__brace_open__colon__hash_b_brace_close_, 88, 5, "{:#b}")
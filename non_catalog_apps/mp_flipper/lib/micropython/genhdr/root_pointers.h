@@ -1,3 +1,4 @@
 // Automatically generated by make_root_pointers.py.
 
+mp_obj_t track_reloc_code_list;
 mp_sched_item_t sched_queue[(4)];
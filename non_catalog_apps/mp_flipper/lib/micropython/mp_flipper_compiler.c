@@ -4,6 +4,7 @@
 #include "py/compile.h"
 #include "py/runtime.h"
 #include "py/persistentcode.h"
+#include "py/reader.h"
 #include "py/gc.h"
 #include "py/stackctrl.h"
 #include "shared/runtime/gchelper.h"
@@ -29,6 +30,163 @@ void mp_flipper_exec_str(const char* code) {
     }
 }
 
+static void mp_flipper_compile_file(qstr file_qstr, mp_compiled_module_t* cm) {
+    mp_lexer_t* lex = mp_lexer_new_from_file(file_qstr);
+    qstr source_name = lex->source_name;
+    mp_parse_tree_t parse_tree = mp_parse(lex, MP_PARSE_FILE_INPUT);
+    mp_compile_to_raw_code(&parse_tree, source_name, false, cm);
+}
+
+static void mp_flipper_vstr_print_strn(void* data, const char* str, size_t length) {
+    vstr_add_strn(data, str, length);
+}
+
+static bool mp_flipper_save_raw_code(
+    const char* py_file_path,
+    const char* mpy_file_path,
+    mp_compiled_module_t* cm) {
+    // native code would need relocation and qstr link info saved as well, never cache it
+    if(cm->has_native) {
+        mp_flipper_import_cache_remove(mpy_file_path);
+
+        return false;
+    }
+
+    vstr_t vstr;
+    vstr_init(&vstr, 256);
+
+    mp_print_t print = {&vstr, mp_flipper_vstr_print_strn};
+    mp_raw_code_save(cm, &print);
+
+    bool saved = mp_flipper_import_cache_save(py_file_path, mpy_file_path, vstr.buf, vstr.len);
+
+    vstr_clear(&vstr);
+
+    return saved;
+}
+
+static mp_compiled_module_t mp_flipper_compiled_module_new() {
+    mp_compiled_module_t cm;
+
+    cm.context = m_new_obj(mp_module_context_t);
+    cm.context->module.globals = mp_globals_get();
+
+    return cm;
+}
+
+// Turns "foo.py" into "foo.mpy", false if the path is no python source or too long.
+static bool mp_flipper_mpy_path(const char* py_file_path, vstr_t* mpy_path) {
+    size_t length = strlen(py_file_path);
+
+    if(length < 3 || strcmp(py_file_path + length - 3, ".py") != 0) {
+        return false;
+    }
+
+    if(length + 2 > mpy_path->alloc) {
+        return false;
+    }
+
+    vstr_add_strn(mpy_path, py_file_path, length);
+    vstr_ins_byte(mpy_path, mpy_path->len - 2, 'm');
+    vstr_null_terminated_str(mpy_path);
+
+    return true;
+}
+
+bool mp_flipper_import_cache_hit(const char* py_file_path) {
+    VSTR_FIXED(mpy_path, MICROPY_ALLOC_PATH_MAX);
+
+    if(!mp_flipper_mpy_path(py_file_path, &mpy_path)) {
+        return false;
+    }
+
+    return mp_flipper_import_cache_is_fresh(py_file_path, mpy_path.buf);
+}
+
+void mp_flipper_compile_cached(const char* py_file_path, mp_compiled_module_t* cm) {
+    VSTR_FIXED(mpy_path, MICROPY_ALLOC_PATH_MAX);
+
+    // syntax errors propagate, just like they would from the regular import
+    mp_flipper_compile_file(qstr_from_str(py_file_path), cm);
+
+    if(!mp_flipper_mpy_path(py_file_path, &mpy_path)) {
+        return;
+    }
+
+    nlr_buf_t nlr;
+
+    // the module is compiled already, a failed save only costs the cache
+    if(nlr_push(&nlr) == 0) {
+        mp_flipper_save_raw_code(py_file_path, mpy_path.buf, cm);
+
+        nlr_pop();
+    }
+}
+
+// Loads plain .mpy files as well as caches, the cache header is skipped.
+static void mp_flipper_load_mpy(const char* mpy_file_path, mp_compiled_module_t* cm) {
+    bool is_cache = mp_flipper_import_cache_is_cache(mpy_file_path);
+
+    mp_reader_t reader;
+    mp_reader_new_file(&reader, qstr_from_str(mpy_file_path));
+
+    if(is_cache) {
+        for(size_t i = 0; i < sizeof(mp_flipper_import_cache_header_t); i++) {
+            reader.readbyte(reader.data);
+        }
+    }
+
+    // closes the reader
+    mp_raw_code_load(&reader, cm);
+}
+
+void mp_flipper_import_mpy(const char* mpy_file_path, mp_compiled_module_t* cm) {
+    nlr_buf_t nlr;
+
+    if(nlr_push(&nlr) == 0) {
+        mp_flipper_load_mpy(mpy_file_path, cm);
+
+        nlr_pop();
+
+        return;
+    }
+
+    // an .mpy next to its source is always a cache, drop it if it can't be loaded
+    VSTR_FIXED(py_path, MICROPY_ALLOC_PATH_MAX);
+    vstr_add_str(&py_path, mpy_file_path);
+    vstr_cut_out_bytes(&py_path, py_path.len - 3, 1);
+
+    if(mp_flipper_import_stat(vstr_null_terminated_str(&py_path)) != MP_FLIPPER_IMPORT_STAT_FILE) {
+        nlr_jump(nlr.ret_val);
+    }
+
+    mp_flipper_import_cache_remove(mpy_file_path);
+    mp_flipper_compile_cached(py_path.buf, cm);
+}
+
+// Loads the up to date .mpy or compiles the source and refreshes the cache.
+static void mp_flipper_load_cached(const char* py_file_path, mp_compiled_module_t* cm) {
+    VSTR_FIXED(mpy_path, MICROPY_ALLOC_PATH_MAX);
+
+    if(mp_flipper_mpy_path(py_file_path, &mpy_path) &&
+       mp_flipper_import_cache_is_fresh(py_file_path, mpy_path.buf)) {
+        nlr_buf_t nlr;
+
+        if(nlr_push(&nlr) == 0) {
+            mp_flipper_load_mpy(mpy_path.buf, cm);
+
+            nlr_pop();
+
+            return;
+        }
+
+        // incompatible or broken cache file, drop it and fall back to the source
+        mp_flipper_import_cache_remove(mpy_path.buf);
+    }
+
+    mp_flipper_compile_cached(py_file_path, cm);
+}
+
 void mp_flipper_exec_py_file(const char* file_path) {
     nlr_buf_t nlr;
 
@@ -41,11 +199,15 @@ void mp_flipper_exec_py_file(const char* file_path) {
                 break;
             }
 
-            // Compile, parse and execute the given file
-            mp_lexer_t* lex = mp_lexer_new_from_file(qstr_from_str(file_path));
-            mp_store_global(MP_QSTR___file__, MP_OBJ_NEW_QSTR(lex->source_name));
-            mp_parse_tree_t parse_tree = mp_parse(lex, MP_PARSE_FILE_INPUT);
-            mp_obj_t module_fun = mp_compile(&parse_tree, lex->source_name, false);
+            // Load cached bytecode or compile the given file, then execute it
+            qstr file_qstr = qstr_from_str(file_path);
+            mp_store_global(MP_QSTR___file__, MP_OBJ_NEW_QSTR(file_qstr));
+
+            mp_compiled_module_t cm = mp_flipper_compiled_module_new();
+
+            mp_flipper_load_cached(file_path, &cm);
+
+            mp_obj_t module_fun = mp_make_function_from_proto_fun(cm.rc, cm.context, NULL);
             mp_call_function_0(module_fun);
         } while(false);
 
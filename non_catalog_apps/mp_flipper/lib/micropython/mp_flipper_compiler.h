@@ -1,9 +1,18 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdbool.h>
 
 #include "mp_flipper_runtime.h"
 
 void mp_flipper_exec_str(const char* str);
 void mp_flipper_exec_py_file(const char* file_path);
-void mp_flipper_compile_and_save_file(const char* py_file_path, const char* mpy_file_path);
+
+struct _mp_compiled_module_t;
+
+// True if the source has an .mpy next to it compiled from this very source.
+bool mp_flipper_import_cache_hit(const char* py_file_path);
+// Compiles the source once and refreshes its .mpy, used by the importer.
+void mp_flipper_compile_cached(const char* py_file_path, struct _mp_compiled_module_t* cm);
+// Loads an .mpy found by the importer, a cache that fails to load is dropped for its source.
+void mp_flipper_import_mpy(const char* mpy_file_path, struct _mp_compiled_module_t* cm);
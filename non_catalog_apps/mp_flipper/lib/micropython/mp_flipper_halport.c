@@ -8,6 +8,7 @@
 
 #include "mp_flipper_halport.h"
 #include "mp_flipper_fileio.h"
+#include "mp_flipper_compiler.h"
 
 void mp_hal_stdout_tx_str(const char* str) {
     mp_flipper_stdout_tx_str(str);
@@ -18,6 +19,13 @@ void mp_hal_stdout_tx_strn_cooked(const char* str, size_t len) {
 }
 
 mp_import_stat_t mp_import_stat(const char* path) {
+#if MICROPY_PERSISTENT_CODE_LOAD
+    // hide sources with an up to date .mpy, so the importer loads the bytecode instead
+    if(mp_flipper_import_cache_hit(path)) {
+        return MP_IMPORT_STAT_NO_EXIST;
+    }
+#endif
+
     mp_flipper_import_stat_t stat = mp_flipper_import_stat(path);
 
     if(stat == MP_FLIPPER_IMPORT_STAT_FILE) {
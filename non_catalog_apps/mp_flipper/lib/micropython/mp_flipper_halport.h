@@ -1,5 +1,8 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include "mpconfigport.h"
 
 // Define so there's no dependency on extmod/virtpin.h
@@ -14,6 +17,24 @@ typedef enum {
 void mp_flipper_stdout_tx_str(const char* str);
 void mp_flipper_stdout_tx_strn_cooked(const char* str, size_t len);
 
+// "MPFC", cached .mpy files start with this header, the bytecode follows it
+#define MP_FLIPPER_IMPORT_CACHE_MAGIC (0x4346504DUL)
+
+typedef struct {
+    uint32_t magic;
+    // the source the bytecode was compiled from, FAT timestamps alone are too coarse
+    uint32_t source_size;
+    uint32_t source_timestamp;
+} mp_flipper_import_cache_header_t;
+
 mp_flipper_import_stat_t mp_flipper_import_stat(const char* path);
+bool mp_flipper_import_cache_is_cache(const char* mpy_path);
+bool mp_flipper_import_cache_is_fresh(const char* py_path, const char* mpy_path);
+bool mp_flipper_import_cache_save(
+    const char* py_path,
+    const char* mpy_path,
+    const char* data,
+    size_t size);
+void mp_flipper_import_cache_remove(const char* mpy_path);
 
 size_t mp_flipper_gc_get_max_new_split();
@@ -385,6 +385,43 @@ static mp_obj_t flipperzero_canvas_clear() {
 }
 static MP_DEFINE_CONST_FUN_OBJ_0(flipperzero_canvas_clear_obj, flipperzero_canvas_clear);
 
+static mp_obj_t flipperzero_canvas_draw_bitmap(size_t n_args, const mp_obj_t* args) {
+    mp_int_t x = mp_obj_get_int(args[0]);
+    mp_int_t y = mp_obj_get_int(args[1]);
+    mp_int_t width = mp_obj_get_int(args[2]);
+    mp_int_t height = mp_obj_get_int(args[3]);
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[4], &bufinfo, MP_BUFFER_READ);
+
+    // the canvas takes 8 bit sizes, larger values would wrap and no longer match the buffer
+    if(width < 0 || height < 0 || width > UINT8_MAX || height > UINT8_MAX) {
+        mp_raise_ValueError(NULL);
+    }
+
+    // rows are padded to full bytes
+    if(bufinfo.len < (size_t)(((width + 7) / 8) * height)) {
+        mp_raise_ValueError(NULL);
+    }
+
+    mp_flipper_canvas_draw_bitmap(x, y, width, height, bufinfo.buf);
+
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(flipperzero_canvas_draw_bitmap_obj, 5, 5, flipperzero_canvas_draw_bitmap);
+
+static mp_obj_t flipperzero_canvas_draw_commands(mp_obj_t commands_obj) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(commands_obj, &bufinfo, MP_BUFFER_READ);
+
+    if(!mp_flipper_canvas_draw_commands(bufinfo.buf, bufinfo.len)) {
+        mp_raise_ValueError(NULL);
+    }
+
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(flipperzero_canvas_draw_commands_obj, flipperzero_canvas_draw_commands);
+
 static void* mp_flipper_on_input_callback = NULL;
 
 static mp_obj_t flipperzero_on_input(mp_obj_t callback_obj) {
@@ -910,6 +947,16 @@ for octave in range(9):
     {MP_ROM_QSTR(MP_QSTR_canvas_set_text_align), MP_ROM_PTR(&flipperzero_canvas_set_text_align_obj)},
     {MP_ROM_QSTR(MP_QSTR_canvas_update), MP_ROM_PTR(&flipperzero_canvas_update_obj)},
     {MP_ROM_QSTR(MP_QSTR_canvas_clear), MP_ROM_PTR(&flipperzero_canvas_clear_obj)},
+    {MP_ROM_QSTR(MP_QSTR_canvas_draw_bitmap), MP_ROM_PTR(&flipperzero_canvas_draw_bitmap_obj)},
+    {MP_ROM_QSTR(MP_QSTR_CANVAS_CMD_DOT), MP_ROM_INT(MP_FLIPPER_CANVAS_CMD_DOT)},
+    {MP_ROM_QSTR(MP_QSTR_CANVAS_CMD_BOX), MP_ROM_INT(MP_FLIPPER_CANVAS_CMD_BOX)},
+    {MP_ROM_QSTR(MP_QSTR_CANVAS_CMD_FRAME), MP_ROM_INT(MP_FLIPPER_CANVAS_CMD_FRAME)},
+    {MP_ROM_QSTR(MP_QSTR_CANVAS_CMD_LINE), MP_ROM_INT(MP_FLIPPER_CANVAS_CMD_LINE)},
+    {MP_ROM_QSTR(MP_QSTR_CANVAS_CMD_CIRCLE), MP_ROM_INT(MP_FLIPPER_CANVAS_CMD_CIRCLE)},
+    {MP_ROM_QSTR(MP_QSTR_CANVAS_CMD_DISC), MP_ROM_INT(MP_FLIPPER_CANVAS_CMD_DISC)},
+    {MP_ROM_QSTR(MP_QSTR_CANVAS_CMD_COLOR), MP_ROM_INT(MP_FLIPPER_CANVAS_CMD_COLOR)},
+    {MP_ROM_QSTR(MP_QSTR_CANVAS_CMD_CLEAR), MP_ROM_INT(MP_FLIPPER_CANVAS_CMD_CLEAR)},
+    {MP_ROM_QSTR(MP_QSTR_canvas_draw_commands), MP_ROM_PTR(&flipperzero_canvas_draw_commands_obj)},
     // input
     {MP_ROM_QSTR(MP_QSTR_on_input), MP_ROM_PTR(&flipperzero_on_input_obj)},
     {MP_ROM_QSTR(MP_QSTR__input_trigger_handler), MP_ROM_PTR(&flipperzero_input_trigger_handler_obj)},
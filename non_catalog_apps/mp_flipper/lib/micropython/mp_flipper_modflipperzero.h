@@ -35,6 +35,16 @@
 #define MP_FLIPPER_FONT_PRIMARY (1 << 0)
 #define MP_FLIPPER_FONT_SECONDARY (1 << 1)
 
+// opcodes of the packed canvas command list, each followed by its byte arguments
+#define MP_FLIPPER_CANVAS_CMD_DOT (1) // x, y
+#define MP_FLIPPER_CANVAS_CMD_BOX (2) // x, y, w, h, r
+#define MP_FLIPPER_CANVAS_CMD_FRAME (3) // x, y, w, h, r
+#define MP_FLIPPER_CANVAS_CMD_LINE (4) // x0, y0, x1, y1
+#define MP_FLIPPER_CANVAS_CMD_CIRCLE (5) // x, y, r
+#define MP_FLIPPER_CANVAS_CMD_DISC (6) // x, y, r
+#define MP_FLIPPER_CANVAS_CMD_COLOR (7) // color
+#define MP_FLIPPER_CANVAS_CMD_CLEAR (8)
+
 void mp_flipper_light_set(uint8_t raw_light, uint8_t brightness);
 void mp_flipper_light_blink_start(uint8_t raw_light, uint8_t brightness, uint16_t on_time, uint16_t period);
 void mp_flipper_light_blink_set_color(uint8_t raw_light);
@@ -193,6 +203,8 @@ void mp_flipper_canvas_set_text(uint8_t x, uint8_t y, const char* text);
 void mp_flipper_canvas_set_text_align(uint8_t x, uint8_t y);
 void mp_flipper_canvas_update();
 void mp_flipper_canvas_clear();
+void mp_flipper_canvas_draw_bitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t* data);
+bool mp_flipper_canvas_draw_commands(const uint8_t* data, size_t length);
 
 void mp_flipper_on_input(uint16_t button, uint16_t type);
 
@@ -44,6 +44,39 @@ void nlr_jump_fail(void* val) {
     mp_flipper_nlr_jump_fail(val);
 }
 
+#if MICROPY_EMIT_MACHINE_CODE
+// Makes native code emitted into the GC heap executable.
+void* mp_flipper_commit_exec(void* buf, size_t size, void* reloc) {
+    (void)size;
+
+    if(reloc) {
+        // Functions may start inside the buffer, keep it reachable for the GC.
+        if(MP_STATE_VM(track_reloc_code_list) == MP_OBJ_NULL) {
+            MP_STATE_VM(track_reloc_code_list) = mp_obj_new_list(0, NULL);
+        }
+        mp_obj_list_append(MP_STATE_VM(track_reloc_code_list), MP_OBJ_FROM_PTR(buf));
+
+        mp_native_relocate(reloc, buf, (uintptr_t)buf);
+    }
+
+#if defined(__ARM_ARCH)
+    // The code was written through the data bus, make sure the stores completed
+    // and no stale instructions are prefetched before it gets called.
+    __asm volatile("dsb\n"
+                   "isb\n" ::
+                       : "memory");
+#endif
+
+    return buf;
+}
+
+void(mp_raise_msg)(const mp_obj_type_t* exc_type, mp_rom_error_text_t msg) {
+    (void)msg;
+
+    mp_raise_type(exc_type);
+}
+#endif
+
 #if MICROPY_ENABLE_GC
 // Run a garbage collection cycle.
 void gc_collect(void) {
@@ -5,6 +5,7 @@
 #include <alloca.h>
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 
 // Type definitions for the specific machine
@@ -25,12 +26,24 @@ typedef long mp_off_t;
 
 #define MICROPY_CONFIG_ROM_LEVEL (MICROPY_CONFIG_ROM_LEVEL_CORE_FEATURES)
 
-#define MICROPY_EMIT_THUMB_ARMV7M (0)
-#define MICROPY_EMIT_INLINE_THUMB_FLOAT (0)
+// Native code for @micropython.native, @micropython.viper and @micropython.asm_thumb
+#define MICROPY_EMIT_THUMB (1)
+#define MICROPY_EMIT_THUMB_ARMV7M (1)
+#define MICROPY_EMIT_INLINE_THUMB (1)
+#define MICROPY_EMIT_INLINE_THUMB_FLOAT (1)
 
-#define MICROPY_PERSISTENT_CODE_LOAD (0)
-#define MICROPY_PERSISTENT_CODE_SAVE (0)
+// Machine code is placed on the GC heap, see mp_flipper_runtime.c
+#define MICROPY_MAKE_POINTER_CALLABLE(p) ((void*)((mp_uint_t)(p) | 1))
+#define MP_PLAT_COMMIT_EXEC(buf, size, reloc) mp_flipper_commit_exec(buf, size, reloc)
+#define MICROPY_PERSISTENT_CODE_TRACK_RELOC_CODE (1)
+
+void* mp_flipper_commit_exec(void* buf, size_t size, void* reloc);
+
+// Scripts and imports are cached as .mpy next to the source, see mp_flipper_compiler.c
+#define MICROPY_PERSISTENT_CODE_LOAD (1)
+#define MICROPY_PERSISTENT_CODE_SAVE (1)
 #define MICROPY_PERSISTENT_CODE_SAVE_FILE (0)
+#define MICROPY_FLIPPER_IMPORT_CACHE (1)
 
 #define MICROPY_ENABLE_COMPILER (1)
 #define MICROPY_ENABLE_GC (1)
@@ -43,6 +56,11 @@ typedef long mp_off_t;
 
 #define MICROPY_ERROR_REPORTING (MICROPY_ERROR_REPORTING_NONE)
 
+// The native function table needs mp_raise_msg as a function, it's only a macro with
+// this error reporting level, see mp_flipper_runtime.c
+struct _mp_obj_type_t;
+void(mp_raise_msg)(const struct _mp_obj_type_t* exc_type, const char* msg);
+
 #define MICROPY_GC_STACK_ENTRY_TYPE uint32_t
 
 #define MICROPY_PY___FILE__ (1)
@@ -101,7 +119,7 @@ typedef long mp_off_t;
 #define MICROPY_PY_BUILTINS_STR_OP_MODULO (1)
 #define MICROPY_PY_BUILTINS_STR_PARTITION (0)
 #define MICROPY_PY_BUILTINS_STR_SPLITLINES (0)
-#define MICROPY_PY_BUILTINS_BYTEARRAY (0)
+#define MICROPY_PY_BUILTINS_BYTEARRAY (1)
 #define MICROPY_PY_BUILTINS_DICT_FROMKEYS (0)
 #define MICROPY_PY_BUILTINS_MEMORYVIEW (0)
 #define MICROPY_PY_BUILTINS_SET (1)
@@ -37,6 +37,10 @@
 #include "py/builtin.h"
 #include "py/frozenmod.h"
 
+#if MICROPY_FLIPPER_IMPORT_CACHE
+#include "mp_flipper_compiler.h"
+#endif
+
 #if MICROPY_DEBUG_VERBOSE // print debugging info
 #define DEBUG_PRINT (1)
 #define DEBUG_printf DEBUG_printf
@@ -246,14 +250,28 @@ static void do_load(mp_module_context_t *module_obj, vstr_t *file) {
     if (file_str[file->len - 3] == 'm') {
         mp_compiled_module_t cm;
         cm.context = module_obj;
+        #if MICROPY_FLIPPER_IMPORT_CACHE
+        mp_flipper_import_mpy(file_str, &cm);
+        #else
         mp_raw_code_load_file(file_qstr, &cm);
+        #endif
         do_execute_proto_fun(cm.context, cm.rc, file_qstr);
         return;
     }
     #endif
 
+    // Compile the source once and refresh its .mpy, stale or missing caches end up here.
+    #if MICROPY_FLIPPER_IMPORT_CACHE
+    {
+        mp_compiled_module_t cm;
+        cm.context = module_obj;
+        mp_flipper_compile_cached(file_str, &cm);
+        do_execute_proto_fun(cm.context, cm.rc, file_qstr);
+        return;
+    }
+
     // If we can compile scripts then load the file and compile and execute it.
-    #if MICROPY_ENABLE_COMPILER
+    #elif MICROPY_ENABLE_COMPILER
     {
         mp_lexer_t *lex = mp_lexer_new_from_file(file_qstr);
         do_load_from_lexer(module_obj, lex);
@@ -194,9 +194,14 @@ uint8_t nrf24_rxpacket(FuriHalSpiBusHandle* handle, uint8_t* packet, uint8_t* re
     uint8_t status = 0;
     uint8_t buf[33]; // 32 max payload size + 1 for command
 
-    status = nrf24_status(handle);
+    // STATUS is clocked out with the first byte of any command, FIFO_STATUS comes with it
+    buf[0] = R_REGISTER | (REGISTER_MASK & REG_FIFO_STATUS);
+    buf[1] = 0;
+    nrf24_spi_trx(handle, buf, buf, 2);
+    status = buf[0];
+    uint8_t st = buf[1];
+    bool clear_rx_dr = status & RX_DR;
     if(!(status & RX_DR)) {
-        uint8_t st = nrf24_read_register(handle, REG_FIFO_STATUS);
         if(st == 0xFF || st == 0) return 0x80; // hardware error
         if((st & 1) == 0) {
             FURI_LOG_D("NRF", "FIFO PKT");
@@ -217,7 +222,8 @@ uint8_t nrf24_rxpacket(FuriHalSpiBusHandle* handle, uint8_t* packet, uint8_t* re
         buf[0] = R_RX_PAYLOAD;
         nrf24_spi_trx(handle, buf, buf, packet_size + 1);
         memcpy(packet, &buf[1], packet_size);
-        nrf24_write_reg(handle, REG_STATUS, RX_DR); // clear RX_DR
+        // Packets left in FIFO are found by FIFO_STATUS, RX_DR is cleared only once
+        if(clear_rx_dr) nrf24_write_reg(handle, REG_STATUS, RX_DR); // clear RX_DR
     }
     if(status & (MAX_RT)) { // MAX_RT
         nrf24_write_reg(handle, REG_STATUS, (MAX_RT)); // clear MAX_RT.
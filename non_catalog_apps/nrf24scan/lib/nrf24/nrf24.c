@@ -195,12 +195,12 @@ uint8_t nrf24_rxpacket(FuriHalSpiBusHandle* handle, uint8_t* packet, uint8_t* re
     uint8_t tx_cmd[33] = {0}; // 32 max payload size + 1 for command
     uint8_t tmp_packet[33] = {0};
 
-    status = nrf24_status(handle);
-    if(!(status & RX_DR)) {
-        tx_cmd[0] = R_REGISTER | (REGISTER_MASK & REG_FIFO_STATUS);
-        nrf24_spi_trx(handle, tx_cmd, tmp_packet, 2, nrf24_TIMEOUT);
-        if((tmp_packet[1] & 1) == 0) status |= RX_DR; // packet in FIFO buffer
-    }
+    // STATUS is clocked out with the first byte of any command, FIFO_STATUS comes with it
+    tx_cmd[0] = R_REGISTER | (REGISTER_MASK & REG_FIFO_STATUS);
+    nrf24_spi_trx(handle, tx_cmd, tmp_packet, 2, nrf24_TIMEOUT);
+    status = tmp_packet[0];
+    bool clear_rx_dr = status & RX_DR;
+    if((tmp_packet[1] & 1) == 0) status |= RX_DR; // packet in FIFO buffer
     if(status & RX_DR) {
         if(packet_size == 1)
             packet_size = nrf24_get_packetlen(handle, (status >> 1) & 7);
@@ -213,7 +213,8 @@ uint8_t nrf24_rxpacket(FuriHalSpiBusHandle* handle, uint8_t* packet, uint8_t* re
         tx_cmd[0] = R_RX_PAYLOAD; tx_cmd[1] = 0;
         nrf24_spi_trx(handle, tx_cmd, tmp_packet, packet_size + 1, nrf24_TIMEOUT);
         memcpy(packet, &tmp_packet[1], packet_size);
-        nrf24_write_reg(handle, REG_STATUS, RX_DR); // clear RX_DR
+        // Packets left in FIFO are found by FIFO_STATUS, RX_DR is cleared only once
+        if(clear_rx_dr) nrf24_write_reg(handle, REG_STATUS, RX_DR); // clear RX_DR
     } else if(status & (TX_DS | MAX_RT)) { // MAX_RT, TX_DS
         nrf24_write_reg(handle, REG_STATUS, (TX_DS | MAX_RT)); // clear RX_DR, MAX_RT.
     }
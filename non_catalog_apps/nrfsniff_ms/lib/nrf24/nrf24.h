@@ -35,15 +35,31 @@ extern "C" {
 #define REG_TX_ADDR 0x10
 
 #define RX_PW_P0 0x11
+#define RX_DR 0x40
 #define TX_DS 0x20
 #define MAX_RT 0x10
+#define RX_P_NO 0x0E
+
+#define NRF24_MAX_PAYLOAD 32
+#define NRF24_RX_FIFO_SIZE 3
+#define nrf24_rx_fifo_empty(status) (((status)&RX_P_NO) == RX_P_NO)
 
 #define nrf24_TIMEOUT 500
 #define nrf24_CE_PIN &gpio_ext_pb2
 #define nrf24_HANDLE &furi_hal_spi_bus_handle_external
 
+/** SPI transfer of one command, chip select is held for the whole transfer */
+typedef void (
+    *nrf24_spi_backend)(FuriHalSpiBusHandle* handle, uint8_t* tx, uint8_t* rx, uint8_t size);
+
 /* Low level API */
 
+/** Replace SPI transfers, e.g. with a mock radio to run the driver on host
+ *
+ * @param      backend - transfer function, NULL restores the hardware bus
+ */
+void nrf24_set_spi_backend(nrf24_spi_backend backend);
+
 /** Write device register
  *
  * @param      handle  - pointer to FuriHalSpiHandle
@@ -264,6 +280,21 @@ uint8_t nrf24_set_dst_mac(FuriHalSpiBusHandle* handle, uint8_t* mac, uint8_t siz
 uint8_t
     nrf24_rxpacket(FuriHalSpiBusHandle* handle, uint8_t* packet, uint8_t* packetsize, bool full);
 
+/** Reads all packets waiting in RX FIFO, up to NRF24_RX_FIFO_SIZE
+ *
+ * @param      handle  - pointer to FuriHalSpiHandle
+ * @param[out] packets - NRF24_RX_FIFO_SIZE packet buffers
+ * @param[out] packetsizes - sizes of the received packets
+ * @param      full - boolean set to true, packet length is determined by RX_PW_P0 register, false it is determined by dynamic payload length command
+ * 
+ * @return     number of packets read
+ */
+uint8_t nrf24_rxpackets(
+    FuriHalSpiBusHandle* handle,
+    uint8_t (*packets)[NRF24_MAX_PAYLOAD],
+    uint8_t* packetsizes,
+    bool full);
+
 /** Sends TX packet
  *
  * @param      handle  - pointer to FuriHalSpiHandle
@@ -316,6 +347,19 @@ void nrf24_init_promisc_mode(FuriHalSpiBusHandle* handle, uint8_t channel, uint8
  */
 bool nrf24_sniff_address(FuriHalSpiBusHandle* handle, uint8_t maclen, uint8_t* address);
 
+/** Reads all packets waiting in RX FIFO and returns possible addresses
+ * Call this only after calling nrf24_init_promisc_mode
+ * @param      handle  - pointer to FuriHalSpiHandle
+ * @param      maclen - length of target mac address
+ * @param[out] addresses - NRF24_RX_FIFO_SIZE sniffed addresses
+ * 
+ * @return     number of addresses found
+ */
+uint8_t nrf24_sniff_addresses(
+    FuriHalSpiBusHandle* handle,
+    uint8_t maclen,
+    uint8_t (*addresses)[5]);
+
 /** Sends ping packet on each channel for designated tx mac looking for ack
  * 
  * @param      handle  - pointer to FuriHalSpiHandle
@@ -361,6 +405,13 @@ void int32_to_bytes(uint32_t val, uint8_t* out, bool bigendian);
  */
 uint32_t bytes_to_int32(uint8_t* bytes, bool bigendian);
 
+/** Check if the nrf24 is connected
+ * @param      handle  - pointer to FuriHalSpiHandle
+ * 
+ * @return     true if connected, otherwise false
+*/
+bool nrf24_check_connected(FuriHalSpiBusHandle* handle);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -14,11 +14,16 @@
 #define MICROSOFT_MIN_CHANNEL 49
 #define COUNT_THRESHOLD       2
 #define DEFAULT_SAMPLE_TIME   8000
-#define MAX_ADDRS             100
-#define MAX_CONFIRMED         32
+#define CANDIDATE_SLOTS       256 // power of two
+#define CANDIDATE_MAX_LOAD    192
+#define CONFIRMED_MIN_SLOTS   64
+#define CONFIRMED_KEY_SIZE    6 // address and rate
+#define PROBE_SLICE_CHANNELS  6 // channels pinged per loop pass
+#define CONFIRMED_HITS        16 // channel stats bump for a confirmed device
 
 #define NRFSNIFF_APP_PATH_FOLDER STORAGE_APP_DATA_PATH_PREFIX
 #define NRFSNIFF_APP_FILENAME    "addresses.txt"
+#define NRFSNIFF_APP_PATH        NRFSNIFF_APP_PATH_FOLDER "/" NRFSNIFF_APP_FILENAME
 #define TAG                      "nrfsniff"
 
 typedef enum {
@@ -35,11 +40,37 @@ typedef struct {
     FuriMutex* mutex;
 } PluginState;
 
+typedef struct {
+    uint8_t addr[5];
+    bool used;
+    uint8_t channel; // channel of the last hit
+    uint16_t count;
+    uint32_t seen; // sample period of the last hit
+} Candidate;
+
+typedef struct {
+    uint8_t key[CONFIRMED_KEY_SIZE];
+    bool used;
+} ConfirmedAddr;
+
+typedef struct {
+    bool active;
+    bool configured; // radio is set up for pinging this candidate
+    bool alt; // pinging the alternate form of the address
+    uint8_t sniffed[5]; // address as it was sniffed
+    uint8_t addr[5]; // address being pinged
+    char hex[12];
+    uint8_t channels[LOGITECH_MAX_CHANNEL + 1]; // ping order
+    uint8_t channel_count;
+    uint8_t next; // position in channels
+} Probe;
+
 char rate_text_fmt[] = "Transfer rate: %dMbps";
 char sample_text_fmt[] = "Sample Time: %d ms";
 char channel_text_fmt[] = "Channel: %d    Sniffing: %s";
 char preamble_text_fmt[] = "Preamble: %02X";
 char sniff_text_fmt[] = "Found: %d       Unique: %u";
+char probe_text_fmt[] = "Try %s %d%%";
 char addresses_header_text[] = "Address,rate";
 char sniffed_address_fmt[] = "%s,%d";
 char rate_text[46];
@@ -47,6 +78,7 @@ char channel_text[38];
 char sample_text[32];
 char preamble_text[14];
 char sniff_text[38];
+char probe_text[24];
 char sniffed_address[14];
 
 uint8_t target_channel = 0;
@@ -58,17 +90,36 @@ uint8_t target_preamble[] = {0xAA, 0x00};
 uint8_t sniffing_state = false;
 char top_address[12];
 
-uint8_t candidates[MAX_ADDRS][5] = {0}; // last 100 sniffed addresses
-uint32_t counts[MAX_ADDRS];
-uint8_t confirmed[MAX_CONFIRMED][5] = {0}; // first 32 confirmed addresses
-uint8_t confirmed_idx = 0;
+// candidates are dropped after a full channel sweep without hearing them again
+#define CANDIDATE_MAX_AGE (LOGITECH_MAX_CHANNEL - MICROSOFT_MIN_CHANNEL + 1)
+
+Candidate candidates[CANDIDATE_SLOTS] = {0}; // open addressing, linear probing
 uint32_t total_candidates = 0;
-uint32_t candidate_idx = 0;
+uint32_t sample_period = 0;
+int top_idx = -1;
+ConfirmedAddr* confirmed = NULL; // addresses from file and confirmed this session
+uint32_t confirmed_slots = 0;
+uint32_t confirmed_count = 0;
+Probe probe = {0};
+uint16_t channel_hits[LOGITECH_MAX_CHANNEL + 1]; // halved after every sweep
+
+static uint32_t addr_hash(const uint8_t* data, uint8_t size) {
+    // FNV-1a
+    uint32_t hash = 2166136261UL;
+    for(uint8_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
 
-static int get_addr_index(uint8_t* addr, uint8_t addr_size) {
-    for(uint32_t i = 0; i < total_candidates; i++) {
-        uint8_t* arr_item = candidates[i];
-        if(!memcmp(arr_item, addr, addr_size)) return i;
+static int get_addr_index(uint8_t* addr) {
+    // load is capped below the table size, so there always is an empty slot to stop at
+    uint32_t slot = addr_hash(addr, 5) & (CANDIDATE_SLOTS - 1);
+    while(candidates[slot].used) {
+        if(!memcmp(candidates[slot].addr, addr, 5)) return slot;
+        slot = (slot + 1) & (CANDIDATE_SLOTS - 1);
     }
 
     return -1;
@@ -76,10 +127,10 @@ static int get_addr_index(uint8_t* addr, uint8_t addr_size) {
 
 static int get_highest_idx() {
     uint32_t highest = 0;
-    int highest_idx = 0;
-    for(uint32_t i = 0; i < total_candidates; i++) {
-        if(counts[i] > highest) {
-            highest = counts[i];
+    int highest_idx = -1;
+    for(uint32_t i = 0; i < CANDIDATE_SLOTS; i++) {
+        if(candidates[i].used && candidates[i].count > highest) {
+            highest = candidates[i].count;
             highest_idx = i;
         }
     }
@@ -87,14 +138,183 @@ static int get_highest_idx() {
     return highest_idx;
 }
 
-// if array is full, start over from beginning
-static void insert_addr(uint8_t* addr, uint8_t addr_size) {
-    if(candidate_idx >= MAX_ADDRS) candidate_idx = 0;
+// backward shift deletion, probe chains stay intact without tombstones
+static void remove_addr(uint32_t slot) {
+    uint32_t next = slot;
+    candidates[slot].used = false;
+    while(true) {
+        next = (next + 1) & (CANDIDATE_SLOTS - 1);
+        if(!candidates[next].used) break;
+
+        // entry may fill the hole only if the hole lies between its home slot and itself
+        uint32_t home = addr_hash(candidates[next].addr, 5) & (CANDIDATE_SLOTS - 1);
+        if(((next - home) & (CANDIDATE_SLOTS - 1)) >= ((next - slot) & (CANDIDATE_SLOTS - 1))) {
+            candidates[slot] = candidates[next];
+            candidates[next].used = false;
+            slot = next;
+        }
+    }
+    total_candidates--;
+}
+
+// if table is full, the candidate heard from longest ago makes room
+static int insert_addr(uint8_t* addr) {
+    if(total_candidates >= CANDIDATE_MAX_LOAD) {
+        int stale = -1;
+        for(uint32_t i = 0; i < CANDIDATE_SLOTS; i++) {
+            if(!candidates[i].used) continue;
+            if(stale == -1 || candidates[i].seen < candidates[stale].seen ||
+               (candidates[i].seen == candidates[stale].seen &&
+                candidates[i].count < candidates[stale].count))
+                stale = i;
+        }
+        remove_addr(stale);
+        top_idx = get_highest_idx();
+    }
+
+    uint32_t slot = addr_hash(addr, 5) & (CANDIDATE_SLOTS - 1);
+    while(candidates[slot].used)
+        slot = (slot + 1) & (CANDIDATE_SLOTS - 1);
+
+    memcpy(candidates[slot].addr, addr, 5);
+    candidates[slot].used = true;
+    candidates[slot].count = 1;
+    candidates[slot].seen = sample_period;
+    total_candidates++;
+    return slot;
+}
+
+// returns true when the address became the top candidate
+static bool count_addr(uint8_t* addr) {
+    int idx = get_addr_index(addr);
+    if(idx == -1) {
+        idx = insert_addr(addr);
+    } else {
+        if(candidates[idx].count < UINT16_MAX) candidates[idx].count++;
+        candidates[idx].seen = sample_period;
+    }
+    candidates[idx].channel = target_channel;
+
+    // single hits are mostly noise, repeated ones say where devices live
+    if(candidates[idx].count >= COUNT_THRESHOLD && channel_hits[target_channel] < UINT16_MAX)
+        channel_hits[target_channel]++;
 
-    memcpy(candidates[candidate_idx], addr, addr_size);
-    counts[candidate_idx] = 1;
-    if(total_candidates < MAX_ADDRS) total_candidates++;
-    candidate_idx++;
+    if(top_idx == idx) return false;
+    if(top_idx != -1 && candidates[idx].count <= candidates[top_idx].count) return false;
+
+    top_idx = idx;
+    return true;
+}
+
+static void age_candidates() {
+    sample_period++;
+    for(uint32_t i = 0; i < CANDIDATE_SLOTS;) {
+        if(candidates[i].used && sample_period - candidates[i].seen > CANDIDATE_MAX_AGE) {
+            // slot may be refilled by a shifted entry, check it again
+            remove_addr(i);
+        } else {
+            i++;
+        }
+    }
+
+    top_idx = get_highest_idx();
+}
+
+static void decay_channel_hits() {
+    for(uint8_t ch = 0; ch <= LOGITECH_MAX_CHANNEL; ch++)
+        channel_hits[ch] >>= 1;
+}
+
+static uint8_t target_rate_mbps() {
+    return target_rate == 8 ? 2 : 1;
+}
+
+static uint32_t confirmed_slot(const uint8_t* key) {
+    uint32_t slot = addr_hash(key, CONFIRMED_KEY_SIZE) & (confirmed_slots - 1);
+    while(confirmed[slot].used && memcmp(confirmed[slot].key, key, CONFIRMED_KEY_SIZE))
+        slot = (slot + 1) & (confirmed_slots - 1);
+
+    return slot;
+}
+
+static void confirmed_key(uint8_t* addr, uint8_t rate, uint8_t* key) {
+    memcpy(key, addr, 5);
+    key[5] = rate;
+}
+
+static bool is_confirmed(uint8_t* addr, uint8_t rate) {
+    uint8_t key[CONFIRMED_KEY_SIZE];
+    if(!confirmed_count) return false;
+
+    confirmed_key(addr, rate, key);
+    return confirmed[confirmed_slot(key)].used;
+}
+
+static void add_confirmed(uint8_t* addr, uint8_t rate) {
+    uint8_t key[CONFIRMED_KEY_SIZE];
+
+    // keep the set at most half full, probes stay short
+    if((confirmed_count + 1) * 2 > confirmed_slots) {
+        ConfirmedAddr* old = confirmed;
+        uint32_t old_slots = confirmed_slots;
+        confirmed_slots = old_slots ? old_slots * 2 : CONFIRMED_MIN_SLOTS;
+        confirmed = malloc(confirmed_slots * sizeof(ConfirmedAddr));
+        memset(confirmed, 0, confirmed_slots * sizeof(ConfirmedAddr));
+        for(uint32_t i = 0; i < old_slots; i++) {
+            if(old[i].used) confirmed[confirmed_slot(old[i].key)] = old[i];
+        }
+        free(old);
+    }
+
+    confirmed_key(addr, rate, key);
+    uint32_t slot = confirmed_slot(key);
+    if(confirmed[slot].used) return;
+
+    memcpy(confirmed[slot].key, key, CONFIRMED_KEY_SIZE);
+    confirmed[slot].used = true;
+    confirmed_count++;
+}
+
+static int8_t hex_nibble(char c) {
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// lines are "0123456789,2", anything else is skipped
+static bool parse_addr_line(const char* line, uint8_t* addr, uint8_t* rate) {
+    for(int i = 0; i < 5; i++) {
+        int8_t hi = hex_nibble(line[i * 2]);
+        if(hi < 0) return false;
+        int8_t lo = hex_nibble(line[i * 2 + 1]);
+        if(lo < 0) return false;
+        addr[i] = (hi << 4) | lo;
+    }
+    if(line[10] != ',' || line[11] < '1' || line[11] > '2') return false;
+
+    *rate = line[11] - '0';
+    return true;
+}
+
+// read saved addresses once, later saves only append
+static void load_confirmed(Storage* storage) {
+    Stream* stream = file_stream_alloc(storage);
+    FuriString* line = furi_string_alloc();
+    uint8_t addr[5];
+    uint8_t rate;
+
+    if(file_stream_open(stream, NRFSNIFF_APP_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        while(stream_read_line(stream, line)) {
+            if(furi_string_size(line) < 12) continue;
+            if(parse_addr_line(furi_string_get_cstr(line), addr, &rate))
+                add_confirmed(addr, rate);
+        }
+    }
+    FURI_LOG_I(TAG, "%lu saved addresses", confirmed_count);
+
+    furi_string_free(line);
+    stream_free(stream);
 }
 
 static void render_callback(Canvas* const canvas, void* ctx) {
@@ -125,7 +345,19 @@ static void render_callback(Canvas* const canvas, void* ctx) {
     canvas_draw_str_aligned(canvas, 10, 30, AlignLeft, AlignBottom, channel_text);
     //canvas_draw_str_aligned(canvas, 10, 30, AlignLeft, AlignBottom, preamble_text);
     canvas_draw_str_aligned(canvas, 10, 40, AlignLeft, AlignBottom, sniff_text);
-    canvas_draw_str_aligned(canvas, 30, 50, AlignLeft, AlignBottom, addresses_header_text);
+    if(probe.active) {
+        // both forms of the address are pinged on every channel
+        int done = probe.next + (probe.alt ? probe.channel_count : 0);
+        snprintf(
+            probe_text,
+            sizeof(probe_text),
+            probe_text_fmt,
+            probe.hex,
+            done * 100 / (probe.channel_count * 2));
+        canvas_draw_str_aligned(canvas, 10, 50, AlignLeft, AlignBottom, probe_text);
+    } else {
+        canvas_draw_str_aligned(canvas, 30, 50, AlignLeft, AlignBottom, addresses_header_text);
+    }
     canvas_draw_str_aligned(canvas, 30, 60, AlignLeft, AlignBottom, sniffed_address);
 
     furi_mutex_release(plugin_state->mutex);
@@ -150,72 +382,42 @@ static bool save_addr_to_file(
     uint8_t* data,
     uint8_t size,
     NotificationApp* notification) {
-    size_t file_size = 0;
     uint8_t linesize = 0;
-    char filepath[42] = {0};
     char addrline[14] = {0};
     char ending[4];
-    uint8_t* file_contents;
-    uint8_t rate = 1;
-    Stream* stream = file_stream_alloc(storage);
+    uint8_t rate = target_rate_mbps();
+
+    if(is_confirmed(data, rate)) {
+        FURI_LOG_I(TAG, "Address exists in file. Ending save process.");
+        return false;
+    }
 
-    if(target_rate == 8) rate = 2;
     snprintf(ending, sizeof(ending), ",%d\n", rate);
     hexlify(data, size, addrline);
     nrf_strcat(addrline, ending);
     linesize = strlen(addrline);
-    strcpy(filepath, NRFSNIFF_APP_PATH_FOLDER);
-    nrf_strcat(filepath, "/");
-    nrf_strcat(filepath, NRFSNIFF_APP_FILENAME);
-    stream_seek(stream, 0, StreamOffsetFromStart);
-
-    // check if address already exists in file
-    if(file_stream_open(stream, filepath, FSAM_READ_WRITE, FSOM_OPEN_APPEND)) {
-        bool found = false;
-        file_size = stream_size(stream);
-        stream_seek(stream, 0, StreamOffsetFromStart);
-        if(file_size > 0) {
-            file_contents = malloc(file_size + 1);
-            memset(file_contents, 0, file_size + 1);
-            if(stream_read(stream, file_contents, file_size) > 0) {
-                char* line = nrf_strtok((char*)file_contents, "\n");
-
-                while(line != NULL) {
-                    if(!memcmp(line, addrline, 12)) {
-                        found = true;
-                        break;
-                    }
-                    line = nrf_strtok(NULL, "\n");
-                }
-            }
-            free(file_contents);
-        }
 
-        if(found) {
-            FURI_LOG_I(TAG, "Address exists in file. Ending save process.");
-            stream_free(stream);
-            return false;
-        } else {
-            if(stream_write(stream, (uint8_t*)addrline, linesize) != linesize) {
-                FURI_LOG_I(TAG, "Failed to write bytes to file stream.");
-                stream_free(stream);
-                return false;
-            } else {
-                FURI_LOG_I(TAG, "Found a new address: %s", addrline);
-                FURI_LOG_I(TAG, "Save successful!");
-
-                notification_message(notification, &sequence_success);
-
-                stream_free(stream);
-                unique_saved_count++;
-                return true;
-            }
-        }
-    } else {
-        FURI_LOG_I(TAG, "Cannot open file \"%s\"", filepath);
+    Stream* stream = file_stream_alloc(storage);
+    if(!file_stream_open(stream, NRFSNIFF_APP_PATH, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+        FURI_LOG_I(TAG, "Cannot open file \"%s\"", NRFSNIFF_APP_PATH);
+        stream_free(stream);
+        return false;
+    }
+
+    if(stream_write(stream, (uint8_t*)addrline, linesize) != linesize) {
+        FURI_LOG_I(TAG, "Failed to write bytes to file stream.");
         stream_free(stream);
         return false;
     }
+
+    FURI_LOG_I(TAG, "Found a new address: %s", addrline);
+    FURI_LOG_I(TAG, "Save successful!");
+
+    notification_message(notification, &sequence_success);
+
+    stream_free(stream);
+    unique_saved_count++;
+    return true;
 }
 
 void alt_address(uint8_t* addr, uint8_t* altaddr) {
@@ -250,79 +452,126 @@ void alt_address(uint8_t* addr, uint8_t* altaddr) {
 }
 
 static bool previously_confirmed(uint8_t* addr) {
-    bool found = false;
-    for(int i = 0; i < MAX_CONFIRMED; i++) {
-        if(!memcmp(confirmed[i], addr, 5)) {
-            found = true;
-            break;
+    return is_confirmed(addr, target_rate_mbps());
+}
+
+// candidate's own channel first, then the ones devices were heard on lately
+static void probe_order_channels(uint8_t heard_on) {
+    probe.channel_count = 0;
+    probe.channels[probe.channel_count++] = heard_on;
+    for(uint8_t ch = MICROSOFT_MIN_CHANNEL; ch <= LOGITECH_MAX_CHANNEL; ch++) {
+        if(ch == heard_on) continue;
+
+        uint8_t pos = probe.channel_count++;
+        while(pos > 1 && channel_hits[probe.channels[pos - 1]] < channel_hits[ch]) {
+            probe.channels[pos] = probe.channels[pos - 1];
+            pos--;
         }
+        probe.channels[pos] = ch;
     }
+}
 
-    return found;
+// highest count goes first
+static bool probe_next() {
+    int idx = get_highest_idx();
+    if(idx == -1 || candidates[idx].count < COUNT_THRESHOLD) return false;
+
+    candidates[idx].count = 0;
+    memcpy(probe.sniffed, candidates[idx].addr, 5);
+    memcpy(probe.addr, candidates[idx].addr, 5);
+    hexlify(probe.addr, 5, probe.hex);
+    probe_order_channels(candidates[idx].channel);
+    probe.alt = false;
+    probe.next = 0;
+    probe.configured = false;
+    probe.active = true;
+    top_idx = get_highest_idx();
+    FURI_LOG_I(TAG, "trying address %s", probe.hex);
+    return true;
 }
 
-static void wrap_up(Storage* storage, NotificationApp* notification) {
-    uint8_t ch;
-    uint8_t addr[5];
-    uint8_t altaddr[5];
-    char trying[12];
-    int idx;
-    uint8_t rate = 0;
-    if(target_rate == 8) rate = 2;
+static void probe_confirmed(Storage* storage, NotificationApp* notification, uint8_t ch) {
+    FURI_LOG_I(TAG, "%s answered on channel %d", probe.hex, (int)ch);
+    hexlify(probe.addr, 5, top_address);
+    found_count++;
+    save_addr_to_file(storage, probe.addr, 5, notification);
+    add_confirmed(probe.addr, target_rate_mbps());
+    // sniffed form of an alternate address is not probed again either
+    add_confirmed(probe.sniffed, target_rate_mbps());
+
+    int idx = get_addr_index(probe.sniffed);
+    if(idx != -1) {
+        remove_addr(idx);
+        top_idx = get_highest_idx();
+    }
 
-    nrf24_set_idle(nrf24_HANDLE);
+    channel_hits[ch] = MIN(channel_hits[ch] + CONFIRMED_HITS, UINT16_MAX);
+    probe.active = false;
+}
 
-    while(true) {
-        idx = get_highest_idx();
-        if(counts[idx] < COUNT_THRESHOLD) break;
-
-        counts[idx] = 0;
-        memcpy(addr, candidates[idx], 5);
-        hexlify(addr, 5, trying);
-        FURI_LOG_I(TAG, "trying address %s", trying);
-        //ch = nrf24_find_channel(nrf24_HANDLE, addr, addr, 5, rate, 2, LOGITECH_MAX_CHANNEL, false);
-        ch = nrf24_find_channel(
-            nrf24_HANDLE, addr, addr, 5, rate, MICROSOFT_MIN_CHANNEL, LOGITECH_MAX_CHANNEL, false);
-        FURI_LOG_I(TAG, "find_channel returned %d", (int)ch);
-        if(ch > LOGITECH_MAX_CHANNEL) {
-            alt_address(addr, altaddr);
-            hexlify(altaddr, 5, trying);
-            FURI_LOG_I(TAG, "trying alternate address %s", trying);
-            ch = nrf24_find_channel(
-                //nrf24_HANDLE, altaddr, altaddr, 5, rate, 2, LOGITECH_MAX_CHANNEL, false);
-                nrf24_HANDLE,
-                altaddr,
-                altaddr,
-                5,
-                rate,
-                MICROSOFT_MIN_CHANNEL,
-                LOGITECH_MAX_CHANNEL,
-                false);
-            FURI_LOG_I(TAG, "find_channel returned %d", (int)ch);
-            memcpy(addr, altaddr, 5);
-        }
+// Pings the next few channels of the active candidate. Radio is set up for TX once per
+// candidate and stays that way, only RF_CH changes, until probe.active drops.
+static void probe_step(Storage* storage, NotificationApp* notification) {
+    uint8_t ping_packet[] = {0x0f, 0x0f, 0x0f, 0x0f}; // this can be anything, we just need an ack
+
+    if(!probe.configured) {
+        nrf24_configure(
+            nrf24_HANDLE,
+            target_rate_mbps(),
+            probe.addr,
+            probe.addr,
+            5,
+            probe.channels[probe.next],
+            false,
+            false);
+        probe.configured = true;
+    }
 
-        if(ch <= LOGITECH_MAX_CHANNEL) {
-            hexlify(addr, 5, top_address);
-            found_count++;
-            save_addr_to_file(storage, addr, 5, notification);
-            if(confirmed_idx < MAX_CONFIRMED) memcpy(confirmed[confirmed_idx++], addr, 5);
-            break;
+    uint8_t end = MIN(probe.next + PROBE_SLICE_CHANNELS, probe.channel_count);
+    for(; probe.next < end; probe.next++) {
+        uint8_t ch = probe.channels[probe.next];
+        nrf24_write_reg(nrf24_HANDLE, REG_RF_CH, ch);
+        if(nrf24_txpacket(nrf24_HANDLE, ping_packet, 4, true)) {
+            probe_confirmed(storage, notification, ch);
+            return;
         }
     }
+
+    if(probe.next < probe.channel_count) return;
+
+    if(!probe.alt) {
+        alt_address(probe.sniffed, probe.addr);
+        hexlify(probe.addr, 5, probe.hex);
+        // Same setup, only the addresses change
+        nrf24_set_src_mac(nrf24_HANDLE, probe.addr, 5);
+        nrf24_set_dst_mac(nrf24_HANDLE, probe.addr, 5);
+        probe.alt = true;
+        probe.next = 0;
+        FURI_LOG_I(TAG, "trying alternate address %s", probe.hex);
+    } else {
+        FURI_LOG_I(TAG, "no channel found");
+        probe.active = false;
+    }
+}
+
+// sniffing stopped, confirm whatever is still queued
+static void wrap_up(Storage* storage, NotificationApp* notification) {
+    nrf24_set_idle(nrf24_HANDLE);
+    while(probe.active || probe_next())
+        probe_step(storage, notification);
 }
 
 static void clear_cache() {
     found_count = 0;
     unique_saved_count = 0;
-    confirmed_idx = 0;
-    candidate_idx = 0;
     //target_channel = 2;
     target_channel = MICROSOFT_MIN_CHANNEL;
     total_candidates = 0;
+    sample_period = 0;
+    top_idx = -1;
+    probe.active = false;
     memset(candidates, 0, sizeof(candidates));
-    memset(counts, 0, sizeof(counts));
-    memset(confirmed, 0, sizeof(confirmed));
+    memset(channel_hits, 0, sizeof(channel_hits));
 }
 
 static void start_sniffing() {
@@ -331,9 +580,9 @@ static void start_sniffing() {
 
 int32_t nrfsniff_app(void* p) {
     UNUSED(p);
-    uint8_t address[5] = {0};
+    uint8_t addresses[NRF24_RX_FIFO_SIZE][5] = {0};
     uint32_t start = 0;
-    hexlify(address, 5, top_address);
+    hexlify(addresses[0], 5, top_address);
     FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(PluginEvent));
     PluginState* plugin_state = malloc(sizeof(PluginState));
     plugin_state->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
@@ -359,10 +608,13 @@ int32_t nrfsniff_app(void* p) {
 
     Storage* storage = furi_record_open(RECORD_STORAGE);
     storage_common_mkdir(storage, NRFSNIFF_APP_PATH_FOLDER);
+    load_confirmed(storage);
 
     PluginEvent event;
     for(bool processing = true; processing;) {
-        FuriStatus event_status = furi_message_queue_get(event_queue, &event, 100);
+        // Pending probe slices run back to back, sniffing paces itself on the queue timeout
+        FuriStatus event_status =
+            furi_message_queue_get(event_queue, &event, probe.active ? 0 : 100);
         furi_mutex_acquire(plugin_state->mutex, FuriWaitForever);
 
         if(event_status == FuriStatusOk) {
@@ -422,30 +674,32 @@ int32_t nrfsniff_app(void* p) {
             }
         }
 
-        if(sniffing_state) {
-            if(nrf24_sniff_address(nrf24_HANDLE, 5, address)) {
-                int idx;
-                uint8_t* top_addr;
-                if(!previously_confirmed(address)) {
-                    idx = get_addr_index(address, 5);
-                    if(idx == -1)
-                        insert_addr(address, 5);
-                    else
-                        counts[idx]++;
-
-                    top_addr = candidates[get_highest_idx()];
-                    hexlify(top_addr, 5, top_address);
-                }
+        if(sniffing_state && (probe.active || probe_next())) {
+            // Candidate is pinged in slices, the loop keeps handling input meanwhile.
+            // Sniffing pauses until it is done, switching modes per slice costs 300 ms.
+            probe_step(storage, notification);
+            if(!probe.active) {
+                start_sniffing();
+                start = furi_get_tick();
+            }
+        } else if(sniffing_state) {
+            // Whole RX FIFO is read per pass, packets arriving in bursts are not dropped
+            uint8_t found = nrf24_sniff_addresses(nrf24_HANDLE, 5, addresses);
+            for(uint8_t i = 0; i < found; i++) {
+                uint8_t* address = addresses[i];
+                if(!previously_confirmed(address) && count_addr(address))
+                    hexlify(candidates[top_idx].addr, 5, top_address);
             }
 
             if(furi_get_tick() - start >= sample_time) {
                 target_channel++;
                 //if(target_channel > LOGITECH_MAX_CHANNEL) target_channel = 2;
-                if(target_channel > LOGITECH_MAX_CHANNEL) target_channel = MICROSOFT_MIN_CHANNEL;
-                {
-                    wrap_up(storage, notification);
-                    start_sniffing();
+                if(target_channel > LOGITECH_MAX_CHANNEL) {
+                    target_channel = MICROSOFT_MIN_CHANNEL;
+                    decay_channel_hits();
                 }
+                age_candidates();
+                start_sniffing();
 
                 start = furi_get_tick();
             }
@@ -456,6 +710,10 @@ int32_t nrfsniff_app(void* p) {
     }
 
     clear_cache();
+    free(confirmed);
+    confirmed = NULL;
+    confirmed_slots = 0;
+    confirmed_count = 0;
     sample_time = DEFAULT_SAMPLE_TIME;
     target_rate = 8; // rate can be either 8 (2Mbps) or 0 (1Mbps)
     sniffing_state = false;